@@ -24,6 +24,7 @@ public:
         MULTIPLY = 2,
         MAX_NUM_OPERATIONS = 3
     };
+    using join_fun_t = double (*)(double, double);
 private:
     Operation _operation;
     std::unique_ptr<const TensorDataType> _tensorType;
@@ -39,6 +40,7 @@ public:
     TensorModifyUpdate &operator=(TensorModifyUpdate &&rhs);
     bool operator==(const ValueUpdate &other) const override;
     Operation getOperation() const { return _operation; }
+    static join_fun_t getJoinFunction(Operation operation);
     const TensorFieldValue &getTensor() const { return *_tensor; }
     void checkCompatibility(const Field &field) const override;
     std::unique_ptr<vespalib::tensor::Tensor> applyTo(const vespalib::tensor::Tensor &tensor) const;
@@ -35,6 +35,8 @@ struct MyExecutor : public Executor {
 TEST("require that parameter passing selection affects function key") {
     EXPECT_NOT_EQUAL(gen_key(*Function::parse("a+b"), PassParams::SEPARATE),
                      gen_key(*Function::parse("a+b"), PassParams::ARRAY));
+    EXPECT_NOT_EQUAL(gen_key(*Function::parse("a+b"), PassParams::ARRAY),
+                     gen_key(*Function::parse("a+b"), PassParams::BATCH));
 }
 
 TEST("require that the number of parameters affects function key") {
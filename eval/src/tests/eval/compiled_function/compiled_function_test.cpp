@@ -46,6 +46,48 @@ TEST("require that lazy parameter passing works") {
     EXPECT_EQUAL(45.0, lazy_fun(my_resolve, &std::vector<double>({9.0, 8.0, 7.0, 6.0, 5.0, 4.0, 3.0, 2.0, 1.0, 0.0})[0]));
 }
 
+TEST("require that batch parameter passing works") {
+    CompiledFunction batch_cf(*Function::parse(params_10, expr_10), PassParams::BATCH);
+    auto batch_fun = batch_cf.get_batch_function();
+    std::vector<std::vector<double>> columns;
+    std::vector<const double *> column_refs;
+    for (size_t p = 0; p < 10; ++p) {
+        columns.push_back({1.0, 5.0, double(p), double(9 - p), 0.0});
+    }
+    for (const auto &column: columns) {
+        column_refs.push_back(column.data());
+    }
+    std::vector<double> results(5, -1.0);
+    batch_fun(column_refs.data(), results.data(), 4);
+    EXPECT_EQUAL(10.0, results[0]);
+    EXPECT_EQUAL(50.0, results[1]);
+    EXPECT_EQUAL(45.0, results[2]);
+    EXPECT_EQUAL(45.0, results[3]);
+    EXPECT_EQUAL(-1.0, results[4]);
+    batch_fun(column_refs.data(), results.data(), 0);
+    EXPECT_EQUAL(10.0, results[0]);
+}
+
+TEST("require that batch evaluation works with many parameter sets and if trees") {
+    auto function = Function::parse({"a", "b"}, "if(a<b,a*2,b+3)+if(a==1,5,0)");
+    CompiledFunction arr_cf(*function, PassParams::ARRAY);
+    CompiledFunction batch_cf(*function, PassParams::BATCH);
+    size_t n = 1001;
+    std::vector<double> a;
+    std::vector<double> b;
+    for (size_t i = 0; i < n; ++i) {
+        a.push_back(double(i % 7));
+        b.push_back(double(i % 5));
+    }
+    std::vector<const double *> columns({a.data(), b.data()});
+    std::vector<double> results(n, 0.0);
+    batch_cf.get_batch_function()(columns.data(), results.data(), n);
+    for (size_t i = 0; i < n; ++i) {
+        std::vector<double> params({a[i], b[i]});
+        EXPECT_EQUAL(arr_cf.get_function()(params.data()), results[i]);
+    }
+}
+
 //-----------------------------------------------------------------------------
 
 std::vector<vespalib::string> unsupported = {
@@ -106,7 +148,19 @@ struct MyEvalTest : test::EvalSpec::EvalTest {
             auto fun = cfun.get_function();
             ASSERT_EQUAL(cfun.num_params(), param_values.size());
             double result = fun(&param_values[0]);
-            if (is_same(expected_result, result)) {
+            CompiledFunction batch_cfun(*function, PassParams::BATCH);
+            std::vector<const double *> columns;
+            for (const double &value: param_values) {
+                columns.push_back(&value);
+            }
+            double batch_result = 0.0;
+            batch_cfun.get_batch_function()(columns.data(), &batch_result, 1);
+            if (!is_same(result, batch_result)) {
+                print_fail && fprintf(stderr, "verifying: %s -> %g ... FAIL: batch got %g\n",
+                                      as_string(param_names, param_values, expression).c_str(),
+                                      expected_result, batch_result);
+                ++fail_cnt;
+            } else if (is_same(expected_result, result)) {
                 print_pass && fprintf(stderr, "verifying: %s -> %g ... PASS\n",
                                       as_string(param_names, param_values, expression).c_str(),
                                       expected_result);
@@ -2,6 +2,7 @@
 
 #include <vespa/eval/eval/function.h>
 #include <vespa/eval/eval/fast_forest.h>
+#include <vespa/eval/eval/fast_forest_batch.h>
 #include <vespa/eval/eval/vm_forest.h>
 #include <vespa/eval/eval/llvm/compiled_function.h>
 #include "model.cpp"
@@ -23,7 +24,22 @@ void estimate_cost(size_t num_params, const char *label, const T &impl) {
             label, (us_min / 10.0), (us_med / 10.0), (us_max / 10.0), (us_nan / 10.0));
 }
 
+void estimate_batch_cost(size_t num_params, const FastForest &forest, size_t batch_size) {
+    std::vector<double> inputs_min(num_params, 0.25);
+    std::vector<double> inputs_med(num_params, 0.50);
+    std::vector<double> inputs_max(num_params, 0.75);
+    std::vector<double> inputs_nan(num_params, std::numeric_limits<double>::quiet_NaN());
+    double us_min = forest.estimate_batch_cost_us(inputs_min, batch_size, 5.0);
+    double us_med = forest.estimate_batch_cost_us(inputs_med, batch_size, 5.0);
+    double us_max = forest.estimate_batch_cost_us(inputs_max, batch_size, 5.0);
+    double us_nan = forest.estimate_batch_cost_us(inputs_nan, batch_size, 5.0);
+    auto label = vespalib::make_string("%s batch", forest.impl_name().c_str());
+    fprintf(stderr, "[%18s] (per 100 eval): [low values] %6.3f ms, [medium values] %6.3f ms, [high values] %6.3f ms, [nan values] %6.3f ms (batch of %zu)\n",
+            label.c_str(), (us_min / 10.0), (us_med / 10.0), (us_max / 10.0), (us_nan / 10.0), batch_size);
+}
+
 void run_fast_forest_bench() {
+    fprintf(stderr, "batch kernels: %s (%zu lanes)\n", ff_batch::get_kernels().name, ff_batch::get_kernels().lanes);
     for (size_t tree_size: std::vector<size_t>({8,16,32,64,128,256})) {
         for (size_t num_trees: std::vector<size_t>({100, 500, 2500, 5000, 10000})) {
             for (size_t max_features: std::vector<size_t>({200})) {
@@ -36,12 +52,16 @@ void run_fast_forest_bench() {
                             auto forest = FastForest::try_convert(*function, min_bits, 64);
                             if (forest) {
                                 estimate_cost(function->num_params(), forest->impl_name().c_str(), *forest);
+                                estimate_batch_cost(function->num_params(), *forest, 64);
                             }
                             if (min_bits > 64) {
                                 break;
                             }
                         }
                         estimate_cost(function->num_params(), "vm forest", CompiledFunction(*function, PassParams::ARRAY, VMForest::optimize_chain));
+                        if (num_trees <= 500) {
+                            estimate_cost(function->num_params(), "llvm", CompiledFunction(*function, PassParams::ARRAY, Optimize::none));
+                        }
                     }
                 }
             }
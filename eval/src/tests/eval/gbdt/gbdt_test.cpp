@@ -407,6 +407,38 @@ TEST("require that fast forest evaluation is correct for all tree size categorie
     }
 }
 
+TEST("require that fast forest batch evaluation matches single document evaluation") {
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<float> dist(0.0, 1.0);
+    for (size_t tree_size: std::vector<size_t>({7,15,30,61,127})) {
+        vespalib::string expression = Model().max_features(35).less_percent(100).invert_percent(50).make_forest(31, tree_size);
+        auto function = Function::parse(expression);
+        auto forest = FastForest::try_convert(*function);
+        if ((tree_size <= 64) || is_little_endian()) {
+            ASSERT_TRUE(forest);
+            TEST_STATE(forest->impl_name().c_str());
+            size_t num_params = function->num_params();
+            auto ctx = forest->create_context();
+            for (size_t num_docs: std::vector<size_t>({1, 8, 16, 37})) {
+                size_t stride = (num_docs + 3);
+                std::vector<float> params(num_params * stride);
+                for (float &value: params) {
+                    value = (dist(gen) < 0.1) ? std::numeric_limits<float>::quiet_NaN() : dist(gen);
+                }
+                std::vector<double> results(num_docs);
+                forest->eval_batch(*ctx, &params[0], stride, num_docs, &results[0]);
+                std::vector<float> doc_params(num_params);
+                for (size_t doc = 0; doc < num_docs; ++doc) {
+                    for (size_t p = 0; p < num_params; ++p) {
+                        doc_params[p] = params[(p * stride) + doc];
+                    }
+                    EXPECT_EQUAL(forest->eval(*ctx, &doc_params[0]), results[doc]);
+                }
+            }
+        }
+    }
+}
+
 //-----------------------------------------------------------------------------
 
 TEST("require that GDBT expressions can be detected") {
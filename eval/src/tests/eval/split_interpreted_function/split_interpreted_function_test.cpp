@@ -0,0 +1,181 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include <vespa/vespalib/testkit/test_kit.h>
+#include <vespa/eval/eval/function.h>
+#include <vespa/eval/eval/node_types.h>
+#include <vespa/eval/eval/split_interpreted_function.h>
+#include <vespa/eval/eval/tensor_spec.h>
+#include <vespa/eval/tensor/default_tensor_engine.h>
+#include <vespa/vespalib/test/insertion_operators.h>
+#include <atomic>
+#include <stdexcept>
+
+using namespace vespalib::eval;
+using vespalib::Stash;
+using vespalib::tensor::DefaultTensorEngine;
+
+const TensorEngine &engine = DefaultTensorEngine::ref();
+
+//-----------------------------------------------------------------------------
+
+// q, w and s are query-level; d and n are not
+const std::vector<vespalib::string> param_names({"q", "w", "s", "d", "n"});
+const std::vector<bool> is_query_level({true, true, true, false, false});
+
+struct MyParams : LazyParams {
+    std::vector<Value::UP> values;
+    mutable std::atomic<size_t> resolve_cnt;
+    size_t fail_idx;
+    MyParams(size_t fail_idx_in = -1) : values(), resolve_cnt(0), fail_idx(fail_idx_in) {
+        values.push_back(engine.from_spec(TensorSpec("tensor(x[3])")
+                                          .add({{"x", 0}}, 1.0)
+                                          .add({{"x", 1}}, 2.0)
+                                          .add({{"x", 2}}, 3.0)));
+        values.push_back(engine.from_spec(TensorSpec("tensor(x[3],y[2])")
+                                          .add({{"x", 0}, {"y", 0}}, 1.0)
+                                          .add({{"x", 0}, {"y", 1}}, 2.0)
+                                          .add({{"x", 1}, {"y", 0}}, 3.0)
+                                          .add({{"x", 1}, {"y", 1}}, 4.0)
+                                          .add({{"x", 2}, {"y", 0}}, 5.0)
+                                          .add({{"x", 2}, {"y", 1}}, 6.0)));
+        values.push_back(std::make_unique<DoubleValue>(2.0));
+        values.push_back(engine.from_spec(TensorSpec("tensor(y[2])")
+                                          .add({{"y", 0}}, 5.0)
+                                          .add({{"y", 1}}, 7.0)));
+        values.push_back(std::make_unique<DoubleValue>(3.0));
+    }
+    ~MyParams() override;
+    const Value &resolve(size_t idx, Stash &) const override {
+        ++resolve_cnt;
+        if (idx == fail_idx) {
+            throw std::runtime_error("failed to resolve " + param_names[idx]);
+        }
+        return *values[idx];
+    }
+};
+MyParams::~MyParams() = default;
+
+struct Fixture {
+    std::shared_ptr<Function const> function;
+    NodeTypes types;
+    InterpretedFunction plain;
+    SplitInterpretedFunction split;
+    Fixture(const vespalib::string &expr)
+        : function(Function::parse(param_names, expr)),
+          types(*function, {ValueType::from_spec("tensor(x[3])"),
+                            ValueType::from_spec("tensor(x[3],y[2])"),
+                            ValueType::double_type(),
+                            ValueType::from_spec("tensor(y[2])"),
+                            ValueType::double_type()}),
+          plain(engine, *function, types),
+          split(engine, *function, types, is_query_level) {}
+    TensorSpec eval_plain() const {
+        MyParams params;
+        InterpretedFunction::Context ctx(plain);
+        return engine.to_spec(plain.eval(ctx, params));
+    }
+    TensorSpec eval_split() const {
+        MyParams params;
+        SplitInterpretedFunction::Results results(split);
+        results.resolve(params);
+        EXPECT_TRUE(results.ready());
+        InterpretedFunction::Context ctx(split.main());
+        return engine.to_spec(split.eval(ctx, params, results));
+    }
+};
+
+void verify(const vespalib::string &expr, size_t num_subexprs, const std::vector<size_t> &query_level_params) {
+    Fixture f(expr);
+    ASSERT_TRUE(!f.function->has_error());
+    EXPECT_EQUAL(f.split.num_params(), param_names.size());
+    EXPECT_EQUAL(f.split.num_subexprs(), num_subexprs);
+    EXPECT_EQUAL(f.split.query_level_params(), query_level_params);
+    EXPECT_EQUAL(f.eval_split(), f.eval_plain());
+}
+
+//-----------------------------------------------------------------------------
+
+TEST("require that query-level subexpressions are split out") {
+    TEST_DO(verify("reduce(q*w,sum,x)*d", 1, {0, 1}));
+    TEST_DO(verify("reduce(reduce(q*w,sum,x)*d,sum)+s*n", 1, {0, 1}));
+    TEST_DO(verify("reduce(q*w,sum,x)*(s+1)+d*n", 1, {0, 1, 2}));
+    TEST_DO(verify("(s+1)*n+reduce(q,max)*n", 2, {0, 2}));
+    TEST_DO(verify("reduce(q,sum)*n+s", 1, {0}));
+}
+
+TEST("require that expressions without query-level subexpressions are not split") {
+    TEST_DO(verify("reduce(d*d,sum)+n", 0, {}));
+    TEST_DO(verify("q*n+reduce(s*d,sum,y)", 0, {}));
+    TEST_DO(verify("reduce(tensor(x[3])(x+n)*q,sum)", 0, {}));
+}
+
+TEST("require that fully query-level expressions can be split") {
+    TEST_DO(verify("reduce(q*w,sum)", 1, {0, 1}));
+    TEST_DO(verify("if(s>1,reduce(q*w,sum,x),reduce(w,max,x))", 1, {0, 1, 2}));
+}
+
+TEST("require that tensor lambda bindings are tracked") {
+    TEST_DO(verify("reduce(tensor(x[3])(x+s)*q,sum)+n", 1, {0, 2}));
+}
+
+TEST("require that subexpression results are independent of the parameters used to calculate them") {
+    Fixture f("rename(q,x,z)*n");
+    EXPECT_EQUAL(f.split.num_subexprs(), 1u);
+    auto params = std::make_unique<MyParams>();
+    SplitInterpretedFunction::Results results(f.split);
+    results.resolve(*params);
+    params.reset();
+    MyParams other_params;
+    InterpretedFunction::Context ctx(f.split.main());
+    EXPECT_EQUAL(engine.to_spec(f.split.eval(ctx, other_params, results)), f.eval_plain());
+}
+
+struct ThreadFixture {
+    Fixture f;
+    SplitInterpretedFunction::Results results;
+    size_t single_resolve_cnt;
+    std::atomic<size_t> total_resolve_cnt;
+    ThreadFixture()
+        : f("reduce(q*w,sum,x)*d+reduce(w,max)*n+(s+1)*n"),
+          results(f.split),
+          single_resolve_cnt(0),
+          total_resolve_cnt(0)
+    {
+        MyParams params;
+        SplitInterpretedFunction::Results single_results(f.split);
+        single_results.resolve(params);
+        single_resolve_cnt = params.resolve_cnt;
+    }
+};
+
+TEST_MT_F("require that query-level subexpressions are evaluated once when shared by multiple threads", 8, ThreadFixture()) {
+    EXPECT_EQUAL(f1.f.split.num_subexprs(), 3u);
+    MyParams params;
+    f1.results.resolve(params);
+    EXPECT_TRUE(f1.results.ready());
+    f1.total_resolve_cnt += params.resolve_cnt;
+    InterpretedFunction::Context ctx(f1.f.split.main());
+    EXPECT_EQUAL(engine.to_spec(f1.f.split.eval(ctx, params, f1.results)), f1.f.eval_plain());
+    TEST_BARRIER();
+    EXPECT_EQUAL(f1.total_resolve_cnt.load(), f1.single_resolve_cnt);
+}
+
+TEST("require that failed subexpression evaluation is reported by every resolve") {
+    Fixture f("reduce(q*w,sum,x)*d+reduce(w,max)*n+(s+1)*n");
+    EXPECT_EQUAL(f.split.num_subexprs(), 3u);
+    MyParams params(1);
+    SplitInterpretedFunction::Results results(f.split);
+    EXPECT_EXCEPTION(results.resolve(params), std::runtime_error, "failed to resolve w");
+    EXPECT_FALSE(results.ready());
+    MyParams good_params;
+    EXPECT_EXCEPTION(results.resolve(good_params), std::runtime_error, "failed to resolve w");
+    EXPECT_EQUAL(good_params.resolve_cnt.load(), 0u);
+}
+
+TEST_MT_F("require that failed subexpression evaluation does not leave other threads waiting", 8, ThreadFixture()) {
+    MyParams params(1);
+    EXPECT_EXCEPTION(f1.results.resolve(params), std::runtime_error, "failed to resolve w");
+    EXPECT_FALSE(f1.results.ready());
+}
+
+TEST_MAIN() { TEST_RUN_ALL(); }
@@ -216,6 +216,7 @@ TEST("require that malformed value type spec is parsed as error") {
     EXPECT_TRUE(ValueType::from_spec("tensor(x{},x[])").is_error());
     EXPECT_TRUE(ValueType::from_spec("tensor(z[])").is_error());
     EXPECT_TRUE(ValueType::from_spec("tensor<float16>(x[10])").is_error());
+    EXPECT_TRUE(ValueType::from_spec("tensor<int16>(x[10])").is_error());
 }
 
 struct ParseResult {
@@ -258,6 +259,29 @@ TEST("require that value types preserve cell type") {
     EXPECT_TRUE(type("tensor(x[10])").cell_type() == CellType::DOUBLE);
     EXPECT_TRUE(type("tensor<double>(x[10])").cell_type() == CellType::DOUBLE);
     EXPECT_TRUE(type("tensor<float>(x[10])").cell_type() == CellType::FLOAT);
+    EXPECT_TRUE(type("tensor<bfloat16>(x[10])").cell_type() == CellType::BFLOAT16);
+    EXPECT_TRUE(type("tensor<int8>(x[10])").cell_type() == CellType::INT8);
+}
+
+TEST("require that narrow cell types round-trip through type spec") {
+    EXPECT_EQUAL(type("tensor<bfloat16>(x{},y[10])").to_spec(), "tensor<bfloat16>(x{},y[10])");
+    EXPECT_EQUAL(type("tensor<int8>(x{},y[10])").to_spec(), "tensor<int8>(x{},y[10])");
+    EXPECT_EQUAL(type("tensor<int8>()"), type("double"));
+}
+
+TEST("require that narrow cell types decay to float when calculating") {
+    EXPECT_EQUAL(type("tensor<int8>(x[10])").map(), type("tensor<float>(x[10])"));
+    EXPECT_EQUAL(type("tensor<bfloat16>(x[10])").map(), type("tensor<float>(x[10])"));
+    EXPECT_EQUAL(type("tensor(x[10])").map(), type("tensor(x[10])"));
+    EXPECT_EQUAL(type("double").map(), type("double"));
+    EXPECT_EQUAL(type("tensor<int8>(x[10],y[5])").reduce({"y"}), type("tensor<float>(x[10])"));
+    EXPECT_EQUAL(type("tensor<int8>(x[10],y[5])").peek({"y"}), type("tensor<int8>(x[10])"));
+    EXPECT_EQUAL(type("tensor<bfloat16>(x[10],y[5])").rename({"y"}, {"z"}), type("tensor<bfloat16>(x[10],z[5])"));
+    EXPECT_EQUAL(ValueType::join(type("tensor<int8>(x[10])"), type("tensor<int8>(y[5])")), type("tensor<float>(x[10],y[5])"));
+    EXPECT_EQUAL(ValueType::join(type("tensor<int8>(x[10])"), type("tensor<bfloat16>(y[5])")), type("tensor<float>(x[10],y[5])"));
+    EXPECT_EQUAL(ValueType::join(type("tensor<int8>(x[10])"), type("tensor(y[5])")), type("tensor(x[10],y[5])"));
+    EXPECT_EQUAL(ValueType::join(type("tensor<bfloat16>(x[10])"), type("double")), type("tensor<float>(x[10])"));
+    EXPECT_EQUAL(ValueType::merge(type("tensor<int8>(x[5])"), type("tensor<int8>(x[5])")), type("tensor<float>(x[5])"));
 }
 
 TEST("require that dimension names can be obtained") {
@@ -475,6 +499,9 @@ TEST("require that cell type is handled correctly for concat") {
     TEST_DO(verify_concat(type("tensor<float>(x[3])"), type("tensor(x[2])"), "x", type("tensor(x[5])")));
     TEST_DO(verify_concat(type("tensor<float>(x[3])"), type("tensor<float>(x[2])"), "x", type("tensor<float>(x[5])")));
     TEST_DO(verify_concat(type("tensor<float>(x[3])"), type("double"), "x", type("tensor<float>(x[4])")));
+    TEST_DO(verify_concat(type("tensor<int8>(x[3])"), type("tensor<int8>(x[2])"), "x", type("tensor<int8>(x[5])")));
+    TEST_DO(verify_concat(type("tensor<int8>(x[3])"), type("tensor<bfloat16>(x[2])"), "x", type("tensor<float>(x[5])")));
+    TEST_DO(verify_concat(type("tensor<bfloat16>(x[3])"), type("tensor(x[2])"), "x", type("tensor(x[5])")));
 }
 
 TEST_MAIN() { TEST_RUN_ALL(); }
@@ -0,0 +1,129 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include <vespa/vespalib/testkit/test_kit.h>
+#include <vespa/eval/eval/tensor_function.h>
+#include <vespa/eval/eval/simple_tensor.h>
+#include <vespa/eval/eval/simple_tensor_engine.h>
+#include <vespa/eval/tensor/default_tensor_engine.h>
+#include <vespa/eval/tensor/dense/dense_fused_join_reduce_function.h>
+#include <vespa/eval/tensor/dense/dense_dot_product_function.h>
+#include <vespa/eval/tensor/dense/dense_matmul_function.h>
+#include <vespa/eval/eval/test/tensor_model.hpp>
+#include <vespa/eval/eval/test/eval_fixture.h>
+
+#include <vespa/vespalib/util/stringfmt.h>
+#include <vespa/vespalib/util/stash.h>
+
+using namespace vespalib;
+using namespace vespalib::eval;
+using namespace vespalib::eval::test;
+using namespace vespalib::tensor;
+using namespace vespalib::eval::tensor_function;
+
+const TensorEngine &prod_engine = DefaultTensorEngine::ref();
+
+EvalFixture::ParamRepo make_params() {
+    return EvalFixture::ParamRepo()
+        .add("a", spec(1.5))
+        .add("b", spec(2.5))
+        .add_vector("x", 5)
+        .add_vector("x", 5)
+        .add_vector("x", 70)
+        .add_vector("x", 70)
+        .add_vector("y", 3)
+        .add_matrix("x", 5, "y", 3)
+        .add_matrix("x", 70, "y", 3)
+        .add_matrix("y", 3, "z", 4)
+        .add_cube("x", 5, "y", 3, "z", 4)
+        .add("x5y3i8", spec(int8_cells({x(5),y(3)}), N()))
+        .add("x5y3bf", spec(bfloat16_cells({x(5),y(3)}), N()))
+        .add("x5_mapped", spec({x({"a", "b", "c", "d", "e"})}, N()))
+        .add("x5y3_mixed", spec({x({"a", "b", "c", "d", "e"}),y(3)}, N()));
+}
+EvalFixture::ParamRepo param_repo = make_params();
+
+void verify_optimized(const vespalib::string &expr, size_t num_inputs, Aggr aggr) {
+    EvalFixture slow_fixture(prod_engine, expr, param_repo, false);
+    EvalFixture fixture(prod_engine, expr, param_repo, true);
+    EXPECT_EQUAL(fixture.result(), EvalFixture::ref(expr, param_repo));
+    EXPECT_EQUAL(fixture.result(), slow_fixture.result());
+    auto info = fixture.find_all<DenseFusedJoinReduceFunction>();
+    ASSERT_EQUAL(info.size(), 1u);
+    EXPECT_TRUE(info[0]->result_is_mutable());
+    EXPECT_EQUAL(info[0]->num_inputs(), num_inputs);
+    EXPECT_EQUAL(int(info[0]->aggr()), int(aggr));
+}
+
+void verify_not_optimized(const vespalib::string &expr) {
+    EvalFixture slow_fixture(prod_engine, expr, param_repo, false);
+    EvalFixture fixture(prod_engine, expr, param_repo, true);
+    EXPECT_EQUAL(fixture.result(), EvalFixture::ref(expr, param_repo));
+    EXPECT_EQUAL(fixture.result(), slow_fixture.result());
+    auto info = fixture.find_all<DenseFusedJoinReduceFunction>();
+    EXPECT_TRUE(info.empty());
+}
+
+TEST("require that join-join-reduce chains are fused") {
+    TEST_DO(verify_optimized("reduce(join(join(x5,x5$2,f(a,b)(a*b)),x5y3,f(a,b)(a+b)),sum,x)", 3, Aggr::SUM));
+    TEST_DO(verify_optimized("reduce(join(join(x5,x5$2,f(a,b)(a*b)),x5y3,f(a,b)(a+b)),sum,y)", 3, Aggr::SUM));
+    TEST_DO(verify_optimized("reduce(join(join(x5,x5$2,f(a,b)(a*b)),x5y3,f(a,b)(a+b)),sum)", 3, Aggr::SUM));
+    TEST_DO(verify_optimized("reduce(join(join(x5,y3,f(a,b)(a-b)),y3z4,f(a,b)(a*b)),max,y)", 3, Aggr::MAX));
+}
+
+TEST("require that reduce of join with different input shapes is fused") {
+    TEST_DO(verify_optimized("reduce(x5*y3,sum,x)", 2, Aggr::SUM));
+    TEST_DO(verify_optimized("reduce(x5y3*y3z4,sum,x,y)", 2, Aggr::SUM));
+    TEST_DO(verify_optimized("reduce(x5y3z4*x5y3,avg,x,z)", 2, Aggr::AVG));
+    TEST_DO(verify_optimized("reduce(x5y3z4*y3z4,prod,y)", 2, Aggr::PROD));
+}
+
+TEST("require that maps and numbers can be part of the fused expression") {
+    TEST_DO(verify_optimized("reduce(map(x5y3,f(a)(a*a)),sum,y)", 1, Aggr::SUM));
+    TEST_DO(verify_optimized("reduce(exp(x5y3-a)*y3,sum,x)", 3, Aggr::SUM));
+    TEST_DO(verify_optimized("reduce(tanh(x5*b+x5$2),min)", 3, Aggr::MIN));
+}
+
+TEST("require that all aggregators work with fused expressions") {
+    for (Aggr aggr: Aggregator::list()) {
+        auto expr = make_string("reduce(x5y3+y3z4,%s,y,z)", AggrNames::name_of(aggr)->c_str());
+        TEST_DO(verify_optimized(expr, 2, aggr));
+    }
+}
+
+TEST("require that large inner loops are evaluated in multiple blocks") {
+    TEST_DO(verify_optimized("reduce(join(join(x70,x70$2,f(a,b)(a*b)),x70y3,f(a,b)(a-b)),sum,x)", 3, Aggr::SUM));
+    TEST_DO(verify_optimized("reduce(x70*y3,sum,x,y)", 2, Aggr::SUM));
+    TEST_DO(verify_optimized("reduce(x70y3*y3,max,y)", 2, Aggr::MAX));
+}
+
+TEST("require that float, int8 and bfloat16 cells can be fused") {
+    TEST_DO(verify_optimized("reduce(join(join(x5f,x5f$2,f(a,b)(a*b)),x5y3f,f(a,b)(a+b)),sum,x)", 3, Aggr::SUM));
+    TEST_DO(verify_optimized("reduce(x5y3f*y3,sum,x)", 2, Aggr::SUM));
+    TEST_DO(verify_optimized("reduce(x5y3i8*x5y3bf,sum,x)", 2, Aggr::SUM));
+    TEST_DO(verify_optimized("reduce(x5y3i8+y3f,max,y)", 2, Aggr::MAX));
+}
+
+TEST("require that dot products and matrix multiplication are handled by their own optimizations") {
+    TEST_DO(verify_not_optimized("reduce(x5*x5$2,sum)"));
+    TEST_DO(verify_not_optimized("reduce(x5y3*y3z4,sum,y)"));
+    EXPECT_EQUAL(EvalFixture(prod_engine, "reduce(x5*x5$2,sum)", param_repo, true).find_all<DenseDotProductFunction>().size(), 1u);
+    EXPECT_EQUAL(EvalFixture(prod_engine, "reduce(x5y3*y3z4,sum,y)", param_repo, true).find_all<DenseMatMulFunction>().size(), 1u);
+}
+
+TEST("require that plain reduce is not fused") {
+    TEST_DO(verify_not_optimized("reduce(x5y3,sum,x)"));
+    TEST_DO(verify_not_optimized("reduce(x5y3z4,sum,x,y)"));
+}
+
+TEST("require that non-dense expressions are not fused") {
+    TEST_DO(verify_not_optimized("reduce(x5_mapped*x5_mapped,sum,x)"));
+    TEST_DO(verify_not_optimized("reduce(x5y3_mixed*y3,sum,y)"));
+    TEST_DO(verify_not_optimized("reduce(x5y3_mixed*y3,sum)"));
+}
+
+TEST("require that expressions with too many inputs are not fused") {
+    TEST_DO(verify_optimized("reduce(x5+x5+x5+x5+x5+x5+x5+x5,sum)", 8, Aggr::SUM));
+    TEST_DO(verify_not_optimized("reduce(x5+x5+x5+x5+x5+x5+x5+x5+x5,sum)"));
+}
+
+TEST_MAIN() { TEST_RUN_ALL(); }
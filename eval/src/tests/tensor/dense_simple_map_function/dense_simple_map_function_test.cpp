@@ -23,7 +23,10 @@ EvalFixture::ParamRepo make_params() {
         .add("b", spec(2.5))
         .add("sparse", spec({x({"a"})}, N()))
         .add("mixed", spec({x({"a"}),y(5)}, N()))
-        .add_matrix("x", 5, "y", 3);
+        .add_matrix("x", 5, "y", 3)
+        .add("x5y3i8", spec(int8_cells({x(5),y(3)}), N()))
+        .add_mutable("@x5y3i8", spec(int8_cells({x(5),y(3)}), N()))
+        .add_mutable("@x5y3bf", spec(bfloat16_cells({x(5),y(3)}), N()));
 }
 EvalFixture::ParamRepo param_repo = make_params();
 
@@ -63,6 +66,12 @@ TEST(MapTest, simple_dense_map_can_be_inplace) {
     verify_optimized("map(@x5y3f,f(x)(x+10))", true);
 }
 
+TEST(MapTest, int8_and_bfloat16_map_produces_float_and_is_never_inplace) {
+    verify_optimized("map(x5y3i8,f(x)(1/x))", false);
+    verify_optimized("map(@x5y3i8,f(x)(1/x))", false);
+    verify_optimized("map(@x5y3bf,f(x)(x+10))", false);
+}
+
 TEST(MapTest, scalar_map_is_not_optimized) {
     verify_not_optimized("map(a,f(x)(x+10))");
 }
@@ -31,6 +31,8 @@ EvalFixture::ParamRepo make_params() {
         .add_cube("a", 1, "b", 1, "c", 2)
         .add_cube("a", 1, "b", 1, "c", 1)
         .add_vector("a", 10)
+        .add("x3y4i8", spec(int8_cells({x(3),y(4)}), N()))
+        .add("x3y4bf", spec(bfloat16_cells({x(3),y(4)}), N()))
         .add("xy_mapped", spec({x({"a", "b"}),y({"x", "y"})}, N()))
         .add("xyz_mixed", spec({x({"a", "b"}),y({"x", "y"}),z(3)}, N()));
 }
@@ -120,4 +122,13 @@ TEST("require that minimal dense single reduce works") {
     TEST_DO(verify_optimized_multi("a1b1c2", "c", 2));
 }
 
+TEST("require that int8 and bfloat16 cells are reduced into float cells") {
+    for (Aggr aggr: Aggregator::list()) {
+        for (const char *arg: {"x3y4i8", "x3y4bf"}) {
+            TEST_DO(verify_optimized(make_string("reduce(%s,%s,x)", arg, AggrNames::name_of(aggr)->c_str()), 0, aggr));
+            TEST_DO(verify_optimized(make_string("reduce(%s,%s,y)", arg, AggrNames::name_of(aggr)->c_str()), 1, aggr));
+        }
+    }
+}
+
 TEST_MAIN() { TEST_RUN_ALL(); }
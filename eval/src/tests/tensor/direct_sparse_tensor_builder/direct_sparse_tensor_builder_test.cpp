@@ -13,24 +13,11 @@ using vespalib::eval::ValueType;
 void
 assertCellValue(double expValue, const TensorAddress &address,
                 const ValueType &type,
-                const SparseTensor::Cells &cells)
+                const SparseTensor &tensor)
 {
+    const SparseTensor::Cells &cells = tensor.cells();
     SparseTensorAddressBuilder addressBuilder;
-    auto dimsItr = type.dimensions().cbegin();
-    auto dimsItrEnd = type.dimensions().cend();
-    for (const auto &element : address.elements()) {
-        while ((dimsItr < dimsItrEnd) && (dimsItr->name < element.dimension())) {
-            addressBuilder.add("");
-            ++dimsItr;
-        }
-        assert((dimsItr != dimsItrEnd) && (dimsItr->name == element.dimension()));
-        addressBuilder.add(element.label());
-        ++dimsItr;
-    }
-    while (dimsItr < dimsItrEnd) {
-        addressBuilder.add("");
-        ++dimsItr;
-    }
+    EXPECT_TRUE(addressBuilder.populate(type, address, tensor.labels()));
     SparseTensorAddressRef addressRef(addressBuilder.getAddressRef());
     auto itr = cells.find(addressRef);
     EXPECT_FALSE(itr == cells.end());
@@ -41,7 +28,7 @@ Tensor::UP
 buildTensor()
 {
     DirectSparseTensorBuilder builder(ValueType::from_spec("tensor(a{},b{},c{},d{})"));
-    SparseTensorAddressBuilder address;
+    SparseTensorAddressBuilder address(builder.labels());
     address.set({"1", "2", "", ""});
     builder.insertCell(address, 10);
     address.set({"", "", "3", "4"});
@@ -54,10 +41,9 @@ TEST("require that tensor can be constructed")
     Tensor::UP tensor = buildTensor();
     const SparseTensor &sparseTensor = dynamic_cast<const SparseTensor &>(*tensor);
     const ValueType &type = sparseTensor.type();
-    const SparseTensor::Cells &cells = sparseTensor.cells();
-    EXPECT_EQUAL(2u, cells.size());
-    assertCellValue(10, TensorAddress({{"a","1"},{"b","2"}}), type, cells);
-    assertCellValue(20, TensorAddress({{"c","3"},{"d","4"}}), type, cells);
+    EXPECT_EQUAL(2u, sparseTensor.cells().size());
+    assertCellValue(10, TensorAddress({{"a","1"},{"b","2"}}), type, sparseTensor);
+    assertCellValue(20, TensorAddress({{"c","3"},{"d","4"}}), type, sparseTensor);
 }
 
 TEST("require that tensor can be converted to tensor spec")
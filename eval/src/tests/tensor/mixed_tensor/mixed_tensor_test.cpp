@@ -0,0 +1,184 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include <vespa/eval/eval/simple_tensor.h>
+#include <vespa/eval/eval/simple_tensor_engine.h>
+#include <vespa/eval/eval/tensor_function.h>
+#include <vespa/eval/tensor/default_tensor_engine.h>
+#include <vespa/eval/tensor/mixed/mixed_tensor.h>
+#include <vespa/eval/tensor/mixed/mixed_tensor_builder.h>
+#include <vespa/eval/tensor/mixed/mixed_tensor_peek_function.h>
+#include <vespa/eval/eval/test/eval_fixture.h>
+#include <vespa/eval/eval/test/tensor_model.hpp>
+#include <vespa/vespalib/objects/nbostream.h>
+#include <vespa/vespalib/gtest/gtest.h>
+
+using namespace vespalib;
+using namespace vespalib::eval;
+using namespace vespalib::eval::test;
+using namespace vespalib::tensor;
+
+const TensorEngine &prod_engine = DefaultTensorEngine::ref();
+
+EvalFixture::ParamRepo make_params() {
+    return EvalFixture::ParamRepo()
+        .add("a", spec(1.5))
+        .add("x3", spec({x(3)}, N()))
+        .add("y5", spec({y(5)}, N()))
+        .add("x_sparse", spec({x({"a","b","c"})}, N()))
+        .add("z_sparse", spec({z({"1","2","4"})}, N()))
+        .add("x_mixed", spec({x({"a","b","c"}),y(5)}, N()))
+        .add("x_mixed_f", spec(float_cells({x({"a","b","c"}),y(5)}), N()))
+        .add("x_mixed_i8", spec(int8_cells({x({"a","b","c"}),y(5)}), N()))
+        .add("x_mixed_other", spec({x({"b","c","d"}),y(5)}, Div16(N())))
+        .add("z_mixed", spec({y(5),z({"1","2","3"})}, Div16(N())))
+        .add("xz_mixed", spec({x({"a","c"}),y(5),z({"1","3"})}, Div16(N())))
+        .add("xz_mixed2", spec({x({"a","b"}),y(5),z({"2","3"})}, N()))
+        .add("xy_mixed", spec({x({"a","b","c"}),y(3),z(2)}, N()))
+        .add("empty_mixed", spec({x({}),y(5)}, N()));
+}
+EvalFixture::ParamRepo param_repo = make_params();
+
+void verify(const vespalib::string &expr) {
+    EvalFixture slow_fixture(prod_engine, expr, param_repo, false);
+    EvalFixture fixture(prod_engine, expr, param_repo, true);
+    EXPECT_EQ(fixture.result(), EvalFixture::ref(expr, param_repo)) << expr;
+    EXPECT_EQ(fixture.result(), slow_fixture.result()) << expr;
+}
+
+void verify_peek_optimized(const vespalib::string &expr) {
+    verify(expr);
+    EvalFixture fixture(prod_engine, expr, param_repo, true);
+    EXPECT_EQ(fixture.find_all<MixedTensorPeekFunction>().size(), 1u) << expr;
+}
+
+void verify_peek_not_optimized(const vespalib::string &expr) {
+    verify(expr);
+    EvalFixture fixture(prod_engine, expr, param_repo, true);
+    EXPECT_TRUE(fixture.find_all<MixedTensorPeekFunction>().empty()) << expr;
+}
+
+Value::UP make_value(const TensorSpec &spec) {
+    return prod_engine.from_spec(spec);
+}
+
+const MixedTensor *as_mixed(const Value &value) {
+    return dynamic_cast<const MixedTensor *>(value.as_tensor());
+}
+
+TEST(MixedTensorTest, mixed_tensor_types_use_mixed_tensor_implementation) {
+    auto spec = param_repo.map.find("x_mixed")->second.value;
+    auto value = make_value(spec);
+    const MixedTensor *mixed = as_mixed(*value);
+    ASSERT_TRUE(mixed != nullptr);
+    EXPECT_EQ(mixed->num_subspaces(), 3u);
+    EXPECT_EQ(mixed->subspace_size(), 5u);
+    EXPECT_EQ(mixed->sparse_type(), ValueType::from_spec("tensor(x{})"));
+    EXPECT_EQ(mixed->dense_type(), ValueType::from_spec("tensor(y[5])"));
+    EXPECT_EQ(prod_engine.to_spec(*value), spec);
+}
+
+TEST(MixedTensorTest, builder_produces_canonical_tensor_implementations) {
+    EXPECT_TRUE(as_mixed(*MixedTensorBuilder(ValueType::from_spec("tensor(x{},y[3])")).build()) != nullptr);
+    EXPECT_TRUE(as_mixed(*MixedTensorBuilder(ValueType::from_spec("tensor(x{})")).build()) == nullptr);
+    EXPECT_TRUE(as_mixed(*MixedTensorBuilder(ValueType::from_spec("tensor(y[3])")).build()) == nullptr);
+    MixedTensorBuilder builder(ValueType::from_spec("tensor<float>(y[3])"));
+    EXPECT_TRUE(builder.set_cell({{"y", 1}}, 5.0));
+    EXPECT_FALSE(builder.set_cell({{"y", 3}}, 5.0));
+    EXPECT_FALSE(builder.set_cell({{"x", 1}}, 5.0));
+    auto tensor = builder.build();
+    EXPECT_EQ(tensor->toSpec(), TensorSpec("tensor<float>(y[3])").add({{"y", 0}}, 0.0).add({{"y", 1}}, 5.0).add({{"y", 2}}, 0.0));
+}
+
+TEST(MixedTensorTest, mixed_tensors_can_be_mapped) {
+    verify("-x_mixed");
+    verify("sqrt(x_mixed_f)");
+    verify("-x_mixed_i8");
+    verify("-empty_mixed");
+}
+
+TEST(MixedTensorTest, mixed_tensors_can_be_joined) {
+    verify("x_mixed+a");
+    verify("a*x_mixed");
+    verify("x_mixed*x_mixed_other");
+    verify("x_mixed*x_mixed_f");
+    verify("x_mixed*x_mixed_i8");
+    verify("x_mixed*z_mixed");
+    verify("z_mixed*x_mixed");
+    verify("x_mixed-xz_mixed");
+    verify("xz_mixed-x_mixed");
+    verify("xz_mixed*xz_mixed2");
+    verify("xz_mixed*z_mixed");
+    verify("xy_mixed*x_sparse");
+    verify("x_mixed*empty_mixed");
+}
+
+TEST(MixedTensorTest, sparse_and_dense_tensors_are_joined_as_mixed_tensors) {
+    verify("x_sparse*y5");
+    verify("y5*x_sparse");
+    verify("x_sparse*x_mixed");
+    verify("z_sparse*x_mixed");
+    verify("z_sparse*xz_mixed");
+    verify("x_mixed*y5");
+    verify("x3*z_mixed");
+}
+
+TEST(MixedTensorTest, mixed_tensors_can_be_merged) {
+    verify("merge(x_mixed,x_mixed_other,f(a,b)(a+b))");
+    verify("merge(x_mixed,x_mixed_f,f(a,b)(a-b))");
+    verify("merge(x_mixed,empty_mixed,f(a,b)(a*b))");
+}
+
+TEST(MixedTensorTest, mixed_tensors_can_be_reduced) {
+    for (vespalib::string aggr: {"sum", "prod", "max", "min", "avg", "count"}) {
+        verify("reduce(x_mixed," + aggr + ")");
+        verify("reduce(x_mixed," + aggr + ",x)");
+        verify("reduce(x_mixed," + aggr + ",y)");
+        verify("reduce(xz_mixed," + aggr + ",x)");
+        verify("reduce(xz_mixed," + aggr + ",z,y)");
+        verify("reduce(xy_mixed," + aggr + ",y)");
+        verify("reduce(xy_mixed," + aggr + ",x,z)");
+        verify("reduce(x_mixed_i8," + aggr + ",x)");
+        verify("reduce(empty_mixed," + aggr + ",x)");
+    }
+}
+
+TEST(MixedTensorTest, mixed_tensor_peek_is_optimized) {
+    verify_peek_optimized("x_mixed{x:b,y:3}");
+    verify_peek_optimized("x_mixed{x:b}");
+    verify_peek_optimized("x_mixed{x:d}");
+    verify_peek_optimized("x_mixed{x:d,y:1}");
+    verify_peek_optimized("x_mixed_f{x:c}");
+    verify_peek_optimized("x_mixed_i8{x:c,y:(a+0.5)}");
+    verify_peek_optimized("x_mixed{x:c,y:(a+3.5)}");
+    verify_peek_optimized("xz_mixed{x:c,z:(a+1.5)}");
+    verify_peek_optimized("xz_mixed{x:c,y:2,z:3}");
+    verify_peek_optimized("xy_mixed{x:a,z:1}");
+    verify_peek_optimized("xy_mixed{x:b,y:(a-0.5)}");
+}
+
+TEST(MixedTensorTest, partial_mapped_peek_is_not_optimized) {
+    verify_peek_not_optimized("xz_mixed{x:a}");
+    verify_peek_not_optimized("xz_mixed{z:1,y:3}");
+    verify_peek_not_optimized("x_sparse{x:a}");
+    verify_peek_not_optimized("x3{x:1}");
+}
+
+TEST(MixedTensorTest, mixed_tensor_serialization_is_compatible_with_reference_implementation) {
+    for (const auto &name: {"x_mixed", "x_mixed_f", "x_mixed_i8", "xz_mixed", "xy_mixed", "empty_mixed"}) {
+        auto spec = param_repo.map.find(name)->second.value;
+        auto value = make_value(spec);
+        ASSERT_TRUE(as_mixed(*value) != nullptr);
+        nbostream prod_data;
+        prod_engine.encode(*value, prod_data);
+        nbostream ref_data(prod_data.peek(), prod_data.size());
+        EXPECT_EQ(SimpleTensorEngine::ref().to_spec(*SimpleTensor::decode(ref_data)), spec) << name;
+        auto decoded = prod_engine.decode(prod_data);
+        ASSERT_TRUE(as_mixed(*decoded) != nullptr);
+        EXPECT_EQ(prod_engine.to_spec(*decoded), spec) << name;
+        nbostream simple_data;
+        SimpleTensor::encode(*SimpleTensor::create(spec), simple_data);
+        EXPECT_EQ(prod_engine.to_spec(*prod_engine.decode(simple_data)), spec) << name;
+    }
+}
+
+GTEST_MAIN_RUN_ALL_TESTS()
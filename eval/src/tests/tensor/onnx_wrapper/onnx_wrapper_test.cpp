@@ -308,4 +308,57 @@ TEST(OnnxTest, we_guess_batch_dimension_size_when_inference_fails) {
     //-------------------------------------------------------------------------
 }
 
+TEST(OnnxTest, model_can_be_batched_only_when_batch_dimension_is_bound_to_1) {
+    Onnx guess_batch(guess_batch_model, Onnx::Optimize::ENABLE);
+    Onnx::WirePlanner planner_1;
+    Onnx::WirePlanner planner_3;
+    ValueType in_1_type = ValueType::from_spec("tensor<float>(a[1])");
+    ValueType in_3_type = ValueType::from_spec("tensor<float>(a[3])");
+    EXPECT_TRUE(planner_1.bind_input_type(in_1_type, guess_batch.inputs()[0]));
+    EXPECT_TRUE(planner_1.bind_input_type(in_1_type, guess_batch.inputs()[1]));
+    EXPECT_TRUE(planner_3.bind_input_type(in_3_type, guess_batch.inputs()[0]));
+    EXPECT_TRUE(planner_3.bind_input_type(in_3_type, guess_batch.inputs()[1]));
+    EXPECT_TRUE(Onnx::BatchEvalContext::can_batch(guess_batch, planner_1.get_wire_info(guess_batch)));
+    EXPECT_FALSE(Onnx::BatchEvalContext::can_batch(guess_batch, planner_3.get_wire_info(guess_batch)));
+
+    Onnx simple(simple_model, Onnx::Optimize::ENABLE);
+    Onnx::WirePlanner planner;
+    EXPECT_TRUE(planner.bind_input_type(ValueType::from_spec("tensor<float>(a[1],b[4])"), simple.inputs()[0]));
+    EXPECT_TRUE(planner.bind_input_type(ValueType::from_spec("tensor<float>(a[4],b[1])"), simple.inputs()[1]));
+    EXPECT_TRUE(planner.bind_input_type(ValueType::from_spec("tensor<float>(a[1],b[1])"), simple.inputs()[2]));
+    EXPECT_FALSE(Onnx::BatchEvalContext::can_batch(simple, planner.get_wire_info(simple)));
+}
+
+TEST(OnnxTest, batch_eval_context_evaluates_model_once_for_multiple_inputs) {
+    Onnx model(guess_batch_model, Onnx::Optimize::ENABLE);
+    Onnx::WirePlanner planner;
+    ValueType in_type = ValueType::from_spec("tensor<double>(a[1])");
+    EXPECT_TRUE(planner.bind_input_type(in_type, model.inputs()[0]));
+    EXPECT_TRUE(planner.bind_input_type(in_type, model.inputs()[1]));
+    Onnx::WireInfo wire_info = planner.get_wire_info(model);
+    Onnx::BatchEvalContext ctx(model, wire_info, 4);
+    EXPECT_EQ(ctx.max_batch_size(), 4);
+    //-------------------------------------------------------------------------
+    std::vector<std::vector<double>> values({{1.0}, {2.0}, {3.0}, {10.0}});
+    for (size_t i = 0; i < values.size(); ++i) {
+        DenseTensorView in(in_type, TypedCells(values[i]));
+        ctx.bind_param(i, 0, in);
+        ctx.bind_param(i, 1, in);
+    }
+    ctx.eval(4);
+    for (size_t i = 0; i < values.size(); ++i) {
+        auto expect = TensorSpec("tensor<float>(d0[1])").add({{"d0", 0}}, 2.0 * values[i][0]);
+        EXPECT_EQ(TensorSpec::from_value(ctx.get_result(i, 0)), expect);
+    }
+    //-------------------------------------------------------------------------
+    std::vector<double> a({5.0});
+    std::vector<double> b({7.0});
+    ctx.bind_param(0, 0, DenseTensorView(in_type, TypedCells(a)));
+    ctx.bind_param(0, 1, DenseTensorView(in_type, TypedCells(b)));
+    ctx.eval(1);
+    EXPECT_EQ(TensorSpec::from_value(ctx.get_result(0, 0)),
+              TensorSpec("tensor<float>(d0[1])").add({{"d0", 0}}, 12.0));
+    //-------------------------------------------------------------------------
+}
+
 GTEST_MAIN_RUN_ALL_TESTS()
@@ -0,0 +1,218 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include <vespa/eval/eval/operation.h>
+#include <vespa/eval/eval/tensor_spec.h>
+#include <vespa/eval/tensor/default_tensor_engine.h>
+#include <vespa/eval/tensor/mixed/mixed_tensor.h>
+#include <vespa/eval/tensor/mixed/mixed_tensor_builder.h>
+#include <vespa/eval/tensor/sparse/sparse_tensor.h>
+#include <vespa/eval/tensor/sparse/sparse_tensor_label_repo.h>
+#include <vespa/eval/tensor/sparse/sparse_tensor_address_builder.h>
+#include <vespa/eval/tensor/sparse/sparse_tensor_address_decoder.h>
+#include <vespa/vespalib/util/stringfmt.h>
+#include <vespa/vespalib/gtest/gtest.h>
+#include <thread>
+
+using namespace vespalib;
+using namespace vespalib::tensor;
+using vespalib::eval::TensorSpec;
+using vespalib::eval::ValueType;
+using vespalib::eval::operation::Add;
+using vespalib::eval::operation::Mul;
+
+using Repo = SparseTensorLabelRepo;
+
+std::unique_ptr<Tensor> make_tensor(const TensorSpec &spec) {
+    auto value = DefaultTensorEngine::ref().from_spec(spec);
+    return std::unique_ptr<Tensor>(dynamic_cast<Tensor*>(value.release()));
+}
+
+// make a tensor enumerating its labels in a repo of its own
+std::unique_ptr<Tensor> make_tensor_with_own_labels(const TensorSpec &spec) {
+    MixedTensorBuilder builder(ValueType::from_spec(spec.type()), std::make_shared<Repo>());
+    for (const auto &cell: spec.cells()) {
+        EXPECT_TRUE(builder.set_cell(cell.first, cell.second));
+    }
+    return builder.build();
+}
+
+TEST(SparseTensorLabelRepoTest, empty_label_has_reserved_id) {
+    Repo repo;
+    EXPECT_EQ(repo.resolve(""), Repo::EMPTY_LABEL);
+    EXPECT_EQ(repo.find(""), Repo::EMPTY_LABEL);
+    EXPECT_EQ(repo.get(Repo::EMPTY_LABEL), "");
+    EXPECT_EQ(repo.size(), 1u);
+}
+
+TEST(SparseTensorLabelRepoTest, labels_are_enumerated_once) {
+    Repo repo;
+    auto foo = repo.resolve("foo");
+    auto bar = repo.resolve("bar");
+    EXPECT_NE(foo, Repo::EMPTY_LABEL);
+    EXPECT_NE(bar, Repo::EMPTY_LABEL);
+    EXPECT_NE(foo, bar);
+    EXPECT_EQ(repo.resolve("foo"), foo);
+    EXPECT_EQ(repo.resolve(vespalib::string("bar")), bar);
+    EXPECT_EQ(repo.find("bar"), bar);
+    EXPECT_EQ(repo.find("baz"), Repo::NO_LABEL);
+    EXPECT_EQ(repo.get(foo), "foo");
+    EXPECT_EQ(repo.get(bar), "bar");
+    EXPECT_EQ(repo.size(), 3u);
+}
+
+TEST(SparseTensorLabelRepoTest, many_labels_can_be_enumerated) {
+    Repo repo;
+    std::vector<Repo::label_t> ids;
+    for (size_t i = 0; i < 50000; ++i) {
+        ids.push_back(repo.resolve(make_string("many_%zu", i)));
+    }
+    EXPECT_EQ(repo.size(), 50001u);
+    for (size_t i = 0; i < ids.size(); ++i) {
+        EXPECT_EQ(repo.get(ids[i]), make_string("many_%zu", i));
+    }
+}
+
+TEST(SparseTensorLabelRepoTest, labels_can_be_enumerated_concurrently) {
+    Repo repo;
+    constexpr size_t num_threads = 4;
+    constexpr size_t num_labels = 10000;
+    std::vector<std::vector<Repo::label_t>> ids(num_threads);
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < num_threads; ++t) {
+        threads.emplace_back([&repo,&ids,t]()
+                             {
+                                 for (size_t i = 0; i < num_labels; ++i) {
+                                     ids[t].push_back(repo.resolve(make_string("label_%zu", (i + t * 1000) % num_labels)));
+                                 }
+                             });
+    }
+    for (auto &thread: threads) {
+        thread.join();
+    }
+    EXPECT_EQ(repo.size(), num_labels + 1);
+    for (size_t t = 0; t < num_threads; ++t) {
+        for (size_t i = 0; i < num_labels; ++i) {
+            auto label = make_string("label_%zu", (i + t * 1000) % num_labels);
+            EXPECT_EQ(ids[t][i], repo.find(label));
+            EXPECT_EQ(repo.get(ids[t][i]), label);
+        }
+    }
+}
+
+TEST(SparseTensorLabelRepoTest, current_repo_is_replaced_when_large) {
+    auto repo = Repo::current();
+    EXPECT_EQ(Repo::current(), repo);
+    vespalib::string last;
+    while (repo->size() < Repo::ROLLOVER_SIZE) {
+        last = make_string("rollover_%zu", repo->size());
+        repo->resolve(last);
+    }
+    auto next = Repo::current();
+    EXPECT_NE(next, repo);
+    EXPECT_EQ(next->size(), 1u);
+    EXPECT_EQ(next->find(last), Repo::NO_LABEL);
+    EXPECT_EQ(repo->get(repo->find(last)), last);
+}
+
+TEST(SparseTensorLabelRepoTest, sparse_addresses_use_fixed_width_label_ids) {
+    Repo repo;
+    SparseTensorAddressBuilder builder(repo);
+    builder.add("a_rather_long_label");
+    builder.addUndefined();
+    builder.add("x");
+    auto ref = builder.getAddressRef();
+    EXPECT_EQ(ref.size(), 3 * sizeof(Repo::label_t));
+    SparseTensorAddressDecoder decoder(ref);
+    EXPECT_EQ(decoder.decodeLabel(repo), "a_rather_long_label");
+    EXPECT_EQ(decoder.decode_label_id(), Repo::EMPTY_LABEL);
+    EXPECT_EQ(decoder.decode_label_id(), repo.find("x"));
+    EXPECT_FALSE(decoder.valid());
+}
+
+TEST(SparseTensorLabelRepoTest, built_tensors_share_the_current_labels) {
+    auto a = make_tensor(TensorSpec("tensor(x{})").add({{"x","a"}}, 1.0));
+    auto b = make_tensor(TensorSpec("tensor(x{})").add({{"x","b"}}, 2.0));
+    const auto &sa = dynamic_cast<const SparseTensor &>(*a);
+    const auto &sb = dynamic_cast<const SparseTensor &>(*b);
+    EXPECT_TRUE(sa.same_labels(sb));
+    EXPECT_EQ(sa.shared_labels(), Repo::current());
+    EXPECT_NE(sa.labels().find("b"), Repo::NO_LABEL);
+    auto sum = a->add(*b);
+    EXPECT_TRUE(sa.same_labels(dynamic_cast<const SparseTensor &>(*sum)));
+    auto joined = a->join(Mul::f, *b);
+    EXPECT_TRUE(sa.same_labels(dynamic_cast<const SparseTensor &>(*joined)));
+}
+
+TEST(SparseTensorLabelRepoTest, labels_are_shared_with_derived_tensors) {
+    auto a = make_tensor(TensorSpec("tensor(x{},y{})").add({{"x","a"},{"y","b"}}, 1.0));
+    auto clone = a->clone();
+    auto reduced = a->reduce(Add::f, {"y"});
+    const auto &sa = dynamic_cast<const SparseTensor &>(*a);
+    EXPECT_TRUE(sa.same_labels(dynamic_cast<const SparseTensor &>(*clone)));
+    EXPECT_TRUE(sa.same_labels(dynamic_cast<const SparseTensor &>(*reduced)));
+    a.reset();
+    EXPECT_EQ(clone->toSpec(), TensorSpec("tensor(x{},y{})").add({{"x","a"},{"y","b"}}, 1.0));
+    EXPECT_EQ(reduced->toSpec(), TensorSpec("tensor(x{})").add({{"x","a"}}, 1.0));
+}
+
+TEST(SparseTensorLabelRepoTest, sparse_tensors_with_different_labels_can_be_combined) {
+    auto a = make_tensor(TensorSpec("tensor(x{},y{})")
+                         .add({{"x","a"},{"y","1"}}, 1.0)
+                         .add({{"x","b"},{"y","2"}}, 2.0));
+    auto b = make_tensor_with_own_labels(TensorSpec("tensor(y{},z{})")
+                         .add({{"y","2"},{"z","c"}}, 3.0)
+                         .add({{"y","3"},{"z","d"}}, 4.0));
+    auto c = make_tensor_with_own_labels(TensorSpec("tensor(x{},y{})")
+                         .add({{"x","b"},{"y","2"}}, 5.0)
+                         .add({{"x","c"},{"y","3"}}, 6.0));
+    EXPECT_EQ(a->join(Mul::f, *b)->toSpec(),
+              TensorSpec("tensor(x{},y{},z{})").add({{"x","b"},{"y","2"},{"z","c"}}, 6.0));
+    EXPECT_EQ(a->join(Mul::f, *c)->toSpec(),
+              TensorSpec("tensor(x{},y{})").add({{"x","b"},{"y","2"}}, 10.0));
+    EXPECT_EQ(a->merge(Add::f, *c)->toSpec(),
+              TensorSpec("tensor(x{},y{})")
+              .add({{"x","a"},{"y","1"}}, 1.0)
+              .add({{"x","b"},{"y","2"}}, 7.0)
+              .add({{"x","c"},{"y","3"}}, 6.0));
+    EXPECT_EQ(a->add(*c)->toSpec(),
+              TensorSpec("tensor(x{},y{})")
+              .add({{"x","a"},{"y","1"}}, 1.0)
+              .add({{"x","b"},{"y","2"}}, 5.0)
+              .add({{"x","c"},{"y","3"}}, 6.0));
+    auto a2 = make_tensor_with_own_labels(a->toSpec());
+    EXPECT_TRUE(a->equals(*a2));
+    EXPECT_FALSE(a->equals(*c));
+}
+
+TEST(SparseTensorLabelRepoTest, mixed_tensors_with_different_labels_can_be_combined) {
+    auto a = make_tensor(TensorSpec("tensor(x{},y[2])")
+                         .add({{"x","a"},{"y",0}}, 1.0).add({{"x","a"},{"y",1}}, 2.0)
+                         .add({{"x","b"},{"y",0}}, 3.0).add({{"x","b"},{"y",1}}, 4.0));
+    auto b = make_tensor_with_own_labels(TensorSpec("tensor(x{},y[2])")
+                         .add({{"x","b"},{"y",0}}, 5.0).add({{"x","b"},{"y",1}}, 6.0)
+                         .add({{"x","c"},{"y",0}}, 7.0).add({{"x","c"},{"y",1}}, 8.0));
+    auto c = make_tensor_with_own_labels(TensorSpec("tensor(z{})").add({{"z","d"}}, 2.0));
+    ASSERT_TRUE(dynamic_cast<const MixedTensor *>(a.get()));
+    EXPECT_EQ(a->join(Mul::f, *b)->toSpec(),
+              TensorSpec("tensor(x{},y[2])").add({{"x","b"},{"y",0}}, 15.0).add({{"x","b"},{"y",1}}, 24.0));
+    EXPECT_EQ(a->merge(Add::f, *b)->toSpec(),
+              TensorSpec("tensor(x{},y[2])")
+              .add({{"x","a"},{"y",0}}, 1.0).add({{"x","a"},{"y",1}}, 2.0)
+              .add({{"x","b"},{"y",0}}, 8.0).add({{"x","b"},{"y",1}}, 10.0)
+              .add({{"x","c"},{"y",0}}, 7.0).add({{"x","c"},{"y",1}}, 8.0));
+    EXPECT_EQ(a->add(*b)->toSpec(),
+              TensorSpec("tensor(x{},y[2])")
+              .add({{"x","a"},{"y",0}}, 1.0).add({{"x","a"},{"y",1}}, 2.0)
+              .add({{"x","b"},{"y",0}}, 5.0).add({{"x","b"},{"y",1}}, 6.0)
+              .add({{"x","c"},{"y",0}}, 7.0).add({{"x","c"},{"y",1}}, 8.0));
+    auto mc = MixedTensor::from_tensor(*c);
+    EXPECT_EQ(a->join(Mul::f, *mc)->toSpec(),
+              TensorSpec("tensor(x{},y[2],z{})")
+              .add({{"x","a"},{"y",0},{"z","d"}}, 2.0).add({{"x","a"},{"y",1},{"z","d"}}, 4.0)
+              .add({{"x","b"},{"y",0},{"z","d"}}, 6.0).add({{"x","b"},{"y",1},{"z","d"}}, 8.0));
+    auto a2 = make_tensor_with_own_labels(a->toSpec());
+    EXPECT_TRUE(a->equals(*a2));
+    EXPECT_FALSE(a->equals(*b));
+}
+
+GTEST_MAIN_RUN_ALL_TESTS()
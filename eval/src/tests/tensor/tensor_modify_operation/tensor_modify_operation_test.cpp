@@ -4,6 +4,8 @@
 #include <vespa/eval/eval/tensor_spec.h>
 #include <vespa/eval/tensor/cell_values.h>
 #include <vespa/eval/tensor/default_tensor_engine.h>
+#include <vespa/eval/tensor/dense/dense_tensor.h>
+#include <vespa/eval/tensor/dense/dense_tensor_modify.h>
 #include <vespa/eval/tensor/sparse/sparse_tensor.h>
 #include <vespa/eval/tensor/test/test_utils.h>
 #include <vespa/vespalib/gtest/gtest.h>
@@ -108,4 +110,32 @@ TEST(TensorModifyTest, mixed_tensors_ignore_updates_to_missing_or_out_of_range_c
                         .add({{"x","a"},{"y",1}}, 3));
 }
 
+void
+checkInPlaceUpdate(const TensorSpec &source, const TensorSpec &update, const TensorSpec &expect)
+{
+    auto sourceTensor = makeTensor<Tensor>(source);
+    auto updateTensor = makeTensor<SparseTensor>(update);
+    const CellValues cellValues(*updateTensor);
+
+    auto &dense = dynamic_cast<const DenseTensorView &>(*sourceTensor);
+    void *cells = const_cast<void *>(dense.cellsRef().data);
+    modify_dense_cells_in_place(vespalib::eval::operation::Add::f, dense.fast_type(), cells, cellValues);
+    EXPECT_EQ(sourceTensor->toSpec(), makeTensor<Tensor>(expect)->toSpec());
+}
+
+TEST(TensorModifyTest, dense_tensor_cells_can_be_modified_in_place)
+{
+    for (const char *type: {"tensor(x[10],y[10])", "tensor<float>(x[10],y[10])"}) {
+        checkInPlaceUpdate(TensorSpec(type)
+                                   .add({{"x",8},{"y",9}}, 11)
+                                   .add({{"x",9},{"y",9}}, 11),
+                           TensorSpec("tensor(x{},y{})")
+                                   .add({{"x","8"},{"y","9"}}, 2)
+                                   .add({{"x","10"},{"y","9"}}, 2),
+                           TensorSpec(type)
+                                   .add({{"x",8},{"y",9}}, 13)
+                                   .add({{"x",9},{"y",9}}, 11));
+    }
+}
+
 GTEST_MAIN_RUN_ALL_TESTS()
@@ -2,11 +2,13 @@
 
 #include "fast_forest.h"
 #include "gbdt.h"
+#include "fast_forest_batch.h"
 #include <vespa/eval/eval/basic_nodes.h>
 #include <vespa/eval/eval/call_nodes.h>
 #include <vespa/eval/eval/operator_nodes.h>
 #include <vespa/vespalib/util/benchmark_timer.h>
 #include <algorithm>
+#include <limits>
 #include <cassert>
 #include <arpa/inet.h>
 
@@ -146,7 +148,9 @@ constexpr size_t max_leafs() { return (sizeof(T) * bits_per_byte); }
 template <typename T>
 struct FixedContext : FastForest::Context {
     std::vector<T> masks;
-    FixedContext(size_t num_trees) : masks(num_trees) {}
+    std::vector<T> batch_masks;
+    std::vector<float> batch_params;
+    FixedContext(size_t num_trees) : masks(num_trees), batch_masks(), batch_params() {}
 };
 
 template <typename T>
@@ -166,20 +170,8 @@ struct FixedForest : FastForest {
         return mask;
     }
 
-    struct Mask {
-        float value;
-        uint32_t tree;
-        T bits;
-        Mask(float v, uint32_t t, T b)
-            : value(v), tree(t), bits(b) {}
-    };
-
-    struct DMask {
-        uint32_t tree;
-        T bits;
-        DMask(uint32_t t, T b)
-            : tree(t), bits(b) {}
-    };
+    using Mask = ff_batch::Mask<T>;
+    using DMask = ff_batch::DMask<T>;
 
     std::vector<uint32_t> _mask_sizes;
     std::vector<Mask>     _masks;
@@ -196,10 +188,13 @@ struct FixedForest : FastForest {
     static void apply_masks(T *ctx_masks, const Mask *pos, const Mask *end, float limit);
     static void apply_masks(T *ctx_masks, const DMask *pos, const DMask *end);
     double get_result(const T *ctx_masks) const;
+    ff_batch::Forest<T> batch_forest() const;
 
     vespalib::string impl_name() const override { return fixed_impl_name<T>(); }
     Context::UP create_context() const override;
     double eval(Context &context, const float *params) const override;
+    void eval_batch(Context &context, const float *params, size_t stride,
+                    size_t num_docs, double *results) const override;
 };
 
 template <typename T>
@@ -335,13 +330,51 @@ FixedForest<T>::eval(Context &context, const float *params) const
     return get_result(ctx_masks);
 }
 
+template <typename T>
+ff_batch::Forest<T>
+FixedForest<T>::batch_forest() const
+{
+    return ff_batch::Forest<T>{&_mask_sizes[0], &_masks[0], &_default_offsets[0], _default_masks.data(),
+                               &_padded_leafs[0], uint32_t(_mask_sizes.size()), _num_trees, _max_leafs};
+}
+
+template <typename T>
+void
+FixedForest<T>::eval_batch(Context &context, const float *params, size_t stride,
+                           size_t num_docs, double *results) const
+{
+    const ff_batch::Kernels &kernels = ff_batch::get_kernels();
+    auto kernel = kernels.get<T>();
+    size_t lanes = kernels.lanes;
+    auto &ctx = static_cast<FixedContext<T>&>(context);
+    ctx.batch_masks.resize(_num_trees * lanes);
+    ff_batch::Forest<T> forest = batch_forest();
+    size_t doc = 0;
+    for (; (doc + lanes) <= num_docs; doc += lanes) {
+        kernel(forest, &ctx.batch_masks[0], params + doc, stride, results + doc);
+    }
+    if (doc < num_docs) {
+        // pad the last block with missing values
+        size_t num_params = _mask_sizes.size();
+        size_t left = (num_docs - doc);
+        ctx.batch_params.assign(num_params * lanes, std::numeric_limits<float>::quiet_NaN());
+        for (size_t p = 0; p < num_params; ++p) {
+            memcpy(&ctx.batch_params[p * lanes], params + (p * stride) + doc, left * sizeof(float));
+        }
+        double tail_results[ff_batch::max_lanes];
+        kernel(forest, &ctx.batch_masks[0], &ctx.batch_params[0], lanes, tail_results);
+        memcpy(results + doc, tail_results, left * sizeof(double));
+    }
+}
+
 //-----------------------------------------------------------------------------
 // implementation using multiple words for each tree
 //-----------------------------------------------------------------------------
 
 struct MultiWordContext : FastForest::Context {
     std::vector<uint32_t> words;
-    MultiWordContext(size_t size) : words(size) {}
+    std::vector<float> params;
+    MultiWordContext(size_t size, size_t num_params) : words(size), params(num_params) {}
 };
 
 struct MultiWordForest : FastForest {
@@ -440,6 +473,8 @@ struct MultiWordForest : FastForest {
     vespalib::string impl_name() const override { return "ff-multiword"; }
     Context::UP create_context() const override;
     double eval(Context &context, const float *params) const override;
+    void eval_batch(Context &context, const float *params, size_t stride,
+                    size_t num_docs, double *results) const override;
 };
 
 MultiWordForest::MultiWordForest(const State &state)
@@ -591,7 +626,7 @@ MultiWordForest::get_result(const uint32_t *ctx_words) const
 FastForest::Context::UP
 MultiWordForest::create_context() const
 {
-    return std::make_unique<MultiWordContext>(_words_per_tree * _tree_offsets.size());
+    return std::make_unique<MultiWordContext>(_words_per_tree * _tree_offsets.size(), _mask_sizes.size());
 }
 
 double
@@ -620,6 +655,20 @@ MultiWordForest::eval(Context &context, const float *params) const
     return get_result(ctx_words);
 }
 
+void
+MultiWordForest::eval_batch(Context &context, const float *params, size_t stride,
+                            size_t num_docs, double *results) const
+{
+    // large trees; evaluate one document at a time
+    std::vector<float> &row = static_cast<MultiWordContext&>(context).params;
+    for (size_t doc = 0; doc < num_docs; ++doc) {
+        for (size_t p = 0; p < row.size(); ++p) {
+            row[p] = params[(p * stride) + doc];
+        }
+        results[doc] = eval(context, &row[0]);
+    }
+}
+
 }
 
 //-----------------------------------------------------------------------------
@@ -669,4 +718,19 @@ FastForest::estimate_cost_us(const std::vector<double> &params, double budget) c
     return BenchmarkTimer::benchmark([&](){ eval(*ctx, &my_params[0]); }, budget) * 1000.0 * 1000.0;
 }
 
+double
+FastForest::estimate_batch_cost_us(const std::vector<double> &params, size_t num_docs, double budget) const
+{
+    auto ctx = create_context();
+    std::vector<float> my_params;
+    for (double param: params) {
+        for (size_t i = 0; i < num_docs; ++i) {
+            my_params.push_back(param);
+        }
+    }
+    std::vector<double> results(num_docs);
+    double us = BenchmarkTimer::benchmark([&](){ eval_batch(*ctx, &my_params[0], num_docs, num_docs, &results[0]); }, budget) * 1000.0 * 1000.0;
+    return (us / num_docs);
+}
+
 }
@@ -36,7 +36,15 @@ public:
     virtual vespalib::string impl_name() const = 0;
     virtual Context::UP create_context() const = 0;
     virtual double eval(Context &context, const float *params) const = 0;
+    // Evaluate the forest for 'num_docs' documents in one go. The
+    // value of parameter 'p' for document 'd' is params[p * stride + d]
+    // (stride >= num_docs). Forests with small trees compare all
+    // documents against each threshold with simd instructions.
+    virtual void eval_batch(Context &context, const float *params, size_t stride,
+                            size_t num_docs, double *results) const = 0;
     double estimate_cost_us(const std::vector<double> &params, double budget = 5.0) const;
+    // estimated cost per document when evaluating 'num_docs' copies of params in a batch
+    double estimate_batch_cost_us(const std::vector<double> &params, size_t num_docs, double budget = 5.0) const;
 };
 
 }
@@ -0,0 +1,35 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "fast_forest_batch.hpp"
+
+namespace vespalib::eval::gbdt::ff_batch {
+
+namespace {
+
+const Kernels &select_kernels() {
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw")) {
+        return avx512_kernels();
+    } else if (__builtin_cpu_supports("avx2")) {
+        return avx2_kernels();
+    }
+    return generic_kernels();
+}
+
+}
+
+const Kernels &
+generic_kernels()
+{
+    static Kernels kernels = make_kernels<8>("generic");
+    return kernels;
+}
+
+const Kernels &
+get_kernels()
+{
+    static const Kernels &kernels = select_kernels();
+    return kernels;
+}
+
+}
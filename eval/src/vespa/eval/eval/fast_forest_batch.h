@@ -0,0 +1,81 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace vespalib::eval::gbdt::ff_batch {
+
+/**
+ * Low-level building blocks used to evaluate a FastForest with fixed
+ * size (single word) leaf masks for a block of documents at once.
+ *
+ * Each tree has one mask word per document (lane). Threshold
+ * comparisons are done for all lanes in one vector operation, and
+ * the resulting lane mask selects which lanes the tree mask is
+ * applied to. The kernels are compiled once per supported
+ * instruction set, and the best variant for the current cpu is
+ * selected at runtime.
+ **/
+
+template <typename T>
+struct Mask {
+    float value;
+    uint32_t tree;
+    T bits;
+    Mask(float v, uint32_t t, T b) : value(v), tree(t), bits(b) {}
+};
+
+template <typename T>
+struct DMask {
+    uint32_t tree;
+    T bits;
+    DMask(uint32_t t, T b) : tree(t), bits(b) {}
+};
+
+// flat view of a forest; see FixedForest in fast_forest.cpp
+template <typename T>
+struct Forest {
+    const uint32_t *mask_sizes;      // [num_params]
+    const Mask<T>  *masks;           // sorted on value for each param
+    const uint32_t *default_offsets; // [num_params + 1]
+    const DMask<T> *default_masks;
+    const float    *leafs;           // [num_trees * max_leafs]
+    uint32_t        num_params;
+    uint32_t        num_trees;
+    uint32_t        max_leafs;
+};
+
+// Evaluate a block of 'lanes' documents. The value of parameter 'p'
+// for lane 'i' is params[p * stride + i]. 'ctx' must have room for
+// (num_trees * lanes) masks.
+template <typename T>
+using kernel_t = void (*)(const Forest<T> &forest, T *ctx, const float *params, size_t stride, double *results);
+
+struct Kernels {
+    const char       *name;
+    size_t            lanes;
+    kernel_t<uint8_t>  eval_8;
+    kernel_t<uint16_t> eval_16;
+    kernel_t<uint32_t> eval_32;
+    kernel_t<uint64_t> eval_64;
+    template <typename T> kernel_t<T> get() const;
+};
+
+template <> inline kernel_t<uint8_t> Kernels::get<uint8_t>() const { return eval_8; }
+template <> inline kernel_t<uint16_t> Kernels::get<uint16_t>() const { return eval_16; }
+template <> inline kernel_t<uint32_t> Kernels::get<uint32_t>() const { return eval_32; }
+template <> inline kernel_t<uint64_t> Kernels::get<uint64_t>() const { return eval_64; }
+
+// the largest number of lanes used by any kernel
+constexpr size_t max_lanes = 16;
+
+const Kernels &generic_kernels();
+const Kernels &avx2_kernels();
+const Kernels &avx512_kernels();
+
+// kernels selected for the current cpu
+const Kernels &get_kernels();
+
+}
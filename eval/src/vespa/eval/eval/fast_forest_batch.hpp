@@ -0,0 +1,98 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+// Kernel implementation shared by the instruction set specific
+// translation units. Everything is kept in an anonymous namespace to
+// avoid mixing code compiled for different targets at link time.
+
+#include "fast_forest_batch.h"
+#include <cstring>
+
+namespace vespalib::eval::gbdt::ff_batch {
+
+namespace {
+
+template <typename T> size_t lsb_idx(T value) { return __builtin_ctz(uint32_t(value)); }
+template <> size_t lsb_idx<uint64_t>(uint64_t value) { return __builtin_ctzll(value); }
+
+// vector of N elements of type E (with element alignment)
+template <typename E, size_t N>
+struct Vec {
+    typedef E type __attribute__((vector_size(N * sizeof(E)), aligned(sizeof(E))));
+};
+
+template <typename T, size_t L>
+void eval_block(const Forest<T> &forest, T *ctx, const float *params, size_t stride, double *results)
+{
+    using FV = typename Vec<float, L>::type;
+    using TV = typename Vec<T, L>::type;
+    TV *ctx_masks = reinterpret_cast<TV *>(ctx);
+    memset(ctx, 0xff, forest.num_trees * L * sizeof(T));
+    const Mask<T> *mask_pos = forest.masks;
+    for (uint32_t p = 0; p < forest.num_params; ++p) {
+        FV value;
+        memcpy(&value, params + (p * stride), sizeof(value));
+        float limit = -__builtin_inff();
+        bool has_nan = false;
+        for (size_t i = 0; i < L; ++i) {
+            if (value[i] != value[i]) {
+                has_nan = true;
+            } else if (value[i] > limit) {
+                limit = value[i];
+            }
+        }
+        const Mask<T> *mask_end = mask_pos + forest.mask_sizes[p];
+        for (const Mask<T> *pos = mask_pos; (pos < mask_end) && !(limit < pos->value); ++pos) {
+            TV skip = ~__builtin_convertvector(value >= pos->value, TV);
+            ctx_masks[pos->tree] &= (skip | pos->bits);
+        }
+        if (has_nan) {
+            TV skip = ~__builtin_convertvector(value != value, TV);
+            const DMask<T> *end = forest.default_masks + forest.default_offsets[p + 1];
+            for (const DMask<T> *pos = forest.default_masks + forest.default_offsets[p]; pos < end; ++pos) {
+                ctx_masks[pos->tree] &= (skip | pos->bits);
+            }
+        }
+        mask_pos = mask_end;
+    }
+    // same summation order as single document evaluation
+    double result1[L];
+    double result2[L];
+    for (size_t i = 0; i < L; ++i) {
+        result1[i] = 0.0;
+        result2[i] = 0.0;
+    }
+    const T *tree_masks = ctx;
+    const float *leafs = forest.leafs;
+    uint32_t leaf_cnt = forest.max_leafs;
+    uint32_t paired_trees = (forest.num_trees & ~uint32_t(3));
+    uint32_t tree = 0;
+    for (; tree < paired_trees; tree += 2, tree_masks += (2 * L), leafs += (2 * leaf_cnt)) {
+        for (size_t i = 0; i < L; ++i) {
+            result1[i] += leafs[lsb_idx(tree_masks[i])];
+            result2[i] += leafs[leaf_cnt + lsb_idx(tree_masks[L + i])];
+        }
+    }
+    for (; tree < forest.num_trees; ++tree, tree_masks += L, leafs += leaf_cnt) {
+        for (size_t i = 0; i < L; ++i) {
+            result1[i] += leafs[lsb_idx(tree_masks[i])];
+        }
+    }
+    for (size_t i = 0; i < L; ++i) {
+        results[i] = (result1[i] + result2[i]);
+    }
+}
+
+template <size_t L>
+Kernels make_kernels(const char *name) {
+    return Kernels{name, L,
+                   eval_block<uint8_t, L>,
+                   eval_block<uint16_t, L>,
+                   eval_block<uint32_t, L>,
+                   eval_block<uint64_t, L>};
+}
+
+}
+
+}
@@ -0,0 +1,14 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "fast_forest_batch.hpp"
+
+namespace vespalib::eval::gbdt::ff_batch {
+
+const Kernels &
+avx512_kernels()
+{
+    static Kernels kernels = make_kernels<16>("avx512");
+    return kernels;
+}
+
+}
@@ -3,6 +3,7 @@
 #pragma once
 
 #include "operation.h"
+#include "value_type.h"
 #include <vespa/vespalib/util/typify.h>
 #include <cmath>
 
@@ -122,24 +123,32 @@ struct TypifyOp2 {
 
 //-----------------------------------------------------------------------------
 
-template <typename A, typename OP1>
-void apply_op1_vec(A *dst, const A *src, size_t n, OP1 &&f) {
+// narrow cell types (int8, bfloat16) are promoted before the
+// operation is applied, to avoid integer arithmetic on int8 cells
+
+template <typename D, typename A, typename OP1>
+void apply_op1_vec(D *dst, const A *src, size_t n, OP1 &&f) {
+    using PA = typename DecayCellType<A>::type;
     for (size_t i = 0; i < n; ++i) {
-        dst[i] = f(src[i]);
+        dst[i] = f(PA(src[i]));
     }
 }
 
 template <typename D, typename A, typename B, typename OP2>
 void apply_op2_vec_num(D *dst, const A *a, B b, size_t n, OP2 &&f) {
+    using PA = typename DecayCellType<A>::type;
+    using PB = typename DecayCellType<B>::type;
     for (size_t i = 0; i < n; ++i) {
-        dst[i] = f(a[i], b);
+        dst[i] = f(PA(a[i]), PB(b));
     }
 }
 
 template <typename D, typename A, typename B, typename OP2>
 void apply_op2_vec_vec(D *dst, const A *a, const B *b, size_t n, OP2 &&f) {
+    using PA = typename DecayCellType<A>::type;
+    using PB = typename DecayCellType<B>::type;
     for (size_t i = 0; i < n; ++i) {
-        dst[i] = f(a[i], b[i]);
+        dst[i] = f(PA(a[i]), PB(b[i]));
     }
 }
 
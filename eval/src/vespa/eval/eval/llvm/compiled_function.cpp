@@ -26,6 +26,7 @@ double empty_function_4(double, double, double, double) { return 0.0; }
 double empty_function_5(double, double, double, double, double) { return 0.0; }
 double empty_array_function(const double *) { return 0.0; }
 double empty_lazy_function(CompiledFunction::resolve_function, void *) { return 0.0; }
+void empty_batch_function(const double * const *, double *, size_t) {}
 
 double my_resolve(void *ctx, size_t idx) { return ((double *)ctx)[idx]; }
 
@@ -73,6 +74,18 @@ CompiledFunction::estimate_cost_us(const std::vector<double> &params, double bud
         auto baseline = [&](){empty(my_resolve, const_cast<double*>(&params[0]));};
         return BenchmarkTimer::benchmark(actual, baseline, budget) * 1000.0 * 1000.0;
     }
+    if (_pass_params == PassParams::BATCH) {
+        auto function = get_batch_function();
+        auto empty = empty_batch_function;
+        std::vector<const double *> columns;
+        for (const double &param: params) {
+            columns.push_back(&param);
+        }
+        double result = 0.0;
+        auto actual = [&](){function(columns.data(), &result, 1);};
+        auto baseline = [&](){empty(columns.data(), &result, 1);};
+        return BenchmarkTimer::benchmark(actual, baseline, budget) * 1000.0 * 1000.0;
+    }
     assert(_pass_params == PassParams::SEPARATE);
     if (params.size() == 0) {
         auto function = get_function<0>();
@@ -30,6 +30,11 @@ public:
     using resolve_function = LazyParams::resolve_function;
     using lazy_function = double (*)(resolve_function, void *ctx);
 
+    // evaluate the function for 'n' parameter sets in one go;
+    // columns[p][i] is the value of parameter 'p' for set 'i' and
+    // the result for set 'i' is stored in results[i]
+    using batch_function = void (*)(const double * const *columns, double *results, size_t n);
+
 private:
     LLVMWrapper _llvm_wrapper;
     void       *_address;
@@ -63,6 +68,10 @@ public:
         assert(_pass_params == PassParams::LAZY);
         return ((lazy_function)_address);
     }
+    batch_function get_batch_function() const {
+        assert(_pass_params == PassParams::BATCH);
+        return ((batch_function)_address);
+    }
     const std::vector<gbdt::Forest::UP> &get_forests() const {
         return _llvm_wrapper.get_forests();
     }
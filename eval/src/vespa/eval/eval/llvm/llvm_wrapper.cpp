@@ -21,6 +21,10 @@
 #undef NDEBUG
 #endif
 #include <llvm/Transforms/IPO/PassManagerBuilder.h>
+#include <llvm/IR/LegacyPassManager.h>
+#include <llvm/Analysis/TargetTransformInfo.h>
+#include <llvm/Target/TargetMachine.h>
+#include <llvm/Support/Host.h>
 #if LLVM_VERSION_MAJOR > 9
 #include <llvm/Support/ManagedStatic.h>
 #endif
@@ -85,7 +89,10 @@ struct FunctionBuilder : public NodeVisitor, public NodeTraverser {
     llvm::IRBuilder<>         builder;
     std::vector<llvm::Value*> params;
     std::vector<llvm::Value*> values;
+    std::vector<llvm::Value*> columns;
     llvm::Function           *function;
+    llvm::BasicBlock         *loop_block;
+    llvm::PHINode            *loop_idx;
     size_t                    num_params;
     PassParams                pass_params;
     bool                      inside_forest;
@@ -155,7 +162,10 @@ struct FunctionBuilder : public NodeVisitor, public NodeTraverser {
           builder(context),
           params(),
           values(),
+          columns(num_params_in, nullptr),
           function(nullptr),
+          loop_block(nullptr),
+          loop_idx(nullptr),
           num_params(num_params_in),
           pass_params(pass_params_in),
           inside_forest(false),
@@ -165,16 +175,22 @@ struct FunctionBuilder : public NodeVisitor, public NodeTraverser {
           plugin_state(plugin_state_out)
     {
         std::vector<llvm::Type*> param_types;
+        llvm::Type *result_type = builder.getDoubleTy();
         if (pass_params == PassParams::SEPARATE) {
             param_types.resize(num_params_in, builder.getDoubleTy());
         } else if (pass_params == PassParams::ARRAY) {
             param_types.push_back(builder.getDoubleTy()->getPointerTo());
-        } else {
-            assert(pass_params == PassParams::LAZY);
+        } else if (pass_params == PassParams::LAZY) {
             param_types.push_back(make_resolve_param_funptr_t());
             param_types.push_back(builder.getVoidTy()->getPointerTo());
+        } else {
+            assert(pass_params == PassParams::BATCH);
+            param_types.push_back(builder.getDoubleTy()->getPointerTo()->getPointerTo());
+            param_types.push_back(builder.getDoubleTy()->getPointerTo());
+            param_types.push_back(builder.getInt64Ty());
+            result_type = builder.getVoidTy();
         }
-        llvm::FunctionType *function_type = llvm::FunctionType::get(builder.getDoubleTy(), param_types, false);
+        llvm::FunctionType *function_type = llvm::FunctionType::get(result_type, param_types, false);
         function = llvm::Function::Create(function_type, llvm::Function::ExternalLinkage, name_in.c_str(), &module);
         function->addFnAttr(llvm::Attribute::AttrKind::NoInline);
         llvm::BasicBlock *block = llvm::BasicBlock::Create(context, "entry", function);
@@ -182,11 +198,49 @@ struct FunctionBuilder : public NodeVisitor, public NodeTraverser {
         for (llvm::Function::arg_iterator itr = function->arg_begin(); itr != function->arg_end(); ++itr) {
             params.push_back(&(*itr));
         }
+        if (pass_params == PassParams::BATCH) {
+            open_loop();
+        }
     }
     ~FunctionBuilder();
 
     //-------------------------------------------------------------------------
 
+    // batch functions evaluate the expression for 'n' documents in
+    // a single loop: void f(const double * const *columns, double *results, size_t n)
+    void open_loop() {
+        llvm::BasicBlock *entry_block = builder.GetInsertBlock();
+        loop_block = llvm::BasicBlock::Create(context, "loop_block", function);
+        llvm::BasicBlock *done_block = llvm::BasicBlock::Create(context, "done_block", function);
+        builder.CreateCondBr(builder.CreateICmpEQ(params[2], builder.getInt64(0), "is_empty"), done_block, loop_block);
+        builder.SetInsertPoint(done_block);
+        builder.CreateRetVoid();
+        builder.SetInsertPoint(loop_block);
+        loop_idx = builder.CreatePHI(builder.getInt64Ty(), 2, "loop_idx");
+        loop_idx->addIncoming(builder.getInt64(0), entry_block);
+    }
+
+    void close_loop(llvm::Value *result) {
+        llvm::Value *addr = builder.CreateGEP(params[1], loop_idx);
+        builder.CreateStore(result, addr);
+        llvm::Value *next_idx = builder.CreateAdd(loop_idx, builder.getInt64(1), "next_idx");
+        loop_idx->addIncoming(next_idx, builder.GetInsertBlock());
+        llvm::BasicBlock *exit_block = llvm::BasicBlock::Create(context, "exit_block", function);
+        builder.CreateCondBr(builder.CreateICmpULT(next_idx, params[2], "has_next"), loop_block, exit_block);
+        builder.SetInsertPoint(exit_block);
+        builder.CreateRetVoid();
+    }
+
+    // column pointers are loaded once in the entry block
+    llvm::Value *get_column(size_t idx) {
+        if (columns[idx] == nullptr) {
+            llvm::IRBuilder<> entry_builder(function->getEntryBlock().getTerminator());
+            llvm::Value *addr = entry_builder.CreateGEP(params[0], entry_builder.getInt64(idx));
+            columns[idx] = entry_builder.CreateLoad(addr, "column");
+        }
+        return columns[idx];
+    }
+
     llvm::Value *get_param(size_t idx) {
         assert(idx < num_params);
         if (pass_params == PassParams::SEPARATE) {
@@ -197,6 +251,10 @@ struct FunctionBuilder : public NodeVisitor, public NodeTraverser {
             llvm::Value *param_array = params[0];
             llvm::Value *addr = builder.CreateGEP(param_array, builder.getInt64(idx));
             return builder.CreateLoad(addr);
+        } else if (pass_params == PassParams::BATCH) {
+            assert(params.size() == 3);
+            llvm::Value *addr = builder.CreateGEP(get_column(idx), loop_idx);
+            return builder.CreateLoad(addr);
         }
         assert(pass_params == PassParams::LAZY);
         assert(params.size() == 2);
@@ -272,7 +330,7 @@ struct FunctionBuilder : public NodeVisitor, public NodeTraverser {
             push_double(node.get_const_value());
             return false;
         }
-        if (!inside_forest && (pass_params != PassParams::SEPARATE) && node.is_forest()) {
+        if (!inside_forest && (pass_params != PassParams::SEPARATE) && (pass_params != PassParams::BATCH) && node.is_forest()) {
             if (try_optimize_forest(node)) {
                 return false;
             }
@@ -316,7 +374,11 @@ struct FunctionBuilder : public NodeVisitor, public NodeTraverser {
     }
 
     llvm::Function *build() {
-        builder.CreateRet(pop_double());
+        if (pass_params == PassParams::BATCH) {
+            close_loop(pop_double());
+        } else {
+            builder.CreateRet(pop_double());
+        }
         assert(values.empty());
         llvm::verifyFunction(*function);
         return function;
@@ -681,7 +743,8 @@ LLVMWrapper::LLVMWrapper()
       _engine(),
       _functions(),
       _forests(),
-      _plugin_state()
+      _plugin_state(),
+      _vectorize(false)
 {
     _context = std::make_unique<llvm::LLVMContext>();
     _module = std::make_unique<llvm::Module>("LLVMWrapper", *_context);
@@ -698,6 +761,9 @@ LLVMWrapper::make_function(size_t num_params, PassParams pass_params, const Node
                             forest_optimizers, _forests, _plugin_state);
     builder.build_root(root);
     _functions.push_back(builder.build());
+    if (pass_params == PassParams::BATCH) {
+        _vectorize = true;
+    }
     return function_id;
 }
 
@@ -714,13 +780,45 @@ LLVMWrapper::make_forest_fragment(size_t num_params, const std::vector<const Nod
     return function_id;
 }
 
+void
+LLVMWrapper::optimize(llvm::TargetMachine &target)
+{
+    _module->setDataLayout(target.createDataLayout());
+    _module->setTargetTriple(target.getTargetTriple().str());
+    llvm::legacy::FunctionPassManager function_passes(_module.get());
+    llvm::legacy::PassManager module_passes;
+    function_passes.add(llvm::createTargetTransformInfoWrapperPass(target.getTargetIRAnalysis()));
+    module_passes.add(llvm::createTargetTransformInfoWrapperPass(target.getTargetIRAnalysis()));
+    llvm::PassManagerBuilder pass_builder;
+    pass_builder.OptLevel = 3;
+    pass_builder.LoopVectorize = true;
+    pass_builder.SLPVectorize = true;
+    pass_builder.populateFunctionPassManager(function_passes);
+    pass_builder.populateModulePassManager(module_passes);
+    function_passes.doInitialization();
+    for (llvm::Function &function: *_module) {
+        function_passes.run(function);
+    }
+    function_passes.doFinalization();
+    module_passes.run(*_module);
+}
+
 void
 LLVMWrapper::compile(llvm::raw_ostream * dumpStream)
 {
     if (dumpStream) {
         _module->print(*dumpStream, nullptr);
     }
-    _engine.reset(llvm::EngineBuilder(std::move(_module)).setOptLevel(llvm::CodeGenOpt::Aggressive).create());
+    if (_vectorize) {
+        // batch functions contain a loop over documents that we want
+        // the IR optimizer to vectorize for the host cpu
+        std::unique_ptr<llvm::TargetMachine> target(llvm::EngineBuilder().setMCPU(llvm::sys::getHostCPUName()).selectTarget());
+        assert(target && "llvm target not available for your platform");
+        optimize(*target);
+        _engine.reset(llvm::EngineBuilder(std::move(_module)).setOptLevel(llvm::CodeGenOpt::Aggressive).create(target.release()));
+    } else {
+        _engine.reset(llvm::EngineBuilder(std::move(_module)).setOptLevel(llvm::CodeGenOpt::Aggressive).create());
+    }
     assert(_engine && "llvm jit not available for your platform");
     _engine->finalizeObject();
 }
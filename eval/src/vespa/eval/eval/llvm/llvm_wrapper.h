@@ -10,6 +10,8 @@
 #include <llvm/ExecutionEngine/ExecutionEngine.h>
 #include <mutex>
 
+namespace llvm { class TargetMachine; }
+
 extern "C" {
     double vespalib_eval_ldexp(double a, double b);
     double vespalib_eval_min(double a, double b);
@@ -48,7 +50,9 @@ private:
     std::vector<llvm::Function*>           _functions;
     std::vector<gbdt::Forest::UP>          _forests;
     std::vector<PluginState::UP>           _plugin_state;
+    bool                                   _vectorize;
 
+    void optimize(llvm::TargetMachine &target);
     void compile(llvm::raw_ostream * dumpStream);
 public:
     LLVMWrapper();
@@ -0,0 +1,178 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "split_interpreted_function.h"
+#include "make_tensor_function.h"
+#include "tensor_engine.h"
+#include "tensor_function.h"
+#include "tensor.h"
+#include <vespa/vespalib/objects/nbostream.h>
+#include <algorithm>
+#include <map>
+#include <set>
+
+namespace vespalib::eval {
+
+using tensor_function::Inject;
+using tensor_function::Lambda;
+
+namespace {
+
+using Child = TensorFunction::Child;
+
+// parameter dependencies of a (sub-)expression; ordered by strength
+enum class Dep { NONE, QUERY, DOC };
+
+void push_params(const TensorFunction &node, std::vector<size_t> &params) {
+    if (auto inject = as<Inject>(node)) {
+        params.push_back(inject->param_idx());
+    } else if (auto lambda = as<Lambda>(node)) {
+        params.insert(params.end(), lambda->bindings().begin(), lambda->bindings().end());
+    }
+}
+
+struct Splitter {
+    const TensorEngine &engine;
+    const std::vector<bool> &is_query_level;
+    size_t num_params;
+    Stash &stash;
+    std::vector<InterpretedFunction::UP> &subexprs;
+    std::set<size_t> query_level_params;
+    std::map<const TensorFunction *, Dep> deps;
+
+    Splitter(const TensorEngine &engine_in, const std::vector<bool> &is_query_level_in,
+             size_t num_params_in, Stash &stash_in, std::vector<InterpretedFunction::UP> &subexprs_out)
+        : engine(engine_in), is_query_level(is_query_level_in), num_params(num_params_in),
+          stash(stash_in), subexprs(subexprs_out), query_level_params(), deps() {}
+
+    Dep find_dep(const TensorFunction &node) {
+        auto pos = deps.find(&node);
+        if (pos != deps.end()) {
+            return pos->second;
+        }
+        Dep dep = Dep::NONE;
+        std::vector<size_t> params;
+        push_params(node, params);
+        for (size_t param: params) {
+            bool query_level = (param < is_query_level.size()) && is_query_level[param];
+            dep = std::max(dep, query_level ? Dep::QUERY : Dep::DOC);
+        }
+        std::vector<Child::CREF> children;
+        node.push_children(children);
+        for (const Child &child: children) {
+            dep = std::max(dep, find_dep(child.get()));
+        }
+        deps[&node] = dep;
+        return dep;
+    }
+
+    void collect_params(const TensorFunction &node) {
+        std::vector<size_t> params;
+        push_params(node, params);
+        query_level_params.insert(params.begin(), params.end());
+        std::vector<Child::CREF> children;
+        node.push_children(children);
+        for (const Child &child: children) {
+            collect_params(child.get());
+        }
+    }
+
+    void split(const Child &child) {
+        const TensorFunction &node = child.get();
+        if ((find_dep(node) == Dep::QUERY) && !as<Inject>(node)) {
+            collect_params(node);
+            size_t param_idx = num_params + subexprs.size();
+            subexprs.push_back(std::make_unique<InterpretedFunction>(engine, engine.optimize(node, stash)));
+            child.set(tensor_function::inject(node.result_type(), param_idx, stash));
+            return;
+        }
+        std::vector<Child::CREF> children;
+        node.push_children(children);
+        for (const Child &grand_child: children) {
+            split(grand_child);
+        }
+    }
+};
+
+} // namespace vespalib::eval::<unnamed>
+
+SplitInterpretedFunction::Results::Results(const SplitInterpretedFunction &function)
+    : _function(function),
+      _lock(),
+      _cond(),
+      _next(0),
+      _done(0),
+      _ready(function.num_subexprs() == 0),
+      _error(),
+      _values(function.num_subexprs())
+{
+}
+
+SplitInterpretedFunction::Results::~Results() = default;
+
+void
+SplitInterpretedFunction::Results::resolve(const LazyParams &params)
+{
+    std::unique_lock guard(_lock);
+    while (!_error && (_next < _values.size())) {
+        size_t idx = _next++;
+        guard.unlock();
+        Value::UP value;
+        std::exception_ptr error;
+        try {
+            value = _function.eval_subexpr(idx, params);
+        } catch (...) {
+            error = std::current_exception();
+        }
+        guard.lock();
+        _values[idx] = std::move(value);
+        if (error && !_error) {
+            _error = error;
+            _cond.notify_all();
+        }
+        if ((++_done == _values.size()) && !_error) {
+            _ready.store(true, std::memory_order_release);
+            _cond.notify_all();
+        }
+    }
+    while (!_error && (_done < _values.size())) {
+        _cond.wait(guard);
+    }
+    if (_error) {
+        std::rethrow_exception(_error);
+    }
+}
+
+SplitInterpretedFunction::SplitInterpretedFunction(const TensorEngine &engine, const Function &function,
+                                                   const NodeTypes &types, const std::vector<bool> &is_query_level)
+    : _engine(engine),
+      _stash(),
+      _num_params(function.num_params()),
+      _subexprs(),
+      _query_level_params(),
+      _main()
+{
+    Child root(make_tensor_function(engine, function.root(), types, _stash));
+    Splitter splitter(engine, is_query_level, _num_params, _stash, _subexprs);
+    splitter.split(root);
+    _query_level_params.assign(splitter.query_level_params.begin(), splitter.query_level_params.end());
+    _main = std::make_unique<InterpretedFunction>(engine, engine.optimize(root.get(), _stash));
+}
+
+SplitInterpretedFunction::~SplitInterpretedFunction() = default;
+
+Value::UP
+SplitInterpretedFunction::eval_subexpr(size_t idx, const LazyParams &params) const
+{
+    const InterpretedFunction &fun = *_subexprs[idx];
+    InterpretedFunction::Context ctx(fun);
+    const Value &result = fun.eval(ctx, params);
+    if (auto tensor = result.as_tensor()) {
+        // the result may refer to parameter values or to the context
+        nbostream data;
+        tensor->engine().encode(*tensor, data);
+        return _engine.decode(data);
+    }
+    return std::make_unique<DoubleValue>(result.as_double());
+}
+
+} // namespace vespalib::eval
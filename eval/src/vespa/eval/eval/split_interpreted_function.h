@@ -0,0 +1,97 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include "interpreted_function.h"
+#include <vespa/vespalib/util/stash.h>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+
+namespace vespalib::eval {
+
+/**
+ * An interpreted function split into query-level subexpressions and
+ * a main function. A query-level subexpression only depends on
+ * parameters flagged as query-level (values that are the same for
+ * all documents evaluated for a query). The main function takes the
+ * results of the query-level subexpressions as extra parameters
+ * (appended after the parameters of the original function). This
+ * enables the query-level subexpressions to be evaluated once per
+ * query and shared by everyone evaluating the main function.
+ **/
+class SplitInterpretedFunction
+{
+public:
+    /**
+     * Results of the query-level subexpressions. Evaluation may be
+     * shared by several threads calling resolve; each thread will
+     * evaluate the subexpressions not already claimed by someone
+     * else and then wait for the remaining results to become
+     * available. All threads must supply parameters with equal
+     * values for the query-level parameters. The results are copied
+     * into values owned by this object, making them independent of
+     * the parameters used to calculate them. If evaluating a
+     * subexpression fails, no more subexpressions are evaluated and
+     * the exception is rethrown by resolve in every thread, also in
+     * later calls.
+     **/
+    class Results {
+    private:
+        const SplitInterpretedFunction &_function;
+        std::mutex                      _lock;
+        std::condition_variable         _cond;
+        size_t                          _next;
+        size_t                          _done;
+        std::atomic<bool>               _ready;
+        std::exception_ptr              _error;
+        std::vector<Value::UP>          _values;
+    public:
+        explicit Results(const SplitInterpretedFunction &function);
+        ~Results();
+        const SplitInterpretedFunction &function() const { return _function; }
+        bool ready() const { return _ready.load(std::memory_order_acquire); }
+        void resolve(const LazyParams &params);
+        const Value &get(size_t idx) const { return *_values[idx]; }
+    };
+
+private:
+    // parameters for the main function
+    struct MainParams : LazyParams {
+        const LazyParams &params;
+        size_t num_params;
+        const Results &results;
+        MainParams(const LazyParams &params_in, size_t num_params_in, const Results &results_in)
+            : params(params_in), num_params(num_params_in), results(results_in) {}
+        const Value &resolve(size_t idx, Stash &stash) const override {
+            return (idx < num_params) ? params.resolve(idx, stash) : results.get(idx - num_params);
+        }
+    };
+
+    const TensorEngine                 &_engine;
+    Stash                               _stash;
+    size_t                              _num_params;
+    std::vector<InterpretedFunction::UP> _subexprs;
+    std::vector<size_t>                 _query_level_params;
+    InterpretedFunction::UP             _main;
+
+public:
+    using UP = std::unique_ptr<SplitInterpretedFunction>;
+    SplitInterpretedFunction(const TensorEngine &engine, const Function &function, const NodeTypes &types,
+                             const std::vector<bool> &is_query_level);
+    ~SplitInterpretedFunction();
+    size_t num_params() const { return _num_params; }
+    size_t num_subexprs() const { return _subexprs.size(); }
+    const InterpretedFunction &subexpr(size_t idx) const { return *_subexprs[idx]; }
+    const InterpretedFunction &main() const { return *_main; }
+    // sorted list of parameters used by query-level subexpressions
+    const std::vector<size_t> &query_level_params() const { return _query_level_params; }
+    Value::UP eval_subexpr(size_t idx, const LazyParams &params) const;
+    const Value &eval(InterpretedFunction::Context &ctx, const LazyParams &params, const Results &results) const {
+        MainParams main_params(params, _num_params, results);
+        return _main->eval(ctx, main_params);
+    }
+};
+
+} // namespace vespalib::eval
@@ -559,7 +559,7 @@ const TensorFunction &reduce(const TensorFunction &child, Aggr aggr, const std::
 }
 
 const TensorFunction &map(const TensorFunction &child, map_fun_t function, Stash &stash) {
-    ValueType result_type = child.result_type();
+    ValueType result_type = child.result_type().map();
     return stash.create<Map>(result_type, child, function);
 }
 
@@ -591,7 +591,7 @@ const TensorFunction &peek(const TensorFunction &param, const std::map<vespalib:
     for (const auto &dim_spec: spec) {
         dimensions.push_back(dim_spec.first);
     }
-    ValueType result_type = param.result_type().reduce(dimensions);
+    ValueType result_type = param.result_type().peek(dimensions);
     return stash.create<Peek>(result_type, param, spec);
 }
 
@@ -12,27 +12,14 @@ using CellType = ValueType::CellType;
 using Dimension = ValueType::Dimension;
 using DimensionList = std::vector<Dimension>;
 
-template <typename A, typename B>
-CellType unify() {
-    using type = typename UnifyCellTypes<A,B>::type;
-    return get_cell_type<type>();
-}
-
-template <typename A>
-CellType unify(CellType b) {
-    switch (b) {
-    case CellType::DOUBLE: return unify<A,double>();
-    case CellType::FLOAT: return unify<A,float>();
-    }
-    abort();
-}
-
 CellType unify(CellType a, CellType b) {
-    switch (a) {
-    case CellType::DOUBLE: return unify<double>(b);
-    case CellType::FLOAT: return unify<float>(b);
+    if (a == b) {
+        return a;
+    } else if ((a == CellType::DOUBLE) || (b == CellType::DOUBLE)) {
+        return CellType::DOUBLE;
+    } else {
+        return CellType::FLOAT;
     }
-    abort();
 }
 
 size_t my_dimension_index(const std::vector<Dimension> &list, const vespalib::string &name) {
@@ -223,8 +210,27 @@ ValueType::dimension_names() const
     return result;
 }
 
+ValueType
+ValueType::map() const
+{
+    if (is_tensor()) {
+        return ValueType(Type::TENSOR, decay_cell_type(_cell_type), std::vector<Dimension>(_dimensions));
+    }
+    return *this;
+}
+
 ValueType
 ValueType::reduce(const std::vector<vespalib::string> &dimensions_in) const
+{
+    ValueType result = peek(dimensions_in);
+    if (result.is_tensor()) {
+        result._cell_type = decay_cell_type(result._cell_type);
+    }
+    return result;
+}
+
+ValueType
+ValueType::peek(const std::vector<vespalib::string> &dimensions_in) const
 {
     if (is_error()) {
         return error_type();
@@ -301,15 +307,15 @@ ValueType::join(const ValueType &lhs, const ValueType &rhs)
     if (lhs.is_error() || rhs.is_error()) {
         return error_type();
     } else if (lhs.is_double()) {
-        return rhs;
+        return rhs.map();
     } else if (rhs.is_double()) {
-        return lhs;
+        return lhs.map();
     }
     MyJoin result(lhs._dimensions, rhs._dimensions);
     if (result.mismatch) {
         return error_type();
     }
-    return tensor_type(std::move(result.dimensions), unify(lhs._cell_type, rhs._cell_type));
+    return tensor_type(std::move(result.dimensions), decay_cell_type(unify(lhs._cell_type, rhs._cell_type)));
 }
 
 ValueType
@@ -323,7 +329,7 @@ ValueType::merge(const ValueType &lhs, const ValueType &rhs)
     if (lhs.dimensions().empty()) {
         return lhs;
     }
-    return tensor_type(lhs.dimensions(), unify(lhs._cell_type, rhs._cell_type));
+    return tensor_type(lhs.dimensions(), decay_cell_type(unify(lhs._cell_type, rhs._cell_type)));
 }
 
 CellType
@@ -336,6 +342,11 @@ ValueType::unify_cell_types(const ValueType &a, const ValueType &b) {
     return unify(a.cell_type(), b.cell_type());
 }
 
+CellType
+ValueType::decay_cell_type(CellType cell_type) {
+    return (cell_type == CellType::DOUBLE) ? CellType::DOUBLE : CellType::FLOAT;
+}
+
 ValueType
 ValueType::concat(const ValueType &lhs, const ValueType &rhs, const vespalib::string &dimension)
 {
@@ -2,7 +2,6 @@
 
 #include "default_tensor_engine.h"
 #include "tensor.h"
-#include "wrapped_simple_tensor.h"
 #include "serialization/typed_binary_format.h"
 #include "sparse/sparse_tensor_address_builder.h"
 #include "sparse/direct_sparse_tensor_builder.h"
@@ -15,6 +14,7 @@
 #include "dense/dense_fast_rename_optimizer.h"
 #include "dense/dense_add_dimension_optimizer.h"
 #include "dense/dense_single_reduce_function.h"
+#include "dense/dense_fused_join_reduce_function.h"
 #include "dense/dense_remove_dimension_optimizer.h"
 #include "dense/dense_lambda_peek_optimizer.h"
 #include "dense/dense_lambda_function.h"
@@ -26,9 +26,13 @@
 #include "dense/vector_from_doubles_function.h"
 #include "dense/dense_tensor_create_function.h"
 #include "dense/dense_tensor_peek_function.h"
+#include "mixed/mixed_tensor.h"
+#include "mixed/mixed_tensor_builder.h"
+#include "mixed/mixed_tensor_peek_function.h"
 #include <vespa/eval/eval/value.h>
 #include <vespa/eval/eval/tensor_spec.h>
 #include <vespa/eval/eval/tensor_spec.h>
+#include <vespa/eval/eval/simple_tensor.h>
 #include <vespa/eval/eval/simple_tensor_engine.h>
 #include <vespa/eval/eval/operation.h>
 #include <vespa/vespalib/objects/nbostream.h>
@@ -65,9 +69,6 @@ const eval::TensorEngine &default_engine() { return DefaultTensorEngine::ref();
 
 const Value &to_simple(const Value &value, Stash &stash) {
     if (auto tensor = value.as_tensor()) {
-        if (auto wrapped = dynamic_cast<const WrappedSimpleTensor *>(tensor)) {
-            return wrapped->get();
-        }
         nbostream data;
         tensor->engine().encode(*tensor, data);
         return *stash.create<Value::UP>(eval::SimpleTensor::decode(data));
@@ -79,11 +80,6 @@ const Value &to_simple(const Value &value, Stash &stash) {
 
 const Value &to_default(const Value &value, Stash &stash) {
     if (auto tensor = value.as_tensor()) {
-        if (auto simple = dynamic_cast<const eval::SimpleTensor *>(tensor)) {
-            if (!Tensor::supported({simple->type()})) {
-                return stash.create<WrappedSimpleTensor>(*simple);
-            }
-        }
         nbostream data;
         tensor->engine().encode(*tensor, data);
         return *stash.create<Value::UP>(default_engine().decode(data));
@@ -91,6 +87,15 @@ const Value &to_default(const Value &value, Stash &stash) {
     return value;
 }
 
+// map tensors to mixed tensors when combining tensors with different layouts
+
+const MixedTensor &to_mixed(const Tensor &tensor, Stash &stash) {
+    if (auto mixed = dynamic_cast<const MixedTensor *>(&tensor)) {
+        return *mixed;
+    }
+    return *stash.create<std::unique_ptr<MixedTensor>>(MixedTensor::from_tensor(tensor));
+}
+
 const Value &to_value(std::unique_ptr<Tensor> tensor, Stash &stash) {
     assert(tensor);
     if (tensor->type().is_tensor()) {
@@ -106,12 +111,12 @@ Value::UP to_value(std::unique_ptr<Tensor> tensor) {
     return std::make_unique<DoubleValue>(tensor->as_double());
 }
 
-const Value &fallback_join(const Value &a, const Value &b, join_fun_t function, Stash &stash) {
-    return to_default(simple_engine().join(to_simple(a, stash), to_simple(b, stash), function, stash), stash);
+const Value &mixed_join(const Tensor &a, const Tensor &b, join_fun_t function, Stash &stash) {
+    return to_value(to_mixed(a, stash).join(function, to_mixed(b, stash)), stash);
 }
 
-const Value &fallback_merge(const Value &a, const Value &b, join_fun_t function, Stash &stash) {
-    return to_default(simple_engine().merge(to_simple(a, stash), to_simple(b, stash), function, stash), stash);
+const Value &mixed_merge(const Tensor &a, const Tensor &b, join_fun_t function, Stash &stash) {
+    return to_value(to_mixed(a, stash).merge(function, to_mixed(b, stash)), stash);
 }
 
 const Value &fallback_reduce(const Value &a, eval::Aggr aggr, const std::vector<vespalib::string> &dimensions, Stash &stash) {
@@ -187,7 +192,7 @@ struct CallDenseTensorBuilder {
             if (cell_idx == UNDEFINED_IDX) {
                 bad_spec(spec);
             }
-            builder.insertCell(cell_idx, cell.second);
+            builder.insertCell(cell_idx, cell.second.value);
         }
         return builder.build();
     }
@@ -208,7 +213,7 @@ DefaultTensorEngine::from_spec(const TensorSpec &spec) const
         return typify_invoke<1,MyTypify,CallDenseTensorBuilder>(type.cell_type(), type, spec);
     } else if (type.is_sparse()) {
         DirectSparseTensorBuilder builder(type);
-        SparseTensorAddressBuilder address_builder;
+        SparseTensorAddressBuilder address_builder(builder.labels());
         for (const auto &cell: spec.cells()) {
             const auto &address = cell.first;
             if (build_cell_address(type, address, address_builder)) {
@@ -219,7 +224,13 @@ DefaultTensorEngine::from_spec(const TensorSpec &spec) const
         }
         return builder.build();
     }
-    return std::make_unique<WrappedSimpleTensor>(eval::SimpleTensor::create(spec));
+    MixedTensorBuilder builder(type);
+    for (const auto &cell: spec.cells()) {
+        if (!builder.set_cell(cell.first, cell.second)) {
+            bad_spec(spec);
+        }
+    }
+    return builder.build();
 }
 
 struct CellFunctionFunAdapter : tensor::CellFunction {
@@ -295,6 +306,7 @@ DefaultTensorEngine::optimize(const TensorFunction &expr, Stash &stash) const
             child.set(VectorFromDoublesFunction::optimize(child.get(), stash));
             child.set(DenseTensorCreateFunction::optimize(child.get(), stash));
             child.set(DenseTensorPeekFunction::optimize(child.get(), stash));
+            child.set(MixedTensorPeekFunction::optimize(child.get(), stash));
             child.set(DenseLambdaPeekOptimizer::optimize(child.get(), stash));
             child.set(DenseLambdaFunction::optimize(child.get(), stash));
             child.set(DenseFastRenameOptimizer::optimize(child.get(), stash));
@@ -302,6 +314,7 @@ DefaultTensorEngine::optimize(const TensorFunction &expr, Stash &stash) const
             child.set(DenseSimpleMapFunction::optimize(child.get(), stash));
             child.set(DenseSimpleJoinFunction::optimize(child.get(), stash));
             child.set(DenseNumberJoinFunction::optimize(child.get(), stash));
+            child.set(DenseFusedJoinReduceFunction::optimize(child.get(), stash));
             child.set(DenseSingleReduceFunction::optimize(child.get(), stash));
             nodes.pop_back();
         }
@@ -318,9 +331,6 @@ DefaultTensorEngine::map(const Value &a, map_fun_t function, Stash &stash) const
     if (auto tensor = a.as_tensor()) {
         assert(&tensor->engine() == this);
         const tensor::Tensor &my_a = static_cast<const tensor::Tensor &>(*tensor);
-        if (!tensor::Tensor::supported({my_a.type()})) {
-            return to_default(simple_engine().map(to_simple(a, stash), function, stash), stash);
-        }
         CellFunctionFunAdapter cell_function(function);
         return to_value(my_a.apply(cell_function), stash);
     } else {
@@ -338,13 +348,10 @@ DefaultTensorEngine::join(const Value &a, const Value &b, join_fun_t function, S
             assert(&tensor_b->engine() == this);
             const tensor::Tensor &my_b = static_cast<const tensor::Tensor &>(*tensor_b);
             if (!tensor::Tensor::supported({my_a.type(), my_b.type()})) {
-                return fallback_join(a, b, function, stash);
+                return mixed_join(my_a, my_b, function, stash);
             }
             return to_value(my_a.join(function, my_b), stash);
         } else {
-            if (!tensor::Tensor::supported({my_a.type()})) {
-                return fallback_join(a, b, function, stash);
-            }
             CellFunctionBindRightAdapter cell_function(function, b.as_double());
             return to_value(my_a.apply(cell_function), stash);
         }
@@ -352,9 +359,6 @@ DefaultTensorEngine::join(const Value &a, const Value &b, join_fun_t function, S
         if (auto tensor_b = b.as_tensor()) {
             assert(&tensor_b->engine() == this);
             const tensor::Tensor &my_b = static_cast<const tensor::Tensor &>(*tensor_b);
-            if (!tensor::Tensor::supported({my_b.type()})) {
-                return fallback_join(a, b, function, stash);
-            }
             CellFunctionBindLeftAdapter cell_function(function, a.as_double());
             return to_value(my_b.apply(cell_function), stash);
         } else {
@@ -374,7 +378,7 @@ DefaultTensorEngine::merge(const Value &a, const Value &b, join_fun_t function,
         const tensor::Tensor &my_a = static_cast<const tensor::Tensor &>(*tensor_a);
         const tensor::Tensor &my_b = static_cast<const tensor::Tensor &>(*tensor_b);
         if (!tensor::Tensor::supported({my_a.type(), my_b.type()})) {
-            return fallback_merge(a, b, function, stash);
+            return mixed_merge(my_a, my_b, function, stash);
         }
         return to_value(my_a.merge(function, my_b), stash);
     } else {
@@ -388,9 +392,6 @@ DefaultTensorEngine::reduce(const Value &a, Aggr aggr, const std::vector<vespali
     if (auto tensor = a.as_tensor()) {
         assert(&tensor->engine() == this);
         const tensor::Tensor &my_a = static_cast<const tensor::Tensor &>(*tensor);
-        if (!tensor::Tensor::supported({my_a.type()})) {
-            return fallback_reduce(a, aggr, dimensions, stash);
-        }
         switch (aggr) {
         case Aggr::PROD: return to_value(my_a.reduce(eval::operation::Mul::f, dimensions), stash);
         case Aggr::SUM:
@@ -4,6 +4,7 @@
 #include "dense_tensor_view.h"
 #include <vespa/eval/eval/operation.h>
 #include <vespa/eval/eval/value.h>
+#include <vespa/vespalib/hwaccelrated/iaccelrated.h>
 
 #include <cblas.h>
 
@@ -46,6 +47,15 @@ void my_cblas_float_dot_product_op(eval::InterpretedFunction::State &state, uint
     state.pop_pop_push(state.stash.create<eval::DoubleValue>(result));
 }
 
+template <typename CT>
+void my_hwaccel_dot_product_op(eval::InterpretedFunction::State &state, uint64_t) {
+    auto lhs_cells = DenseTensorView::typify_cells<CT>(state.peek(1));
+    auto rhs_cells = DenseTensorView::typify_cells<CT>(state.peek(0));
+    const auto &accel = hwaccelrated::IAccelrated::getAccelerator();
+    double result = accel.dotProduct(lhs_cells.cbegin(), rhs_cells.cbegin(), lhs_cells.size());
+    state.pop_pop_push(state.stash.create<eval::DoubleValue>(result));
+}
+
 struct MyDotProductOp {
     template <typename LCT, typename RCT>
     static auto invoke() { return my_dot_product_op<LCT,RCT>; }
@@ -59,6 +69,12 @@ eval::InterpretedFunction::op_function my_select(CellType lct, CellType rct) {
         if (lct == ValueType::CellType::FLOAT) {
             return my_cblas_float_dot_product_op;
         }
+        if (lct == ValueType::CellType::BFLOAT16) {
+            return my_hwaccel_dot_product_op<BFloat16>;
+        }
+        if (lct == ValueType::CellType::INT8) {
+            return my_hwaccel_dot_product_op<int8_t>;
+        }
     }
     using MyTypify = eval::TypifyCellType;
     return typify_invoke<2,MyTypify,MyDotProductOp>(lct, rct);
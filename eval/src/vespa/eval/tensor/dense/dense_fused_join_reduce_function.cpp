@@ -0,0 +1,399 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "dense_fused_join_reduce_function.h"
+#include "dense_tensor_view.h"
+#include <vespa/eval/eval/value.h>
+#include <vespa/eval/eval/operation.h>
+#include <vespa/eval/eval/inline_operation.h>
+#include <vespa/vespalib/util/typify.h>
+#include <algorithm>
+#include <cassert>
+
+namespace vespalib::tensor {
+
+using eval::Aggr;
+using eval::DoubleValue;
+using eval::InterpretedFunction;
+using eval::TensorEngine;
+using eval::TensorFunction;
+using eval::Value;
+using eval::ValueType;
+using eval::TypifyCellType;
+using eval::TypifyAggr;
+using eval::as;
+
+using namespace eval::operation;
+using namespace eval::tensor_function;
+
+using Step = DenseFusedJoinReduceFunction::Step;
+using State = InterpretedFunction::State;
+
+namespace {
+
+// number of cells calculated at a time along the innermost loop
+constexpr size_t block_size = 64;
+constexpr size_t max_inputs = DenseFusedJoinReduceFunction::max_inputs;
+
+using load_fun_t = void (*)(double *dst, const void *cells, size_t offset, size_t stride, size_t n);
+using block_op1_t = void (*)(double *values, size_t n, map_fun_t fun);
+using block_op2_t = void (*)(double *lhs_values, const double *rhs_values, size_t n, join_fun_t fun);
+
+template <typename CT>
+void my_load(double *dst, const void *cells, size_t offset, size_t stride, size_t n) {
+    const CT *src = static_cast<const CT *>(cells) + offset;
+    if (stride == 1) {
+        for (size_t i = 0; i < n; ++i) {
+            dst[i] = src[i];
+        }
+    } else if (stride == 0) {
+        double value = *src;
+        for (size_t i = 0; i < n; ++i) {
+            dst[i] = value;
+        }
+    } else {
+        for (size_t i = 0; i < n; ++i) {
+            dst[i] = src[i * stride];
+        }
+    }
+}
+
+struct MyGetLoad {
+    template <typename CT> static auto invoke() { return my_load<CT>; }
+};
+
+template <typename OP1>
+void my_block_op1(double *values, size_t n, map_fun_t fun) {
+    OP1 my_op(fun);
+    for (size_t i = 0; i < n; ++i) {
+        values[i] = my_op(values[i]);
+    }
+}
+
+struct MyGetOp1 {
+    template <typename OP1> static auto invoke() { return my_block_op1<OP1>; }
+};
+
+template <typename OP2>
+void my_block_op2(double *lhs_values, const double *rhs_values, size_t n, join_fun_t fun) {
+    OP2 my_op(fun);
+    for (size_t i = 0; i < n; ++i) {
+        lhs_values[i] = my_op(lhs_values[i], rhs_values[i]);
+    }
+}
+
+struct MyGetOp2 {
+    template <typename OP2> static auto invoke() { return my_block_op2<OP2>; }
+};
+
+void round_to_float(double *values, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        values[i] = float(values[i]);
+    }
+}
+
+struct Op {
+    Step::Type type;
+    size_t input;
+    map_fun_t map_fun;
+    join_fun_t join_fun;
+    block_op1_t block_op1;
+    block_op2_t block_op2;
+    bool float_result;
+};
+
+struct Params {
+    const ValueType &result_type;
+    size_t num_inputs;
+    size_t num_cells;
+    std::vector<Op> ops;
+    std::vector<load_fun_t> load;     // [input]
+    std::vector<char> is_number;      // [input]
+    std::vector<size_t> loop_size;    // [loop]
+    std::vector<size_t> loop_stride;  // [loop * num_inputs + input]
+    size_t num_kept_loops;
+    Params(const ValueType &result_type_in, size_t num_inputs_in)
+        : result_type(result_type_in), num_inputs(num_inputs_in),
+          num_cells(result_type_in.dense_subspace_size()), ops(), load(),
+          is_number(), loop_size(), loop_stride(), num_kept_loops(0) {}
+    const size_t *stride(size_t loop) const { return &loop_stride[loop * num_inputs]; }
+};
+
+// calculate the fused expression for 'n' consecutive positions
+// along the innermost loop, starting at the given input offsets
+struct BlockEval {
+    const Params &params;
+    const void **cells;
+    const size_t *inner_stride;
+    double values[max_inputs][block_size];
+    BlockEval(const Params &params_in, const void **cells_in)
+        : params(params_in), cells(cells_in), inner_stride(params.stride(params.loop_size.size() - 1)) {}
+    const double *calc(const size_t *offsets, size_t n) {
+        size_t sp = 0;
+        for (const Op &op: params.ops) {
+            switch (op.type) {
+            case Step::Type::INPUT:
+                params.load[op.input](values[sp++], cells[op.input], offsets[op.input], inner_stride[op.input], n);
+                break;
+            case Step::Type::MAP:
+                op.block_op1(values[sp - 1], n, op.map_fun);
+                break;
+            case Step::Type::JOIN:
+                op.block_op2(values[sp - 2], values[sp - 1], n, op.join_fun);
+                --sp;
+                break;
+            }
+            if (op.float_result) {
+                round_to_float(values[sp - 1], n);
+            }
+        }
+        assert(sp == 1);
+        return values[0];
+    }
+};
+
+template <typename F>
+void run_loops(const Params &params, size_t loop, size_t end, const size_t *offsets, F &&f) {
+    if (loop == end) {
+        f(offsets);
+        return;
+    }
+    size_t my_offsets[max_inputs];
+    std::copy(offsets, offsets + params.num_inputs, my_offsets);
+    const size_t *stride = params.stride(loop);
+    for (size_t i = 0; i < params.loop_size[loop]; ++i) {
+        run_loops(params, loop + 1, end, my_offsets, f);
+        for (size_t j = 0; j < params.num_inputs; ++j) {
+            my_offsets[j] += stride[j];
+        }
+    }
+}
+
+template <typename OCT, typename AGGR>
+void fused_join_reduce(const Params &params, const void **cells, OCT *dst) {
+    BlockEval block(params, cells);
+    size_t inner_loop = (params.loop_size.size() - 1);
+    size_t inner_size = params.loop_size[inner_loop];
+    AGGR aggr;
+    size_t zero_offsets[max_inputs] = {};
+    run_loops(params, 0, params.num_kept_loops, zero_offsets, [&](const size_t *kept_offsets) {
+                  bool first = true;
+                  run_loops(params, params.num_kept_loops, inner_loop, kept_offsets, [&](const size_t *offsets) {
+                                size_t my_offsets[max_inputs];
+                                std::copy(offsets, offsets + params.num_inputs, my_offsets);
+                                for (size_t done = 0; done < inner_size; ) {
+                                    size_t n = std::min(block_size, inner_size - done);
+                                    const double *values = block.calc(my_offsets, n);
+                                    size_t i = 0;
+                                    if (first) {
+                                        aggr.first(OCT(values[i++]));
+                                        first = false;
+                                    }
+                                    for (; i < n; ++i) {
+                                        aggr.next(OCT(values[i]));
+                                    }
+                                    for (size_t j = 0; j < params.num_inputs; ++j) {
+                                        my_offsets[j] += (n * block.inner_stride[j]);
+                                    }
+                                    done += n;
+                                }
+                            });
+                  *dst++ = aggr.result();
+              });
+}
+
+template <typename OCT, typename AGGR>
+void my_fused_join_reduce_op(State &state, uint64_t param) {
+    const Params &params = *(const Params *)(param);
+    const void *cells[max_inputs];
+    double numbers[max_inputs];
+    for (size_t i = 0; i < params.num_inputs; ++i) {
+        const Value &value = state.peek(params.num_inputs - 1 - i);
+        if (params.is_number[i]) {
+            numbers[i] = value.as_double();
+            cells[i] = &numbers[i];
+        } else {
+            cells[i] = static_cast<const DenseTensorView &>(value).cellsRef().data;
+        }
+    }
+    if (params.result_type.is_double()) {
+        OCT result;
+        fused_join_reduce<OCT, AGGR>(params, cells, &result);
+        state.pop_n_push(params.num_inputs, state.stash.create<DoubleValue>(result));
+    } else {
+        ArrayRef<OCT> dst_cells = state.stash.create_array<OCT>(params.num_cells);
+        fused_join_reduce<OCT, AGGR>(params, cells, dst_cells.begin());
+        state.pop_n_push(params.num_inputs, state.stash.create<DenseTensorView>(params.result_type, TypedCells(dst_cells)));
+    }
+}
+
+struct MyGetFun {
+    template <typename R1, typename R2> static auto invoke() {
+        using OCT = typename eval::DecayCellType<R1>::type;
+        return my_fused_join_reduce_op<OCT, typename R2::template templ<OCT>>;
+    }
+};
+
+using MyTypify = TypifyValue<TypifyCellType,TypifyAggr>;
+
+// strides of each loop dimension for a single input (0 if not present)
+std::vector<size_t> make_strides(const ValueType &type, const std::vector<const ValueType::Dimension *> &loop_dims) {
+    std::vector<size_t> strides(loop_dims.size(), 0);
+    size_t stride = 1;
+    for (size_t i = type.dimensions().size(); i-- > 0; ) {
+        const auto &dim = type.dimensions()[i];
+        for (size_t loop = 0; loop < loop_dims.size(); ++loop) {
+            if (loop_dims[loop]->name == dim.name) {
+                assert(loop_dims[loop]->size == dim.size);
+                strides[loop] = stride;
+            }
+        }
+        stride *= dim.size;
+    }
+    return strides;
+}
+
+void make_loops(Params &params, const ValueType &joined_type, const ValueType &result_type,
+                const std::vector<const ValueType *> &input_types)
+{
+    std::vector<const ValueType::Dimension *> loop_dims;
+    for (const auto &dim: joined_type.dimensions()) {
+        if (result_type.dimension_index(dim.name) != ValueType::Dimension::npos) {
+            loop_dims.push_back(&dim);
+        }
+    }
+    size_t num_kept = loop_dims.size();
+    for (const auto &dim: joined_type.dimensions()) {
+        if (result_type.dimension_index(dim.name) == ValueType::Dimension::npos) {
+            loop_dims.push_back(&dim);
+        }
+    }
+    assert(loop_dims.size() > num_kept);
+    std::vector<std::vector<size_t>> strides;
+    for (const ValueType *type: input_types) {
+        strides.push_back(make_strides(*type, loop_dims));
+    }
+    // combine adjacent loops (on the same side of the kept/reduced
+    // split) that can be iterated as a single loop for all inputs
+    for (size_t loop = 0; loop < loop_dims.size(); ++loop) {
+        bool can_combine = (loop != 0) && (loop != num_kept);
+        for (size_t i = 0; can_combine && (i < input_types.size()); ++i) {
+            can_combine = (strides[i][loop - 1] == (strides[i][loop] * loop_dims[loop]->size));
+        }
+        if (can_combine) {
+            params.loop_size.back() *= loop_dims[loop]->size;
+            for (size_t i = 0; i < input_types.size(); ++i) {
+                params.loop_stride[params.loop_stride.size() - input_types.size() + i] = strides[i][loop];
+            }
+        } else {
+            if (loop == num_kept) {
+                params.num_kept_loops = params.loop_size.size();
+            }
+            params.loop_size.push_back(loop_dims[loop]->size);
+            for (size_t i = 0; i < input_types.size(); ++i) {
+                params.loop_stride.push_back(strides[i][loop]);
+            }
+        }
+    }
+}
+
+bool is_fusable_type(const ValueType &type) {
+    return (type.is_dense() || type.is_double());
+}
+
+bool collect_steps(const TensorFunction &node, std::vector<Step> &steps, std::vector<TensorFunction::Child> &children) {
+    if (!is_fusable_type(node.result_type())) {
+        return false;
+    }
+    bool float_result = (node.result_type().cell_type() == ValueType::CellType::FLOAT);
+    if (auto join = as<Join>(node)) {
+        if (!collect_steps(join->lhs(), steps, children) ||
+            !collect_steps(join->rhs(), steps, children))
+        {
+            return false;
+        }
+        steps.push_back(Step{Step::Type::JOIN, 0, nullptr, join->function(), float_result});
+    } else if (auto map = as<Map>(node)) {
+        if (!collect_steps(map->child(), steps, children)) {
+            return false;
+        }
+        steps.push_back(Step{Step::Type::MAP, 0, map->function(), nullptr, float_result});
+    } else {
+        if (children.size() == max_inputs) {
+            return false;
+        }
+        steps.push_back(Step{Step::Type::INPUT, children.size(), nullptr, nullptr, false});
+        children.emplace_back(node);
+    }
+    return true;
+}
+
+} // namespace vespalib::tensor::<unnamed>
+
+DenseFusedJoinReduceFunction::DenseFusedJoinReduceFunction(const ValueType &result_type,
+                                                           const ValueType &joined_type,
+                                                           Aggr aggr,
+                                                           std::vector<Step> steps,
+                                                           std::vector<Child> children)
+    : TensorFunction(),
+      _result_type(result_type),
+      _joined_type(joined_type),
+      _aggr(aggr),
+      _steps(std::move(steps)),
+      _children(std::move(children))
+{
+}
+
+DenseFusedJoinReduceFunction::~DenseFusedJoinReduceFunction() = default;
+
+void
+DenseFusedJoinReduceFunction::push_children(std::vector<Child::CREF> &target) const
+{
+    for (const Child &c: _children) {
+        target.emplace_back(c);
+    }
+}
+
+InterpretedFunction::Instruction
+DenseFusedJoinReduceFunction::compile_self(const TensorEngine &, Stash &stash) const
+{
+    auto &params = stash.create<Params>(_result_type, _children.size());
+    std::vector<const ValueType *> input_types;
+    for (const Child &child: _children) {
+        const ValueType &type = child.get().result_type();
+        input_types.push_back(&type);
+        params.is_number.push_back(type.is_double() ? 1 : 0);
+        params.load.push_back(typify_invoke<1,TypifyCellType,MyGetLoad>(type.cell_type()));
+    }
+    for (const Step &step: _steps) {
+        Op op{step.type, step.input, step.map_fun, step.join_fun, nullptr, nullptr, step.float_result};
+        if (step.type == Step::Type::MAP) {
+            op.block_op1 = typify_invoke<1,TypifyOp1,MyGetOp1>(step.map_fun);
+        } else if (step.type == Step::Type::JOIN) {
+            op.block_op2 = typify_invoke<1,TypifyOp2,MyGetOp2>(step.join_fun);
+        }
+        params.ops.push_back(op);
+    }
+    make_loops(params, _joined_type, _result_type, input_types);
+    auto op = typify_invoke<2,MyTypify,MyGetFun>(_result_type.cell_type(), _aggr);
+    static_assert(sizeof(uint64_t) == sizeof(&params));
+    return InterpretedFunction::Instruction(op, (uint64_t)&params);
+}
+
+const TensorFunction &
+DenseFusedJoinReduceFunction::optimize(const TensorFunction &expr, Stash &stash)
+{
+    auto reduce = as<Reduce>(expr);
+    if (reduce && is_fusable_type(expr.result_type()) && reduce->child().result_type().is_dense() &&
+        (as<Join>(reduce->child()) || as<Map>(reduce->child())))
+    {
+        std::vector<Step> steps;
+        std::vector<Child> children;
+        if (collect_steps(reduce->child(), steps, children)) {
+            return stash.create<DenseFusedJoinReduceFunction>(expr.result_type(), reduce->child().result_type(),
+                                                              reduce->aggr(), std::move(steps), std::move(children));
+        }
+    }
+    return expr;
+}
+
+} // namespace vespalib::tensor
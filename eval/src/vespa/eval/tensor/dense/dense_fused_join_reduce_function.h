@@ -0,0 +1,59 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include <vespa/eval/eval/tensor_function.h>
+#include <vespa/eval/eval/aggr.h>
+
+namespace vespalib::tensor {
+
+/**
+ * Tensor function reducing the result of a tree of join and map
+ * operations over dense tensors (and numbers) without materializing
+ * any of the intermediate results. All operations are evaluated for
+ * a block of cells at a time inside a single loop nest spanning the
+ * dimensions of the joined tensor, and the values are aggregated
+ * directly into the cells of the (dense or number) result.
+ **/
+class DenseFusedJoinReduceFunction : public eval::TensorFunction
+{
+public:
+    // largest number of inputs (leaf tensors/numbers) we will fuse
+    static constexpr size_t max_inputs = 8;
+
+    // one step of the fused expression, listed in post-order
+    struct Step {
+        enum class Type { INPUT, MAP, JOIN };
+        Type type;
+        size_t input;
+        eval::tensor_function::map_fun_t map_fun;
+        eval::tensor_function::join_fun_t join_fun;
+        bool float_result; // intermediate result has float cells
+    };
+
+private:
+    eval::ValueType _result_type;
+    eval::ValueType _joined_type;
+    eval::Aggr _aggr;
+    std::vector<Step> _steps;
+    std::vector<Child> _children;
+
+public:
+    DenseFusedJoinReduceFunction(const eval::ValueType &result_type,
+                                 const eval::ValueType &joined_type,
+                                 eval::Aggr aggr,
+                                 std::vector<Step> steps,
+                                 std::vector<Child> children);
+    ~DenseFusedJoinReduceFunction() override;
+    const eval::ValueType &result_type() const override { return _result_type; }
+    const eval::ValueType &joined_type() const { return _joined_type; }
+    eval::Aggr aggr() const { return _aggr; }
+    const std::vector<Step> &steps() const { return _steps; }
+    size_t num_inputs() const { return _children.size(); }
+    void push_children(std::vector<Child::CREF> &children) const override;
+    eval::InterpretedFunction::Instruction compile_self(const eval::TensorEngine &engine, Stash &stash) const override;
+    bool result_is_mutable() const override { return true; }
+    static const eval::TensorFunction &optimize(const eval::TensorFunction &expr, Stash &stash);
+};
+
+} // namespace vespalib::tensor
@@ -29,28 +29,31 @@ using State = eval::InterpretedFunction::State;
 
 namespace {
 
-template <typename CT, bool inplace>
-ArrayRef<CT> make_dst_cells(ConstArrayRef<CT> src_cells, Stash &stash) {
-    if (inplace) {
+template <typename OCT, bool inplace, typename ICT>
+ArrayRef<OCT> make_dst_cells(ConstArrayRef<ICT> src_cells, Stash &stash) {
+    if constexpr (inplace) {
+        static_assert(std::is_same_v<ICT, OCT>);
         return unconstify(src_cells);
     } else {
-        return stash.create_array<CT>(src_cells.size());
+        return stash.create_array<OCT>(src_cells.size());
     }
 }
 
-template <typename CT, typename Fun, bool inplace, bool swap>
+template <typename ICT, typename Fun, bool inplace, bool swap>
 void my_number_join_op(State &state, uint64_t param) {
+    using OCT = typename eval::DecayCellType<ICT>::type;
     using OP = typename std::conditional<swap,SwapArgs2<Fun>,Fun>::type;
     OP my_op((join_fun_t)param);
     const Value &tensor = state.peek(swap ? 0 : 1);
-    CT number = state.peek(swap ? 1 : 0).as_double();
-    auto src_cells = DenseTensorView::typify_cells<CT>(tensor);
-    auto dst_cells = make_dst_cells<CT, inplace>(src_cells, state.stash);
+    OCT number = state.peek(swap ? 1 : 0).as_double();
+    auto src_cells = DenseTensorView::typify_cells<ICT>(tensor);
+    auto dst_cells = make_dst_cells<OCT, inplace>(src_cells, state.stash);
     apply_op2_vec_num(dst_cells.begin(), src_cells.begin(), number, dst_cells.size(), my_op);
-    if (inplace) {
+    if constexpr (inplace) {
         state.pop_pop_push(tensor);
     } else {
-        state.pop_pop_push(state.stash.create<DenseTensorView>(tensor.type(), TypedCells(dst_cells)));
+        const ValueType &res_type = std::is_same_v<ICT, OCT> ? tensor.type() : state.stash.create<ValueType>(tensor.type().map());
+        state.pop_pop_push(state.stash.create<DenseTensorView>(res_type, TypedCells(dst_cells)));
     }
 }
 
@@ -58,7 +61,11 @@ void my_number_join_op(State &state, uint64_t param) {
 
 struct MyGetFun {
     template <typename R1, typename R2, typename R3, typename R4> static auto invoke() {
-        return my_number_join_op<R1, R2, R3::value, R4::value>;
+        if constexpr (R3::value && !std::is_same_v<R1, typename eval::DecayCellType<R1>::type>) {
+            return my_number_join_op<R1, R2, false, R4::value>;
+        } else {
+            return my_number_join_op<R1, R2, R3::value, R4::value>;
+        }
     }
 };
 
@@ -87,17 +94,16 @@ DenseNumberJoinFunction::~DenseNumberJoinFunction() = default;
 bool
 DenseNumberJoinFunction::inplace() const
 {
-    if (_primary == Primary::LHS) {
-        return lhs().result_is_mutable();
-    } else {
-        return rhs().result_is_mutable();
-    }
+    const TensorFunction &primary = (_primary == Primary::LHS) ? lhs() : rhs();
+    return (primary.result_is_mutable() &&
+            (primary.result_type().cell_type() == result_type().cell_type()));
 }
 
 Instruction
 DenseNumberJoinFunction::compile_self(const TensorEngine &, Stash &) const
 {
-    auto op = typify_invoke<4,MyTypify,MyGetFun>(result_type().cell_type(), function(),
+    const TensorFunction &primary = (_primary == Primary::LHS) ? lhs() : rhs();
+    auto op = typify_invoke<4,MyTypify,MyGetFun>(primary.result_type().cell_type(), function(),
                                                  inplace(), (_primary == Primary::RHS));
     static_assert(sizeof(uint64_t) == sizeof(function()));
     return Instruction(op, (uint64_t)(function()));
@@ -110,10 +116,10 @@ DenseNumberJoinFunction::optimize(const TensorFunction &expr, Stash &stash)
         const TensorFunction &lhs = join->lhs();
         const TensorFunction &rhs = join->rhs();
         if (is_dense(lhs) && is_double(rhs)) {
-            assert(cell_type(expr) == cell_type(lhs));
+            assert(cell_type(expr) == ValueType::decay_cell_type(cell_type(lhs)));
             return stash.create<DenseNumberJoinFunction>(join->result_type(), lhs, rhs, join->function(), Primary::LHS);
         } else if (is_double(lhs) && is_dense(rhs)) {
-            assert(cell_type(expr) == cell_type(rhs));
+            assert(cell_type(expr) == ValueType::decay_cell_type(cell_type(rhs)));
             return stash.create<DenseNumberJoinFunction>(join->result_type(), lhs, rhs, join->function(), Primary::RHS);
         }
     }
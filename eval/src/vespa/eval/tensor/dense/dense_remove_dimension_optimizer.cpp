@@ -42,10 +42,10 @@ DenseRemoveDimensionOptimizer::optimize(const eval::TensorFunction &expr, Stash
         const TensorFunction &child = reduce->child();
         if (expr.result_type().is_dense() &&
             child.result_type().is_dense() &&
+            (expr.result_type().cell_type() == child.result_type().cell_type()) &&
             is_ident_aggr(reduce->aggr()) &&
             is_trivial_dim_list(child.result_type(), reduce->dimensions()))
         {
-            assert(expr.result_type().cell_type() == child.result_type().cell_type());
             return DenseReplaceTypeFunction::create_compact(expr.result_type(), child, stash);
         }
     }
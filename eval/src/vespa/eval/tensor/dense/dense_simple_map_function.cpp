@@ -27,24 +27,27 @@ using State = eval::InterpretedFunction::State;
 
 namespace {
 
-template <typename CT, bool inplace>
-ArrayRef<CT> make_dst_cells(ConstArrayRef<CT> src_cells, Stash &stash) {
-    if (inplace) {
+template <typename OCT, bool inplace, typename ICT>
+ArrayRef<OCT> make_dst_cells(ConstArrayRef<ICT> src_cells, Stash &stash) {
+    if constexpr (inplace) {
+        static_assert(std::is_same_v<ICT, OCT>);
         return unconstify(src_cells);
     } else {
-        return stash.create_array<CT>(src_cells.size());
+        return stash.create_array<OCT>(src_cells.size());
     }
 }
 
-template <typename CT, typename Fun, bool inplace>
+template <typename ICT, typename Fun, bool inplace>
 void my_simple_map_op(State &state, uint64_t param) {
+    using OCT = typename eval::DecayCellType<ICT>::type;
     Fun my_fun((map_fun_t)param);
     auto const &child = state.peek(0);
-    auto src_cells = DenseTensorView::typify_cells<CT>(child);
-    auto dst_cells = make_dst_cells<CT, inplace>(src_cells, state.stash);
+    auto src_cells = DenseTensorView::typify_cells<ICT>(child);
+    auto dst_cells = make_dst_cells<OCT, inplace>(src_cells, state.stash);
     apply_op1_vec(dst_cells.begin(), src_cells.begin(), dst_cells.size(), my_fun);
-    if (!inplace) {
-        state.pop_push(state.stash.create<DenseTensorView>(child.type(), TypedCells(dst_cells)));
+    if constexpr (!inplace) {
+        const ValueType &res_type = std::is_same_v<ICT, OCT> ? child.type() : state.stash.create<ValueType>(child.type().map());
+        state.pop_push(state.stash.create<DenseTensorView>(res_type, TypedCells(dst_cells)));
     }
 }
 
@@ -52,7 +55,11 @@ void my_simple_map_op(State &state, uint64_t param) {
 
 struct MyGetFun {
     template <typename R1, typename R2, typename R3> static auto invoke() {
-        return my_simple_map_op<R1, R2, R3::value>;
+        if constexpr (R3::value && !std::is_same_v<R1, typename eval::DecayCellType<R1>::type>) {
+            return my_simple_map_op<R1, R2, false>;
+        } else {
+            return my_simple_map_op<R1, R2, R3::value>;
+        }
     }
 };
 
@@ -74,7 +81,7 @@ DenseSimpleMapFunction::~DenseSimpleMapFunction() = default;
 Instruction
 DenseSimpleMapFunction::compile_self(const TensorEngine &, Stash &) const
 {
-    auto op = typify_invoke<3,MyTypify,MyGetFun>(result_type().cell_type(), function(), inplace());
+    auto op = typify_invoke<3,MyTypify,MyGetFun>(child().result_type().cell_type(), function(), inplace());
     static_assert(sizeof(uint64_t) == sizeof(function()));
     return Instruction(op, (uint64_t)(function()));
 }
@@ -17,7 +17,10 @@ public:
                            const TensorFunction &child,
                            map_fun_t function_in);
     ~DenseSimpleMapFunction() override;
-    bool inplace() const { return child().result_is_mutable(); }
+    bool inplace() const {
+        return (child().result_is_mutable() &&
+                (result_type().cell_type() == child().result_type().cell_type()));
+    }
     eval::InterpretedFunction::Instruction compile_self(const eval::TensorEngine &engine, Stash &stash) const override;
     static const eval::TensorFunction &optimize(const eval::TensorFunction &expr, Stash &stash);
 };
@@ -42,27 +42,28 @@ struct Params {
     }
 };
 
-template <typename CT, typename AGGR>
-CT reduce_cells(const CT *src, size_t dim_size, size_t stride, AGGR &aggr) {
-    aggr.first(*src);
+template <typename ICT, typename OCT, typename AGGR>
+OCT reduce_cells(const ICT *src, size_t dim_size, size_t stride, AGGR &aggr) {
+    aggr.first(OCT(*src));
     for (size_t i = 1; i < dim_size; ++i) {
         src += stride;
-        aggr.next(*src);
+        aggr.next(OCT(*src));
     }
     return aggr.result();
 }
 
-template <typename CT, typename AGGR>
+template <typename ICT, typename AGGR>
 void my_single_reduce_op(InterpretedFunction::State &state, uint64_t param) {
+    using OCT = typename eval::DecayCellType<ICT>::type;
     const auto &params = *(const Params *)(param);
-    const CT *src = DenseTensorView::typify_cells<CT>(state.peek(0)).cbegin();
-    auto dst_cells = state.stash.create_array<CT>(params.outer_size * params.inner_size);
+    const ICT *src = DenseTensorView::typify_cells<ICT>(state.peek(0)).cbegin();
+    auto dst_cells = state.stash.create_array<OCT>(params.outer_size * params.inner_size);
     AGGR aggr;
-    CT *dst = dst_cells.begin();
+    OCT *dst = dst_cells.begin();
     const size_t block_size = (params.dim_size * params.inner_size);
     for (size_t outer = 0; outer < params.outer_size; ++outer) {
         for (size_t inner = 0; inner < params.inner_size; ++inner) {
-            *dst++ = reduce_cells<CT, AGGR>(src + inner, params.dim_size, params.inner_size, aggr);
+            *dst++ = reduce_cells<ICT, OCT, AGGR>(src + inner, params.dim_size, params.inner_size, aggr);
         }
         src += block_size;
     }
@@ -71,16 +72,13 @@ void my_single_reduce_op(InterpretedFunction::State &state, uint64_t param) {
 
 struct MyGetFun {
     template <typename R1, typename R2> static auto invoke() {
-        return my_single_reduce_op<R1, typename R2::template templ<R1>>;
+        using OCT = typename eval::DecayCellType<R1>::type;
+        return my_single_reduce_op<R1, typename R2::template templ<OCT>>;
     }
 };
 
 using MyTypify = TypifyValue<TypifyCellType,TypifyAggr>;
 
-bool check_input_type(const ValueType &type) {
-    return (type.is_dense() && ((type.cell_type() == CellType::FLOAT) || (type.cell_type() == CellType::DOUBLE)));
-}
-
 } // namespace vespalib::tensor::<unnamed>
 
 DenseSingleReduceFunction::DenseSingleReduceFunction(const ValueType &result_type,
@@ -97,7 +95,7 @@ DenseSingleReduceFunction::~DenseSingleReduceFunction() = default;
 InterpretedFunction::Instruction
 DenseSingleReduceFunction::compile_self(const TensorEngine &, Stash &stash) const
 {
-    auto op = typify_invoke<2,MyTypify,MyGetFun>(result_type().cell_type(), _aggr);
+    auto op = typify_invoke<2,MyTypify,MyGetFun>(child().result_type().cell_type(), _aggr);
     auto &params = stash.create<Params>(result_type(), child().result_type(), _dim_idx);
     static_assert(sizeof(uint64_t) == sizeof(&params));
     return InterpretedFunction::Instruction(op, (uint64_t)&params);
@@ -108,12 +106,12 @@ DenseSingleReduceFunction::optimize(const TensorFunction &expr, Stash &stash)
 {
     auto reduce = as<Reduce>(expr);
     if (reduce && (reduce->dimensions().size() == 1) &&
-        check_input_type(reduce->child().result_type()) &&
+        reduce->child().result_type().is_dense() &&
         expr.result_type().is_dense())
     {
         size_t dim_idx = reduce->child().result_type().dimension_index(reduce->dimensions()[0]);
         assert(dim_idx != ValueType::Dimension::npos);
-        assert(expr.result_type().cell_type() == reduce->child().result_type().cell_type());
+        assert(expr.result_type().cell_type() == ValueType::decay_cell_type(reduce->child().result_type().cell_type()));
         return stash.create<DenseSingleReduceFunction>(expr.result_type(), reduce->child(), dim_idx, reduce->aggr());
     }
     return expr;
@@ -71,6 +71,8 @@ DenseTensor<CT>::operator==(const DenseTensor<RCT> &rhs) const
 }
 
 template class DenseTensor<float>;
+template class DenseTensor<BFloat16>;
+template class DenseTensor<int8_t>;
 template class DenseTensor<double>;
 
 }
@@ -3,6 +3,7 @@
 #include "dense_tensor_modify.h"
 #include "dense_tensor_address_mapper.h"
 #include "dense_tensor.h"
+#include <vespa/eval/tensor/cell_values.h>
 
 namespace vespalib::tensor {
 
@@ -36,7 +37,51 @@ DenseTensorModify<CT>::build()
     return std::make_unique<DenseTensor<CT>>(_type, std::move(_cells));
 }
 
+namespace {
+
+template <class CT>
+class InPlaceModifier : public TensorVisitor
+{
+    using join_fun_t = Tensor::join_fun_t;
+    join_fun_t             _op;
+    const eval::ValueType &_type;
+    CT                    *_cells;
+
+public:
+    InPlaceModifier(join_fun_t op, const eval::ValueType &type, CT *cells)
+        : _op(op), _type(type), _cells(cells) {}
+    void visit(const TensorAddress &address, double value) override {
+        uint32_t idx = DenseTensorAddressMapper::mapAddressToIndex(address, _type);
+        if (idx != DenseTensorAddressMapper::BAD_ADDRESS) {
+            _cells[idx] = (CT) _op(_cells[idx], value);
+        }
+    }
+};
+
+template <class CT>
+void modify_in_place(Tensor::join_fun_t op, const eval::ValueType &type, void *cells, const CellValues &cellValues) {
+    InPlaceModifier<CT> modifier(op, type, static_cast<CT *>(cells));
+    cellValues.accept(modifier);
+}
+
+}
+
+void
+modify_dense_cells_in_place(Tensor::join_fun_t op, const eval::ValueType &type, void *cells,
+                            const CellValues &cellValues)
+{
+    switch (type.cell_type()) {
+    case eval::ValueType::CellType::DOUBLE:   return modify_in_place<double>(op, type, cells, cellValues);
+    case eval::ValueType::CellType::FLOAT:    return modify_in_place<float>(op, type, cells, cellValues);
+    case eval::ValueType::CellType::BFLOAT16: return modify_in_place<BFloat16>(op, type, cells, cellValues);
+    case eval::ValueType::CellType::INT8:     return modify_in_place<int8_t>(op, type, cells, cellValues);
+    }
+    abort();
+}
+
 template class DenseTensorModify<float>;
+template class DenseTensorModify<BFloat16>;
+template class DenseTensorModify<int8_t>;
 template class DenseTensorModify<double>;
 
 } // namespace
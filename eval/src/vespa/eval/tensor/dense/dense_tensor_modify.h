@@ -7,6 +7,8 @@
 
 namespace vespalib::tensor {
 
+class CellValues;
+
 /*
  * This class handles tensor modify update on a dense tensor.
  * For all cells visited, a join function is applied to determine
@@ -27,4 +29,13 @@ public:
     std::unique_ptr<Tensor> build();
 };
 
+/*
+ * Apply a tensor modify update directly to the cells of a dense
+ * tensor with the given type, typically a fresh copy of the cells
+ * stored in a tensor attribute that is not yet visible to readers.
+ * Cell addresses not matching the type are ignored.
+ */
+void modify_dense_cells_in_place(Tensor::join_fun_t op, const eval::ValueType &type, void *cells,
+                                 const CellValues &cellValues);
+
 }
@@ -379,10 +379,12 @@ Onnx::EvalContext::convert_result(EvalContext &self, size_t idx)
     }
 }
 
+// selected by onnx element type, since cell types without a matching
+// element type (like bfloat16) are always converted
 struct Onnx::EvalContext::SelectAdaptParam {
     template <typename ...Ts> static auto invoke() { return adapt_param<Ts...>; }
-    auto operator()(eval::ValueType::CellType ct) {
-        return typify_invoke<1,MyTypify,SelectAdaptParam>(ct);
+    auto operator()(Onnx::ElementType et) {
+        return typify_invoke<1,MyTypify,SelectAdaptParam>(et);
     }
 };
 
@@ -425,7 +427,7 @@ Onnx::EvalContext::EvalContext(const Onnx &model, const WireInfo &wire_info)
         const auto &onnx = _wire_info.onnx_inputs[i];
         if (is_same_type(vespa.cell_type(), onnx.elements)) {
             _param_values.push_back(Ort::Value(nullptr));
-            _param_binders.push_back(SelectAdaptParam()(vespa.cell_type()));
+            _param_binders.push_back(SelectAdaptParam()(onnx.elements));
         } else {
             _param_values.push_back(CreateOnnxTensor()(onnx, _alloc));
             _param_binders.push_back(SelectConvertParam()(vespa.cell_type(), onnx.elements));
@@ -475,6 +477,166 @@ Onnx::EvalContext::get_result(size_t i) const
 
 //-----------------------------------------------------------------------------
 
+namespace {
+
+struct ElementSize {
+    template <typename T> static size_t invoke() { return sizeof(T); }
+};
+
+struct CopyBatchParam {
+    template <typename SRC, typename DST> static void copy(const eval::Value &param, void *dst_in) {
+        auto cells = static_cast<const DenseTensorView &>(param).cellsRef().typify<SRC>();
+        DST *dst = static_cast<DST *>(dst_in);
+        for (size_t i = 0; i < cells.size(); ++i) {
+            dst[i] = DST(cells[i]);
+        }
+    }
+    template <typename SRC, typename DST> static auto invoke() { return copy<SRC,DST>; }
+};
+
+struct ConvertBatchResult {
+    template <typename SRC, typename DST> static void convert(const void *src_in, void *dst_in, size_t n) {
+        const SRC *src = static_cast<const SRC *>(src_in);
+        DST *dst = static_cast<DST *>(dst_in);
+        for (size_t i = 0; i < n; ++i) {
+            dst[i] = DST(src[i]);
+        }
+    }
+    template <typename SRC, typename DST> static auto invoke() { return convert<SRC,DST>; }
+};
+
+struct MakeBatchValue {
+    template <typename T> static Ort::Value make(Ort::MemoryInfo &memory, void *data, const std::vector<int64_t> &shape) {
+        size_t num_cells = 1;
+        for (int64_t size: shape) {
+            num_cells *= size;
+        }
+        return Ort::Value::CreateTensor<T>(memory, static_cast<T *>(data), num_cells, shape.data(), shape.size());
+    }
+    template <typename T> static auto invoke() { return make<T>; }
+};
+
+bool has_batch_dimension(const Onnx::TensorInfo &info, const Onnx::TensorType &type) {
+    return (!info.dimensions.empty() && !info.dimensions[0].is_known() &&
+            !type.dimensions.empty() && (type.dimensions[0] == 1));
+}
+
+size_t row_size(const Onnx::TensorType &type) {
+    size_t size = 1;
+    for (size_t i = 1; i < type.dimensions.size(); ++i) {
+        size *= type.dimensions[i];
+    }
+    return size;
+}
+
+} // namespace <unnamed>
+
+bool
+Onnx::BatchEvalContext::can_batch(const Onnx &model, const WireInfo &wire_info)
+{
+    for (size_t i = 0; i < model.inputs().size(); ++i) {
+        if (!has_batch_dimension(model.inputs()[i], wire_info.onnx_inputs[i])) {
+            return false;
+        }
+    }
+    for (size_t i = 0; i < model.outputs().size(); ++i) {
+        if (!has_batch_dimension(model.outputs()[i], wire_info.onnx_outputs[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+Onnx::BatchEvalContext::BatchEvalContext(const Onnx &model, const WireInfo &wire_info, size_t max_batch_size)
+    : _model(model),
+      _wire_info(wire_info),
+      _max_batch_size(max_batch_size),
+      _cpu_memory(Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault)),
+      _params(),
+      _param_binders(),
+      _outputs(),
+      _converted(),
+      _result_converters(),
+      _results()
+{
+    assert(can_batch(_model, _wire_info));
+    assert(_max_batch_size > 0);
+    auto make_buffer = [this](const Onnx::TensorType &type) {
+        size_t elem_size = typify_invoke<1,MyTypify,ElementSize>(type.elements);
+        size_t rows = row_size(type);
+        return Buffer{type.dimensions, rows, elem_size,
+                      std::vector<char>(_max_batch_size * rows * elem_size),
+                      typify_invoke<1,MyTypify,MakeBatchValue>(type.elements)};
+    };
+    for (size_t i = 0; i < _model.inputs().size(); ++i) {
+        const auto &vespa = _wire_info.vespa_inputs[i];
+        const auto &onnx = _wire_info.onnx_inputs[i];
+        _params.push_back(make_buffer(onnx));
+        _param_binders.push_back(typify_invoke<2,MyTypify,CopyBatchParam>(vespa.cell_type(), onnx.elements));
+    }
+    for (size_t i = 0; i < _model.outputs().size(); ++i) {
+        const auto &vespa = _wire_info.vespa_outputs[i];
+        const auto &onnx = _wire_info.onnx_outputs[i];
+        _outputs.push_back(make_buffer(onnx));
+        if (is_same_type(vespa.cell_type(), onnx.elements)) {
+            _converted.emplace_back();
+            _result_converters.push_back(nullptr);
+        } else {
+            size_t cell_size = typify_invoke<1,MyTypify,ElementSize>(vespa.cell_type());
+            _converted.emplace_back(_max_batch_size * _outputs.back().row_size * cell_size);
+            _result_converters.push_back(typify_invoke<2,MyTypify,ConvertBatchResult>(onnx.elements, vespa.cell_type()));
+        }
+    }
+    for (size_t b = 0; b < _max_batch_size; ++b) {
+        for (size_t i = 0; i < _outputs.size(); ++i) {
+            const auto &vespa = _wire_info.vespa_outputs[i];
+            const auto &output = _outputs[i];
+            const char *base = _converted[i].empty() ? output.data.data() : _converted[i].data();
+            size_t cell_size = typify_invoke<1,MyTypify,ElementSize>(vespa.cell_type());
+            TypedCells cells(base + (b * output.row_size * cell_size), vespa.cell_type(), output.row_size);
+            _results.push_back(std::make_unique<DenseTensorView>(vespa, cells));
+        }
+    }
+}
+
+Onnx::BatchEvalContext::~BatchEvalContext() = default;
+
+void
+Onnx::BatchEvalContext::bind_param(size_t batch_idx, size_t i, const eval::Value &param)
+{
+    assert(batch_idx < _max_batch_size);
+    auto &param_buf = _params[i];
+    _param_binders[i](param, param_buf.data.data() + (batch_idx * param_buf.row_size * param_buf.elem_size));
+}
+
+void
+Onnx::BatchEvalContext::eval(size_t batch_size)
+{
+    assert((batch_size > 0) && (batch_size <= _max_batch_size));
+    std::vector<Ort::Value> param_values;
+    std::vector<Ort::Value> result_values;
+    for (auto &buf: _params) {
+        buf.shape[0] = batch_size;
+        param_values.push_back(buf.make_value(_cpu_memory, buf.data.data(), buf.shape));
+    }
+    for (auto &buf: _outputs) {
+        buf.shape[0] = batch_size;
+        result_values.push_back(buf.make_value(_cpu_memory, buf.data.data(), buf.shape));
+    }
+    Ort::Session &session = const_cast<Ort::Session&>(_model._session);
+    Ort::RunOptions run_opts(nullptr);
+    session.Run(run_opts,
+                _model._input_name_refs.data(), param_values.data(), param_values.size(),
+                _model._output_name_refs.data(), result_values.data(), result_values.size());
+    for (size_t i = 0; i < _outputs.size(); ++i) {
+        if (_result_converters[i] != nullptr) {
+            _result_converters[i](_outputs[i].data.data(), _converted[i].data(), batch_size * _outputs[i].row_size);
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+
 Onnx::Shared::Shared()
     : _env(ORT_LOGGING_LEVEL_WARNING, "vespa-onnx-wrapper")
 {
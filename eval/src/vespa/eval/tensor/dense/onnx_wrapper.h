@@ -135,6 +135,53 @@ public:
         const eval::Value &get_result(size_t i) const;
     };
 
+    // evaluation context used to run the model once for a batch of
+    // independent input sets (typically one per document). This is
+    // only possible if the leading dimension of all model inputs and
+    // outputs is unknown or symbolic and the wire plan binds it to
+    // size 1 (see 'can_batch'). Parameters are copied into batch
+    // buffers when bound, and each result is a view of its own slice
+    // of the batched outputs that stays valid until the next eval.
+    class BatchEvalContext {
+    private:
+        using param_fun_t = void (*)(const eval::Value &, void *);
+        using result_fun_t = void (*)(const void *, void *, size_t);
+        using value_fun_t = Ort::Value (*)(Ort::MemoryInfo &, void *, const std::vector<int64_t> &);
+
+        struct Buffer {
+            std::vector<int64_t> shape;
+            size_t               row_size;
+            size_t               elem_size;
+            std::vector<char>    data;
+            value_fun_t          make_value;
+        };
+
+        const Onnx                       &_model;
+        const WireInfo                   &_wire_info;
+        size_t                            _max_batch_size;
+        Ort::MemoryInfo                   _cpu_memory;
+        std::vector<Buffer>               _params;
+        std::vector<param_fun_t>          _param_binders;
+        std::vector<Buffer>               _outputs;
+        std::vector<std::vector<char>>    _converted;
+        std::vector<result_fun_t>         _result_converters;
+        std::vector<eval::Value::UP>      _results; // [batch_idx * num_results + i]
+
+    public:
+        static bool can_batch(const Onnx &model, const WireInfo &wire_info);
+
+        BatchEvalContext(const Onnx &model, const WireInfo &wire_info, size_t max_batch_size);
+        ~BatchEvalContext();
+        size_t max_batch_size() const { return _max_batch_size; }
+        size_t num_params() const { return _params.size(); }
+        size_t num_results() const { return _outputs.size(); }
+        void bind_param(size_t batch_idx, size_t i, const eval::Value &param);
+        void eval(size_t batch_size);
+        const eval::Value &get_result(size_t batch_idx, size_t i) const {
+            return *_results[batch_idx * _outputs.size() + i];
+        }
+    };
+
 private:
     // common stuff shared between model sessions
     class Shared {
@@ -11,6 +11,7 @@ namespace vespalib::tensor {
 // Low-level typed cells reference
 
 using CellType = vespalib::eval::ValueType::CellType;
+using vespalib::BFloat16;
 
 struct TypedCells {
     const void *data;
@@ -19,6 +20,8 @@ struct TypedCells {
 
     explicit TypedCells(ConstArrayRef<double> cells) : data(cells.begin()), type(CellType::DOUBLE), size(cells.size()) {}
     explicit TypedCells(ConstArrayRef<float> cells) : data(cells.begin()), type(CellType::FLOAT), size(cells.size()) {}
+    explicit TypedCells(ConstArrayRef<BFloat16> cells) : data(cells.begin()), type(CellType::BFLOAT16), size(cells.size()) {}
+    explicit TypedCells(ConstArrayRef<int8_t> cells) : data(cells.begin()), type(CellType::INT8), size(cells.size()) {}
 
     TypedCells() : data(nullptr), type(CellType::DOUBLE), size(0) {}
     TypedCells(const void *dp, CellType ct, size_t sz) : data(dp), type(ct), size(sz) {}
@@ -33,13 +36,11 @@ struct TypedCells {
     }
 
     double get(size_t idx) const {
-        if (type == CellType::DOUBLE) {
-            const double *p = (const double *)data;
-            return p[idx];
-        }
-        if (type == CellType::FLOAT) {
-            const float *p = (const float *)data;
-            return p[idx];
+        switch (type) {
+        case CellType::DOUBLE: return ((const double *)data)[idx];
+        case CellType::FLOAT: return ((const float *)data)[idx];
+        case CellType::BFLOAT16: return ((const BFloat16 *)data)[idx];
+        case CellType::INT8: return ((const int8_t *)data)[idx];
         }
         abort();
     }
@@ -55,6 +56,8 @@ decltype(auto) dispatch_1(const TypedCells &a, Args &&...args) {
     switch (a.type) {
         case CellType::DOUBLE: return TGT::call(a.unsafe_typify<double>(), std::forward<Args>(args)...);
         case CellType::FLOAT:  return TGT::call(a.unsafe_typify<float>(),  std::forward<Args>(args)...);
+        case CellType::BFLOAT16: return TGT::call(a.unsafe_typify<BFloat16>(), std::forward<Args>(args)...);
+        case CellType::INT8:   return TGT::call(a.unsafe_typify<int8_t>(), std::forward<Args>(args)...);
     }
     abort();
 }
@@ -64,6 +67,8 @@ decltype(auto) dispatch_2(A1 &&a, const TypedCells &b, Args &&...args) {
     switch (b.type) {
         case CellType::DOUBLE: return dispatch_1<TGT>(std::forward<A1>(a), b.unsafe_typify<double>(), std::forward<Args>(args)...);
         case CellType::FLOAT:  return dispatch_1<TGT>(std::forward<A1>(a), b.unsafe_typify<float>(),  std::forward<Args>(args)...);
+        case CellType::BFLOAT16: return dispatch_1<TGT>(std::forward<A1>(a), b.unsafe_typify<BFloat16>(), std::forward<Args>(args)...);
+        case CellType::INT8:   return dispatch_1<TGT>(std::forward<A1>(a), b.unsafe_typify<int8_t>(), std::forward<Args>(args)...);
     }
     abort();
 }
@@ -42,5 +42,7 @@ TypedDenseTensorBuilder<CT>::build()
 
 template class TypedDenseTensorBuilder<double>;
 template class TypedDenseTensorBuilder<float>;
+template class TypedDenseTensorBuilder<BFloat16>;
+template class TypedDenseTensorBuilder<int8_t>;
 
 } // namespace
@@ -0,0 +1,675 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "mixed_tensor.h"
+#include "mixed_tensor_builder.h"
+#include <vespa/eval/tensor/cell_values.h>
+#include <vespa/eval/tensor/tensor_address_builder.h>
+#include <vespa/eval/tensor/tensor_address_element_iterator.h>
+#include <vespa/eval/tensor/tensor_visitor.h>
+#include <vespa/eval/tensor/dense/dense_tensor_view.h>
+#include <vespa/eval/tensor/sparse/sparse_tensor.h>
+#include <vespa/eval/tensor/sparse/sparse_tensor_address_builder.h>
+#include <vespa/eval/tensor/sparse/sparse_tensor_address_combiner.h>
+#include <vespa/eval/tensor/sparse/sparse_tensor_address_decoder.h>
+#include <vespa/eval/tensor/sparse/sparse_tensor_address_reducer.h>
+#include <vespa/eval/tensor/sparse/sparse_tensor_label_mapper.h>
+#include <vespa/vespalib/stllike/hash_map.hpp>
+#include <vespa/vespalib/stllike/hash_set.h>
+#include <vespa/vespalib/util/stringfmt.h>
+#include <cassert>
+
+namespace vespalib::tensor {
+
+using eval::TensorSpec;
+using eval::ValueType;
+
+namespace {
+
+using Index = MixedTensor::Index;
+
+constexpr size_t BAD_OFFSET = std::numeric_limits<size_t>::max();
+
+void
+copy_index(Index &index, const Index &index_in, Stash &stash)
+{
+    // copy the hashtable structure and make the keys point to our
+    // own copy of the addresses
+    index = index_in;
+    for (auto &entry: index) {
+        SparseTensorAddressRef old_ref = entry.first;
+        SparseTensorAddressRef new_ref(old_ref, stash);
+        entry.first = new_ref;
+    }
+}
+
+std::vector<vespalib::string>
+dimension_names(const ValueType &type)
+{
+    std::vector<vespalib::string> result;
+    for (const auto &dim: type.dimensions()) {
+        result.push_back(dim.name);
+    }
+    return result;
+}
+
+std::vector<vespalib::string>
+dimensions_not_in(const ValueType &type, const ValueType &other)
+{
+    std::vector<vespalib::string> result;
+    for (const auto &dim: type.dimensions()) {
+        if (other.dimension_index(dim.name) == ValueType::Dimension::npos) {
+            result.push_back(dim.name);
+        }
+    }
+    return result;
+}
+
+/**
+ * For each cell in a dense subspace of type 'outer', calculate the
+ * offset of the corresponding cell in a dense subspace of type
+ * 'inner'. All dimensions of 'inner' must also be in 'outer'.
+ **/
+std::vector<uint32_t>
+map_dense_offsets(const ValueType &outer, const ValueType &inner)
+{
+    const auto &dims = outer.dimensions();
+    std::vector<size_t> inner_stride(dims.size(), 0);
+    size_t stride = 1;
+    for (size_t i = inner.dimensions().size(); i-- > 0; ) {
+        const auto &dim = inner.dimensions()[i];
+        size_t outer_idx = outer.dimension_index(dim.name);
+        assert(outer_idx != ValueType::Dimension::npos);
+        inner_stride[outer_idx] = stride;
+        stride *= dim.size;
+    }
+    size_t outer_size = outer.dense_subspace_size();
+    std::vector<uint32_t> result;
+    result.reserve(outer_size);
+    std::vector<size_t> idx(dims.size(), 0);
+    size_t offset = 0;
+    for (size_t i = 0; i < outer_size; ++i) {
+        result.push_back(offset);
+        for (size_t d = dims.size(); d-- > 0; ) {
+            offset += inner_stride[d];
+            if (++idx[d] < dims[d].size) {
+                break;
+            }
+            offset -= (inner_stride[d] * dims[d].size);
+            idx[d] = 0;
+        }
+    }
+    return result;
+}
+
+/**
+ * Visit all cells in a tensor with their full address (indexed
+ * labels are given by their position in the dense subspace).
+ **/
+template <typename F>
+void for_each_cell(const MixedTensor &tensor, F &&f) {
+    const auto &dims = tensor.fast_type().dimensions();
+    std::vector<vespalib::stringref> labels(dims.size());
+    std::vector<size_t> idx(dims.size(), 0);
+    for (const auto &entry: tensor.index()) {
+        SparseTensorAddressDecoder decoder(entry.first);
+        for (size_t d = 0; d < dims.size(); ++d) {
+            idx[d] = 0;
+            if (dims[d].is_mapped()) {
+                labels[d] = decoder.decodeLabel(tensor.labels());
+            }
+        }
+        assert(!decoder.valid());
+        auto cells = tensor.subspace(entry.second);
+        for (double value: cells) {
+            f(labels, idx, value);
+            for (size_t d = dims.size(); d-- > 0; ) {
+                if (dims[d].is_indexed()) {
+                    if (++idx[d] < dims[d].size) {
+                        break;
+                    }
+                    idx[d] = 0;
+                }
+            }
+        }
+    }
+}
+
+/**
+ * Look up an address using the label ids of another tensor in the
+ * index of the given tensor. Returns nullptr if there is no such
+ * subspace.
+ **/
+const uint32_t *
+find_mapped(const MixedTensor &tensor, SparseTensorLabelMapper &mapper,
+            SparseTensorAddressRef address, SparseTensorAddressBuilder &tmp)
+{
+    if (!mapper.identity()) {
+        if (!mapper.map_address(address, tmp)) {
+            return nullptr;
+        }
+        address = tmp.getAddressRef();
+    }
+    auto pos = tensor.index().find(address);
+    return (pos != tensor.index().end()) ? &pos->second : nullptr;
+}
+
+struct SubspaceJoiner {
+    const MixedTensor &lhs;
+    const MixedTensor &rhs;
+    Tensor::join_fun_t function;
+    std::vector<uint32_t> lhs_offsets;
+    std::vector<uint32_t> rhs_offsets;
+    SubspaceJoiner(const ValueType &type, const MixedTensor &lhs_in, const MixedTensor &rhs_in,
+                   Tensor::join_fun_t function_in)
+        : lhs(lhs_in), rhs(rhs_in), function(function_in),
+          lhs_offsets(map_dense_offsets(MixedTensor::dense_type_of(type), lhs.dense_type())),
+          rhs_offsets(map_dense_offsets(MixedTensor::dense_type_of(type), rhs.dense_type()))
+    {}
+    void join(MixedTensorBuilder &builder, SparseTensorAddressRef address, uint32_t lhs_idx, uint32_t rhs_idx) const {
+        auto lhs_cells = lhs.subspace(lhs_idx);
+        auto rhs_cells = rhs.subspace(rhs_idx);
+        auto dst = builder.add_subspace(address);
+        for (size_t i = 0; i < dst.size(); ++i) {
+            dst[i] = function(lhs_cells[lhs_offsets[i]], rhs_cells[rhs_offsets[i]]);
+        }
+    }
+};
+
+Tensor::UP
+join_tensors(const MixedTensor &lhs, const MixedTensor &rhs, Tensor::join_fun_t function)
+{
+    ValueType type = ValueType::join(lhs.fast_type(), rhs.fast_type());
+    SubspaceJoiner joiner(type, lhs, rhs, function);
+    sparse::TensorAddressCombiner combiner(lhs.sparse_type(), rhs.sparse_type());
+    SparseTensorAddressBuilder tmp;
+    size_t overlap = combiner.numOverlappingDimensions();
+    if (overlap == rhs.sparse_type().dimensions().size()) {
+        // all mapped dimensions of rhs are also in lhs: look up the
+        // matching rhs subspace for each lhs subspace
+        MixedTensorBuilder builder(type, lhs.shared_labels());
+        builder.reserve(lhs.num_subspaces());
+        SparseTensorLabelMapper mapper(lhs.labels(), rhs.labels());
+        sparse::TensorAddressReducer projector(lhs.sparse_type(), dimensions_not_in(lhs.sparse_type(), rhs.sparse_type()));
+        for (const auto &lhs_entry: lhs.index()) {
+            projector.reduce(lhs_entry.first);
+            if (const uint32_t *rhs_idx = find_mapped(rhs, mapper, projector.getAddressRef(), tmp)) {
+                joiner.join(builder, lhs_entry.first, lhs_entry.second, *rhs_idx);
+            }
+        }
+        return builder.build();
+    } else if (overlap == lhs.sparse_type().dimensions().size()) {
+        MixedTensorBuilder builder(type, rhs.shared_labels());
+        builder.reserve(rhs.num_subspaces());
+        SparseTensorLabelMapper mapper(rhs.labels(), lhs.labels());
+        sparse::TensorAddressReducer projector(rhs.sparse_type(), dimensions_not_in(rhs.sparse_type(), lhs.sparse_type()));
+        for (const auto &rhs_entry: rhs.index()) {
+            projector.reduce(rhs_entry.first);
+            if (const uint32_t *lhs_idx = find_mapped(lhs, mapper, projector.getAddressRef(), tmp)) {
+                joiner.join(builder, rhs_entry.first, *lhs_idx, rhs_entry.second);
+            }
+        }
+        return builder.build();
+    } else if (lhs.same_labels(rhs)) {
+        MixedTensorBuilder builder(type, lhs.shared_labels());
+        for (const auto &lhs_entry: lhs.index()) {
+            for (const auto &rhs_entry: rhs.index()) {
+                if (combiner.combine(lhs_entry.first, rhs_entry.first)) {
+                    joiner.join(builder, combiner.getAddressRef(), lhs_entry.second, rhs_entry.second);
+                }
+            }
+        }
+        return builder.build();
+    }
+    // enumerate the labels of both tensors in the current repo
+    MixedTensorBuilder builder(type);
+    SparseTensorLabelMapper lhs_mapper(lhs.labels(), builder.labels());
+    SparseTensorLabelMapper rhs_mapper(rhs.labels(), builder.labels());
+    for (const auto &lhs_entry: lhs.index()) {
+        for (const auto &rhs_entry: rhs.index()) {
+            if (combiner.combine(lhs_entry.first, rhs_entry.first, lhs_mapper, rhs_mapper)) {
+                joiner.join(builder, combiner.getAddressRef(), lhs_entry.second, rhs_entry.second);
+            }
+        }
+    }
+    return builder.build();
+}
+
+struct MixedTensorModify : TensorVisitor {
+    const MixedTensor &tensor;
+    Tensor::join_fun_t op;
+    std::vector<double> &cells;
+    SparseTensorAddressBuilder address_builder;
+    MixedTensorModify(const MixedTensor &tensor_in, Tensor::join_fun_t op_in, std::vector<double> &cells_in)
+        : tensor(tensor_in), op(op_in), cells(cells_in), address_builder() {}
+    void visit(const TensorAddress &address, double value) override;
+};
+
+struct MixedTensorRemove : TensorVisitor {
+    const MixedTensor &tensor;
+    Index &index;
+    SparseTensorAddressBuilder address_builder;
+    MixedTensorRemove(const MixedTensor &tensor_in, Index &index_in)
+        : tensor(tensor_in), index(index_in), address_builder() {}
+    void visit(const TensorAddress &address, double) override {
+        if (address_builder.populate(tensor.sparse_type(), address, tensor.labels())) {
+            index.erase(address_builder.getAddressRef());
+        }
+    }
+};
+
+} // namespace vespalib::tensor::<unnamed>
+
+MixedTensor::MixedTensor(const ValueType &type_in, Index &&index_in, std::vector<double> &&cells_in, Stash &&stash_in,
+                         SparseTensorLabelRepo::SP labels_in)
+    : _type(type_in),
+      _sparse_type(sparse_type_of(type_in)),
+      _dense_type(dense_type_of(type_in)),
+      _subspace_size(type_in.dense_subspace_size()),
+      _index(std::move(index_in)),
+      _cells(std::move(cells_in)),
+      _stash(std::move(stash_in)),
+      _labels(std::move(labels_in))
+{
+    assert(_cells.size() == (_index.size() * _subspace_size));
+}
+
+MixedTensor::~MixedTensor() = default;
+
+ValueType
+MixedTensor::sparse_type_of(const ValueType &type)
+{
+    std::vector<ValueType::Dimension> dimensions;
+    for (const auto &dim: type.dimensions()) {
+        if (dim.is_mapped()) {
+            dimensions.push_back(dim);
+        }
+    }
+    return ValueType::tensor_type(std::move(dimensions), type.cell_type());
+}
+
+ValueType
+MixedTensor::dense_type_of(const ValueType &type)
+{
+    std::vector<ValueType::Dimension> dimensions;
+    for (const auto &dim: type.dimensions()) {
+        if (dim.is_indexed()) {
+            dimensions.push_back(dim);
+        }
+    }
+    return ValueType::tensor_type(std::move(dimensions), type.cell_type());
+}
+
+struct CallCopyDenseCells {
+    template <typename CT>
+    static void call(const ConstArrayRef<CT> &src, ArrayRef<double> dst) {
+        for (size_t i = 0; i < src.size(); ++i) {
+            dst[i] = src[i];
+        }
+    }
+};
+
+std::unique_ptr<MixedTensor>
+MixedTensor::from_tensor(const Tensor &tensor)
+{
+    if (auto mixed = dynamic_cast<const MixedTensor *>(&tensor)) {
+        return std::unique_ptr<MixedTensor>(static_cast<MixedTensor *>(mixed->clone().release()));
+    }
+    if (auto sparse = dynamic_cast<const SparseTensor *>(&tensor)) {
+        // sparse addresses are kept as-is, so share the label repo
+        MixedTensorBuilder builder(tensor.type(), sparse->shared_labels());
+        builder.reserve(sparse->cells().size());
+        for (const auto &cell: sparse->cells()) {
+            builder.add_subspace(cell.first)[0] = cell.second;
+        }
+        return builder.build_mixed();
+    }
+    MixedTensorBuilder builder(tensor.type());
+    if (auto dense = dynamic_cast<const DenseTensorView *>(&tensor)) {
+        dispatch_1<CallCopyDenseCells>(dense->cellsRef(), builder.add_subspace(SparseTensorAddressRef("", 0)));
+    } else {
+        for (const auto &cell: tensor.toSpec().cells()) {
+            bool ok = builder.set_cell(cell.first, cell.second);
+            assert(ok);
+            (void) ok;
+        }
+    }
+    return builder.build_mixed();
+}
+
+const double *
+MixedTensor::find_subspace(SparseTensorAddressRef address) const
+{
+    auto pos = _index.find(address);
+    if (pos == _index.end()) {
+        return nullptr;
+    }
+    return &_cells[pos->second * _subspace_size];
+}
+
+bool
+MixedTensor::operator==(const MixedTensor &rhs) const
+{
+    if ((_type != rhs._type) || (_index.size() != rhs._index.size())) {
+        return false;
+    }
+    SparseTensorLabelMapper mapper(labels(), rhs.labels());
+    SparseTensorAddressBuilder tmp;
+    for (const auto &entry: _index) {
+        const uint32_t *rhs_idx = find_mapped(rhs, mapper, entry.first, tmp);
+        if (rhs_idx == nullptr) {
+            return false;
+        }
+        auto cells = subspace(entry.second);
+        auto rhs_cells = rhs.subspace(*rhs_idx);
+        if (!std::equal(cells.begin(), cells.end(), rhs_cells.begin())) {
+            return false;
+        }
+    }
+    return true;
+}
+
+double
+MixedTensor::as_double() const
+{
+    double result = 0.0;
+    for (double value: _cells) {
+        result += value;
+    }
+    return result;
+}
+
+Tensor::UP
+MixedTensor::apply(const CellFunction &func) const
+{
+    Index index;
+    Stash stash(STASH_CHUNK_SIZE);
+    copy_index(index, _index, stash);
+    std::vector<double> cells;
+    cells.reserve(_cells.size());
+    for (double value: _cells) {
+        cells.push_back(func.apply(value));
+    }
+    return std::make_unique<MixedTensor>(_type.map(), std::move(index), std::move(cells), std::move(stash), _labels);
+}
+
+Tensor::UP
+MixedTensor::join(join_fun_t function, const Tensor &arg) const
+{
+    const MixedTensor *rhs = dynamic_cast<const MixedTensor *>(&arg);
+    if (!rhs) {
+        return Tensor::UP();
+    }
+    return join_tensors(*this, *rhs, function);
+}
+
+Tensor::UP
+MixedTensor::merge(join_fun_t function, const Tensor &arg) const
+{
+    const MixedTensor *rhs = dynamic_cast<const MixedTensor *>(&arg);
+    assert(rhs && (fast_type().dimensions() == rhs->fast_type().dimensions()));
+    if (!same_labels(*rhs)) {
+        // enumerate the labels of both tensors in the current repo
+        MixedTensorBuilder builder(ValueType::merge(fast_type(), rhs->fast_type()));
+        builder.reserve(num_subspaces() + rhs->num_subspaces());
+        SparseTensorLabelMapper lhs_mapper(labels(), builder.labels());
+        SparseTensorLabelMapper rhs_mapper(rhs->labels(), builder.labels());
+        SparseTensorAddressBuilder address;
+        for (const auto &entry: _index) {
+            lhs_mapper.map_address(entry.first, address);
+            auto cells = subspace(entry.second);
+            auto dst = builder.add_subspace(address.getAddressRef());
+            std::copy(cells.begin(), cells.end(), dst.begin());
+        }
+        for (const auto &entry: rhs->index()) {
+            rhs_mapper.map_address(entry.first, address);
+            auto cells = rhs->subspace(entry.second);
+            bool added;
+            auto dst = builder.add_subspace(address.getAddressRef(), added);
+            for (size_t i = 0; i < dst.size(); ++i) {
+                dst[i] = added ? cells[i] : function(dst[i], cells[i]);
+            }
+        }
+        return builder.build();
+    }
+    MixedTensorBuilder builder(ValueType::merge(fast_type(), rhs->fast_type()), _labels);
+    builder.reserve(num_subspaces() + rhs->num_subspaces());
+    for (const auto &entry: _index) {
+        auto cells = subspace(entry.second);
+        auto dst = builder.add_subspace(entry.first);
+        const double *rhs_cells = rhs->find_subspace(entry.first);
+        if (rhs_cells == nullptr) {
+            std::copy(cells.begin(), cells.end(), dst.begin());
+        } else {
+            for (size_t i = 0; i < dst.size(); ++i) {
+                dst[i] = function(cells[i], rhs_cells[i]);
+            }
+        }
+    }
+    for (const auto &entry: rhs->index()) {
+        if (_index.find(entry.first) == _index.end()) {
+            auto cells = rhs->subspace(entry.second);
+            auto dst = builder.add_subspace(entry.first);
+            std::copy(cells.begin(), cells.end(), dst.begin());
+        }
+    }
+    return builder.build();
+}
+
+Tensor::UP
+MixedTensor::reduce(join_fun_t op, const std::vector<vespalib::string> &dimensions) const
+{
+    MixedTensorBuilder builder(_type.reduce(dimensions), _labels);
+    auto out_offsets = map_dense_offsets(_dense_type, dense_type_of(builder.fast_type()));
+    // the first cell reduced into each result cell is used as-is
+    std::vector<bool> first(_subspace_size);
+    std::vector<bool> seen(builder.subspace_size(), false);
+    for (size_t i = 0; i < _subspace_size; ++i) {
+        first[i] = !seen[out_offsets[i]];
+        seen[out_offsets[i]] = true;
+    }
+    sparse::TensorAddressReducer reducer(_sparse_type, dimensions.empty() ? dimension_names(_sparse_type) : dimensions);
+    std::vector<double> tmp(builder.subspace_size(), 0.0);
+    for (const auto &entry: _index) {
+        auto cells = subspace(entry.second);
+        for (size_t i = 0; i < cells.size(); ++i) {
+            double &dst = tmp[out_offsets[i]];
+            dst = first[i] ? cells[i] : op(dst, cells[i]);
+        }
+        reducer.reduce(entry.first);
+        bool added;
+        auto dst = builder.add_subspace(reducer.getAddressRef(), added);
+        for (size_t i = 0; i < dst.size(); ++i) {
+            dst[i] = added ? tmp[i] : op(dst[i], tmp[i]);
+        }
+    }
+    return builder.build();
+}
+
+size_t
+MixedTensor::find_dense_offset(const TensorAddress &address) const
+{
+    TensorAddressElementIterator<TensorAddress> itr(address);
+    size_t offset = 0;
+    for (const auto &dim: _dense_type.dimensions()) {
+        if (!itr.skipToDimension(dim.name)) {
+            return BAD_OFFSET;
+        }
+        vespalib::string label = itr.label();
+        char *end = nullptr;
+        size_t idx = strtoul(label.c_str(), &end, 10);
+        if (label.empty() || (*end != '\0') || (idx >= dim.size)) {
+            return BAD_OFFSET;
+        }
+        offset = (offset * dim.size) + idx;
+    }
+    return offset;
+}
+
+void
+MixedTensorModify::visit(const TensorAddress &address, double value)
+{
+    size_t offset = tensor.find_dense_offset(address);
+    if (offset == BAD_OFFSET) {
+        return;
+    }
+    if (!address_builder.populate(tensor.sparse_type(), address, tensor.labels())) {
+        return;
+    }
+    auto pos = tensor.index().find(address_builder.getAddressRef());
+    if (pos != tensor.index().end()) {
+        double &cell = cells[(pos->second * tensor.subspace_size()) + offset];
+        cell = op(cell, value);
+    }
+}
+
+std::unique_ptr<Tensor>
+MixedTensor::modify(join_fun_t op, const CellValues &cellValues) const
+{
+    Index index;
+    Stash stash(STASH_CHUNK_SIZE);
+    copy_index(index, _index, stash);
+    std::vector<double> cells(_cells);
+    MixedTensorModify modifier(*this, op, cells);
+    cellValues.accept(modifier);
+    return std::make_unique<MixedTensor>(_type, std::move(index), std::move(cells), std::move(stash), _labels);
+}
+
+std::unique_ptr<Tensor>
+MixedTensor::add(const Tensor &arg) const
+{
+    const MixedTensor *rhs = dynamic_cast<const MixedTensor *>(&arg);
+    if (!rhs || (_type != rhs->_type)) {
+        return Tensor::UP();
+    }
+    if (!same_labels(*rhs)) {
+        // enumerate the labels of both tensors in the current repo
+        MixedTensorBuilder builder(_type);
+        builder.reserve(num_subspaces() + rhs->num_subspaces());
+        SparseTensorLabelMapper lhs_mapper(labels(), builder.labels());
+        SparseTensorLabelMapper rhs_mapper(rhs->labels(), builder.labels());
+        SparseTensorAddressBuilder address;
+        for (const auto &entry: _index) {
+            lhs_mapper.map_address(entry.first, address);
+            auto cells = subspace(entry.second);
+            auto dst = builder.add_subspace(address.getAddressRef());
+            std::copy(cells.begin(), cells.end(), dst.begin());
+        }
+        for (const auto &entry: rhs->index()) {
+            // overwrites the subspace from this tensor, if any
+            rhs_mapper.map_address(entry.first, address);
+            auto cells = rhs->subspace(entry.second);
+            auto dst = builder.add_subspace(address.getAddressRef());
+            std::copy(cells.begin(), cells.end(), dst.begin());
+        }
+        return builder.build_mixed();
+    }
+    MixedTensorBuilder builder(_type, _labels);
+    builder.reserve(num_subspaces() + rhs->num_subspaces());
+    for (const auto &entry: _index) {
+        if (rhs->index().find(entry.first) == rhs->index().end()) {
+            auto cells = subspace(entry.second);
+            auto dst = builder.add_subspace(entry.first);
+            std::copy(cells.begin(), cells.end(), dst.begin());
+        }
+    }
+    for (const auto &entry: rhs->index()) {
+        auto cells = rhs->subspace(entry.second);
+        auto dst = builder.add_subspace(entry.first);
+        std::copy(cells.begin(), cells.end(), dst.begin());
+    }
+    return builder.build_mixed();
+}
+
+std::unique_ptr<Tensor>
+MixedTensor::remove(const CellValues &cellAddresses) const
+{
+    Index to_keep;
+    Stash stash(STASH_CHUNK_SIZE);
+    copy_index(to_keep, _index, stash);
+    MixedTensorRemove remover(*this, to_keep);
+    cellAddresses.accept(remover);
+    MixedTensorBuilder builder(_type, _labels);
+    builder.reserve(to_keep.size());
+    for (const auto &entry: to_keep) {
+        auto cells = subspace(entry.second);
+        auto dst = builder.add_subspace(entry.first);
+        std::copy(cells.begin(), cells.end(), dst.begin());
+    }
+    return builder.build_mixed();
+}
+
+bool
+MixedTensor::equals(const Tensor &arg) const
+{
+    const MixedTensor *rhs = dynamic_cast<const MixedTensor *>(&arg);
+    if (!rhs) {
+        return false;
+    }
+    return *this == *rhs;
+}
+
+Tensor::UP
+MixedTensor::clone() const
+{
+    size_t mem_use = _stash.get_memory_usage().usedBytes();
+    Stash stash(std::min(STASH_CHUNK_SIZE, (mem_use + 63) & ~size_t(63)));
+    Index index;
+    copy_index(index, _index, stash);
+    std::vector<double> cells(_cells);
+    return std::make_unique<MixedTensor>(_type, std::move(index), std::move(cells), std::move(stash), _labels);
+}
+
+TensorSpec
+MixedTensor::toSpec() const
+{
+    TensorSpec result(_type.to_spec());
+    const auto &dims = _type.dimensions();
+    TensorSpec::Address address;
+    for_each_cell(*this, [&](const auto &labels, const auto &idx, double value)
+                  {
+                      address.clear();
+                      for (size_t d = 0; d < dims.size(); ++d) {
+                          if (dims[d].is_mapped()) {
+                              address.emplace(dims[d].name, TensorSpec::Label(vespalib::string(labels[d])));
+                          } else {
+                              address.emplace(dims[d].name, TensorSpec::Label(idx[d]));
+                          }
+                      }
+                      result.add(address, value);
+                  });
+    return result;
+}
+
+void
+MixedTensor::accept(TensorVisitor &visitor) const
+{
+    const auto &dims = _type.dimensions();
+    TensorAddressBuilder addr;
+    for_each_cell(*this, [&](const auto &labels, const auto &idx, double value)
+                  {
+                      addr.clear();
+                      for (size_t d = 0; d < dims.size(); ++d) {
+                          if (dims[d].is_mapped()) {
+                              addr.add(dims[d].name, labels[d]);
+                          } else {
+                              addr.add(dims[d].name, make_string("%zu", idx[d]));
+                          }
+                      }
+                      visitor.visit(addr.build(), value);
+                  });
+}
+
+MemoryUsage
+MixedTensor::get_memory_usage() const
+{
+    MemoryUsage result = _stash.get_memory_usage();
+    // the label repo is shared with other tensors and not included
+    size_t plus = sizeof(MixedTensor) + _index.getMemoryConsumption();
+    result.incUsedBytes(plus + (_cells.size() * sizeof(double)));
+    result.incAllocatedBytes(plus + (_cells.capacity() * sizeof(double)));
+    return result;
+}
+
+}
+
+VESPALIB_HASH_MAP_INSTANTIATE(vespalib::tensor::SparseTensorAddressRef, uint32_t);
@@ -0,0 +1,94 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include <vespa/eval/tensor/tensor.h>
+#include <vespa/eval/tensor/sparse/sparse_tensor_address_ref.h>
+#include <vespa/eval/tensor/sparse/sparse_tensor_label_repo.h>
+#include <vespa/vespalib/stllike/hash_map.h>
+#include <vespa/vespalib/util/arrayref.h>
+#include <vespa/vespalib/util/stash.h>
+
+namespace vespalib::tensor {
+
+/**
+ * A tensor implementation for tensors with both mapped and indexed
+ * dimensions. The labels of the mapped dimensions select a dense
+ * subspace spanned by all the indexed dimensions.
+ *
+ * Mapped addresses are kept in a hash index (using the same compact
+ * address encoding and per-tensor label repo as SparseTensor) that
+ * maps each address to its subspace number. The cells of all dense subspaces are stored
+ * contiguously; subspace 'n' owns the cells in the range
+ * [n * subspace_size, (n + 1) * subspace_size). Tensor operations
+ * work on entire subspaces and never need to look at the address of
+ * individual cells.
+ *
+ * Cell values are stored as doubles independent of the cell type of
+ * the tensor type, as is also done by SparseTensor.
+ **/
+class MixedTensor : public Tensor
+{
+public:
+    using Index = hash_map<SparseTensorAddressRef, uint32_t, hash<SparseTensorAddressRef>,
+                           std::equal_to<>, hashtable_base::and_modulator>;
+
+    static constexpr size_t STASH_CHUNK_SIZE = 16384u;
+
+private:
+    eval::ValueType _type;
+    eval::ValueType _sparse_type;
+    eval::ValueType _dense_type;
+    size_t _subspace_size;
+    Index _index;
+    std::vector<double> _cells;
+    Stash _stash;
+    SparseTensorLabelRepo::SP _labels;
+
+public:
+    MixedTensor(const eval::ValueType &type_in, Index &&index_in, std::vector<double> &&cells_in, Stash &&stash_in,
+                SparseTensorLabelRepo::SP labels_in);
+    ~MixedTensor() override;
+
+    // type containing only the mapped dimensions of the given type
+    static eval::ValueType sparse_type_of(const eval::ValueType &type);
+    // type containing only the indexed dimensions of the given type
+    static eval::ValueType dense_type_of(const eval::ValueType &type);
+    // make a mixed tensor with the same cells as a tensor using any implementation
+    static std::unique_ptr<MixedTensor> from_tensor(const Tensor &tensor);
+
+    const eval::ValueType &fast_type() const { return _type; }
+    const eval::ValueType &sparse_type() const { return _sparse_type; }
+    const eval::ValueType &dense_type() const { return _dense_type; }
+    size_t subspace_size() const { return _subspace_size; }
+    size_t num_subspaces() const { return _index.size(); }
+    const Index &index() const { return _index; }
+    const SparseTensorLabelRepo &labels() const { return *_labels; }
+    const SparseTensorLabelRepo::SP &shared_labels() const { return _labels; }
+    bool same_labels(const MixedTensor &rhs) const { return (_labels == rhs._labels); }
+    ConstArrayRef<double> subspace(uint32_t subspace_idx) const {
+        return ConstArrayRef<double>(&_cells[subspace_idx * _subspace_size], _subspace_size);
+    }
+    // returns nullptr if there is no subspace with the given address (using our label ids)
+    const double *find_subspace(SparseTensorAddressRef address) const;
+    // offset within a dense subspace; max size_t if the indexed labels are invalid
+    size_t find_dense_offset(const TensorAddress &address) const;
+    bool operator==(const MixedTensor &rhs) const;
+
+    const eval::ValueType &type() const override { return _type; }
+    double as_double() const override;
+    Tensor::UP apply(const CellFunction &func) const override;
+    Tensor::UP join(join_fun_t function, const Tensor &arg) const override;
+    Tensor::UP merge(join_fun_t function, const Tensor &arg) const override;
+    Tensor::UP reduce(join_fun_t op, const std::vector<vespalib::string> &dimensions) const override;
+    std::unique_ptr<Tensor> modify(join_fun_t op, const CellValues &cellValues) const override;
+    std::unique_ptr<Tensor> add(const Tensor &arg) const override;
+    std::unique_ptr<Tensor> remove(const CellValues &cellAddresses) const override;
+    bool equals(const Tensor &arg) const override;
+    Tensor::UP clone() const override;
+    eval::TensorSpec toSpec() const override;
+    void accept(TensorVisitor &visitor) const override;
+    MemoryUsage get_memory_usage() const override;
+};
+
+}
@@ -0,0 +1,128 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "mixed_tensor_builder.h"
+#include <vespa/eval/tensor/dense/dense_tensor.h>
+#include <vespa/eval/tensor/sparse/direct_sparse_tensor_builder.h>
+#include <vespa/vespalib/stllike/hash_map.hpp>
+
+namespace vespalib::tensor {
+
+using eval::TensorSpec;
+using eval::ValueType;
+
+namespace {
+
+struct CallBuildDense {
+    template <typename CT>
+    static Tensor::UP invoke(const ValueType &type, const std::vector<double> &cells) {
+        std::vector<CT> dense_cells(type.dense_subspace_size(), CT(0.0));
+        for (size_t i = 0; i < cells.size(); ++i) {
+            dense_cells[i] = CT(cells[i]);
+        }
+        return std::make_unique<DenseTensor<CT>>(type, std::move(dense_cells));
+    }
+};
+
+} // namespace vespalib::tensor::<unnamed>
+
+MixedTensorBuilder::MixedTensorBuilder(const ValueType &type_in)
+    : _type(type_in),
+      _subspace_size(type_in.dense_subspace_size()),
+      _index(),
+      _cells(),
+      _stash(MixedTensor::STASH_CHUNK_SIZE),
+      _labels(SparseTensorLabelRepo::current()),
+      _address_builder(*_labels)
+{
+}
+
+MixedTensorBuilder::MixedTensorBuilder(const ValueType &type_in, SparseTensorLabelRepo::SP labels_in)
+    : _type(type_in),
+      _subspace_size(type_in.dense_subspace_size()),
+      _index(),
+      _cells(),
+      _stash(MixedTensor::STASH_CHUNK_SIZE),
+      _labels(std::move(labels_in)),
+      _address_builder(*_labels)
+{
+}
+
+MixedTensorBuilder::~MixedTensorBuilder() = default;
+
+void
+MixedTensorBuilder::reserve(size_t num_subspaces)
+{
+    _index.resize(num_subspaces * 2);
+    _cells.reserve(num_subspaces * _subspace_size);
+}
+
+ArrayRef<double>
+MixedTensorBuilder::add_subspace(SparseTensorAddressRef address, bool &added)
+{
+    uint32_t subspace_idx = _index.size();
+    auto res = _index.insert(std::make_pair(address, subspace_idx));
+    added = res.second;
+    if (added) {
+        // Replace key with own copy
+        res.first->first = SparseTensorAddressRef(address, _stash);
+        _cells.resize(_cells.size() + _subspace_size, 0.0);
+    } else {
+        subspace_idx = res.first->second;
+    }
+    return ArrayRef<double>(&_cells[subspace_idx * _subspace_size], _subspace_size);
+}
+
+bool
+MixedTensorBuilder::set_cell(const TensorSpec::Address &address, double value)
+{
+    if (_type.dimensions().size() != address.size()) {
+        return false;
+    }
+    size_t d = 0;
+    size_t offset = 0;
+    _address_builder.clear();
+    for (const auto &binding: address) {
+        const auto &dim = _type.dimensions()[d++];
+        if (dim.name != binding.first) {
+            return false;
+        }
+        if (dim.is_mapped()) {
+            _address_builder.add(binding.second.name);
+        } else {
+            if (binding.second.index >= dim.size) {
+                return false;
+            }
+            offset = (offset * dim.size) + binding.second.index;
+        }
+    }
+    add_subspace(_address_builder.getAddressRef())[offset] = value;
+    return true;
+}
+
+std::unique_ptr<MixedTensor>
+MixedTensorBuilder::build_mixed()
+{
+    return std::make_unique<MixedTensor>(_type, std::move(_index), std::move(_cells), std::move(_stash), std::move(_labels));
+}
+
+Tensor::UP
+MixedTensorBuilder::build()
+{
+    if (_type.is_double()) {
+        double value = _cells.empty() ? 0.0 : _cells[0];
+        return std::make_unique<DenseTensor<double>>(_type, std::vector<double>({value}));
+    } else if (_type.is_dense()) {
+        using MyTypify = eval::TypifyCellType;
+        return typify_invoke<1,MyTypify,CallBuildDense>(_type.cell_type(), _type, _cells);
+    } else if (_type.is_sparse()) {
+        DirectSparseTensorBuilder builder(_type, _labels);
+        builder.reserve(_index.size());
+        for (const auto &entry: _index) {
+            builder.insertCell(entry.first, _cells[entry.second]);
+        }
+        return builder.build();
+    }
+    return build_mixed();
+}
+
+}
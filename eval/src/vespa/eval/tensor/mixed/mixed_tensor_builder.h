@@ -0,0 +1,71 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include "mixed_tensor.h"
+#include <vespa/eval/tensor/sparse/sparse_tensor_address_builder.h>
+
+namespace vespalib::tensor {
+
+/**
+ * Utility class to build tensors by adding entire dense subspaces
+ * addressed by the labels of the mapped dimensions, to be used by
+ * tensor operations on mixed tensors.
+ *
+ * Like DirectSparseTensorBuilder, subspace addresses must use label
+ * ids from the label repo of the builder, which is either the
+ * current repo of the process or the repo of another tensor.
+ */
+class MixedTensorBuilder
+{
+private:
+    eval::ValueType _type;
+    size_t _subspace_size;
+    MixedTensor::Index _index;
+    std::vector<double> _cells;
+    Stash _stash;
+    SparseTensorLabelRepo::SP _labels;
+    SparseTensorAddressBuilder _address_builder;
+
+public:
+    explicit MixedTensorBuilder(const eval::ValueType &type_in);
+    // subspace addresses must use label ids of the given repo
+    MixedTensorBuilder(const eval::ValueType &type_in, SparseTensorLabelRepo::SP labels_in);
+    ~MixedTensorBuilder();
+
+    const eval::ValueType &fast_type() const { return _type; }
+    size_t subspace_size() const { return _subspace_size; }
+    // the repo to enumerate labels in
+    SparseTensorLabelRepo &labels() { return *_labels; }
+    void reserve(size_t num_subspaces);
+
+    /**
+     * Returns the cells of the subspace with the given address,
+     * adding a new subspace with all cells set to 0.0 if it does not
+     * already exist. 'added' tells whether a new subspace was added.
+     * The returned cells are only valid until the next subspace is
+     * added.
+     **/
+    ArrayRef<double> add_subspace(SparseTensorAddressRef address, bool &added);
+    ArrayRef<double> add_subspace(SparseTensorAddressRef address) {
+        bool added;
+        return add_subspace(address, added);
+    }
+
+    /**
+     * Set the value of a single cell. Returns false if the address
+     * does not match the tensor type.
+     **/
+    bool set_cell(const eval::TensorSpec::Address &address, double value);
+
+    std::unique_ptr<MixedTensor> build_mixed();
+
+    /**
+     * Build a tensor using the default implementation for the
+     * resulting tensor type; only types with both mapped and
+     * indexed dimensions will result in a MixedTensor.
+     **/
+    Tensor::UP build();
+};
+
+}
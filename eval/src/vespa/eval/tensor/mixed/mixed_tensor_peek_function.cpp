@@ -0,0 +1,193 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "mixed_tensor_peek_function.h"
+#include "mixed_tensor.h"
+#include <vespa/eval/eval/value.h>
+#include <vespa/eval/tensor/dense/dense_tensor_view.h>
+#include <vespa/eval/tensor/sparse/sparse_tensor_address_builder.h>
+#include <vespa/vespalib/util/stringfmt.h>
+#include <cinttypes>
+
+namespace vespalib::tensor {
+
+using eval::Value;
+using eval::DoubleValue;
+using eval::ValueType;
+using eval::TensorSpec;
+using eval::TensorFunction;
+using eval::TensorEngine;
+using Child = eval::TensorFunction::Child;
+using eval::as;
+using namespace eval::tensor_function;
+
+namespace {
+
+template <typename CT>
+void my_mixed_peek_op(eval::InterpretedFunction::State &state, uint64_t param) {
+    const auto &self = *((const MixedTensorPeekFunction *)(param));
+    std::vector<vespalib::string> labels(self.num_mapped());
+    size_t offset = 0;
+    bool valid = true;
+    for (const auto &dim: self.spec()) {
+        if (dim.from_child) {
+            double value = state.peek(0).as_double();
+            state.stack.pop_back();
+            if (dim.mapped) {
+                labels[dim.mapped_idx] = make_string("%" PRId64, int64_t(value));
+            } else {
+                size_t dim_idx = value;
+                valid &= (dim_idx < dim.size);
+                offset += (dim_idx * dim.stride);
+            }
+        } else if (dim.mapped) {
+            labels[dim.mapped_idx] = dim.label;
+        } else {
+            offset += (dim.index * dim.stride);
+        }
+    }
+    const auto &tensor = static_cast<const MixedTensor &>(*state.peek(0).as_tensor());
+    state.stack.pop_back();
+    SparseTensorAddressBuilder address;
+    for (const auto &label: labels) {
+        auto label_id = tensor.labels().find(label);
+        valid &= (label_id != SparseTensorLabelRepo::NO_LABEL);
+        address.add_label_id(label_id);
+    }
+    const double *cells = valid ? tensor.find_subspace(address.getAddressRef()) : nullptr;
+    const auto &result_offsets = self.result_offsets();
+    if (self.result_type().is_double()) {
+        const Value &result = state.stash.create<DoubleValue>(cells ? cells[offset] : 0.0);
+        state.stack.emplace_back(result);
+    } else {
+        ArrayRef<CT> dst_cells = state.stash.create_array<CT>(result_offsets.size());
+        for (size_t i = 0; i < result_offsets.size(); ++i) {
+            dst_cells[i] = cells ? CT(cells[offset + result_offsets[i]]) : CT(0.0);
+        }
+        const Value &result = state.stash.create<DenseTensorView>(self.result_type(), TypedCells(dst_cells));
+        state.stack.emplace_back(result);
+    }
+}
+
+struct MyMixedPeekOp {
+    template <typename CT>
+    static auto invoke() { return my_mixed_peek_op<CT>; }
+};
+
+std::vector<uint32_t> make_result_offsets(const ValueType &result_type, const ValueType &dense_type,
+                                          const std::vector<size_t> &strides)
+{
+    const auto &dims = result_type.dimensions();
+    std::vector<size_t> result_strides;
+    for (const auto &dim: dims) {
+        result_strides.push_back(strides[dense_type.dimension_index(dim.name)]);
+    }
+    std::vector<uint32_t> result;
+    std::vector<size_t> idx(dims.size(), 0);
+    size_t offset = 0;
+    for (size_t i = 0; i < result_type.dense_subspace_size(); ++i) {
+        result.push_back(offset);
+        for (size_t d = dims.size(); d-- > 0; ) {
+            offset += result_strides[d];
+            if (++idx[d] < dims[d].size) {
+                break;
+            }
+            offset -= (result_strides[d] * dims[d].size);
+            idx[d] = 0;
+        }
+    }
+    return result;
+}
+
+} // namespace vespalib::tensor::<unnamed>
+
+MixedTensorPeekFunction::MixedTensorPeekFunction(const ValueType &result_type, std::vector<Child> children,
+                                                 std::vector<DimSpec> spec, size_t num_mapped,
+                                                 std::vector<uint32_t> result_offsets)
+    : TensorFunction(),
+      _result_type(result_type),
+      _children(std::move(children)),
+      _spec(std::move(spec)),
+      _num_mapped(num_mapped),
+      _result_offsets(std::move(result_offsets))
+{
+}
+
+MixedTensorPeekFunction::~MixedTensorPeekFunction() = default;
+
+void
+MixedTensorPeekFunction::push_children(std::vector<Child::CREF> &target) const
+{
+    for (const Child &c: _children) {
+        target.emplace_back(c);
+    }
+}
+
+eval::InterpretedFunction::Instruction
+MixedTensorPeekFunction::compile_self(const TensorEngine &, Stash &) const
+{
+    static_assert(sizeof(uint64_t) == sizeof(this));
+    using MyTypify = eval::TypifyCellType;
+    auto op = typify_invoke<1,MyTypify,MyMixedPeekOp>(_result_type.cell_type());
+    return eval::InterpretedFunction::Instruction(op, (uint64_t)this);
+}
+
+const TensorFunction &
+MixedTensorPeekFunction::optimize(const eval::TensorFunction &expr, Stash &stash)
+{
+    if (auto peek = as<Peek>(expr)) {
+        const ValueType &peek_type = peek->param_type();
+        const ValueType &result_type = expr.result_type();
+        if (peek_type.is_sparse() || peek_type.is_dense() || !(result_type.is_double() || result_type.is_dense())) {
+            return expr;
+        }
+        ValueType dense_type = MixedTensor::dense_type_of(peek_type);
+        std::vector<size_t> strides(dense_type.dimensions().size(), 0);
+        size_t stride = 1;
+        for (size_t i = strides.size(); i-- > 0; ) {
+            strides[i] = stride;
+            stride *= dense_type.dimensions()[i].size;
+        }
+        size_t num_mapped = MixedTensor::sparse_type_of(peek_type).dimensions().size();
+        std::vector<DimSpec> spec;
+        size_t mapped_idx = num_mapped;
+        size_t dense_idx = strides.size();
+        for (auto dim = peek_type.dimensions().rbegin(); dim != peek_type.dimensions().rend(); ++dim) {
+            if (dim->is_mapped()) {
+                --mapped_idx;
+            } else {
+                --dense_idx;
+            }
+            auto dim_spec = peek->spec().find(dim->name);
+            if (dim_spec == peek->spec().end()) {
+                if (dim->is_mapped()) {
+                    return expr;
+                }
+                continue;
+            }
+            DimSpec my_spec{dim->is_mapped(), false, "", 0, dim->size,
+                            dim->is_mapped() ? 0 : strides[dense_idx], mapped_idx};
+            bool ok = std::visit(vespalib::overload
+                                 {
+                                     [&](const TensorSpec::Label &label) {
+                                         my_spec.label = label.name;
+                                         my_spec.index = label.index;
+                                         return (label.is_mapped() == dim->is_mapped());
+                                     },
+                                     [&](const TensorFunction::Child &) {
+                                         my_spec.from_child = true;
+                                         return true;
+                                     }
+                                 }, dim_spec->second);
+            if (!ok || (!my_spec.from_child && !my_spec.mapped && (my_spec.index >= my_spec.size))) {
+                return expr;
+            }
+            spec.push_back(std::move(my_spec));
+        }
+        auto result_offsets = make_result_offsets(result_type, dense_type, strides);
+        return stash.create<MixedTensorPeekFunction>(result_type, peek->copy_children(), std::move(spec),
+                                                     num_mapped, std::move(result_offsets));
+    }
+    return expr;
+}
+
+} // namespace vespalib::tensor
@@ -0,0 +1,58 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include <vespa/eval/eval/tensor_function.h>
+
+namespace vespalib::tensor {
+
+/**
+ * Tensor function for peeking into a mixed tensor where all mapped
+ * dimensions are given a label. The labels of the mapped dimensions
+ * are used to look up a single dense subspace, and the result (a
+ * double or a dense tensor) is extracted directly from it.
+ */
+class MixedTensorPeekFunction : public eval::TensorFunction
+{
+public:
+    struct DimSpec {
+        bool mapped;
+        bool from_child;     // use result of next child expression
+        vespalib::string label;
+        size_t index;
+        size_t size;
+        size_t stride;       // within the dense subspace
+        size_t mapped_idx;   // position among the mapped dimensions
+    };
+private:
+    eval::ValueType _result_type;
+
+    // first child is the tensor we want to peek
+    // other children are label/index expressions
+    // (expressions are sorted by normalized dimension order)
+    std::vector<Child> _children;
+
+    // all peeked dimensions in reverse order
+    // (note that child expression order is inverted by the stack)
+    std::vector<DimSpec> _spec;
+
+    size_t _num_mapped;
+
+    // offsets within the dense subspace for all result cells when
+    // all peeked indexed dimensions have index 0
+    std::vector<uint32_t> _result_offsets;
+public:
+    MixedTensorPeekFunction(const eval::ValueType &result_type, std::vector<Child> children,
+                            std::vector<DimSpec> spec, size_t num_mapped, std::vector<uint32_t> result_offsets);
+    ~MixedTensorPeekFunction() override;
+    const eval::ValueType &result_type() const override { return _result_type; }
+    const std::vector<DimSpec> &spec() const { return _spec; }
+    size_t num_mapped() const { return _num_mapped; }
+    const std::vector<uint32_t> &result_offsets() const { return _result_offsets; }
+    void push_children(std::vector<Child::CREF> &children) const override;
+    eval::InterpretedFunction::Instruction compile_self(const eval::TensorEngine &engine, Stash &stash) const override;
+    bool result_is_mutable() const override { return true; }
+    static const eval::TensorFunction &optimize(const eval::TensorFunction &expr, Stash &stash);
+};
+
+} // namespace vespalib::tensor
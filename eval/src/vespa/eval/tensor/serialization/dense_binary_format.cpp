@@ -68,6 +68,12 @@ void decodeCells(CellType cell_type, nbostream &stream, size_t cellsSize, V &cel
     case CellType::FLOAT:
         decodeCells<float>(stream, cellsSize, cells);
         break;
+    case CellType::BFLOAT16:
+        decodeCells<BFloat16>(stream, cellsSize, cells);
+        break;
+    case CellType::INT8:
+        decodeCells<int8_t>(stream, cellsSize, cells);
+        break;
     }
 }
 
@@ -86,6 +92,12 @@ DenseBinaryFormat::serialize(nbostream &stream, const DenseTensorView &tensor)
     case CellType::FLOAT:
         encodeCells<float>(stream, cells);
         break;
+    case CellType::BFLOAT16:
+        encodeCells<BFloat16>(stream, cells);
+        break;
+    case CellType::INT8:
+        encodeCells<int8_t>(stream, cells);
+        break;
     }
 }
 
@@ -123,5 +135,7 @@ DenseBinaryFormat::deserializeCellsOnly(nbostream &stream, std::vector<T> &cells
 
 template void DenseBinaryFormat::deserializeCellsOnly(nbostream &stream, std::vector<double> &cells, CellType cell_type);
 template void DenseBinaryFormat::deserializeCellsOnly(nbostream &stream, std::vector<float> &cells, CellType cell_type);
+template void DenseBinaryFormat::deserializeCellsOnly(nbostream &stream, std::vector<BFloat16> &cells, CellType cell_type);
+template void DenseBinaryFormat::deserializeCellsOnly(nbostream &stream, std::vector<int8_t> &cells, CellType cell_type);
 
 }
@@ -0,0 +1,131 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "mixed_binary_format.h"
+#include <vespa/eval/tensor/mixed/mixed_tensor.h>
+#include <vespa/eval/tensor/mixed/mixed_tensor_builder.h>
+#include <vespa/eval/tensor/sparse/sparse_tensor_address_builder.h>
+#include <vespa/eval/tensor/sparse/sparse_tensor_address_decoder.h>
+#include <vespa/vespalib/objects/nbostream.h>
+#include <cassert>
+
+using vespalib::nbostream;
+using vespalib::eval::ValueType;
+using CellType = vespalib::eval::ValueType::CellType;
+
+namespace vespalib::tensor {
+
+namespace {
+
+void encodeDimensions(nbostream &stream, const MixedTensor &tensor) {
+    const auto &sparse_dims = tensor.sparse_type().dimensions();
+    stream.putInt1_4Bytes(sparse_dims.size());
+    for (const auto &dimension : sparse_dims) {
+        stream.writeSmallString(dimension.name);
+    }
+    const auto &dense_dims = tensor.dense_type().dimensions();
+    stream.putInt1_4Bytes(dense_dims.size());
+    for (const auto &dimension : dense_dims) {
+        stream.writeSmallString(dimension.name);
+        stream.putInt1_4Bytes(dimension.size);
+    }
+}
+
+template<typename T>
+void encodeCells(nbostream &stream, ConstArrayRef<double> cells) {
+    for (double value : cells) {
+        stream << static_cast<T>(value);
+    }
+}
+
+void encodeCells(CellType cell_type, nbostream &stream, ConstArrayRef<double> cells) {
+    switch (cell_type) {
+    case CellType::DOUBLE:
+        encodeCells<double>(stream, cells);
+        break;
+    case CellType::FLOAT:
+        encodeCells<float>(stream, cells);
+        break;
+    case CellType::BFLOAT16:
+        encodeCells<BFloat16>(stream, cells);
+        break;
+    case CellType::INT8:
+        encodeCells<int8_t>(stream, cells);
+        break;
+    }
+}
+
+template<typename T>
+void decodeCells(nbostream &stream, ArrayRef<double> cells) {
+    T cellValue = 0.0;
+    for (double &cell : cells) {
+        stream >> cellValue;
+        cell = cellValue;
+    }
+}
+
+void decodeCells(CellType cell_type, nbostream &stream, ArrayRef<double> cells) {
+    switch (cell_type) {
+    case CellType::DOUBLE:
+        decodeCells<double>(stream, cells);
+        break;
+    case CellType::FLOAT:
+        decodeCells<float>(stream, cells);
+        break;
+    case CellType::BFLOAT16:
+        decodeCells<BFloat16>(stream, cells);
+        break;
+    case CellType::INT8:
+        decodeCells<int8_t>(stream, cells);
+        break;
+    }
+}
+
+}
+
+void
+MixedBinaryFormat::serialize(nbostream &stream, const MixedTensor &tensor)
+{
+    encodeDimensions(stream, tensor);
+    size_t num_mapped = tensor.sparse_type().dimensions().size();
+    assert(num_mapped > 0);
+    stream.putInt1_4Bytes(tensor.num_subspaces());
+    for (const auto &entry : tensor.index()) {
+        SparseTensorAddressDecoder decoder(entry.first);
+        for (size_t i = 0; i < num_mapped; ++i) {
+            stream.writeSmallString(decoder.decodeLabel(tensor.labels()));
+        }
+        encodeCells(tensor.fast_type().cell_type(), stream, tensor.subspace(entry.second));
+    }
+}
+
+std::unique_ptr<Tensor>
+MixedBinaryFormat::deserialize(nbostream &stream, CellType cell_type)
+{
+    vespalib::string str;
+    std::vector<ValueType::Dimension> dimensions;
+    size_t num_mapped = stream.getInt1_4Bytes();
+    for (size_t i = 0; i < num_mapped; ++i) {
+        stream.readSmallString(str);
+        dimensions.emplace_back(str);
+    }
+    size_t num_indexed = stream.getInt1_4Bytes();
+    for (size_t i = 0; i < num_indexed; ++i) {
+        stream.readSmallString(str);
+        dimensions.emplace_back(str, stream.getInt1_4Bytes());
+    }
+    MixedTensorBuilder builder(ValueType::tensor_type(std::move(dimensions), cell_type));
+    size_t num_blocks = (num_mapped > 0) ? stream.getInt1_4Bytes() : 1;
+    builder.reserve(num_blocks);
+    SparseTensorAddressBuilder address(builder.labels());
+    for (size_t block = 0; block < num_blocks; ++block) {
+        address.clear();
+        for (size_t i = 0; i < num_mapped; ++i) {
+            stream.readSmallString(str);
+            address.add(str);
+        }
+        decodeCells(cell_type, stream, builder.add_subspace(address.getAddressRef()));
+    }
+    return builder.build();
+}
+
+}
@@ -17,21 +17,33 @@ DirectSparseTensorBuilder::copyCells(const Cells &cells_in)
 DirectSparseTensorBuilder::DirectSparseTensorBuilder()
     : _stash(SparseTensor::STASH_CHUNK_SIZE),
       _type(eval::ValueType::double_type()),
-      _cells()
+      _cells(),
+      _labels(SparseTensorLabelRepo::current())
 {
 }
 
 DirectSparseTensorBuilder::DirectSparseTensorBuilder(const eval::ValueType &type_in)
     : _stash(SparseTensor::STASH_CHUNK_SIZE),
       _type(type_in),
-      _cells()
+      _cells(),
+      _labels(SparseTensorLabelRepo::current())
 {
 }
 
-DirectSparseTensorBuilder::DirectSparseTensorBuilder(const eval::ValueType &type_in, const Cells &cells_in)
+DirectSparseTensorBuilder::DirectSparseTensorBuilder(const eval::ValueType &type_in, SparseTensorLabelRepo::SP labels_in)
     : _stash(SparseTensor::STASH_CHUNK_SIZE),
       _type(type_in),
-      _cells()
+      _cells(),
+      _labels(std::move(labels_in))
+{
+}
+
+DirectSparseTensorBuilder::DirectSparseTensorBuilder(const eval::ValueType &type_in, const Cells &cells_in,
+                                                     SparseTensorLabelRepo::SP labels_in)
+    : _stash(SparseTensor::STASH_CHUNK_SIZE),
+      _type(type_in),
+      _cells(),
+      _labels(std::move(labels_in))
 {
     copyCells(cells_in);
 }
@@ -40,7 +52,7 @@ DirectSparseTensorBuilder::~DirectSparseTensorBuilder() = default;
 
 Tensor::UP
 DirectSparseTensorBuilder::build() {
-    return std::make_unique<SparseTensor>(std::move(_type), std::move(_cells), std::move(_stash));
+    return std::make_unique<SparseTensor>(std::move(_type), std::move(_cells), std::move(_stash), std::move(_labels));
 }
 
 void DirectSparseTensorBuilder::reserve(uint32_t estimatedCells) {
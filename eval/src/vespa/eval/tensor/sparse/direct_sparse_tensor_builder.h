@@ -11,6 +11,10 @@ namespace vespalib::tensor {
 /**
  * Utility class to build tensors of type SparseTensor, to be used by
  * tensor operations.
+ *
+ * Cell addresses must use label ids from the label repo of the
+ * builder (see labels()), which is either the current repo of the
+ * process or the repo of another tensor.
  */
 class DirectSparseTensorBuilder
 {
@@ -23,12 +27,14 @@ private:
     Stash _stash;
     eval::ValueType _type;
     Cells _cells;
+    SparseTensorLabelRepo::SP _labels;
 
 public:
     void copyCells(const Cells &cells_in);
     DirectSparseTensorBuilder();
     DirectSparseTensorBuilder(const eval::ValueType &type_in);
-    DirectSparseTensorBuilder(const eval::ValueType &type_in, const Cells &cells_in);
+    DirectSparseTensorBuilder(const eval::ValueType &type_in, SparseTensorLabelRepo::SP labels_in);
+    DirectSparseTensorBuilder(const eval::ValueType &type_in, const Cells &cells_in, SparseTensorLabelRepo::SP labels_in);
     ~DirectSparseTensorBuilder();
 
     Tensor::UP build();
@@ -62,6 +68,9 @@ public:
 
     eval::ValueType &fast_type() { return _type; }
     Cells &cells() { return _cells; }
+    // the repo to enumerate labels in
+    SparseTensorLabelRepo &labels() { return *_labels; }
+    const SparseTensorLabelRepo &labels() const { return *_labels; }
     void reserve(uint32_t estimatedCells);
 };
 
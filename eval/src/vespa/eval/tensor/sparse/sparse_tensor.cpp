@@ -3,6 +3,7 @@
 #include "sparse_tensor.h"
 #include "sparse_tensor_add.h"
 #include "sparse_tensor_address_builder.h"
+#include "sparse_tensor_label_mapper.h"
 #include "sparse_tensor_apply.hpp"
 #include "sparse_tensor_match.h"
 #include "sparse_tensor_modify.h"
@@ -46,19 +47,26 @@ copyCells(Cells &cells, const Cells &cells_in, Stash &stash)
 
 }
 
-SparseTensor::SparseTensor(const eval::ValueType &type_in, const Cells &cells_in)
+SparseTensor::SparseTensor(const eval::ValueType &type_in, const Cells &cells_in, SparseTensorLabelRepo::SP labels_in)
     : _type(type_in),
       _cells(),
-      _stash(STASH_CHUNK_SIZE)
+      _stash(STASH_CHUNK_SIZE),
+      _labels(std::move(labels_in))
 {
+    if (!_labels) {
+        assert(cells_in.empty());
+        _labels = SparseTensorLabelRepo::current();
+    }
     copyCells(_cells, cells_in, _stash);
 }
 
 
-SparseTensor::SparseTensor(eval::ValueType &&type_in, Cells &&cells_in, Stash &&stash_in)
+SparseTensor::SparseTensor(eval::ValueType &&type_in, Cells &&cells_in, Stash &&stash_in,
+                           SparseTensorLabelRepo::SP labels_in)
     : _type(std::move(type_in)),
       _cells(std::move(cells_in)),
-      _stash(std::move(stash_in))
+      _stash(std::move(stash_in)),
+      _labels(std::move(labels_in))
 { }
 
 SparseTensor::~SparseTensor() = default;
@@ -66,7 +74,24 @@ SparseTensor::~SparseTensor() = default;
 bool
 SparseTensor::operator==(const SparseTensor &rhs) const
 {
-    return _type == rhs._type && _cells == rhs._cells;
+    if (_type != rhs._type || _cells.size() != rhs._cells.size()) {
+        return false;
+    }
+    if (same_labels(rhs)) {
+        return _cells == rhs._cells;
+    }
+    SparseTensorLabelMapper mapper(labels(), rhs.labels());
+    SparseTensorAddressBuilder address;
+    for (const auto &cell : _cells) {
+        if (!mapper.map_address(cell.first, address)) {
+            return false;
+        }
+        auto pos = rhs._cells.find(address.getAddressRef());
+        if (pos == rhs._cells.end() || pos->second != cell.second) {
+            return false;
+        }
+    }
+    return true;
 }
 
 
@@ -122,20 +147,22 @@ SparseTensor::clone() const
         eval::ValueType type_copy = _type;
         return std::make_unique<SparseTensor>(std::move(type_copy),
                                               std::move(cells_copy),
-                                              std::move(stash_copy));
+                                              std::move(stash_copy),
+                                              _labels);
     }
-    return std::make_unique<SparseTensor>(_type, _cells);
+    return std::make_unique<SparseTensor>(_type, _cells, _labels);
 }
 
 namespace {
 
 void
 buildAddress(const eval::ValueType &type,
+             const SparseTensorLabelRepo &labels,
              SparseTensorAddressDecoder &decoder,
              TensorSpec::Address &address)
 {
     for (const auto &dimension : type.dimensions()) {
-        auto label = decoder.decodeLabel();
+        auto label = decoder.decodeLabel(labels);
         address.emplace(std::make_pair(dimension.name, TensorSpec::Label(label)));
     }
     assert(!decoder.valid());
@@ -150,7 +177,7 @@ SparseTensor::toSpec() const
     TensorSpec::Address address;
     for (const auto &cell : _cells) {
         SparseTensorAddressDecoder decoder(cell.first);
-        buildAddress(_type, decoder, address);
+        buildAddress(_type, labels(), decoder, address);
         result.add(address, cell.second);
         address.clear();
     }
@@ -169,7 +196,7 @@ SparseTensor::accept(TensorVisitor &visitor) const
         SparseTensorAddressDecoder decoder(cell.first);
         addrBuilder.clear();
         for (const auto &dimension : _type.dimensions()) {
-            auto label = decoder.decodeLabel();
+            auto label = decoder.decodeLabel(labels());
             if (label.size() != 0u) {
                 addrBuilder.add(dimension.name, label);
             }
@@ -203,7 +230,24 @@ SparseTensor::merge(join_fun_t function, const Tensor &arg) const
 {
     const SparseTensor *rhs = dynamic_cast<const SparseTensor *>(&arg);
     assert(rhs && (fast_type().dimensions() == rhs->fast_type().dimensions()));
-    DirectSparseTensorBuilder builder(eval::ValueType::merge(fast_type(), rhs->fast_type()));
+    if (!same_labels(*rhs)) {
+        // enumerate the labels of both tensors in the current repo
+        DirectSparseTensorBuilder builder(eval::ValueType::merge(fast_type(), rhs->fast_type()));
+        builder.reserve(cells().size() + rhs->cells().size());
+        SparseTensorLabelMapper lhsMapper(labels(), builder.labels());
+        SparseTensorLabelMapper rhsMapper(rhs->labels(), builder.labels());
+        SparseTensorAddressBuilder address;
+        for (const auto &cell: cells()) {
+            lhsMapper.map_address(cell.first, address);
+            builder.insertCell(address, cell.second);
+        }
+        for (const auto &cell: rhs->cells()) {
+            rhsMapper.map_address(cell.first, address);
+            builder.insertCell(address, cell.second, function);
+        }
+        return builder.build();
+    }
+    DirectSparseTensorBuilder builder(eval::ValueType::merge(fast_type(), rhs->fast_type()), _labels);
     builder.reserve(cells().size() + rhs->cells().size());
     for (const auto &cell: cells()) {
         auto pos = rhs->cells().find(cell.first);
@@ -235,7 +279,7 @@ SparseTensor::modify(join_fun_t op, const CellValues &cellValues) const
     Stash stash;
     Cells cells;
     copyCells(cells, _cells, stash);
-    SparseTensorModify modifier(op, _type, std::move(stash), std::move(cells));
+    SparseTensorModify modifier(op, _type, std::move(stash), std::move(cells), _labels);
     cellValues.accept(modifier);
     return modifier.build();
 }
@@ -250,7 +294,8 @@ SparseTensor::add(const Tensor &arg) const
     Cells cells;
     Stash stash;
     copyCells(cells, _cells, stash);
-    SparseTensorAdd adder(_type, std::move(cells), std::move(stash));
+    // new labels of the added cells are appended to our repo
+    SparseTensorAdd adder(_type, std::move(cells), std::move(stash), _labels);
     rhs->accept(adder);
     return adder.build();
 }
@@ -261,7 +306,7 @@ SparseTensor::remove(const CellValues &cellAddresses) const
     Cells cells;
     Stash stash;
     copyCells(cells, _cells, stash);
-    SparseTensorRemove remover(_type, std::move(cells), std::move(stash));
+    SparseTensorRemove remover(_type, std::move(cells), std::move(stash), _labels);
     cellAddresses.accept(remover);
     return remover.build();
 }
@@ -270,6 +315,7 @@ MemoryUsage
 SparseTensor::get_memory_usage() const
 {
     MemoryUsage result = _stash.get_memory_usage();
+    // the label repo is shared with other tensors and not included
     size_t plus = sizeof(SparseTensor) + _cells.getMemoryConsumption();
     result.incUsedBytes(plus);
     result.incAllocatedBytes(plus); // should probably be even more
@@ -3,6 +3,7 @@
 #pragma once
 
 #include "sparse_tensor_address_ref.h"
+#include "sparse_tensor_label_repo.h"
 #include <vespa/eval/tensor/cell_function.h>
 #include <vespa/eval/tensor/tensor.h>
 #include <vespa/eval/tensor/tensor_address.h>
@@ -17,6 +18,9 @@ namespace vespalib::tensor {
  * A tensor implementation using serialized tensor addresses to
  * improve CPU cache and TLB hit ratio, relative to SimpleTensor
  * implementation.
+ *
+ * The addresses contain label ids from the label repo of the tensor,
+ * see SparseTensorLabelRepo.
  */
 class SparseTensor : public Tensor
 {
@@ -30,12 +34,18 @@ private:
     eval::ValueType _type;
     Cells _cells;
     Stash _stash;
+    SparseTensorLabelRepo::SP _labels;
 
 public:
-    explicit SparseTensor(const eval::ValueType &type_in, const Cells &cells_in);
-    SparseTensor(eval::ValueType &&type_in, Cells &&cells_in, Stash &&stash_in);
+    // the current repo is used if none is given; cells_in must then be empty
+    explicit SparseTensor(const eval::ValueType &type_in, const Cells &cells_in,
+                          SparseTensorLabelRepo::SP labels_in = SparseTensorLabelRepo::SP());
+    SparseTensor(eval::ValueType &&type_in, Cells &&cells_in, Stash &&stash_in, SparseTensorLabelRepo::SP labels_in);
     ~SparseTensor() override;
     const Cells &cells() const { return _cells; }
+    const SparseTensorLabelRepo &labels() const { return *_labels; }
+    const SparseTensorLabelRepo::SP &shared_labels() const { return _labels; }
+    bool same_labels(const SparseTensor &rhs) const { return (_labels == rhs._labels); }
     const eval::ValueType &fast_type() const { return _type; }
     bool operator==(const SparseTensor &rhs) const;
     eval::ValueType combineDimensionsWith(const SparseTensor &rhs) const;
@@ -4,11 +4,13 @@
 
 namespace vespalib::tensor {
 
-SparseTensorAdd::SparseTensorAdd(const eval::ValueType &type, Cells &&cells, Stash &&stash)
+SparseTensorAdd::SparseTensorAdd(const eval::ValueType &type, Cells &&cells, Stash &&stash,
+                                 SparseTensorLabelRepo::SP labels)
     : _type(type),
       _cells(std::move(cells)),
       _stash(std::move(stash)),
-      _addressBuilder()
+      _labels(std::move(labels)),
+      _addressBuilder(*_labels)
 {
 }
 
@@ -27,7 +29,7 @@ SparseTensorAdd::visit(const TensorAddress &address, double value)
 std::unique_ptr<Tensor>
 SparseTensorAdd::build()
 {
-    return std::make_unique<SparseTensor>(std::move(_type), std::move(_cells), std::move(_stash));
+    return std::make_unique<SparseTensor>(std::move(_type), std::move(_cells), std::move(_stash), std::move(_labels));
 }
 
 }
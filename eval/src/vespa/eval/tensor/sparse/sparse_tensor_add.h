@@ -20,10 +20,13 @@ class SparseTensorAdd : public TensorVisitor
     eval::ValueType _type;
     Cells _cells;
     Stash _stash;
+    SparseTensorLabelRepo::SP _labels;
     SparseTensorAddressBuilder _addressBuilder;
 
 public:
-    SparseTensorAdd(const eval::ValueType &type, Cells &&cells, Stash &&stash);
+    // the given repo must enumerate the labels used by the given cells
+    SparseTensorAdd(const eval::ValueType &type, Cells &&cells, Stash &&stash,
+                    SparseTensorLabelRepo::SP labels);
     ~SparseTensorAdd();
     void visit(const TensorAddress &address, double value) override;
     std::unique_ptr<Tensor> build();
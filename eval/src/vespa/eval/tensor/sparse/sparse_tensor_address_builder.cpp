@@ -8,7 +8,14 @@
 namespace vespalib::tensor {
 
 SparseTensorAddressBuilder::SparseTensorAddressBuilder()
-    : _address()
+    : _address(),
+      _labels(nullptr)
+{
+}
+
+SparseTensorAddressBuilder::SparseTensorAddressBuilder(SparseTensorLabelRepo &labels)
+    : _address(),
+      _labels(&labels)
 {
 }
 
@@ -26,4 +33,24 @@ SparseTensorAddressBuilder::populate(const eval::ValueType &type, const TensorAd
     }
 }
 
+bool
+SparseTensorAddressBuilder::populate(const eval::ValueType &type, const TensorAddress &address,
+                                     const SparseTensorLabelRepo &labels)
+{
+    clear();
+    TensorAddressElementIterator itr(address);
+    for (const auto &dimension : type.dimensions()) {
+        if (itr.skipToDimension(dimension.name)) {
+            label_t label_id = labels.find(itr.label());
+            if (label_id == SparseTensorLabelRepo::NO_LABEL) {
+                return false;
+            }
+            add_label_id(label_id);
+        } else {
+            addUndefined();
+        }
+    }
+    return true;
+}
+
 }
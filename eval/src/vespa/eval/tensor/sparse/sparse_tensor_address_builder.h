@@ -3,7 +3,9 @@
 #pragma once
 
 #include "sparse_tensor_address_ref.h"
+#include "sparse_tensor_label_repo.h"
 #include <vespa/vespalib/stllike/string.h>
+#include <cassert>
 
 namespace vespalib::eval { class ValueType; }
 
@@ -17,17 +19,23 @@ class TensorAddress;
  * All dimensions in the tensors are present, empty label is the "undefined"
  * value.
  *
- * Format: (labelStr NUL)*
+ * Format: (labelId)* where each label id is a native uint32_t obtained
+ * from the SparseTensorLabelRepo of the tensor the address belongs to.
+ * Labels given as strings are enumerated in the repo the builder was
+ * created with.
  */
 class SparseTensorAddressBuilder
 {
 private:
     vespalib::Array<char> _address;
+    SparseTensorLabelRepo *_labels;
 
 protected:
-    void append(vespalib::stringref str) {
-        for (size_t i(0); i < str.size() + 1; i++) {
-            _address.push_back_fast(str[i]);
+    using label_t = SparseTensorLabelRepo::label_t;
+    void append(label_t label_id) {
+        const char *bytes = reinterpret_cast<const char *>(&label_id);
+        for (size_t i(0); i < sizeof(label_t); i++) {
+            _address.push_back_fast(bytes[i]);
         }
     }
     void ensure_room(size_t additional) {
@@ -37,11 +45,16 @@ protected:
     }
 public:
     SparseTensorAddressBuilder();
+    explicit SparseTensorAddressBuilder(SparseTensorLabelRepo &labels);
     void add(vespalib::stringref label) {
-        ensure_room(label.size()+1);
-        append(label);
+        assert(_labels != nullptr);
+        add_label_id(_labels->resolve(label));
     }
-    void addUndefined() { _address.push_back('\0'); }
+    void add_label_id(label_t label_id) {
+        ensure_room(sizeof(label_t));
+        append(label_id);
+    }
+    void addUndefined() { add_label_id(SparseTensorLabelRepo::EMPTY_LABEL); }
     void clear() { _address.clear(); }
     void set(std::initializer_list<vespalib::stringref> labels) {
         clear();
@@ -54,6 +67,8 @@ public:
     }
     bool empty() const { return _address.empty(); }
     void populate(const eval::ValueType &type, const TensorAddress &address);
+    // only use labels already in the given repo; returns false if some label is not
+    bool populate(const eval::ValueType &type, const TensorAddress &address, const SparseTensorLabelRepo &labels);
 };
 
 }
@@ -2,6 +2,7 @@
 
 #include "sparse_tensor_address_combiner.h"
 #include "sparse_tensor_address_decoder.h"
+#include "sparse_tensor_label_mapper.h"
 #include <vespa/eval/eval/value_type.h>
 #include <vespa/vespalib/util/overload.h>
 #include <vespa/vespalib/util/visit_ranges.h>
@@ -34,9 +35,10 @@ TensorAddressCombiner::numOverlappingDimensions() const {
     return count;
 }
 
+template <typename LhsMap, typename RhsMap>
 bool
-TensorAddressCombiner::combine(SparseTensorAddressRef lhsRef,
-                               SparseTensorAddressRef rhsRef)
+TensorAddressCombiner::combine_impl(SparseTensorAddressRef lhsRef, SparseTensorAddressRef rhsRef,
+                                    LhsMap &&lhsMap, RhsMap &&rhsMap)
 {
     clear();
     ensure_room(lhsRef.size() + rhsRef.size());
@@ -45,14 +47,14 @@ TensorAddressCombiner::combine(SparseTensorAddressRef lhsRef,
     for (auto op : _ops) {
         switch (op) {
         case AddressOp::LHS:
-            append(lhs.decodeLabel());
+            append(lhsMap(lhs.decode_label_id()));
             break;
         case AddressOp::RHS:
-            append(rhs.decodeLabel());
+            append(rhsMap(rhs.decode_label_id()));
             break;
         case AddressOp::BOTH:
-            auto lhsLabel(lhs.decodeLabel());
-            auto rhsLabel(rhs.decodeLabel());
+            auto lhsLabel(lhsMap(lhs.decode_label_id()));
+            auto rhsLabel(rhsMap(rhs.decode_label_id()));
             if (lhsLabel != rhsLabel) {
                 return false;
             }
@@ -62,4 +64,20 @@ TensorAddressCombiner::combine(SparseTensorAddressRef lhsRef,
     return true;
 }
 
+bool
+TensorAddressCombiner::combine(SparseTensorAddressRef lhsRef, SparseTensorAddressRef rhsRef)
+{
+    auto same = [](label_t label_id) noexcept { return label_id; };
+    return combine_impl(lhsRef, rhsRef, same, same);
+}
+
+bool
+TensorAddressCombiner::combine(SparseTensorAddressRef lhsRef, SparseTensorAddressRef rhsRef,
+                               SparseTensorLabelMapper &lhsMapper, SparseTensorLabelMapper &rhsMapper)
+{
+    return combine_impl(lhsRef, rhsRef,
+                        [&lhsMapper](label_t label_id) { return lhsMapper.map(label_id); },
+                        [&rhsMapper](label_t label_id) { return rhsMapper.map(label_id); });
+}
+
 }
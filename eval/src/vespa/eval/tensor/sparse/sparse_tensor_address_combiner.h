@@ -7,6 +7,7 @@
 #define VESPA_DLL_LOCAL  __attribute__ ((visibility("hidden")))
 
 namespace vespalib::eval { class ValueType; }
+namespace vespalib::tensor { class SparseTensorLabelMapper; }
 namespace vespalib::tensor::sparse {
 
 /**
@@ -18,11 +19,18 @@ class TensorAddressCombiner : public SparseTensorAddressBuilder
     enum class AddressOp { LHS, RHS, BOTH };
 
     std::vector<AddressOp> _ops;
+
+    template <typename LhsMap, typename RhsMap>
+    bool combine_impl(SparseTensorAddressRef lhsRef, SparseTensorAddressRef rhsRef, LhsMap &&lhsMap, RhsMap &&rhsMap);
 public:
     TensorAddressCombiner(const eval::ValueType &lhs, const eval::ValueType &rhs);
     ~TensorAddressCombiner();
 
+    // both addresses use the same label repo
     VESPA_DLL_LOCAL bool combine(SparseTensorAddressRef lhsRef, SparseTensorAddressRef rhsRef);
+    // the label ids of each address are translated into the repo of the combined address
+    VESPA_DLL_LOCAL bool combine(SparseTensorAddressRef lhsRef, SparseTensorAddressRef rhsRef,
+                                 SparseTensorLabelMapper &lhsMapper, SparseTensorLabelMapper &rhsMapper);
     size_t numOverlappingDimensions() const;
     size_t numDimensions() const { return _ops.size(); }
 };
@@ -4,6 +4,8 @@
 
 #include <vespa/vespalib/stllike/string.h>
 #include "sparse_tensor_address_ref.h"
+#include "sparse_tensor_label_repo.h"
+#include <cstring>
 
 namespace vespalib::tensor {
 
@@ -24,15 +26,16 @@ public:
     bool valid() const { return _cur != _end; }
 
     void skipLabel() {
-        while (*_cur != '\0') {
-            ++_cur;
-        }
-        ++_cur;
+        _cur += sizeof(SparseTensorLabelRepo::label_t);
     }
-    vespalib::stringref decodeLabel() {
-        const char *base = _cur;
+    SparseTensorLabelRepo::label_t decode_label_id() {
+        SparseTensorLabelRepo::label_t label_id;
+        memcpy(&label_id, _cur, sizeof(label_id));
         skipLabel();
-        return vespalib::stringref(base, _cur - base - 1);
+        return label_id;
+    }
+    vespalib::stringref decodeLabel(const SparseTensorLabelRepo &labels) {
+        return labels.get(decode_label_id());
     }
 
 };
@@ -37,7 +37,7 @@ public:
                 decoder.skipLabel();
                 break;
             case AddressOp::COPY:
-                add(decoder.decodeLabel());
+                add_label_id(decoder.decode_label_id());
             }
         }
         assert(!decoder.valid());
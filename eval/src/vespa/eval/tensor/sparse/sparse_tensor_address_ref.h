@@ -42,6 +42,7 @@ public:
 
     uint32_t calcHash() const;
 
+    // note: orders by label ids, not by label strings
     bool operator<(const SparseTensorAddressRef &rhs) const {
         size_t minSize = std::min(_size, rhs._size);
         int res = memcmp(_start, rhs._start, minSize);
@@ -5,15 +5,15 @@
 #include "sparse_tensor_apply.h"
 #include "sparse_tensor_address_combiner.h"
 #include "direct_sparse_tensor_builder.h"
+#include "sparse_tensor_label_mapper.h"
 
 namespace vespalib::tensor::sparse {
 
-template <typename Function>
+template <typename Function, typename Combine>
 std::unique_ptr<Tensor>
-apply(const SparseTensor &lhs, const SparseTensor &rhs, Function &&func)
+apply_combined(const SparseTensor &lhs, const SparseTensor &rhs, DirectSparseTensorBuilder &builder,
+               const TensorAddressCombiner &addressCombiner, Function &&func, Combine &&combine)
 {
-    DirectSparseTensorBuilder builder(lhs.combineDimensionsWith(rhs));
-    TensorAddressCombiner addressCombiner(lhs.fast_type(), rhs.fast_type());
     size_t estimatedCells = (lhs.cells().size() * rhs.cells().size());
     if (addressCombiner.numOverlappingDimensions() != 0) {
         estimatedCells = std::min(lhs.cells().size(), rhs.cells().size());
@@ -21,7 +21,7 @@ apply(const SparseTensor &lhs, const SparseTensor &rhs, Function &&func)
     builder.reserve(estimatedCells*2);
     for (const auto &lhsCell : lhs.cells()) {
         for (const auto &rhsCell : rhs.cells()) {
-            bool combineSuccess = addressCombiner.combine(lhsCell.first, rhsCell.first);
+            bool combineSuccess = combine(lhsCell.first, rhsCell.first);
             if (combineSuccess) {
                 builder.insertCell(addressCombiner.getAddressRef(),
                                    func(lhsCell.second, rhsCell.second));
@@ -31,4 +31,24 @@ apply(const SparseTensor &lhs, const SparseTensor &rhs, Function &&func)
     return builder.build();
 }
 
+template <typename Function>
+std::unique_ptr<Tensor>
+apply(const SparseTensor &lhs, const SparseTensor &rhs, Function &&func)
+{
+    TensorAddressCombiner addressCombiner(lhs.fast_type(), rhs.fast_type());
+    if (lhs.same_labels(rhs)) {
+        DirectSparseTensorBuilder builder(lhs.combineDimensionsWith(rhs), lhs.shared_labels());
+        return apply_combined(lhs, rhs, builder, addressCombiner, func,
+                              [&addressCombiner](SparseTensorAddressRef lhsRef, SparseTensorAddressRef rhsRef)
+                              { return addressCombiner.combine(lhsRef, rhsRef); });
+    }
+    // enumerate the labels of both tensors in the current repo
+    DirectSparseTensorBuilder builder(lhs.combineDimensionsWith(rhs));
+    SparseTensorLabelMapper lhsMapper(lhs.labels(), builder.labels());
+    SparseTensorLabelMapper rhsMapper(rhs.labels(), builder.labels());
+    return apply_combined(lhs, rhs, builder, addressCombiner, func,
+                          [&](SparseTensorAddressRef lhsRef, SparseTensorAddressRef rhsRef)
+                          { return addressCombiner.combine(lhsRef, rhsRef, lhsMapper, rhsMapper); });
+}
+
 }
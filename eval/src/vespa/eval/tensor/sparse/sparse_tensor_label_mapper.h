@@ -0,0 +1,86 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include "sparse_tensor_address_builder.h"
+#include "sparse_tensor_address_decoder.h"
+#include "sparse_tensor_label_repo.h"
+#include <vector>
+
+namespace vespalib::tensor {
+
+/**
+ * Translates label ids of one label repo into label ids of another.
+ * Each label is looked up by string the first time it is seen; later
+ * translations of the same id are a table lookup. Labels not found
+ * in the target repo are either enumerated in it (when the target is
+ * mutable) or translated to NO_LABEL. Translating between a repo and
+ * itself is the identity.
+ **/
+class SparseTensorLabelMapper
+{
+public:
+    using label_t = SparseTensorLabelRepo::label_t;
+
+private:
+    static constexpr label_t UNMAPPED = SparseTensorLabelRepo::NO_LABEL - 1;
+
+    const SparseTensorLabelRepo &_from;
+    const SparseTensorLabelRepo &_to;
+    SparseTensorLabelRepo      *_mutable_to;
+    std::vector<label_t>        _map;
+
+    label_t lookup(label_t id) {
+        auto label = _from.get(id);
+        return (_mutable_to != nullptr) ? _mutable_to->resolve(label) : _to.find(label);
+    }
+
+public:
+    // unknown labels are enumerated in 'to'
+    SparseTensorLabelMapper(const SparseTensorLabelRepo &from, SparseTensorLabelRepo &to)
+        : _from(from), _to(to), _mutable_to(&to), _map()
+    {
+        if (!identity()) {
+            _map.resize(from.size(), UNMAPPED);
+        }
+    }
+    // unknown labels are translated to NO_LABEL
+    SparseTensorLabelMapper(const SparseTensorLabelRepo &from, const SparseTensorLabelRepo &to)
+        : _from(from), _to(to), _mutable_to(nullptr), _map()
+    {
+        if (!identity()) {
+            _map.resize(from.size(), UNMAPPED);
+        }
+    }
+    bool identity() const { return (&_from == &_to); }
+
+    label_t map(label_t id) {
+        if (identity()) {
+            return id;
+        }
+        label_t &result = _map[id];
+        if (result == UNMAPPED) {
+            result = lookup(id);
+        }
+        return result;
+    }
+
+    /**
+     * Write the translation of a complete address into the given
+     * builder. Returns false if some label is not in the target repo.
+     **/
+    bool map_address(SparseTensorAddressRef ref, SparseTensorAddressBuilder &dst) {
+        dst.clear();
+        SparseTensorAddressDecoder decoder(ref);
+        while (decoder.valid()) {
+            label_t id = map(decoder.decode_label_id());
+            if (id == SparseTensorLabelRepo::NO_LABEL) {
+                return false;
+            }
+            dst.add_label_id(id);
+        }
+        return true;
+    }
+};
+
+}
@@ -0,0 +1,151 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "sparse_tensor_label_repo.h"
+#include <vespa/vespalib/stllike/hash_fun.h>
+#include <vespa/vespalib/stllike/hash_map.hpp>
+#include <cassert>
+
+namespace vespalib::tensor {
+
+namespace {
+
+constexpr size_t STRINGS_CHUNK_SIZE = 1024u;
+
+// ids reserved for SparseTensorLabelMapper (NO_LABEL - 1) and NO_LABEL itself
+constexpr size_t MAX_LABELS = (SparseTensorLabelRepo::NO_LABEL - 1);
+
+}
+
+SparseTensorLabelRepo::Partition::Partition()
+    : lock(),
+      ids(),
+      strings(STRINGS_CHUNK_SIZE)
+{
+}
+
+SparseTensorLabelRepo::Partition::~Partition() = default;
+
+SparseTensorLabelRepo::SparseTensorLabelRepo()
+    : _partitions(),
+      _size(1),
+      _chunk_lock(),
+      _chunks()
+{
+    for (auto &chunk: _chunks) {
+        chunk.store(nullptr, std::memory_order_relaxed);
+    }
+    uint32_t size = 0;
+    char *entry = _partitions[0].strings.create_array<char>(sizeof(size)).begin();
+    memcpy(entry, &size, sizeof(size));
+    store(EMPTY_LABEL, entry);
+}
+
+SparseTensorLabelRepo::~SparseTensorLabelRepo()
+{
+    for (auto &chunk: _chunks) {
+        delete[] chunk.load(std::memory_order_relaxed);
+    }
+}
+
+uint32_t
+SparseTensorLabelRepo::part_id(vespalib::stringref label)
+{
+    return (hashValue(label.data(), label.size()) & PART_MASK);
+}
+
+const char **
+SparseTensorLabelRepo::ensure_chunk(uint32_t chunk)
+{
+    const char **entries = _chunks[chunk].load(std::memory_order_acquire);
+    if (entries == nullptr) {
+        std::lock_guard<std::mutex> guard(_chunk_lock);
+        entries = _chunks[chunk].load(std::memory_order_relaxed);
+        if (entries == nullptr) {
+            entries = new const char *[size_t(1) << (FIRST_CHUNK_BITS + chunk)];
+            _chunks[chunk].store(entries, std::memory_order_release);
+        }
+    }
+    return entries;
+}
+
+void
+SparseTensorLabelRepo::store(label_t id, const char *entry)
+{
+    uint32_t chunk = chunk_of(id);
+    ensure_chunk(chunk)[id - chunk_start(chunk)] = entry;
+}
+
+SparseTensorLabelRepo::SP
+SparseTensorLabelRepo::current()
+{
+    static std::mutex lock;
+    static SP repo;
+    std::lock_guard<std::mutex> guard(lock);
+    if (!repo || (repo->size() >= ROLLOVER_SIZE)) {
+        repo = std::make_shared<SparseTensorLabelRepo>();
+    }
+    return repo;
+}
+
+SparseTensorLabelRepo::label_t
+SparseTensorLabelRepo::resolve(vespalib::stringref label)
+{
+    if (label.empty()) {
+        return EMPTY_LABEL;
+    }
+    Partition &part = _partitions[part_id(label)];
+    std::lock_guard<std::mutex> guard(part.lock);
+    auto pos = part.ids.find(label);
+    if (pos != part.ids.end()) {
+        return pos->second;
+    }
+    label_t id = _size.fetch_add(1, std::memory_order_relaxed);
+    assert(id < MAX_LABELS);
+    uint32_t size = label.size();
+    char *entry = part.strings.create_array<char>(sizeof(size) + size).begin();
+    memcpy(entry, &size, sizeof(size));
+    memcpy(entry + sizeof(size), label.data(), size);
+    store(id, entry);
+    part.ids.insert(std::make_pair(vespalib::stringref(entry + sizeof(size), size), id));
+    return id;
+}
+
+SparseTensorLabelRepo::label_t
+SparseTensorLabelRepo::find(vespalib::stringref label) const
+{
+    if (label.empty()) {
+        return EMPTY_LABEL;
+    }
+    const Partition &part = _partitions[part_id(label)];
+    std::lock_guard<std::mutex> guard(part.lock);
+    auto pos = part.ids.find(label);
+    return (pos != part.ids.end()) ? pos->second : NO_LABEL;
+}
+
+MemoryUsage
+SparseTensorLabelRepo::get_memory_usage() const
+{
+    MemoryUsage result;
+    for (const auto &part: _partitions) {
+        std::lock_guard<std::mutex> guard(part.lock);
+        result.merge(part.strings.get_memory_usage());
+        size_t plus = part.ids.getMemoryConsumption();
+        result.incUsedBytes(plus);
+        result.incAllocatedBytes(plus);
+    }
+    size_t plus = sizeof(SparseTensorLabelRepo);
+    size_t used = size();
+    for (uint32_t chunk = 0; chunk < MAX_CHUNKS; ++chunk) {
+        if (_chunks[chunk].load(std::memory_order_relaxed) != nullptr) {
+            size_t chunk_size = (size_t(1) << (FIRST_CHUNK_BITS + chunk));
+            result.incAllocatedBytes(chunk_size * sizeof(const char *));
+            result.incUsedBytes(std::min(used, chunk_size) * sizeof(const char *));
+            used -= std::min(used, chunk_size);
+        }
+    }
+    result.incUsedBytes(plus);
+    result.incAllocatedBytes(plus);
+    return result;
+}
+
+}
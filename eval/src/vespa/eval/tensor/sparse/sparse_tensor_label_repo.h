@@ -0,0 +1,108 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include <vespa/vespalib/stllike/string.h>
+#include <vespa/vespalib/stllike/hash_map.h>
+#include <vespa/vespalib/util/memoryusage.h>
+#include <vespa/vespalib/util/optimized.h>
+#include <vespa/vespalib/util/stash.h>
+#include <atomic>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <mutex>
+
+namespace vespalib::tensor {
+
+/**
+ * Enumeration of the labels used in sparse tensor addresses. Each
+ * distinct label is assigned a fixed-width id the first time it is
+ * seen; sparse tensor addresses store label ids instead of label
+ * strings. This makes addresses cheaper to hash, compare and combine,
+ * and more compact for long labels.
+ *
+ * Repos are append-only and thread-safe: labels are never removed
+ * and the id of a label never changes, so a repo can be shared by
+ * any number of tensors while labels are added to it. Tensors are
+ * built using the current() repo of the process, which means that
+ * identical labels get identical ids and that tensors combined in
+ * the common case need no label translation at all. When the current
+ * repo has grown large, it is replaced by a new one; tensors keep
+ * the repo they were built with, which is freed together with the
+ * last tensor using it. Operations combining tensors with different
+ * repos translate label ids using SparseTensorLabelMapper.
+ *
+ * Lookup from label to id is partitioned to reduce lock contention,
+ * while lookup from id to label is lock-free.
+ **/
+class SparseTensorLabelRepo
+{
+public:
+    using label_t = uint32_t;
+    using SP = std::shared_ptr<SparseTensorLabelRepo>;
+    // the empty string (used for undefined labels) always has id 0
+    static constexpr label_t EMPTY_LABEL = 0;
+    // returned by find() for labels not in the repo
+    static constexpr label_t NO_LABEL = std::numeric_limits<label_t>::max();
+    // the current repo is replaced when it has this many labels
+    static constexpr size_t ROLLOVER_SIZE = (1u << 20);
+
+private:
+    static constexpr uint32_t PART_BITS = 4;
+    static constexpr uint32_t NUM_PARTS = (1u << PART_BITS);
+    static constexpr uint32_t PART_MASK = (NUM_PARTS - 1);
+    // chunk n holds (1 << (FIRST_CHUNK_BITS + n)) labels
+    static constexpr uint32_t FIRST_CHUNK_BITS = 10;
+    static constexpr uint32_t MAX_CHUNKS = (33 - FIRST_CHUNK_BITS);
+
+    struct Partition {
+        mutable std::mutex lock;
+        hash_map<vespalib::stringref, label_t> ids;
+        Stash strings;
+        Partition();
+        ~Partition();
+    };
+
+    Partition _partitions[NUM_PARTS];
+    std::atomic<uint32_t> _size;
+    std::mutex _chunk_lock;
+    // each entry points to a label stored as [uint32_t size][chars]
+    std::atomic<const char **> _chunks[MAX_CHUNKS];
+
+    static uint32_t chunk_of(label_t id) {
+        return Optimized::msbIdx((id >> FIRST_CHUNK_BITS) + 1);
+    }
+    static uint32_t chunk_start(uint32_t chunk) {
+        return (((1u << chunk) - 1) << FIRST_CHUNK_BITS);
+    }
+    static uint32_t part_id(vespalib::stringref label);
+    const char **ensure_chunk(uint32_t chunk);
+    void store(label_t id, const char *entry);
+
+public:
+    SparseTensorLabelRepo();
+    SparseTensorLabelRepo(const SparseTensorLabelRepo &) = delete;
+    SparseTensorLabelRepo &operator=(const SparseTensorLabelRepo &) = delete;
+    ~SparseTensorLabelRepo();
+
+    // the repo new tensors should enumerate their labels in
+    static SP current();
+
+    // get the id of a label, enumerating it if needed
+    label_t resolve(vespalib::stringref label);
+    // get the id of a label, NO_LABEL if it is not enumerated
+    label_t find(vespalib::stringref label) const;
+    // get the label with the given id
+    vespalib::stringref get(label_t id) const {
+        uint32_t chunk = chunk_of(id);
+        const char *entry = _chunks[chunk].load(std::memory_order_acquire)[id - chunk_start(chunk)];
+        uint32_t size;
+        memcpy(&size, entry, sizeof(size));
+        return vespalib::stringref(entry + sizeof(size), size);
+    }
+    size_t size() const { return _size.load(std::memory_order_relaxed); }
+    MemoryUsage get_memory_usage() const;
+};
+
+}
@@ -2,6 +2,7 @@
 
 #include "sparse_tensor_match.h"
 #include "sparse_tensor_address_decoder.h"
+#include "sparse_tensor_label_mapper.h"
 #include <vespa/vespalib/stllike/hash_map.hpp>
 #include <vespa/vespalib/util/overload.h>
 #include <vespa/vespalib/util/visit_ranges.h>
@@ -13,16 +14,30 @@ void
 SparseTensorMatch::fastMatch(const TensorImplType &lhs, const TensorImplType &rhs)
 {
     _builder.reserve(lhs.cells().size());
+    if (lhs.same_labels(rhs)) {
+        for (const auto &lhsCell : lhs.cells()) {
+            auto rhsItr = rhs.cells().find(lhsCell.first);
+            if (rhsItr != rhs.cells().end()) {
+                _builder.insertCell(lhsCell.first, lhsCell.second * rhsItr->second);
+            }
+        }
+        return;
+    }
+    SparseTensorLabelMapper mapper(lhs.labels(), rhs.labels());
+    SparseTensorAddressBuilder rhsAddress;
     for (const auto &lhsCell : lhs.cells()) {
-        auto rhsItr = rhs.cells().find(lhsCell.first);
-        if (rhsItr != rhs.cells().end()) {
-            _builder.insertCell(lhsCell.first, lhsCell.second * rhsItr->second);
+        if (mapper.map_address(lhsCell.first, rhsAddress)) {
+            auto rhsItr = rhs.cells().find(rhsAddress.getAddressRef());
+            if (rhsItr != rhs.cells().end()) {
+                _builder.insertCell(lhsCell.first, lhsCell.second * rhsItr->second);
+            }
         }
     }
 }
 
 SparseTensorMatch::SparseTensorMatch(const TensorImplType &lhs, const TensorImplType &rhs)
-    : Parent(lhs.combineDimensionsWith(rhs))
+    : Parent(lhs.combineDimensionsWith(rhs),
+             ((lhs.cells().size() <= rhs.cells().size()) ? lhs : rhs).shared_labels())
 {
     assert (lhs.fast_type().dimensions().size() == rhs.fast_type().dimensions().size());
     assert (lhs.fast_type().dimensions().size() == _builder.fast_type().dimensions().size());
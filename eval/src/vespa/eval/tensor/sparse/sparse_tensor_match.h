@@ -21,6 +21,7 @@ public:
     using typename Parent::TensorImplType;
     using Parent::_builder;
 private:
+    // the result shares the label repo of lhs
     void fastMatch(const TensorImplType &lhs, const TensorImplType &rhs);
 public:
     SparseTensorMatch(const TensorImplType &lhs, const TensorImplType &rhs);
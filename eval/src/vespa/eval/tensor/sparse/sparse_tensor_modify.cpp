@@ -5,11 +5,13 @@
 
 namespace vespalib::tensor {
 
-SparseTensorModify::SparseTensorModify(join_fun_t op, const eval::ValueType &type, Stash &&stash, Cells &&cells)
+SparseTensorModify::SparseTensorModify(join_fun_t op, const eval::ValueType &type, Stash &&stash, Cells &&cells,
+                                       SparseTensorLabelRepo::SP labels)
     : _op(op),
       _type(type),
       _stash(std::move(stash)),
       _cells(std::move(cells)),
+      _labels(std::move(labels)),
       _addressBuilder()
 {
 }
@@ -19,7 +21,10 @@ SparseTensorModify::~SparseTensorModify() = default;
 void
 SparseTensorModify::visit(const TensorAddress &address, double value)
 {
-    _addressBuilder.populate(_type, address);
+    if (!_addressBuilder.populate(_type, address, *_labels)) {
+        // unknown label, so there is no such cell
+        return;
+    }
     auto addressRef = _addressBuilder.getAddressRef();
     auto cellItr = _cells.find(addressRef);
     if (cellItr != _cells.end()) {
@@ -30,7 +35,7 @@ SparseTensorModify::visit(const TensorAddress &address, double value)
 std::unique_ptr<Tensor>
 SparseTensorModify::build()
 {
-    return std::make_unique<SparseTensor>(std::move(_type), std::move(_cells), std::move(_stash));
+    return std::make_unique<SparseTensor>(std::move(_type), std::move(_cells), std::move(_stash), std::move(_labels));
 }
 
 }
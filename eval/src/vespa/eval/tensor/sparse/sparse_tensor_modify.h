@@ -21,10 +21,12 @@ class SparseTensorModify : public TensorVisitor
     eval::ValueType        _type;
     Stash                  _stash;
     Cells                  _cells;
+    SparseTensorLabelRepo::SP _labels;
     SparseTensorAddressBuilder _addressBuilder;
 
 public:
-    SparseTensorModify(join_fun_t op, const eval::ValueType &type, Stash &&stash, Cells &&cells);
+    SparseTensorModify(join_fun_t op, const eval::ValueType &type, Stash &&stash, Cells &&cells,
+                       SparseTensorLabelRepo::SP labels);
     ~SparseTensorModify();
     void visit(const TensorAddress &address, double value) override;
     std::unique_ptr<Tensor> build();
@@ -42,7 +42,7 @@ reduce(const SparseTensor &tensor,
     if (dimensions.empty()) {
         return reduceAll(tensor, func);
     }
-    DirectSparseTensorBuilder builder(tensor.fast_type().reduce(dimensions));
+    DirectSparseTensorBuilder builder(tensor.fast_type().reduce(dimensions), tensor.shared_labels());
     if (builder.fast_type().dimensions().empty()) {
         return reduceAll(tensor, builder, func);
     }
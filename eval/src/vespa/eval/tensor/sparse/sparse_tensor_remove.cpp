@@ -5,10 +5,12 @@
 
 namespace vespalib::tensor {
 
-SparseTensorRemove::SparseTensorRemove(const eval::ValueType &type, Cells &&cells, Stash &&stash)
+SparseTensorRemove::SparseTensorRemove(const eval::ValueType &type, Cells &&cells, Stash &&stash,
+                                       SparseTensorLabelRepo::SP labels)
     : _type(type),
       _cells(std::move(cells)),
       _stash(std::move(stash)),
+      _labels(std::move(labels)),
       _addressBuilder()
 {
 }
@@ -19,15 +21,15 @@ void
 SparseTensorRemove::visit(const TensorAddress &address, double value)
 {
     (void) value;
-    _addressBuilder.populate(_type, address);
-    auto addressRef = _addressBuilder.getAddressRef();
-    _cells.erase(addressRef);
+    if (_addressBuilder.populate(_type, address, *_labels)) {
+        _cells.erase(_addressBuilder.getAddressRef());
+    }
 }
 
 std::unique_ptr<Tensor>
 SparseTensorRemove::build()
 {
-    return std::make_unique<SparseTensor>(std::move(_type), std::move(_cells), std::move(_stash));
+    return std::make_unique<SparseTensor>(std::move(_type), std::move(_cells), std::move(_stash), std::move(_labels));
 }
 
 }
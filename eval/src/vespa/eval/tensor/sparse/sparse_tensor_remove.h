@@ -20,10 +20,11 @@ private:
     eval::ValueType _type;
     Cells _cells;
     Stash _stash;
+    SparseTensorLabelRepo::SP _labels;
     SparseTensorAddressBuilder _addressBuilder;
 
 public:
-    SparseTensorRemove(const eval::ValueType &type, Cells &&cells, Stash &&stash);
+    SparseTensorRemove(const eval::ValueType &type, Cells &&cells, Stash &&stash, SparseTensorLabelRepo::SP labels);
     ~SparseTensorRemove();
     void visit(const TensorAddress &address, double value) override;
     std::unique_ptr<Tensor> build();
@@ -34,8 +34,13 @@ public:
           _type(_builder.fast_type()),
           _cells(_builder.cells())
     {}
-    TensorOperation(const eval::ValueType &type, const Cells &cells)
-        : _builder(type, cells),
+    TensorOperation(const eval::ValueType &type, SparseTensorLabelRepo::SP labels)
+        : _builder(type, std::move(labels)),
+          _type(_builder.fast_type()),
+          _cells(_builder.cells())
+    {}
+    TensorOperation(const eval::ValueType &type, const Cells &cells, SparseTensorLabelRepo::SP labels)
+        : _builder(type, cells, std::move(labels)),
           _type(_builder.fast_type()),
           _cells(_builder.cells())
     {}
@@ -80,4 +80,33 @@ TEST_F("require that connections are spread among transport threads", Fixture)
     }
 }
 
+TEST_F("require that sharded listen sockets spread accepted connections", Fixture)
+{
+    f1.server.SetReusePort(true);
+    FNET_Connector *listener = f1.server.Listen("tcp/0", &f1.streamer, &f1.adapter);
+    ASSERT_TRUE(listener);
+    EXPECT_EQUAL(listener->GetNumShards(), 8u);
+    uint32_t port = listener->GetPortNumber();
+    vespalib::string spec = vespalib::make_string("tcp/localhost:%u", port);
+    std::vector<FNET_Connection *> connections;
+    for (size_t i = 0; i < 256; ++i) {
+        connections.push_back(f1.client.Connect(spec.c_str(), &f1.streamer));
+        ASSERT_TRUE(connections.back());
+    }
+    f1.wait_for_components(256, 264);
+    check_threads(f1.server, 8, "server");
+    uint64_t io_events = 0;
+    for (const auto &stats: f1.server.get_thread_stats()) {
+        EXPECT_GREATER(stats.num_components, 1u);
+        io_events += stats.io_events;
+    }
+    EXPECT_GREATER_EQUAL(io_events, 256u);
+    FNET_Transport::Close(listener);
+    f1.wait_for_components(256, 256);
+    listener->SubRef();
+    for (FNET_Connection *conn: connections) {
+        conn->SubRef();
+    }
+}
+
 TEST_MAIN() { TEST_RUN_ALL(); }
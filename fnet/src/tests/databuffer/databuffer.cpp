@@ -1,7 +1,27 @@
 // Copyright 2017 Yahoo Holdings. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
 #include <vespa/vespalib/testkit/test_kit.h>
 #include <vespa/fnet/databuffer.h>
+#include <vespa/fnet/dummypacket.h>
+#include <vespa/fnet/output_segments.h>
 #include <chrono>
+#include <sys/uio.h>
+
+struct MyPacket : public FNET_DummyPacket {
+    bool &freed;
+    MyPacket(bool &freed_in) : freed(freed_in) {}
+    void Free() override {
+        freed = true;
+        delete this;
+    }
+};
+
+vespalib::string flatten(const struct iovec *iov, uint32_t cnt) {
+    vespalib::string result;
+    for (uint32_t i = 0; i < cnt; ++i) {
+        result.append(static_cast<const char *>(iov[i].iov_base), iov[i].iov_len);
+    }
+    return result;
+}
 
 TEST("test resetIfEmpty") {
     FNET_DataBuffer buf(64);
@@ -198,4 +218,77 @@ TEST("testSpeed") {
           ms.count());
 }
 
+TEST("require that small byte ranges are copied even with reference sink") {
+    FNET_DataBuffer buf(64);
+    FNET_OutputSegments segments;
+    buf.SetReferenceSink(&segments);
+    buf.WriteBytes("abc", 3);
+    buf.EnsureFree(3);
+    buf.WriteBytesRefFast("def", 3);
+    EXPECT_EQUAL(6u, buf.GetDataLen());
+    EXPECT_TRUE(segments.IsEmpty());
+    EXPECT_EQUAL(0, memcmp(buf.GetData(), "abcdef", 6));
+}
+
+TEST("require that large byte ranges are referenced and spliced into output") {
+    uint32_t size = FNET_OutputSegments::MIN_REFERENCE_SIZE;
+    vespalib::string a(size, 'a');
+    vespalib::string b(size, 'b');
+    FNET_DataBuffer buf(64);
+    FNET_OutputSegments segments;
+    buf.SetReferenceSink(&segments);
+    bool freed1 = false;
+    bool freed2 = false;
+    buf.WriteBytes("x", 1);
+    buf.WriteBytesRefFast(a.data(), a.size());
+    buf.WriteBytes("y", 1);
+    segments.FreePacket(new MyPacket(freed1));
+    buf.WriteBytesRefFast(b.data(), b.size());
+    segments.FreePacket(new MyPacket(freed2));
+    EXPECT_EQUAL(2u, buf.GetDataLen());
+    EXPECT_EQUAL(2u * size, segments.GetPendingBytes());
+    EXPECT_EQUAL(2u, segments.GetHeldPacketCnt());
+    struct iovec iov[FNET_OutputSegments::MAX_IOV];
+    uint32_t cnt = segments.FillIOVec(buf, iov, FNET_OutputSegments::MAX_IOV);
+    EXPECT_EQUAL(4u, cnt);
+    EXPECT_EQUAL("x" + a + "y" + b, flatten(iov, cnt));
+    segments.Consume(buf, size);
+    EXPECT_FALSE(freed1);
+    segments.Consume(buf, 2);
+    EXPECT_TRUE(freed1);
+    EXPECT_FALSE(freed2);
+    EXPECT_EQUAL(0u, buf.GetDataLen());
+    cnt = segments.FillIOVec(buf, iov, FNET_OutputSegments::MAX_IOV);
+    EXPECT_EQUAL(b, flatten(iov, cnt));
+    segments.Consume(buf, 10);
+    cnt = segments.FillIOVec(buf, iov, FNET_OutputSegments::MAX_IOV);
+    EXPECT_EQUAL(b.substr(10), flatten(iov, cnt));
+    segments.Consume(buf, size - 10);
+    EXPECT_TRUE(freed2);
+    EXPECT_TRUE(segments.IsEmpty());
+    EXPECT_EQUAL(0u, segments.GetPendingBytes());
+    EXPECT_EQUAL(0u, segments.GetHeldPacketCnt());
+}
+
+TEST("require that packets without referenced data are freed at once") {
+    FNET_OutputSegments segments;
+    bool freed = false;
+    segments.FreePacket(new MyPacket(freed));
+    EXPECT_TRUE(freed);
+}
+
+TEST("require that held packets are freed when output is discarded") {
+    vespalib::string a(FNET_OutputSegments::MIN_REFERENCE_SIZE, 'a');
+    FNET_DataBuffer buf(64);
+    FNET_OutputSegments segments;
+    buf.SetReferenceSink(&segments);
+    bool freed = false;
+    buf.WriteBytesRefFast(a.data(), a.size());
+    segments.FreePacket(new MyPacket(freed));
+    EXPECT_FALSE(freed);
+    segments.DiscardAll();
+    EXPECT_TRUE(freed);
+    EXPECT_TRUE(segments.IsEmpty());
+}
+
 TEST_MAIN() { TEST_RUN_ALL(); }
@@ -9,6 +9,7 @@
 
 using vespalib::SocketSpec;
 using vespalib::BenchmarkTimer;
+using vespalib::compression::CompressionConfig;
 
 constexpr double timeout = 60.0;
 constexpr double short_timeout = 0.1;
@@ -262,7 +263,8 @@ public:
     RequestLatch &detached_req() { return _testRPC.detached_req(); }
     EchoTest &echo() { return _echoTest; }
 
-    Fixture()
+    Fixture(const CompressionConfig &client_compression = CompressionConfig(),
+            const CompressionConfig &server_compression = CompressionConfig())
         : _client(crypto),
           _server(crypto),
           _peerSpec(),
@@ -272,6 +274,8 @@ public:
     {
         _client.supervisor().GetTransport()->SetTCPNoDelay(true);
         _server.supervisor().GetTransport()->SetTCPNoDelay(true);
+        _client.supervisor().SetCompression(client_compression);
+        _server.supervisor().SetCompression(server_compression);
         ASSERT_TRUE(_server.supervisor().Listen("tcp/0"));
         _peerSpec = SocketSpec::from_host_port("localhost", _server.supervisor().GetListenPort()).spec();
         _target = _client.supervisor().GetTarget(_peerSpec.c_str());
@@ -420,6 +424,129 @@ TEST_F("require that parameters can be echoed as return values", Fixture()) {
     EXPECT_TRUE(req.get().GetParams()->Equals(req.get().GetReturn()));
 }
 
+void verify_large_echo(Fixture &f) {
+    MyReq req("frt.rpc.echo");
+    vespalib::string str;
+    for (size_t i = 0; i < 10000; ++i) {
+        str.append("compressible ");
+    }
+    req.get().GetParams()->AddString(str.data(), str.size());
+    req.get().GetParams()->AddInt32(42);
+    f.target().InvokeSync(req.borrow(), timeout);
+    ASSERT_TRUE(req.get().CheckReturnTypes("si"));
+    EXPECT_TRUE(req.get().GetReturn()->Equals(req.get().GetParams()));
+}
+
+TEST("require that large packet bodies are compressed on the wire") {
+    FRT_PacketFactory factory;
+    FNET_SimplePacketStreamer streamer(&factory);
+    MyReq req("echo");
+    vespalib::string str(100000, 'x');
+    req.get().GetParams()->AddString(str.data(), str.size());
+    FNET_DataBuffer buf;
+    FNET_Packet *packet = req.get().CreateRequestPacket(true, CompressionConfig(CompressionConfig::ZSTD, 3, 90, 1024));
+    streamer.Encode(packet, 7, &buf);
+    packet->Free();
+    EXPECT_LESS(buf.GetDataLen(), 1000u);
+    uint32_t plen, pcode, chid;
+    bool broken = false;
+    ASSERT_TRUE(streamer.GetPacketInfo(&buf, &plen, &pcode, &chid, &broken));
+    EXPECT_EQUAL(7u, chid);
+    EXPECT_TRUE(((pcode >> 16) & FLAG_FRT_RPC_COMPRESSED) != 0);
+    MyReq decoded(new FRT_RPCRequest());
+    decoded.get().SetAcceptCompressed(true);
+    FNET_Packet *result = streamer.Decode(&buf, plen, pcode, FNET_Context(decoded.borrow()));
+    ASSERT_TRUE(result != nullptr);
+    result->Free();
+    EXPECT_EQUAL(0u, buf.GetDataLen());
+    EXPECT_EQUAL(vespalib::string("echo"), vespalib::string(decoded.get().GetMethodName()));
+    EXPECT_TRUE(decoded.get().GetParams()->Equals(req.get().GetParams()));
+}
+
+struct CompressedPacket {
+    FRT_PacketFactory factory;
+    FNET_SimplePacketStreamer streamer;
+    FNET_DataBuffer buf;
+    uint32_t plen, pcode, chid;
+    CompressedPacket() : factory(), streamer(&factory), buf(), plen(0), pcode(0), chid(0) {
+        MyReq req("echo");
+        vespalib::string str(100000, 'x');
+        req.get().GetParams()->AddString(str.data(), str.size());
+        FNET_Packet *packet = req.get().CreateRequestPacket(true, CompressionConfig(CompressionConfig::ZSTD, 3, 90, 1024));
+        streamer.Encode(packet, 7, &buf);
+        packet->Free();
+        bool broken = false;
+        ASSERT_TRUE(streamer.GetPacketInfo(&buf, &plen, &pcode, &chid, &broken));
+        ASSERT_TRUE(((pcode >> 16) & FLAG_FRT_RPC_COMPRESSED) != 0);
+    }
+    bool decode(bool accept_compressed) {
+        MyReq decoded(new FRT_RPCRequest());
+        decoded.get().SetAcceptCompressed(accept_compressed);
+        FNET_Packet *result = streamer.Decode(&buf, plen, pcode, FNET_Context(decoded.borrow()));
+        EXPECT_EQUAL(0u, buf.GetDataLen());
+        if (result == nullptr) {
+            return false;
+        }
+        result->Free();
+        return true;
+    }
+};
+
+TEST_F("require that compressed packets are rejected unless compression was negotiated", CompressedPacket()) {
+    EXPECT_FALSE(f1.decode(false));
+}
+
+TEST_F("require that compressed packets with too large uncompressed size are rejected", CompressedPacket()) {
+    // body starts with the compression type and the uncompressed size (host endian here)
+    uint32_t huge = FRT_RPCPacket::MAX_UNCOMPRESSED_SIZE + 1;
+    memcpy(f1.buf.GetData() + 1, &huge, sizeof(huge));
+    EXPECT_FALSE(f1.decode(true));
+}
+
+TEST_F("require that compressed packets are decoded when compression was negotiated", CompressedPacket()) {
+    EXPECT_TRUE(f1.decode(true));
+}
+
+TEST("require that small packet bodies are not compressed") {
+    FRT_PacketFactory factory;
+    FNET_SimplePacketStreamer streamer(&factory);
+    MyReq req(42, false, FRTE_NO_ERROR, 0);
+    FNET_DataBuffer buf;
+    FNET_Packet *packet = req.get().CreateRequestPacket(true, CompressionConfig(CompressionConfig::ZSTD, 3, 90, 1024));
+    streamer.Encode(packet, 7, &buf);
+    packet->Free();
+    uint32_t plen, pcode, chid;
+    bool broken = false;
+    ASSERT_TRUE(streamer.GetPacketInfo(&buf, &plen, &pcode, &chid, &broken));
+    EXPECT_TRUE(((pcode >> 16) & FLAG_FRT_RPC_COMPRESSED) == 0);
+}
+
+TEST_F("require that compression is not used by default", Fixture()) {
+    EXPECT_FALSE(f1.target().GetConnection()->GetOutputCompression().useCompression());
+    TEST_DO(verify_large_echo(f1));
+}
+
+TEST_F("require that large requests and replies can be compressed",
+       Fixture(CompressionConfig(CompressionConfig::ZSTD, 3, 90, 1024),
+               CompressionConfig(CompressionConfig::LZ4, 0, 90, 1024)))
+{
+    auto compression = f1.target().GetConnection()->GetOutputCompression();
+    EXPECT_EQUAL(CompressionConfig::ZSTD, compression.type);
+    EXPECT_EQUAL(1024u, compression.minSize);
+    TEST_DO(verify_large_echo(f1));
+    MyReq req("inc");
+    req.get().GetParams()->AddInt32(502);
+    f1.target().InvokeSync(req.borrow(), timeout);
+    EXPECT_EQUAL(req.get_int_ret(), 503u);
+}
+
+TEST_F("require that requests are compressed even if the server does not compress replies",
+       Fixture(CompressionConfig(CompressionConfig::LZ4, 0, 90, 1024)))
+{
+    EXPECT_EQUAL(CompressionConfig::LZ4, f1.target().GetConnection()->GetOutputCompression().type);
+    TEST_DO(verify_large_echo(f1));
+}
+
 TEST_MAIN() {
     crypto = my_crypto_engine();
     TEST_RUN_ALL();
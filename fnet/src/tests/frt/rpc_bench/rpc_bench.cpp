@@ -0,0 +1,324 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include <vespa/fnet/frt/frt.h>
+#include <vespa/fnet/transport.h>
+#include <vespa/fastos/app.h>
+#include <vespa/vespalib/net/crypto_engine.h>
+#include <vespa/vespalib/net/tls/tls_crypto_engine.h>
+#include <vespa/vespalib/test/make_tls_options_for_testing.h>
+#include <algorithm>
+#include <atomic>
+#include <cinttypes>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <sys/resource.h>
+
+using vespalib::CryptoEngine;
+using clock_type = std::chrono::steady_clock;
+
+namespace {
+
+struct Options {
+    uint32_t    invokers = 16;
+    uint32_t    pipeline = 1;
+    uint32_t    connections = 1;
+    uint32_t    request_size = 64;
+    uint32_t    reply_size = 64;
+    uint32_t    client_threads = 1;
+    uint32_t    server_threads = 1;
+    uint32_t    busy_poll_us = 0;
+    double      warmup_s = 1.0;
+    double      duration_s = 5.0;
+    std::string crypto = "null";
+};
+
+CryptoEngine::SP make_crypto(const std::string &name) {
+    if (name == "null") {
+        return std::make_shared<vespalib::NullCryptoEngine>();
+    }
+    if (name == "xor") {
+        return std::make_shared<vespalib::XorCryptoEngine>();
+    }
+    if (name == "tls") {
+        return std::make_shared<vespalib::TlsCryptoEngine>(vespalib::test::make_tls_options_for_testing());
+    }
+    return CryptoEngine::SP();
+}
+
+double cpu_seconds() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return (usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) +
+        (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1000000.0;
+}
+
+struct Rpc {
+    FastOS_ThreadPool thread_pool;
+    FNET_Transport    transport;
+    FRT_Supervisor    orb;
+    Rpc(CryptoEngine::SP crypto, size_t num_threads, uint32_t busy_poll_us)
+        : thread_pool(128 * 1024), transport(std::move(crypto), num_threads), orb(&transport)
+    {
+        transport.SetBusyPollTime(std::chrono::microseconds(busy_poll_us));
+    }
+    bool start() { return transport.Start(&thread_pool); }
+    ~Rpc() {
+        transport.ShutDown(true);
+        thread_pool.Close();
+    }
+};
+
+struct Server : Rpc, FRT_Invokable {
+    Server(CryptoEngine::SP crypto, const Options &opts)
+        : Rpc(std::move(crypto), opts.server_threads, opts.busy_poll_us)
+    {
+        FRT_ReflectionBuilder rb(&orb);
+        rb.DefineMethod("bench", "xi", "x", FRT_METHOD(Server::rpc_bench), this);
+        rb.MethodDesc("reply with a blob of the requested size");
+        rb.ParamDesc("payload", "ignored payload");
+        rb.ParamDesc("reply_size", "size of the blob to reply with");
+        rb.ReturnDesc("payload", "a blob of the requested size");
+    }
+    void rpc_bench(FRT_RPCRequest *req) {
+        uint32_t size = req->GetParams()->GetValue(1)._intval32;
+        char *buf = req->GetReturn()->AddData(size);
+        memset(buf, 'r', size);
+    }
+};
+
+/**
+ * A user thread keeping a fixed number of requests in flight. Each
+ * completed request is handed back to the thread, which records its
+ * latency and sends it again.
+ **/
+class Invoker : public FRT_IRequestWait
+{
+private:
+    struct Slot {
+        FRT_RPCRequest        *req;
+        clock_type::time_point start;
+    };
+    std::mutex                  _lock;
+    std::condition_variable     _cond;
+    std::vector<uint32_t>       _done;
+    std::vector<Slot>           _slots;
+    FRT_Supervisor             &_orb;
+    FRT_Target                 &_target;
+    const Options              &_opts;
+    std::vector<char>           _payload;
+
+    void send(uint32_t idx) {
+        Slot &slot = _slots[idx];
+        slot.req = _orb.AllocRPCRequest(slot.req);
+        slot.req->SetMethodName("bench");
+        slot.req->GetParams()->AddData(_payload.data(), _payload.size());
+        slot.req->GetParams()->AddInt32(_opts.reply_size);
+        slot.req->SetContext(FNET_Context(idx));
+        slot.start = clock_type::now();
+        _target.InvokeAsync(slot.req, 60.0, this);
+    }
+
+public:
+    std::vector<double> latencies; // in seconds, measured requests only
+    uint64_t            errors;
+
+    Invoker(FRT_Supervisor &orb, FRT_Target &target, const Options &opts)
+        : _lock(), _cond(), _done(), _slots(opts.pipeline, Slot{nullptr, clock_type::time_point()}),
+          _orb(orb), _target(target), _opts(opts), _payload(opts.request_size, 'p'),
+          latencies(), errors(0)
+    {}
+
+    ~Invoker() override {
+        for (Slot &slot : _slots) {
+            if (slot.req != nullptr) {
+                slot.req->SubRef();
+            }
+        }
+    }
+
+    void RequestDone(FRT_RPCRequest *req) override {
+        std::lock_guard<std::mutex> guard(_lock);
+        _done.push_back(req->GetContext()._value.INT);
+        _cond.notify_one();
+    }
+
+    void run(const std::atomic<int> &phase) {
+        for (uint32_t i = 0; i < _slots.size(); ++i) {
+            send(i);
+        }
+        uint32_t pending = _slots.size();
+        std::vector<uint32_t> done;
+        while (pending > 0) {
+            {
+                std::unique_lock<std::mutex> guard(_lock);
+                _cond.wait(guard, [this]{ return !_done.empty(); });
+                done.swap(_done);
+            }
+            auto now = clock_type::now();
+            int current = phase.load(std::memory_order_relaxed);
+            for (uint32_t idx : done) {
+                Slot &slot = _slots[idx];
+                if (slot.req->IsError()) {
+                    ++errors;
+                }
+                if (current == 1) {
+                    latencies.push_back(std::chrono::duration<double>(now - slot.start).count());
+                }
+                if (current < 2) {
+                    send(idx);
+                } else {
+                    --pending;
+                }
+            }
+            done.clear();
+        }
+    }
+};
+
+double percentile(const std::vector<double> &sorted, double p) {
+    if (sorted.empty()) {
+        return 0.0;
+    }
+    size_t idx = std::min(sorted.size() - 1, size_t(p * sorted.size()));
+    return sorted[idx];
+}
+
+}
+
+class RpcBench : public FastOS_Application
+{
+private:
+    static void usage();
+public:
+    int Main() override;
+};
+
+void
+RpcBench::usage()
+{
+    fprintf(stderr, "usage: fnet_rpc_bench_app [options]\n");
+    fprintf(stderr, "    -c <num>   number of invoker threads (default 16)\n");
+    fprintf(stderr, "    -p <num>   requests in flight per invoker (default 1)\n");
+    fprintf(stderr, "    -n <num>   number of connections shared by the invokers (default 1)\n");
+    fprintf(stderr, "    -s <bytes> request payload size (default 64)\n");
+    fprintf(stderr, "    -r <bytes> reply payload size (default 64)\n");
+    fprintf(stderr, "    -t <num>   client transport threads (default 1)\n");
+    fprintf(stderr, "    -T <num>   server transport threads (default 1)\n");
+    fprintf(stderr, "    -b <us>    transport busy-poll time in microseconds (default 0)\n");
+    fprintf(stderr, "    -e <name>  crypto engine: null, xor or tls (default null)\n");
+    fprintf(stderr, "    -w <sec>   warmup time (default 1)\n");
+    fprintf(stderr, "    -d <sec>   measurement time (default 5)\n");
+}
+
+int
+RpcBench::Main()
+{
+    Options opts;
+    int argi = 1;
+    const char *optArg;
+    int c;
+    while ((c = GetOpt("c:p:n:s:r:t:T:b:e:w:d:", optArg, argi)) != -1) {
+        switch (c) {
+        case 'c': opts.invokers = atoi(optArg); break;
+        case 'p': opts.pipeline = atoi(optArg); break;
+        case 'n': opts.connections = atoi(optArg); break;
+        case 's': opts.request_size = atoi(optArg); break;
+        case 'r': opts.reply_size = atoi(optArg); break;
+        case 't': opts.client_threads = atoi(optArg); break;
+        case 'T': opts.server_threads = atoi(optArg); break;
+        case 'b': opts.busy_poll_us = atoi(optArg); break;
+        case 'e': opts.crypto = optArg; break;
+        case 'w': opts.warmup_s = atof(optArg); break;
+        case 'd': opts.duration_s = atof(optArg); break;
+        default:
+            usage();
+            return 1;
+        }
+    }
+    CryptoEngine::SP crypto = make_crypto(opts.crypto);
+    if (!crypto || (opts.invokers == 0) || (opts.pipeline == 0) || (opts.connections == 0) ||
+        (opts.client_threads == 0) || (opts.server_threads == 0))
+    {
+        usage();
+        return 1;
+    }
+
+    Server server(crypto, opts);
+    if (!server.orb.Listen(0) || !server.start()) {
+        fprintf(stderr, "could not start server\n");
+        return 1;
+    }
+    Rpc client(crypto, opts.client_threads, opts.busy_poll_us);
+    if (!client.start()) {
+        fprintf(stderr, "could not start client\n");
+        return 1;
+    }
+    std::vector<FRT_Target *> targets;
+    for (uint32_t i = 0; i < opts.connections; ++i) {
+        targets.push_back(client.orb.GetTarget(server.orb.GetListenPort()));
+    }
+    std::vector<std::unique_ptr<Invoker>> invokers;
+    for (uint32_t i = 0; i < opts.invokers; ++i) {
+        invokers.push_back(std::make_unique<Invoker>(client.orb, *targets[i % targets.size()], opts));
+    }
+
+    // phase 0: warmup, 1: measure, 2: drain
+    std::atomic<int> phase(0);
+    std::vector<std::thread> threads;
+    for (auto &invoker : invokers) {
+        threads.emplace_back([&invoker, &phase]() { invoker->run(phase); });
+    }
+    std::this_thread::sleep_for(std::chrono::duration<double>(opts.warmup_s));
+    double cpu_before = cpu_seconds();
+    auto time_before = clock_type::now();
+    phase = 1;
+    std::this_thread::sleep_for(std::chrono::duration<double>(opts.duration_s));
+    phase = 2;
+    auto time_after = clock_type::now();
+    double cpu_after = cpu_seconds();
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    std::vector<double> latencies;
+    uint64_t errors = 0;
+    for (const auto &invoker : invokers) {
+        latencies.insert(latencies.end(), invoker->latencies.begin(), invoker->latencies.end());
+        errors += invoker->errors;
+    }
+    invokers.clear();
+    for (FRT_Target *target : targets) {
+        target->SubRef();
+    }
+    std::sort(latencies.begin(), latencies.end());
+    double elapsed = std::chrono::duration<double>(time_after - time_before).count();
+    double ops = latencies.size();
+    fprintf(stdout, "crypto: %s, invokers: %u, pipeline: %u, connections: %u, "
+            "request: %u bytes, reply: %u bytes, transport threads: %u/%u, busy-poll: %u us\n",
+            opts.crypto.c_str(), opts.invokers, opts.pipeline, opts.connections,
+            opts.request_size, opts.reply_size, opts.client_threads, opts.server_threads, opts.busy_poll_us);
+    fprintf(stdout, "throughput : %.0f ops/s\n", ops / elapsed);
+    fprintf(stdout, "latency    : p50 %.3f ms, p99 %.3f ms, max %.3f ms\n",
+            percentile(latencies, 0.50) * 1000.0, percentile(latencies, 0.99) * 1000.0,
+            (latencies.empty() ? 0.0 : latencies.back()) * 1000.0);
+    // client and server share the process, so this covers both sides
+    fprintf(stdout, "cpu        : %.2f us/op (%.2f cores)\n",
+            (ops > 0) ? ((cpu_after - cpu_before) / ops * 1000000.0) : 0.0,
+            (cpu_after - cpu_before) / elapsed);
+    if (errors > 0) {
+        fprintf(stdout, "errors     : %" PRIu64 "\n", errors);
+        return 1;
+    }
+    return 0;
+}
+
+int
+main(int argc, char **argv)
+{
+    RpcBench app;
+    return app.Entry(argc, argv);
+}
@@ -37,4 +37,23 @@ TEST("sync execute") {
     ASSERT_TRUE(exe4.gate.getCount() == 1u);
 }
 
+TEST("execute with busy polling") {
+    FastOS_ThreadPool pool(128 * 1024 * 1024);
+    FNET_Transport transport;
+    transport.SetBusyPollTime(std::chrono::milliseconds(100));
+    ASSERT_TRUE(transport.Start(&pool));
+    for (size_t i = 0; i < 100; ++i) {
+        DoIt exe;
+        ASSERT_TRUE(transport.execute(&exe));
+        exe.gate.await();
+    }
+    auto stats = transport.get_thread_stats();
+    ASSERT_EQUAL(stats.size(), 1u);
+    EXPECT_EQUAL(stats[0].busy_poll_time.count(), 100000);
+    EXPECT_GREATER(stats[0].spin_hits, 0u);
+    EXPECT_LESS(stats[0].wakeups, 100u);
+    transport.ShutDown(true);
+    pool.Close();
+}
+
 TEST_MAIN() { TEST_RUN_ALL(); }
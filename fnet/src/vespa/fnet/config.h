@@ -2,6 +2,7 @@
 
 #pragma once
 
+#include <chrono>
 #include <cstdint>
 
 /**
@@ -15,6 +16,7 @@ public:
     uint32_t  _maxInputBufferSize;
     uint32_t  _maxOutputBufferSize;
     bool      _tcpNoDelay;
+    std::chrono::microseconds _busyPollTime;
 
     FNET_Config();
 };
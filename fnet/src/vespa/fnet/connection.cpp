@@ -10,6 +10,7 @@
 #include "transport_thread.h"
 #include "transport.h"
 #include <vespa/vespalib/net/socket_spec.h>
+#include <sys/uio.h>
 
 #include <vespa/log/log.h>
 LOG_SETUP(".fnet");
@@ -387,7 +388,7 @@ FNET_Connection::Write()
 
         // fill output buffer
 
-        while (_output.GetDataLen() < chunk_size) {
+        while (_output.GetDataLen() + _outputSegments.GetPendingBytes() < chunk_size) {
             if (_myQueue.IsEmpty_NoLock())
                 break;
 
@@ -395,29 +396,36 @@ FNET_Connection::Write()
             if (packet->IsRegularPacket()) { // ignore non-regular packets
                 _streamer->Encode(packet, context._value.INT, &_output);
             }
-            packet->Free();
+            _outputSegments.FreePacket(packet);
         }
 
-        if (_output.GetDataLen() == 0) {
+        if (_output.GetDataLen() == 0 && _outputSegments.IsEmpty()) {
             res = 0;
             break;
         }
 
         // write data
 
-        res = _socket->write(_output.GetData(), _output.GetDataLen());
+        if (_outputSegments.IsEmpty()) {
+            res = _socket->write(_output.GetData(), _output.GetDataLen());
+        } else {
+            struct iovec iov[FNET_OutputSegments::MAX_IOV];
+            uint32_t cnt = _outputSegments.FillIOVec(_output, iov, FNET_OutputSegments::MAX_IOV);
+            res = _socket->writev(iov, cnt);
+        }
         my_errno = errno;
         writeCnt++;
         if (res > 0) {
-            _output.DataToDead((uint32_t)res);
+            _outputSegments.Consume(_output, res);
             _output.resetIfEmpty();
         }
     } while (res > 0 &&
              _output.GetDataLen() == 0 &&
+             _outputSegments.IsEmpty() &&
              !_myQueue.IsEmpty_NoLock() &&
              writeCnt < FNET_WRITE_REDO);
 
-    if ((_output.GetDataLen() > 0)) {
+    if ((_output.GetDataLen() > 0) || !_outputSegments.IsEmpty()) {
         ++my_write_work;
     }
 
@@ -487,11 +495,15 @@ FNET_Connection::FNET_Connection(FNET_TransportThread *owner,
       _queue(256),
       _myQueue(256),
       _output(FNET_WRITE_SIZE * 2),
+      _outputSegments(),
       _channels(),
       _callbackTarget(nullptr),
+      _outputCompression(),
+      _acceptCompressed(false),
       _cleanup(nullptr)
 {
     assert(_socket && (_socket->get_fd() >= 0));
+    _output.SetReferenceSink(&_outputSegments);
     _num_connections.fetch_add(1, std::memory_order_relaxed);
 }
 
@@ -521,8 +533,11 @@ FNET_Connection::FNET_Connection(FNET_TransportThread *owner,
       _queue(256),
       _myQueue(256),
       _output(FNET_WRITE_SIZE * 2),
+      _outputSegments(),
       _channels(),
       _callbackTarget(nullptr),
+      _outputCompression(),
+      _acceptCompressed(false),
       _cleanup(nullptr)
 {
     if (adminHandler != nullptr) {
@@ -530,6 +545,7 @@ FNET_Connection::FNET_Connection(FNET_TransportThread *owner,
         _adminChannel = admin.get();
         _channels.Register(admin.release());
     }
+    _output.SetReferenceSink(&_outputSegments);
     _num_connections.fetch_add(1, std::memory_order_relaxed);
 }
 
@@ -602,6 +618,22 @@ FNET_Connection::SetCleanupHandler(FNET_IConnectionCleanupHandler *handler)
 }
 
 
+void
+FNET_Connection::SetOutputCompression(const vespalib::compression::CompressionConfig &config)
+{
+    std::lock_guard<std::mutex> guard(_ioc_lock);
+    _outputCompression = config;
+}
+
+
+vespalib::compression::CompressionConfig
+FNET_Connection::GetOutputCompression()
+{
+    std::lock_guard<std::mutex> guard(_ioc_lock);
+    return _outputCompression;
+}
+
+
 FNET_Channel*
 FNET_Connection::OpenChannel(FNET_IPacketHandler *handler,
                              FNET_Context context,
@@ -736,6 +768,7 @@ FNET_Connection::Close()
     _resolve_handler.reset();
     detach_selector();
     SetState(FNET_CLOSED);
+    _outputSegments.DiscardAll();
     _ioc_socket_fd = -1;
     if (!_flags._handshake_work_pending) {
         _socket.reset();
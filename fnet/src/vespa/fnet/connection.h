@@ -7,9 +7,11 @@
 #include "context.h"
 #include "channellookup.h"
 #include "packetqueue.h"
+#include "output_segments.h"
 #include <vespa/vespalib/net/socket_handle.h>
 #include <vespa/vespalib/net/async_resolver.h>
 #include <vespa/vespalib/net/crypto_socket.h>
+#include <vespa/vespalib/util/compressionconfig.h>
 #include <atomic>
 
 class FNET_IPacketStreamer;
@@ -107,8 +109,11 @@ private:
     FNET_PacketQueue_NoLock  _queue;           // outer output queue
     FNET_PacketQueue_NoLock  _myQueue;         // inner output queue
     FNET_DataBuffer          _output;          // output buffer
+    FNET_OutputSegments      _outputSegments;  // referenced output
     FNET_ChannelLookup       _channels;        // channel 'DB'
     FNET_Channel            *_callbackTarget;  // target of current callback
+    vespalib::compression::CompressionConfig _outputCompression; // agreed with peer
+    std::atomic<bool>        _acceptCompressed; // peer may send compressed packets
 
     FNET_IConnectionCleanupHandler *_cleanup;  // cleanup handler
 
@@ -335,6 +340,39 @@ public:
     FNET_Context *GetContextPT() { return &_context; }
 
 
+    /**
+     * Set the compression to use for outgoing packets. FNET does not
+     * compress anything by itself; this is where the packet layer
+     * keeps the compression agreed upon with the peer. The default
+     * is no compression.
+     *
+     * @param config output compression for this connection
+     **/
+    void SetOutputCompression(const vespalib::compression::CompressionConfig &config);
+
+
+    /**
+     * @return the compression to use for outgoing packets
+     **/
+    vespalib::compression::CompressionConfig GetOutputCompression();
+
+
+    /**
+     * Allow the peer to send compressed packets on this connection.
+     * The packet layer sets this when compression is negotiated and
+     * rejects packets flagged as compressed until then.
+     *
+     * @param value whether compressed input is accepted
+     **/
+    void SetAcceptCompressed(bool value) { _acceptCompressed.store(value); }
+
+
+    /**
+     * @return whether the peer may send compressed packets
+     **/
+    bool AcceptCompressed() const { return _acceptCompressed.load(); }
+
+
     /**
      * @return current connection state.
      **/
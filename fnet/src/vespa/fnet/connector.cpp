@@ -16,15 +16,28 @@ FNET_Connector::FNET_Connector(FNET_TransportThread *owner,
                                FNET_IPacketStreamer *streamer,
                                FNET_IServerAdapter *serverAdapter,
                                const char *spec,
-                               vespalib::ServerSocket server_socket)
+                               vespalib::ServerSocket server_socket,
+                               bool sharded,
+                               std::vector<FNET_Connector *> shards)
     : FNET_IOComponent(owner, server_socket.get_fd(), spec, /* time-out = */ false),
       _streamer(streamer),
       _serverAdapter(serverAdapter),
-      _server_socket(std::move(server_socket))
+      _server_socket(std::move(server_socket)),
+      _sharded(sharded),
+      _shards(std::move(shards)),
+      _shutdown(false)
 {
 }
 
 
+FNET_Connector::~FNET_Connector()
+{
+    for (FNET_Connector *shard: _shards) {
+        shard->SubRef();
+    }
+}
+
+
 uint32_t
 FNET_Connector::GetPortNumber() const {
     return _server_socket.address().port();
@@ -36,7 +49,24 @@ FNET_Connector::Close()
 {
     detach_selector();
     _ioc_socket_fd = -1;
-    _server_socket = vespalib::ServerSocket();
+    {
+        std::lock_guard<std::mutex> guard(_ioc_lock);
+        _server_socket = vespalib::ServerSocket();
+    }
+    for (FNET_Connector *shard: _shards) {
+        shard->shutdown();
+    }
+}
+
+
+void
+FNET_Connector::shutdown()
+{
+    std::lock_guard<std::mutex> guard(_ioc_lock);
+    _shutdown.store(true, std::memory_order_release);
+    if (_server_socket.valid()) {
+        _server_socket.shutdown();
+    }
 }
 
 
@@ -47,6 +77,9 @@ FNET_Connector::HandleReadEvent()
     if (handle.valid()) {
         FNET_Transport &transport = Owner()->owner();
         FNET_TransportThread *thread = transport.select_thread(&handle, sizeof(handle));
+        if (_sharded && (Owner()->GetLoad() <= thread->GetLoad())) {
+            thread = Owner(); // keep connection where the kernel put it
+        }
         if (thread->tune(handle)) {
             std::unique_ptr<FNET_Connection> conn = std::make_unique<FNET_Connection>(thread, _streamer, _serverAdapter, std::move(handle), GetSpec());
             if (conn->Init()) {
@@ -55,6 +88,8 @@ FNET_Connector::HandleReadEvent()
                 LOG(debug, "Connector(%s): failed to init incoming connection", GetSpec());
             }
         }
+    } else if (_shutdown.load(std::memory_order_acquire)) {
+        return false;
     }
     return true;
 }
@@ -4,20 +4,29 @@
 
 #include "iocomponent.h"
 #include <vespa/vespalib/net/server_socket.h>
+#include <atomic>
+#include <vector>
 
 class FNET_IPacketStreamer;
 class FNET_IServerAdapter;
 
 /**
  * Class used to listen for incoming connections on a single TCP/IP
- * port.
+ * port. Several connectors in different transport threads may share
+ * the same port (SO_REUSEPORT), letting the kernel spread incoming
+ * connections among them. One of them (the one handed out to the
+ * application) then owns the others (its shards) and shuts them down
+ * when closed.
  **/
 class FNET_Connector : public FNET_IOComponent
 {
 private:
-    FNET_IPacketStreamer  *_streamer;
-    FNET_IServerAdapter   *_serverAdapter;
-    vespalib::ServerSocket _server_socket;
+    FNET_IPacketStreamer         *_streamer;
+    FNET_IServerAdapter          *_serverAdapter;
+    vespalib::ServerSocket        _server_socket;
+    bool                          _sharded;
+    std::vector<FNET_Connector *> _shards;
+    std::atomic<bool>             _shutdown;
 
     FNET_Connector(const FNET_Connector &);
     FNET_Connector &operator=(const FNET_Connector &);
@@ -31,12 +40,17 @@ public:
      * @param serverAdapter object for custom channel creation
      * @param spec listen spec for this connector
      * @param server_socket the underlying server socket
+     * @param sharded whether the port is shared with other connectors
+     * @param shards other connectors owned by this one
      **/
     FNET_Connector(FNET_TransportThread *owner,
                    FNET_IPacketStreamer *streamer,
                    FNET_IServerAdapter *serverAdapter,
                    const char *spec,
-                   vespalib::ServerSocket server_socket);
+                   vespalib::ServerSocket server_socket,
+                   bool sharded = false,
+                   std::vector<FNET_Connector *> shards = {});
+    ~FNET_Connector() override;
 
     /**
      * Obtain the port number of the underlying server socket.
@@ -45,13 +59,30 @@ public:
      **/
     uint32_t GetPortNumber() const;
 
+    /**
+     * Obtain the number of connectors accepting connections on behalf
+     * of this one, including itself. This is 1 unless the listen
+     * socket is sharded across transport threads.
+     *
+     * @return number of connectors
+     **/
+    uint32_t GetNumShards() const { return _shards.size() + 1; }
+
     /**
      * Close this connector. This method must be called in the transport
      * thread in order to avoid race conditions related to socket event
-     * registration, deregistration and triggering.
+     * registration, deregistration and triggering. Shards owned by
+     * this connector are shut down.
      **/
     void Close() override;
 
+    /**
+     * Stop accepting connections. This method may be called from any
+     * thread. The underlying socket is shut down, which will wake up
+     * the owning transport thread and make it close the connector.
+     **/
+    void shutdown();
+
     /**
      * Called by the transport layer when a read event has occurred. If
      * an incoming connection could be accepted, an event is posted on
@@ -7,7 +7,9 @@ FNET_DataBuffer::FNET_DataBuffer(uint32_t len)
     : _bufstart(nullptr),
       _bufend(nullptr),
       _datapt(nullptr),
-      _freept(nullptr)
+      _freept(nullptr),
+      _ownedBuf(),
+      _refSink(nullptr)
 {
     if (len > 0 && len < 256)
         len = 256;
@@ -28,7 +30,9 @@ FNET_DataBuffer::FNET_DataBuffer(char *buf, uint32_t len)
     : _bufstart(buf),
       _bufend(buf + len),
       _datapt(_bufstart),
-      _freept(_bufstart)
+      _freept(_bufstart),
+      _ownedBuf(),
+      _refSink(nullptr)
 {
 }
 
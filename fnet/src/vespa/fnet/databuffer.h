@@ -7,6 +7,32 @@
 #include <cassert>
 #include <cstring>
 
+class FNET_DataBuffer;
+
+/**
+ * Interface used by a databuffer to hand off large byte ranges that
+ * are to be referenced rather than copied into the buffer. The
+ * referenced memory must stay valid until the receiver of the
+ * reference is done with it.
+ **/
+class FNET_IDataReferenceSink
+{
+public:
+    virtual ~FNET_IDataReferenceSink() {}
+
+    /**
+     * Try to reference the given bytes at the current end of the
+     * given buffer instead of copying them.
+     *
+     * @return true if the bytes were referenced, false if they
+     *         should be copied into the buffer.
+     * @param buf the buffer the bytes logically belong to.
+     * @param src source byte buffer.
+     * @param len number of bytes.
+     **/
+    virtual bool AddReference(FNET_DataBuffer &buf, const void *src, uint32_t len) = 0;
+};
+
 /**
  * This is a buffer that may hold the stream representation of
  * packets. It has helper methods in order to simplify and standardize
@@ -37,6 +63,7 @@ private:
     char  *_datapt;
     char  *_freept;
     Alloc  _ownedBuf;
+    FNET_IDataReferenceSink *_refSink;
 
     FNET_DataBuffer(const FNET_DataBuffer &);
     FNET_DataBuffer &operator=(const FNET_DataBuffer &);
@@ -61,6 +88,14 @@ public:
     FNET_DataBuffer(char *buf, uint32_t len);
     ~FNET_DataBuffer();
 
+    /**
+     * Set the sink receiving byte ranges written with
+     * WriteBytesRefFast. Without a sink, all bytes are copied.
+     *
+     * @param sink the reference sink, may be nullptr.
+     **/
+    void SetReferenceSink(FNET_IDataReferenceSink *sink) { _refSink = sink; }
+
     /**
      * @return a pointer to the dead part of this buffer.
      **/
@@ -604,6 +639,22 @@ public:
         _freept += len;
     }
 
+    /**
+     * Write bytes to this buffer, letting the reference sink (if any)
+     * reference them instead of copying. The referenced memory must
+     * stay valid until the packet being encoded is freed. Skip
+     * checking for free space.
+     *
+     * @param src source byte buffer.
+     * @param len number of bytes to write.
+     **/
+    void WriteBytesRefFast(const void *src, uint32_t len)
+    {
+        if (_refSink == nullptr || !_refSink->AddReference(*this, src, len)) {
+            WriteBytesFast(src, len);
+        }
+    }
+
     /**
      * Read bytes from this buffer.
      *
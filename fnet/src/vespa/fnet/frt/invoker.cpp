@@ -96,7 +96,7 @@ FRT_RPCInvoker::HandleDone(bool freeChannel)
     if (_noReply || (_req->GetErrorCode() == FRTE_RPC_BAD_REQUEST))
         _req->SubRef();
     else
-        ch->Send(_req->CreateReplyPacket());
+        ch->Send(_req->CreateReplyPacket(ch->GetConnection()->GetOutputCompression()));
 
     // free FNET channel (if not in packet delivery callback)
     if (freeChannel)
@@ -4,31 +4,146 @@
 #include "rpcrequest.h"
 #include <vespa/fnet/info.h>
 #include <vespa/fnet/databuffer.h>
+#include <vespa/vespalib/data/databuffer.h>
+#include <vespa/vespalib/util/compressor.h>
 #include <vespa/vespalib/util/stringfmt.h>
+#include <stdexcept>
 
+namespace {
+
+// compression type (8 bits) and uncompressed size (32 bits)
+constexpr uint32_t COMPRESSION_HEADER_SIZE = sizeof(uint8_t) + sizeof(uint32_t);
+
+}
+
+FRT_RPCPacket::FRT_RPCPacket(FRT_RPCRequest *req, uint32_t flags, bool ownsRef)
+    : _req(req),
+      _flags(flags),
+      _ownsRef(ownsRef),
+      _prepared(false),
+      _compression(),
+      _uncompressedLen(0),
+      _body()
+{
+}
 
 FRT_RPCPacket::~FRT_RPCPacket() { }
 
 void
 FRT_RPCPacket::Free()
 {
+    // packets live in the request stash and are not destructed
+    _body.reset();
     if (_ownsRef) {
         _req->DiscardBlobs();
         _req->SubRef();
     }
 }
 
+
+bool
+FRT_RPCPacket::PacketIsHostEndian()
+{
+    uint32_t packet_endian = ((_flags & FLAG_FRT_RPC_LITTLE_ENDIAN) != 0)
+                             ? FNET_Info::ENDIAN_LITTLE : FNET_Info::ENDIAN_BIG;
+    return (packet_endian == FNET_Info::GetEndian());
+}
+
+
+template <typename EncodeBody>
+void
+FRT_RPCPacket::PrepareBody(uint32_t bodyLen, EncodeBody &&encodeBody)
+{
+    if (_prepared) {
+        return;
+    }
+    _prepared = true;
+    if (!_compression.useCompression() || bodyLen < _compression.minSize
+        || bodyLen > MAX_UNCOMPRESSED_SIZE)
+    {
+        return;
+    }
+    FNET_DataBuffer body(bodyLen);
+    encodeBody(&body);
+    vespalib::ConstBufferRef src(body.GetData(), body.GetDataLen());
+    _body = std::make_unique<vespalib::DataBuffer>();
+    auto type = vespalib::compression::compress(_compression, src, *_body, false);
+    _uncompressedLen = bodyLen;
+    if (CompressionConfig::isCompressed(type)) {
+        _compression.type = type;
+        _flags |= FLAG_FRT_RPC_COMPRESSED;
+    }
+}
+
+
+uint32_t
+FRT_RPCPacket::GetPreparedLength()
+{
+    return (Compressed() ? COMPRESSION_HEADER_SIZE : 0) + _body->getDataLen();
+}
+
+
+void
+FRT_RPCPacket::EncodePrepared(FNET_DataBuffer *dst)
+{
+    if (Compressed()) {
+        dst->WriteInt8Fast(_compression.type);
+        if (PacketIsHostEndian()) {
+            uint32_t tmp = _uncompressedLen;
+            dst->WriteBytesFast(&tmp, sizeof(tmp));
+        } else {
+            dst->WriteInt32Fast(_uncompressedLen);
+        }
+    }
+    // the body buffer lives until the packet is freed
+    dst->WriteBytesRefFast(_body->getData(), _body->getDataLen());
+}
+
+
+bool
+FRT_RPCPacket::Decompress(FNET_DataBuffer *src, uint32_t len, vespalib::DataBuffer &dst)
+{
+    if (len < COMPRESSION_HEADER_SIZE) {
+        src->DataToDead(len);
+        return false;
+    }
+    auto type = CompressionConfig::toType(src->ReadInt8());
+    uint32_t uncompressedLen = LittleEndian() ? src->ReadInt32Reverse() : src->ReadInt32();
+    len -= COMPRESSION_HEADER_SIZE;
+    // the uncompressed size comes from the peer; do not trust it
+    bool ok = CompressionConfig::isCompressed(type) && (uncompressedLen <= MAX_UNCOMPRESSED_SIZE);
+    if (ok) {
+        try {
+            vespalib::ConstBufferRef compressed(src->GetData(), len);
+            vespalib::compression::decompress(type, uncompressedLen, compressed, dst, false);
+            ok = (dst.getDataLen() == uncompressedLen);
+        } catch (const std::exception &) {
+            ok = false;
+        }
+    }
+    src->DataToDead(len);
+    return ok;
+}
+
 //--------------------------------------------------------------------
 
+void
+FRT_RPCRequestPacket::Prepare()
+{
+    PrepareBody(GetBodyLength(), [this](FNET_DataBuffer *dst) { EncodeBody(dst); });
+}
+
+
 uint32_t
 FRT_RPCRequestPacket::GetPCODE()
 {
+    Prepare();
     return (_flags << 16) + PCODE_FRT_RPC_REQUEST;
 }
 
 
 uint32_t
-FRT_RPCRequestPacket::GetLength()
+FRT_RPCRequestPacket::GetBodyLength()
 {
     return (sizeof(uint32_t)
             + _req->GetMethodNameLen()
@@ -36,8 +151,16 @@ FRT_RPCRequestPacket::GetLength()
 }
 
 
+uint32_t
+FRT_RPCRequestPacket::GetLength()
+{
+    Prepare();
+    return _body ? GetPreparedLength() : GetBodyLength();
+}
+
+
 void
-FRT_RPCRequestPacket::Encode(FNET_DataBuffer *dst)
+FRT_RPCRequestPacket::EncodeBody(FNET_DataBuffer *dst)
 {
     uint32_t packet_endian = ((_flags & FLAG_FRT_RPC_LITTLE_ENDIAN) != 0)
                              ? FNET_Info::ENDIAN_LITTLE : FNET_Info::ENDIAN_BIG;
@@ -59,8 +182,20 @@ FRT_RPCRequestPacket::Encode(FNET_DataBuffer *dst)
 }
 
 
+void
+FRT_RPCRequestPacket::Encode(FNET_DataBuffer *dst)
+{
+    Prepare();
+    if (_body) {
+        EncodePrepared(dst);
+    } else {
+        EncodeBody(dst);
+    }
+}
+
+
 bool
-FRT_RPCRequestPacket::Decode(FNET_DataBuffer *src, uint32_t len)
+FRT_RPCRequestPacket::DecodeBody(FNET_DataBuffer *src, uint32_t len)
 {
     uint32_t packet_endian = ((_flags & FLAG_FRT_RPC_LITTLE_ENDIAN) != 0)
                              ? FNET_Info::ENDIAN_LITTLE : FNET_Info::ENDIAN_BIG;
@@ -88,6 +223,22 @@ error:
 }
 
 
+bool
+FRT_RPCRequestPacket::Decode(FNET_DataBuffer *src, uint32_t len)
+{
+    if (Compressed()) {
+        vespalib::DataBuffer body;
+        if (!Decompress(src, len, body)) {
+            return false;
+        }
+        FNET_DataBuffer buf(body.getData(), body.getDataLen());
+        buf.FreeToData(body.getDataLen());
+        return DecodeBody(&buf, body.getDataLen());
+    }
+    return DecodeBody(src, len);
+}
+
+
 vespalib::string
 FRT_RPCRequestPacket::Print(uint32_t indent)
 {
@@ -104,22 +255,38 @@ FRT_RPCRequestPacket::Print(uint32_t indent)
 
 //--------------------------------------------------------------------
 
+void
+FRT_RPCReplyPacket::Prepare()
+{
+    PrepareBody(GetBodyLength(), [this](FNET_DataBuffer *dst) { EncodeBody(dst); });
+}
+
+
 uint32_t
 FRT_RPCReplyPacket::GetPCODE()
 {
+    Prepare();
     return (_flags << 16) + PCODE_FRT_RPC_REPLY;
 }
 
 
 uint32_t
-FRT_RPCReplyPacket::GetLength()
+FRT_RPCReplyPacket::GetBodyLength()
 {
     return _req->GetReturn()->GetLength();
 }
 
 
+uint32_t
+FRT_RPCReplyPacket::GetLength()
+{
+    Prepare();
+    return _body ? GetPreparedLength() : GetBodyLength();
+}
+
+
 void
-FRT_RPCReplyPacket::Encode(FNET_DataBuffer *dst)
+FRT_RPCReplyPacket::EncodeBody(FNET_DataBuffer *dst)
 {
     uint32_t packet_endian = ((_flags & FLAG_FRT_RPC_LITTLE_ENDIAN) != 0)
                              ? FNET_Info::ENDIAN_LITTLE : FNET_Info::ENDIAN_BIG;
@@ -134,8 +301,20 @@ FRT_RPCReplyPacket::Encode(FNET_DataBuffer *dst)
 }
 
 
+void
+FRT_RPCReplyPacket::Encode(FNET_DataBuffer *dst)
+{
+    Prepare();
+    if (_body) {
+        EncodePrepared(dst);
+    } else {
+        EncodeBody(dst);
+    }
+}
+
+
 bool
-FRT_RPCReplyPacket::Decode(FNET_DataBuffer *src, uint32_t len)
+FRT_RPCReplyPacket::DecodeBody(FNET_DataBuffer *src, uint32_t len)
 {
     uint32_t packet_endian = ((_flags & FLAG_FRT_RPC_LITTLE_ENDIAN) != 0)
                              ? FNET_Info::ENDIAN_LITTLE : FNET_Info::ENDIAN_BIG;
@@ -149,6 +328,22 @@ FRT_RPCReplyPacket::Decode(FNET_DataBuffer *src, uint32_t len)
 }
 
 
+bool
+FRT_RPCReplyPacket::Decode(FNET_DataBuffer *src, uint32_t len)
+{
+    if (Compressed()) {
+        vespalib::DataBuffer body;
+        if (!Decompress(src, len, body)) {
+            return false;
+        }
+        FNET_DataBuffer buf(body.getData(), body.getDataLen());
+        buf.FreeToData(body.getDataLen());
+        return DecodeBody(&buf, body.getDataLen());
+    }
+    return DecodeBody(src, len);
+}
+
+
 vespalib::string
 FRT_RPCReplyPacket::Print(uint32_t indent)
 {
@@ -251,6 +446,10 @@ FRT_PacketFactory::CreatePacket(uint32_t pcode, FNET_Context context)
     if (req == nullptr || (flags & ~FLAG_FRT_RPC_SUPPORTED_MASK) != 0)
         return nullptr;
 
+    // compressed packets are only accepted after negotiation
+    if ((flags & FLAG_FRT_RPC_COMPRESSED) != 0 && !req->AcceptCompressed())
+        return nullptr;
+
     vespalib::Stash & stash = req->getStash();
     pcode &= 0xffff; // remove flags
 
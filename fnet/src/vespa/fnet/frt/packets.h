@@ -5,8 +5,11 @@
 #include <vespa/fnet/packet.h>
 #include <vespa/fnet/ipacketfactory.h>
 #include <vespa/vespalib/util/traits.h>
+#include <vespa/vespalib/util/compressionconfig.h>
+#include <memory>
 
 class FRT_RPCRequest;
+namespace vespalib { class DataBuffer; }
 
 enum {
     PCODE_FRT_RPC_FIRST          = 100,
@@ -20,29 +23,85 @@ enum {
 enum {
     FLAG_FRT_RPC_LITTLE_ENDIAN  = 0x0001,
     FLAG_FRT_RPC_NOREPLY        = 0x0002,
-    FLAG_FRT_RPC_SUPPORTED_MASK = 0x0003
+    FLAG_FRT_RPC_COMPRESSED     = 0x0004,
+    FLAG_FRT_RPC_SUPPORTED_MASK = 0x0007
 };
 
 
+/**
+ * Request and reply packets may have their body (everything after
+ * the packet header) compressed. This is flagged with
+ * FLAG_FRT_RPC_COMPRESSED, and the body is then replaced by the
+ * compression type (8 bits), the uncompressed body size (32 bits,
+ * packet endian) and the compressed body. Compression is only used
+ * on connections where the peer has announced that it understands
+ * it (see frt.rpc.negotiateCompression), and compressed packets
+ * received on other connections are rejected. Bodies larger than
+ * MAX_UNCOMPRESSED_SIZE are never compressed, and compressed packets
+ * claiming a larger body are rejected without decompressing them.
+ **/
 class FRT_RPCPacket : public FNET_Packet
 {
+public:
+    static constexpr uint32_t MAX_UNCOMPRESSED_SIZE = 256u * 1024u * 1024u;
+
 protected:
-    FRT_RPCRequest *_req;
-    uint32_t        _flags;
-    bool            _ownsRef;
+    using CompressionConfig = vespalib::compression::CompressionConfig;
+
+    FRT_RPCRequest   *_req;
+    uint32_t          _flags;
+    bool              _ownsRef;
+    bool              _prepared;        // body encoding decided
+    CompressionConfig _compression;     // used when encoding
+    uint32_t          _uncompressedLen; // body size before compression
+    std::unique_ptr<vespalib::DataBuffer> _body; // pre-encoded body
 
     FRT_RPCPacket(const FRT_RPCPacket &);
     FRT_RPCPacket &operator=(const FRT_RPCPacket &);
 
+    bool PacketIsHostEndian();
+
+    /**
+     * Try to compress the packet body if compression is enabled for
+     * this packet and the body is large enough. The encoded body is
+     * kept in the packet, and the compressed flag is set if
+     * compression paid off. Only the first call has any effect.
+     *
+     * @param bodyLen size of the uncompressed body
+     * @param encodeBody encodes the uncompressed body into a buffer
+     **/
+    template <typename EncodeBody>
+    void PrepareBody(uint32_t bodyLen, EncodeBody &&encodeBody);
+
+    uint32_t GetPreparedLength();
+    void EncodePrepared(FNET_DataBuffer *dst);
+
+    /**
+     * Decompress a compressed packet body.
+     *
+     * @return false if the body could not be decompressed
+     * @param src packet data
+     * @param len packet length
+     * @param dst where to put the uncompressed body
+     **/
+    bool Decompress(FNET_DataBuffer *src, uint32_t len, vespalib::DataBuffer &dst);
+
 public:
-    FRT_RPCPacket(FRT_RPCRequest *req, uint32_t flags, bool ownsRef)
-        : _req(req),
-          _flags(flags),
-          _ownsRef(ownsRef)
-    {}
+    FRT_RPCPacket(FRT_RPCRequest *req, uint32_t flags, bool ownsRef);
 
     bool LittleEndian() { return (_flags & FLAG_FRT_RPC_LITTLE_ENDIAN) != 0; }
     bool NoReply() { return (_flags & FLAG_FRT_RPC_NOREPLY) != 0; }
+    bool Compressed() { return (_flags & FLAG_FRT_RPC_COMPRESSED) != 0; }
+
+    /**
+     * Allow the body of this packet to be compressed when it is
+     * encoded. Only use this if the peer has announced that it
+     * understands compressed packets.
+     *
+     * @param config how to compress; minSize is the smallest body
+     *               that will be compressed.
+     **/
+    void SetCompression(const CompressionConfig &config) { _compression = config; }
 
     ~FRT_RPCPacket();
     void Free() override;
@@ -51,6 +110,12 @@ public:
 
 class FRT_RPCRequestPacket : public FRT_RPCPacket
 {
+private:
+    uint32_t GetBodyLength();
+    void EncodeBody(FNET_DataBuffer *dst);
+    bool DecodeBody(FNET_DataBuffer *src, uint32_t len);
+    void Prepare();
+
 public:
     FRT_RPCRequestPacket(FRT_RPCRequest *req,
                          uint32_t flags,
@@ -67,6 +132,12 @@ public:
 
 class FRT_RPCReplyPacket : public FRT_RPCPacket
 {
+private:
+    uint32_t GetBodyLength();
+    void EncodeBody(FNET_DataBuffer *dst);
+    bool DecodeBody(FNET_DataBuffer *src, uint32_t len);
+    void Prepare();
+
 public:
     FRT_RPCReplyPacket(FRT_RPCRequest *req,
                        uint32_t flags,
@@ -17,6 +17,7 @@ FRT_RPCRequest::FRT_RPCRequest()
       _methodNameLen(0),
       _errorMessage(nullptr),
       _methodName(nullptr),
+      _acceptCompressed(false),
       _detachedPT(nullptr),
       _abortHandler(nullptr),
       _returnHandler(nullptr),
@@ -108,6 +109,7 @@ FRT_RPCRequest::Reset() {
     _errorMessage = nullptr;
     _methodNameLen = 0;
     _methodName = nullptr;
+    _acceptCompressed = false;
     _detachedPT = nullptr;
     _completed = 0;
     _abortHandler = nullptr;
@@ -156,7 +158,7 @@ FRT_RPCRequest::Print(uint32_t indent)
 
 
 FNET_Packet *
-FRT_RPCRequest::CreateRequestPacket(bool wantReply)
+FRT_RPCRequest::CreateRequestPacket(bool wantReply, const CompressionConfig &compression)
 {
     uint32_t flags = 0;
     if (FNET_Info::GetEndian() == FNET_Info::ENDIAN_LITTLE)
@@ -167,12 +169,14 @@ FRT_RPCRequest::CreateRequestPacket(bool wantReply)
     else
         flags |= FLAG_FRT_RPC_NOREPLY;
 
-    return &_stash.create<FRT_RPCRequestPacket>(this, flags, true);
+    auto &packet = _stash.create<FRT_RPCRequestPacket>(this, flags, true);
+    packet.SetCompression(compression);
+    return &packet;
 }
 
 
 FNET_Packet *
-FRT_RPCRequest::CreateReplyPacket()
+FRT_RPCRequest::CreateReplyPacket(const CompressionConfig &compression)
 {
     uint32_t flags = 0;
     if (FNET_Info::GetEndian() == FNET_Info::ENDIAN_LITTLE)
@@ -181,6 +185,8 @@ FRT_RPCRequest::CreateReplyPacket()
     if (IsError()) {
         return &_stash.create<FRT_RPCErrorPacket>(this, flags, true);
     } else {
-        return &_stash.create<FRT_RPCReplyPacket>(this, flags, true);
+        auto &packet = _stash.create<FRT_RPCReplyPacket>(this, flags, true);
+        packet.SetCompression(compression);
+        return &packet;
     }
 }
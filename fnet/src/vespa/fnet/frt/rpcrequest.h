@@ -6,6 +6,7 @@
 #include "error.h"
 #include <vespa/fnet/context.h>
 #include <vespa/vespalib/util/stash.h>
+#include <vespa/vespalib/util/compressionconfig.h>
 #include <atomic>
 
 class FNETConnection;
@@ -66,6 +67,7 @@ private:
     uint32_t         _methodNameLen;
     char            *_errorMessage;
     char            *_methodName;
+    bool             _acceptCompressed;
 
     bool                *_detachedPT;
     FRT_IAbortHandler   *_abortHandler;
@@ -130,8 +132,13 @@ public:
 
     void Print(uint32_t indent = 0);
 
-    FNET_Packet *CreateRequestPacket(bool wantReply);
-    FNET_Packet *CreateReplyPacket();
+    using CompressionConfig = vespalib::compression::CompressionConfig;
+    FNET_Packet *CreateRequestPacket(bool wantReply, const CompressionConfig &compression = CompressionConfig());
+    FNET_Packet *CreateReplyPacket(const CompressionConfig &compression = CompressionConfig());
+
+    // whether a compressed packet may be decoded for this request
+    void SetAcceptCompressed(bool value) { _acceptCompressed = value; }
+    bool AcceptCompressed() const { return _acceptCompressed; }
 
     void SetDetachedPT(bool *detachedPT) { _detachedPT = detachedPT; }
     FRT_RPCRequest *Detach() { *_detachedPT = true; return this; }
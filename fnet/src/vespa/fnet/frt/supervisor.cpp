@@ -9,6 +9,50 @@
 #include <vespa/fnet/connector.h>
 #include <vespa/fastos/thread.h>
 
+namespace {
+
+using vespalib::compression::CompressionConfig;
+
+constexpr double NEGOTIATE_COMPRESSION_TIMEOUT = 60.0;
+
+uint32_t compression_bit(CompressionConfig::Type type) {
+    return (1u << type);
+}
+
+// compression types that can be decoded by any supervisor
+uint32_t accepted_compression_types() {
+    return compression_bit(CompressionConfig::LZ4) | compression_bit(CompressionConfig::ZSTD);
+}
+
+/**
+ * Completes compression negotiation on the client side of a
+ * connection. Lives in the stash of the negotiation request.
+ **/
+class CompressionNegotiation : public FRT_IRequestWait
+{
+private:
+    FNET_Connection   *_conn;
+    CompressionConfig  _config;
+public:
+    CompressionNegotiation(FNET_Connection *conn, const CompressionConfig &config)
+        : _conn(conn), _config(config)
+    {
+        _conn->AddRef();
+    }
+    void RequestDone(FRT_RPCRequest *req) override {
+        // peers not supporting compression fail with FRTE_RPC_NO_SUCH_METHOD
+        if (!req->IsError() && req->CheckReturnTypes("i")
+            && (req->GetReturn()->GetValue(0)._intval32 & compression_bit(_config.type)) != 0)
+        {
+            _conn->SetOutputCompression(_config);
+        }
+        _conn->SubRef();
+        req->SubRef(); // destructs this object
+    }
+};
+
+}
+
 FRT_Supervisor::FRT_Supervisor(FNET_Transport *transport)
     : _transport(transport),
       _packetFactory(),
@@ -17,7 +61,8 @@ FRT_Supervisor::FRT_Supervisor(FNET_Transport *transport)
       _reflectionManager(),
       _rpcHooks(&_reflectionManager),
       _connHooks(*this),
-      _methodMismatchHook()
+      _methodMismatchHook(),
+      _compression()
 {
     _rpcHooks.InitRPC(this);
 }
@@ -63,8 +108,9 @@ FRT_Target *
 FRT_Supervisor::GetTarget(const char *spec)
 {
     FNET_TransportThread *thread = _transport->select_thread(spec, strlen(spec));
-    return new FRT_Target(thread->GetScheduler(),
-                          thread->Connect(spec, &_packetStreamer));
+    FNET_Connection *conn = thread->Connect(spec, &_packetStreamer);
+    NegotiateCompression(thread, conn);
+    return new FRT_Target(thread->GetScheduler(), conn);
 }
 
 
@@ -72,10 +118,11 @@ FRT_Target *
 FRT_Supervisor::Get2WayTarget(const char *spec, FNET_Context connContext)
 {
     FNET_TransportThread *thread = _transport->select_thread(spec, strlen(spec));
-    return new FRT_Target(thread->GetScheduler(),
-                          thread->Connect(spec, &_packetStreamer,
-                                  nullptr, FNET_Context(),
-                                  this, connContext));
+    FNET_Connection *conn = thread->Connect(spec, &_packetStreamer,
+                                            nullptr, FNET_Context(),
+                                            this, connContext);
+    NegotiateCompression(thread, conn);
+    return new FRT_Target(thread->GetScheduler(), conn);
 }
 
 
@@ -88,6 +135,22 @@ FRT_Supervisor::GetTarget(int port)
 }
 
 
+void
+FRT_Supervisor::NegotiateCompression(FNET_TransportThread *thread, FNET_Connection *conn)
+{
+    if (conn == nullptr || !_compression.useCompression()) {
+        return;
+    }
+    FRT_RPCRequest *req = AllocRPCRequest();
+    req->SetMethodName("frt.rpc.negotiateCompression");
+    req->GetParams()->AddInt32(accepted_compression_types());
+    // the peer may compress its replies as soon as it has seen this request
+    conn->SetAcceptCompressed(true);
+    auto &waiter = req->getStash().create<CompressionNegotiation>(conn, _compression);
+    InvokeAsync(thread, conn, req, NEGOTIATE_COMPRESSION_TIMEOUT, &waiter);
+}
+
+
 FRT_RPCRequest *
 FRT_Supervisor::AllocRPCRequest(FRT_RPCRequest *tradein)
 {
@@ -134,7 +197,7 @@ FRT_Supervisor::InvokeVoid(FNET_Connection *conn, FRT_RPCRequest *req)
 {
     if (conn != nullptr) {
         FNET_Channel *ch = conn->OpenChannel();
-        ch->Send(req->CreateRequestPacket(false));
+        ch->Send(req->CreateRequestPacket(false, conn->GetOutputCompression()));
         ch->Free();
     } else {
         req->SubRef();
@@ -146,8 +209,10 @@ void
 FRT_Supervisor::InvokeAsync(SchedulerPtr scheduler, FNET_Connection *conn, FRT_RPCRequest *req, double timeout, FRT_IRequestWait *waiter)
 {
     uint32_t chid;
-    FNET_Packet *packet = req->CreateRequestPacket(true);
+    FNET_Packet *packet = req->CreateRequestPacket(true, (conn == nullptr)
+                                                   ? CompressionConfig() : conn->GetOutputCompression());
     FRT_RPCAdapter *adapter = &req->getStash().create<FRT_RPCAdapter>(scheduler.ptr, req, waiter);
+    req->SetAcceptCompressed((conn != nullptr) && conn->AcceptCompressed());
     FNET_Channel *ch = (conn == nullptr)? nullptr : conn->OpenChannel(adapter, FNET_Context((void *)req), &chid);
 
     adapter->SetChannel(ch);
@@ -192,6 +257,7 @@ FRT_Supervisor::InitChannel(FNET_Channel *channel, uint32_t pcode)
         channel->SetContext((void *)req);
         if (req != nullptr) {
             req->SetContext(FNET_Context(channel));
+            req->SetAcceptCompressed(channel->GetConnection()->AcceptCompressed());
             rc = true;
         }
     }
@@ -242,6 +308,7 @@ FRT_Supervisor::HandlePacket(FNET_Packet *packet, FNET_Context context)
 void
 FRT_Supervisor::RPCHooks::InitRPC(FRT_Supervisor *supervisor)
 {
+    _supervisor = supervisor;
     FRT_ReflectionBuilder rb(supervisor);
     //---------------------------------------------------------------------------
     rb.DefineMethod("frt.rpc.ping", "", "",
@@ -275,6 +342,13 @@ FRT_Supervisor::RPCHooks::InitRPC(FRT_Supervisor *supervisor)
     rb.ReturnDesc("returnNames", "Method return value names");
     rb.ReturnDesc("returnDesc",  "Method return value descriptions");
     //---------------------------------------------------------------------------
+    rb.DefineMethod("frt.rpc.negotiateCompression", "i", "i",
+                    FRT_METHOD(FRT_Supervisor::RPCHooks::RPC_NegotiateCompression),
+                    this);
+    rb.MethodDesc("Negotiate compression of packets sent on this connection");
+    rb.ParamDesc ("accepted", "Compression types accepted by the caller (bit mask of 1 << type)");
+    rb.ReturnDesc("accepted", "Compression types accepted by the callee (bit mask of 1 << type)");
+    //---------------------------------------------------------------------------
 }
 
 
@@ -316,6 +390,23 @@ FRT_Supervisor::RPCHooks::RPC_GetMethodInfo(FRT_RPCRequest *req)
     }
 }
 
+
+void
+FRT_Supervisor::RPCHooks::RPC_NegotiateCompression(FRT_RPCRequest *req)
+{
+    uint32_t accepted = req->GetParams()->GetValue(0)._intval32;
+    const CompressionConfig &config = _supervisor->GetCompression();
+    FNET_Connection *conn = req->GetConnection();
+    if (conn != nullptr) {
+        // the caller may compress its requests once it gets our reply
+        conn->SetAcceptCompressed(true);
+        if (config.useCompression() && (accepted & compression_bit(config.type)) != 0) {
+            conn->SetOutputCompression(config);
+        }
+    }
+    req->GetReturn()->AddInt32(accepted_compression_types());
+}
+
 //----------------------------------------------------
 // Connection Hooks
 //----------------------------------------------------
@@ -24,21 +24,25 @@ class FRT_Supervisor : public FNET_IServerAdapter,
                        public FNET_IPacketHandler
 {
 public:
+    using CompressionConfig = vespalib::compression::CompressionConfig;
+
     class RPCHooks : public FRT_Invokable
     {
     private:
         FRT_ReflectionManager *_reflectionManager;
+        FRT_Supervisor        *_supervisor;
     public:
         RPCHooks(const RPCHooks &) = delete;
         RPCHooks &operator=(const RPCHooks &) = delete;
         explicit RPCHooks(FRT_ReflectionManager *reflect)
-            : _reflectionManager(reflect) {}
+            : _reflectionManager(reflect), _supervisor(nullptr) {}
 
         void InitRPC(FRT_Supervisor *supervisor);
         void RPC_Ping(FRT_RPCRequest *req);
         void RPC_Echo(FRT_RPCRequest *req);
         void RPC_GetMethodList(FRT_RPCRequest *req);
         void RPC_GetMethodInfo(FRT_RPCRequest *req);
+        void RPC_NegotiateCompression(FRT_RPCRequest *req);
     };
 
     class ConnHooks : public FNET_IConnectionCleanupHandler,
@@ -73,6 +77,9 @@ private:
     RPCHooks                      _rpcHooks;
     ConnHooks                     _connHooks;
     std::unique_ptr<FRT_Method>   _methodMismatchHook;
+    CompressionConfig             _compression;
+
+    void NegotiateCompression(FNET_TransportThread *thread, FNET_Connection *conn);
 
 public:
     explicit FRT_Supervisor(FNET_Transport *transport);
@@ -99,6 +106,21 @@ public:
     void SetSessionFiniHook(FRT_METHOD_PT  method, FRT_Invokable *handler);
     void SetMethodMismatchHook(FRT_METHOD_PT  method, FRT_Invokable *handler);
 
+    /**
+     * Enable compression of large request and reply packets. Each
+     * new target connection will negotiate compression with its peer,
+     * and compression is used for requests on the connection if the
+     * peer accepts it. Replies are compressed on connections where
+     * the peer has requested compression and this supervisor has
+     * compression enabled. Must be called before any targets are
+     * created or connections are accepted.
+     *
+     * @param config how to compress; minSize is the smallest packet
+     *               body that will be compressed.
+     **/
+    void SetCompression(const CompressionConfig &config) { _compression = config; }
+    const CompressionConfig &GetCompression() const { return _compression; }
+
     struct SchedulerPtr {
         FNET_Scheduler *ptr;
         SchedulerPtr(FNET_Scheduler *scheduler)
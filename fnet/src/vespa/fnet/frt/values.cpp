@@ -1322,8 +1322,8 @@ FRT_Values::EncodeCopy(FNET_DataBuffer *dst)
 
         case FRT_VALUE_STRING:
             dst->WriteBytesFast(&(_values[i]._string._len), sizeof(uint32_t));
-            dst->WriteBytesFast(_values[i]._string._str,
-                                _values[i]._string._len);
+            dst->WriteBytesRefFast(_values[i]._string._str,
+                                   _values[i]._string._len);
             break;
 
         case FRT_VALUE_STRING_ARRAY:
@@ -1334,15 +1334,15 @@ FRT_Values::EncodeCopy(FNET_DataBuffer *dst)
             dst->WriteBytesFast(&len, sizeof(len));
             for (; len > 0; len--, pt++) {
                 dst->WriteBytesFast(&(pt->_len), sizeof(uint32_t));
-                dst->WriteBytesFast(pt->_str, pt->_len);
+                dst->WriteBytesRefFast(pt->_str, pt->_len);
             }
         }
         break;
 
         case FRT_VALUE_DATA:
             dst->WriteBytesFast(&(_values[i]._data._len), sizeof(uint32_t));
-            dst->WriteBytesFast(_values[i]._data._buf,
-                                _values[i]._data._len);
+            dst->WriteBytesRefFast(_values[i]._data._buf,
+                                   _values[i]._data._len);
             break;
 
         case FRT_VALUE_DATA_ARRAY:
@@ -1353,7 +1353,7 @@ FRT_Values::EncodeCopy(FNET_DataBuffer *dst)
             dst->WriteBytesFast(&len, sizeof(len));
             for (; len > 0; len--, pt++) {
                 dst->WriteBytesFast(&(pt->_len), sizeof(uint32_t));
-                dst->WriteBytesFast(pt->_buf, pt->_len);
+                dst->WriteBytesRefFast(pt->_buf, pt->_len);
             }
         }
         break;
@@ -1469,8 +1469,8 @@ FRT_Values::EncodeBig(FNET_DataBuffer *dst)
 
         case FRT_VALUE_STRING:
             dst->WriteInt32Fast(_values[i]._string._len);
-            dst->WriteBytesFast(_values[i]._string._str,
-                                _values[i]._string._len);
+            dst->WriteBytesRefFast(_values[i]._string._str,
+                                   _values[i]._string._len);
             break;
 
         case FRT_VALUE_STRING_ARRAY:
@@ -1481,15 +1481,15 @@ FRT_Values::EncodeBig(FNET_DataBuffer *dst)
             dst->WriteInt32Fast(len);
             for (; len > 0; len--, pt++) {
                 dst->WriteInt32Fast(pt->_len);
-                dst->WriteBytesFast(pt->_str, pt->_len);
+                dst->WriteBytesRefFast(pt->_str, pt->_len);
             }
         }
         break;
 
         case FRT_VALUE_DATA:
             dst->WriteInt32Fast(_values[i]._data._len);
-            dst->WriteBytesFast(_values[i]._data._buf,
-                                _values[i]._data._len);
+            dst->WriteBytesRefFast(_values[i]._data._buf,
+                                   _values[i]._data._len);
             break;
 
         case FRT_VALUE_DATA_ARRAY:
@@ -1500,7 +1500,7 @@ FRT_Values::EncodeBig(FNET_DataBuffer *dst)
             dst->WriteInt32Fast(len);
             for (; len > 0; len--, pt++) {
                 dst->WriteInt32Fast(pt->_len);
-                dst->WriteBytesFast(pt->_buf, pt->_len);
+                dst->WriteBytesRefFast(pt->_buf, pt->_len);
             }
         }
         break;
@@ -0,0 +1,125 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "output_segments.h"
+#include "packet.h"
+#include <algorithm>
+#include <cassert>
+#include <sys/uio.h>
+
+FNET_OutputSegments::FNET_OutputSegments()
+    : _consumed(0),
+      _segOffset(0),
+      _added(0),
+      _done(0),
+      _lastAdded(0),
+      _pendingBytes(0),
+      _segments(),
+      _held()
+{
+}
+
+FNET_OutputSegments::~FNET_OutputSegments()
+{
+    DiscardAll();
+}
+
+void
+FNET_OutputSegments::ReleasePackets()
+{
+    while (!_held.empty() && _held.front().segments <= _done) {
+        FNET_Packet *packet = _held.front().packet;
+        _held.pop_front();
+        packet->Free();
+    }
+}
+
+bool
+FNET_OutputSegments::AddReference(FNET_DataBuffer &buf, const void *src, uint32_t len)
+{
+    if (len < MIN_REFERENCE_SIZE) {
+        return false;
+    }
+    _segments.push_back(Segment{_consumed + buf.GetDataLen(), static_cast<const char *>(src), len});
+    ++_added;
+    _pendingBytes += len;
+    return true;
+}
+
+void
+FNET_OutputSegments::FreePacket(FNET_Packet *packet)
+{
+    if (_added != _lastAdded) {
+        _lastAdded = _added;
+        _held.push_back(HeldPacket{_added, packet});
+    } else {
+        packet->Free();
+    }
+}
+
+uint32_t
+FNET_OutputSegments::FillIOVec(FNET_DataBuffer &buf, struct iovec *iov, uint32_t max)
+{
+    uint32_t cnt = 0;
+    uint64_t pos = _consumed;
+    uint64_t end = _consumed + buf.GetDataLen();
+    uint32_t segOffset = _segOffset;
+    for (auto itr = _segments.begin(); itr != _segments.end() && cnt < max; ++itr) {
+        if (itr->pos > pos) {
+            iov[cnt].iov_base = buf.GetData() + (pos - _consumed);
+            iov[cnt].iov_len = itr->pos - pos;
+            pos = itr->pos;
+            if (++cnt == max) {
+                return cnt;
+            }
+        }
+        iov[cnt].iov_base = const_cast<char *>(itr->data + segOffset);
+        iov[cnt].iov_len = itr->len - segOffset;
+        segOffset = 0;
+        ++cnt;
+    }
+    if (cnt < max && end > pos) {
+        iov[cnt].iov_base = buf.GetData() + (pos - _consumed);
+        iov[cnt].iov_len = end - pos;
+        ++cnt;
+    }
+    return cnt;
+}
+
+void
+FNET_OutputSegments::Consume(FNET_DataBuffer &buf, uint64_t len)
+{
+    while (len > 0) {
+        if (!_segments.empty() && _segments.front().pos == _consumed) {
+            const Segment &seg = _segments.front();
+            uint32_t n = std::min(len, uint64_t(seg.len - _segOffset));
+            _segOffset += n;
+            len -= n;
+            if (_segOffset == seg.len) {
+                _pendingBytes -= seg.len;
+                _segOffset = 0;
+                _segments.pop_front();
+                ++_done;
+            }
+        } else {
+            uint64_t avail = _segments.empty()
+                             ? buf.GetDataLen()
+                             : (_segments.front().pos - _consumed);
+            uint32_t n = std::min(len, avail);
+            assert(n > 0);
+            buf.DataToDead(n);
+            _consumed += n;
+            len -= n;
+        }
+    }
+    ReleasePackets();
+}
+
+void
+FNET_OutputSegments::DiscardAll()
+{
+    _segments.clear();
+    _segOffset = 0;
+    _pendingBytes = 0;
+    _done = _added;
+    ReleasePackets();
+}
@@ -0,0 +1,118 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include "databuffer.h"
+#include <cstdint>
+#include <deque>
+
+class FNET_Packet;
+struct iovec;
+
+/**
+ * This class keeps track of large byte ranges that are referenced
+ * rather than copied into the output buffer of a connection. The
+ * logical output stream is the data in the output buffer with the
+ * referenced segments spliced in at the positions where they were
+ * written. Packets referencing segments are held until all their
+ * segments have been written to the socket, since the referenced
+ * memory is owned by the packet.
+ *
+ * This class has no locking; it is only used by the transport thread
+ * owning the connection.
+ **/
+class FNET_OutputSegments : public FNET_IDataReferenceSink
+{
+public:
+    /**
+     * Byte ranges smaller than this are copied into the output buffer.
+     **/
+    static constexpr uint32_t MIN_REFERENCE_SIZE = 16384;
+
+    /**
+     * Maximum number of io vectors filled by a single call to
+     * FillIOVec.
+     **/
+    static constexpr uint32_t MAX_IOV = 64;
+
+private:
+    struct Segment {
+        uint64_t    pos;  // position in output buffer stream
+        const char *data;
+        uint32_t    len;
+    };
+    struct HeldPacket {
+        uint64_t     segments; // segments added when packet was encoded
+        FNET_Packet *packet;
+    };
+
+    uint64_t               _consumed;     // buffer bytes written
+    uint32_t               _segOffset;    // bytes written from first segment
+    uint64_t               _added;        // segments added
+    uint64_t               _done;         // segments written
+    uint64_t               _lastAdded;    // _added at last FreePacket
+    uint64_t               _pendingBytes; // unwritten segment bytes
+    std::deque<Segment>    _segments;
+    std::deque<HeldPacket> _held;
+
+    void ReleasePackets();
+
+public:
+    FNET_OutputSegments(const FNET_OutputSegments &) = delete;
+    FNET_OutputSegments &operator=(const FNET_OutputSegments &) = delete;
+    FNET_OutputSegments();
+    ~FNET_OutputSegments() override;
+
+    bool AddReference(FNET_DataBuffer &buf, const void *src, uint32_t len) override;
+
+    /**
+     * Free a packet that has been encoded into the output buffer. If
+     * segments were referenced while encoding the packet, it is held
+     * until those segments have been written.
+     *
+     * @param packet the encoded packet.
+     **/
+    void FreePacket(FNET_Packet *packet);
+
+    /**
+     * Fill io vectors describing the logical output stream, starting
+     * at the first unwritten byte.
+     *
+     * @return number of io vectors filled.
+     * @param buf the output buffer.
+     * @param iov io vectors to fill.
+     * @param max maximum number of io vectors to fill.
+     **/
+    uint32_t FillIOVec(FNET_DataBuffer &buf, struct iovec *iov, uint32_t max);
+
+    /**
+     * Mark bytes of the logical output stream as written. Buffer data
+     * is moved to the dead part of the buffer, and packets whose
+     * segments have all been written are freed.
+     *
+     * @param buf the output buffer.
+     * @param len number of bytes written.
+     **/
+    void Consume(FNET_DataBuffer &buf, uint64_t len);
+
+    /**
+     * Drop all segments and free all held packets. Used when the
+     * connection is closed with unwritten output.
+     **/
+    void DiscardAll();
+
+    /**
+     * @return whether there are any unwritten segments.
+     **/
+    bool IsEmpty() const { return _segments.empty(); }
+
+    /**
+     * @return number of unwritten bytes in referenced segments.
+     **/
+    uint64_t GetPendingBytes() const { return _pendingBytes; }
+
+    /**
+     * @return number of packets currently held.
+     **/
+    uint32_t GetHeldPacketCnt() const { return _held.size(); }
+};
@@ -3,9 +3,18 @@
 #include "transport.h"
 #include "transport_thread.h"
 #include "iocomponent.h"
+#include "connector.h"
+#include <vespa/vespalib/net/server_socket.h>
+#include <vespa/vespalib/net/socket_spec.h>
 #include <chrono>
 #include <xxhash.h>
 
+#include <vespa/log/log.h>
+LOG_SETUP(".fnet");
+
+using vespalib::ServerSocket;
+using vespalib::SocketSpec;
+
 namespace {
 
 struct HashState {
@@ -28,7 +37,8 @@ FNET_Transport::FNET_Transport(vespalib::AsyncResolver::SP resolver, vespalib::C
     : _async_resolver(std::move(resolver)),
       _crypto_engine(std::move(crypto)),
       _work_pool(1, 128 * 1024, fnet_work_pool, 1024),
-      _threads()
+      _threads(),
+      _reuse_port(false)
 {
     assert(num_threads >= 1);
     for (size_t i = 0; i < num_threads; ++i) {
@@ -69,16 +79,38 @@ FNET_TransportThread *
 FNET_Transport::select_thread(const void *key, size_t key_len) const
 {
     HashState hash_state(key, key_len);
-    size_t hash_value = XXH64(&hash_state, sizeof(hash_state), 0);
-    size_t thread_id = (hash_value % _threads.size());
-    return _threads[thread_id].get();
+    uint64_t hash_value = XXH64(&hash_state, sizeof(hash_state), 0);
+    FNET_TransportThread *first = _threads[(hash_value & 0xffffffff) % _threads.size()].get();
+    FNET_TransportThread *second = _threads[(hash_value >> 32) % _threads.size()].get();
+    return (second->GetLoad() < first->GetLoad()) ? second : first;
 }
 
 FNET_Connector *
 FNET_Transport::Listen(const char *spec, FNET_IPacketStreamer *streamer,
                        FNET_IServerAdapter *serverAdapter)
 {
-    return select_thread(spec, strlen(spec))->Listen(spec, streamer, serverAdapter);
+    FNET_TransportThread *primary = select_thread(spec, strlen(spec));
+    SocketSpec socket_spec(spec);
+    if (!_reuse_port || (_threads.size() == 1) || (socket_spec.port() < 0)) {
+        return primary->Listen(spec, streamer, serverAdapter);
+    }
+    ServerSocket server_socket(socket_spec, true);
+    if (!server_socket.valid()) {
+        LOG(debug, "Transport: could not listen with SO_REUSEPORT on '%s', using a single socket", spec);
+        return primary->Listen(spec, streamer, serverAdapter);
+    }
+    SocketSpec shard_spec = socket_spec.replace_port(server_socket.address().port());
+    std::vector<FNET_Connector *> shards;
+    for (const auto &thread: _threads) {
+        if (thread.get() != primary) {
+            FNET_Connector *shard = thread->Listen(spec, ServerSocket(shard_spec, true),
+                                                   streamer, serverAdapter, true, {});
+            if (shard != nullptr) {
+                shards.push_back(shard);
+            }
+        }
+    }
+    return primary->Listen(spec, std::move(server_socket), streamer, serverAdapter, true, std::move(shards));
 }
 
 FNET_Connection *
@@ -133,6 +165,25 @@ FNET_Transport::SetTCPNoDelay(bool noDelay)
     }
 }
 
+std::vector<FNET_TransportThreadStats>
+FNET_Transport::get_thread_stats() const
+{
+    std::vector<FNET_TransportThreadStats> result;
+    result.reserve(_threads.size());
+    for (const auto &thread: _threads) {
+        result.push_back(thread->get_stats());
+    }
+    return result;
+}
+
+void
+FNET_Transport::SetBusyPollTime(std::chrono::microseconds time)
+{
+    for (const auto &thread: _threads) {
+        thread->SetBusyPollTime(time);
+    }
+}
+
 void
 FNET_Transport::sync()
 {
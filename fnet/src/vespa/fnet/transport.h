@@ -3,6 +3,8 @@
 #pragma once
 
 #include "context.h"
+#include "transport_thread_stats.h"
+#include <chrono>
 #include <memory>
 #include <vector>
 #include <vespa/vespalib/net/async_resolver.h>
@@ -32,6 +34,7 @@ private:
     vespalib::CryptoEngine::SP _crypto_engine;
     vespalib::ThreadStackExecutor _work_pool;
     Threads _threads;
+    bool _reuse_port;
 
 public:
     /**
@@ -100,9 +103,10 @@ public:
     vespalib::CryptoSocket::UP create_server_crypto_socket(vespalib::SocketHandle socket);
 
     /**
-     * Select one of the underlying transport threads. The selection
-     * is based on hashing the given key as well as the current stack
-     * pointer.
+     * Select one of the underlying transport threads. Two candidates
+     * are picked based on hashing the given key as well as the
+     * current stack pointer, and the one with the lowest recent load
+     * is selected.
      *
      * @return selected transport thread
      **/
@@ -117,7 +121,9 @@ public:
      * a port number. Example: listen for tcp/ip connections on port
      * 8001: spec = 'tcp/8001'. If you want to enable strict binding you
      * may supply a hostname as well, like this:
-     * 'tcp/mycomputer.mydomain:8001'.
+     * 'tcp/mycomputer.mydomain:8001'. With SO_REUSEPORT enabled (see
+     * @ref SetReusePort), each transport thread gets its own socket
+     * listening on the tcp port, all owned by the returned connector.
      *
      * @return the connector object, or nullptr if listen failed.
      * @param spec string specifying how and where to listen.
@@ -215,6 +221,38 @@ public:
      **/
     void SetTCPNoDelay(bool noDelay);
 
+    /**
+     * Set the maximum time transport threads will spin, polling for
+     * events without blocking, before they block waiting for
+     * events. This trades cpu usage for lower latency when handing
+     * work over to the transport threads; threads back off when idle.
+     * 0 (the default) disables busy-polling. Must be set before the
+     * transport is started.
+     *
+     * @param time maximum time to spin before blocking.
+     **/
+    void SetBusyPollTime(std::chrono::microseconds time);
+
+    /**
+     * Enable or disable sharding of tcp listen sockets across
+     * transport threads using the SO_REUSEPORT socket option. When
+     * enabled, the kernel spreads incoming connections among the
+     * transport threads instead of having a single thread accept all
+     * of them. Only affects subsequent calls to Listen. Listening
+     * falls back to a single socket if the option is not supported.
+     *
+     * @param reusePort true if listen sockets should be sharded.
+     **/
+    void SetReusePort(bool reusePort) { _reuse_port = reusePort; }
+
+    /**
+     * Obtain load metrics for each of the underlying transport
+     * threads.
+     *
+     * @return load metrics, one entry per transport thread
+     **/
+    std::vector<FNET_TransportThreadStats> get_thread_stats() const;
+
     /**
      * Synchronize with all transport threads. This method will block
      * until all events posted before this method was invoked has been
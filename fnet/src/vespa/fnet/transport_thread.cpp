@@ -45,7 +45,7 @@ FNET_TransportThread::AddComponent(FNET_IOComponent *comp)
         _componentsTail = comp;
         if (_timeOutHead == nullptr)
             _timeOutHead = comp;
-        _componentCnt++;
+        _componentCnt.store(_componentCnt.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
     } else {
         comp->_ioc_prev = nullptr;
         comp->_ioc_next = _componentsHead;
@@ -55,7 +55,7 @@ FNET_TransportThread::AddComponent(FNET_IOComponent *comp)
             _componentsHead->_ioc_prev = comp;
         }
         _componentsHead = comp;
-        _componentCnt++;
+        _componentCnt.store(_componentCnt.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
     }
 }
 
@@ -73,7 +73,7 @@ FNET_TransportThread::RemoveComponent(FNET_IOComponent *comp)
         comp->_ioc_prev->_ioc_next = comp->_ioc_next;
     if (comp->_ioc_next != nullptr)
         comp->_ioc_next->_ioc_prev = comp->_ioc_prev;
-    _componentCnt--;
+    _componentCnt.store(_componentCnt.load(std::memory_order_relaxed) - 1, std::memory_order_relaxed);
 }
 
 
@@ -123,8 +123,10 @@ FNET_TransportThread::PostEvent(FNET_ControlPacket *cpacket,
         }
         wasEmpty = _queue.IsEmpty_NoLock();
         _queue.QueuePacket_NoLock(cpacket, context);
+        _eventsQueued.store(true, std::memory_order_relaxed);
     }
-    if (wasEmpty) {
+    if (wasEmpty && _pollBlocking.load(std::memory_order_relaxed)) {
+        _wakeups.fetch_add(1, std::memory_order_relaxed);
         _selector.wakeup();
     }
     return true;
@@ -223,7 +225,19 @@ FNET_TransportThread::FNET_TransportThread(FNET_Transport &owner_in)
       _started(false),
       _shutdown(false),
       _finished(false),
-      _waitFinished(false)
+      _waitFinished(false),
+      _ioEvents(0),
+      _busyTime(0),
+      _load(0),
+      _loadStart(_now),
+      _loadBusy(clock::duration::zero()),
+      _eventsQueued(false),
+      _pollBlocking(true),
+      _maxSpinTime(clock::duration::zero()),
+      _spinTime(clock::duration::zero()),
+      _spinHits(0),
+      _blockingPolls(0),
+      _wakeups(0)
 {
     trapsigpipe();
 }
@@ -256,14 +270,27 @@ FNET_Connector*
 FNET_TransportThread::Listen(const char *spec, FNET_IPacketStreamer *streamer,
                              FNET_IServerAdapter *serverAdapter)
 {
-    ServerSocket server_socket{SocketSpec(spec)};
+    return Listen(spec, ServerSocket{SocketSpec(spec)}, streamer, serverAdapter, false, {});
+}
+
+
+FNET_Connector*
+FNET_TransportThread::Listen(const char *spec, ServerSocket server_socket,
+                             FNET_IPacketStreamer *streamer, FNET_IServerAdapter *serverAdapter,
+                             bool sharded, std::vector<FNET_Connector *> shards)
+{
     if (server_socket.valid() && server_socket.set_blocking(false)) {
-        FNET_Connector *connector = new FNET_Connector(this, streamer, serverAdapter, spec, std::move(server_socket));
+        FNET_Connector *connector = new FNET_Connector(this, streamer, serverAdapter, spec, std::move(server_socket),
+                                                       sharded, std::move(shards));
         connector->EnableReadEvent(true);
         connector->AddRef_NoLock();
         Add(connector, /* needRef = */ false);
         return connector;
     }
+    for (FNET_Connector *shard: shards) {
+        shard->shutdown();
+        shard->SubRef();
+    }
     return nullptr;
 }
 
@@ -394,6 +421,11 @@ FNET_TransportThread::InitEventLoop()
         return false;
     }
     _now = clock::now();
+    _maxSpinTime = std::chrono::duration_cast<clock::duration>(_config._busyPollTime);
+    _spinTime = _maxSpinTime;
+    if (_maxSpinTime > clock::duration::zero()) {
+        _pollBlocking.store(false, std::memory_order_relaxed);
+    }
     return true;
 }
 
@@ -404,6 +436,7 @@ FNET_TransportThread::handle_wakeup()
     {
         std::lock_guard<std::mutex> guard(_lock);
         _queue.FlushPackets_NoLock(&_myQueue);
+        _eventsQueued.store(false, std::memory_order_relaxed);
     }
 
     FNET_Context context;
@@ -447,9 +480,58 @@ FNET_TransportThread::handle_wakeup()
 }
 
 
+void
+FNET_TransportThread::update_load(time_point done)
+{
+    clock::duration busy = done - _now;
+    _busyTime.store(_busyTime.load(std::memory_order_relaxed) +
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(busy).count(),
+                    std::memory_order_relaxed);
+    _loadBusy += busy;
+    clock::duration window = done - _loadStart;
+    if (window >= load_window) {
+        _load.store(uint32_t((_loadBusy * 1000) / window), std::memory_order_relaxed);
+        _loadStart = done;
+        _loadBusy = clock::duration::zero();
+    }
+}
+
+
+void
+FNET_TransportThread::busy_poll(int msTimeout)
+{
+    if (_spinTime > clock::duration::zero()) {
+        time_point deadline = clock::now() + _spinTime;
+        do {
+            _selector.poll(0);
+            if ((_selector.num_events() > 0) || _eventsQueued.load(std::memory_order_relaxed)) {
+                _spinHits.store(_spinHits.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+                _spinTime = _maxSpinTime;
+                return;
+            }
+        } while (clock::now() < deadline);
+        _spinTime /= 2;
+    }
+    // events posted after this point will wake us up
+    _pollBlocking.store(true, std::memory_order_relaxed);
+    bool queued;
+    {
+        std::lock_guard<std::mutex> guard(_lock);
+        queued = !_queue.IsEmpty_NoLock();
+    }
+    _selector.poll(queued ? 0 : msTimeout);
+    _pollBlocking.store(false, std::memory_order_relaxed);
+    _blockingPolls.store(_blockingPolls.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    if (_selector.num_events() > 0) {
+        _spinTime = _maxSpinTime;
+    }
+}
+
+
 void
 FNET_TransportThread::handle_event(FNET_IOComponent &ctx, bool read, bool write)
 {
+    _ioEvents.store(_ioEvents.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
     if (!ctx._flags._ioc_delete) {
         bool rc = true;
         if (read) {
@@ -475,7 +557,11 @@ FNET_TransportThread::EventLoopIteration()
 
     if (!IsShutDown()) {
         // obtain I/O events
-        _selector.poll(msTimeout);
+        if (_maxSpinTime > clock::duration::zero()) {
+            busy_poll(msTimeout);
+        } else {
+            _selector.poll(msTimeout);
+        }
 
         // sample current time (performed once per event loop iteration)
         _now = clock::now();
@@ -483,6 +569,11 @@ FNET_TransportThread::EventLoopIteration()
         // handle wakeup and io-events
         _selector.dispatch(*this);
 
+        // handle events posted without waking us up
+        if ((_maxSpinTime > clock::duration::zero()) && _eventsQueued.load(std::memory_order_relaxed)) {
+            handle_wakeup();
+        }
+
         // handle IOC time-outs
         if (_config._iocTimeOut > 0) {
             time_point oldest = (_now - std::chrono::milliseconds(_config._iocTimeOut));
@@ -501,6 +592,9 @@ FNET_TransportThread::EventLoopIteration()
 
         // perform scheduled delete operations
         FlushDeleteList();
+
+        // keep track of how busy this thread is
+        update_load(clock::now());
     }                      // -- END OF MAIN EVENT LOOP --
 
     if (!IsShutDown())
@@ -538,7 +632,7 @@ FNET_TransportThread::EventLoopIteration()
     assert(_componentsHead == nullptr &&
            _componentsTail == nullptr &&
            _timeOutHead    == nullptr &&
-           _componentCnt   == 0    &&
+           GetNumIOComponents() == 0 &&
            _queue.IsEmpty_NoLock() &&
            _myQueue.IsEmpty_NoLock());
 
@@ -556,6 +650,22 @@ FNET_TransportThread::EventLoopIteration()
 }
 
 
+FNET_TransportThreadStats
+FNET_TransportThread::get_stats() const
+{
+    FNET_TransportThreadStats stats;
+    stats.num_components = GetNumIOComponents();
+    stats.io_events = _ioEvents.load(std::memory_order_relaxed);
+    stats.busy_time = std::chrono::nanoseconds(_busyTime.load(std::memory_order_relaxed));
+    stats.load = GetLoad() / 1000.0;
+    stats.busy_poll_time = _config._busyPollTime;
+    stats.spin_hits = _spinHits.load(std::memory_order_relaxed);
+    stats.blocking_polls = _blockingPolls.load(std::memory_order_relaxed);
+    stats.wakeups = _wakeups.load(std::memory_order_relaxed);
+    return stats;
+}
+
+
 bool
 FNET_TransportThread::Start(FastOS_ThreadPool *pool)
 {
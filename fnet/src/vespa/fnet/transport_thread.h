@@ -6,16 +6,20 @@
 #include "config.h"
 #include "task.h"
 #include "packetqueue.h"
+#include "transport_thread_stats.h"
 #include <vespa/fastos/thread.h>
 #include <vespa/vespalib/net/socket_handle.h>
+#include <vespa/vespalib/net/server_socket.h>
 #include <vespa/vespalib/net/selector.h>
 #include <atomic>
 #include <mutex>
 #include <condition_variable>
 #include <chrono>
+#include <vector>
 
 class FNET_Transport;
 class FNET_ControlPacket;
+class FNET_Connector;
 class FNET_IPacketStreamer;
 class FNET_IServerAdapter;
 
@@ -33,6 +37,12 @@ public:
     using clock = FNET_Scheduler::clock;
     using time_point = clock::time_point;
 
+    /**
+     * Length of the window used to sample the recent load of a
+     * transport thread.
+     **/
+    static constexpr std::chrono::milliseconds load_window = std::chrono::milliseconds(100);
+
 private:
     FNET_Transport          &_owner;          // owning transport layer
     time_point               _now;            // current time sampler
@@ -41,7 +51,7 @@ private:
     FNET_IOComponent        *_componentsHead; // I/O component list head
     FNET_IOComponent        *_timeOutHead;    // first IOC in list to time out
     FNET_IOComponent        *_componentsTail; // I/O component list tail
-    uint32_t                 _componentCnt;   // # of components
+    std::atomic<uint32_t>    _componentCnt;   // # of components
     FNET_IOComponent        *_deleteList;     // IOC delete list
     Selector                 _selector;       // I/O event generator
     FNET_PacketQueue_NoLock  _queue;          // outer event queue
@@ -53,6 +63,18 @@ private:
     std::atomic<bool>        _shutdown;       // should stop event loop ?
     bool                     _finished;       // event loop stopped ?
     bool                     _waitFinished;   // someone is waiting for _finished
+    std::atomic<uint64_t>    _ioEvents;       // # of io events handled
+    std::atomic<int64_t>     _busyTime;       // ns spent handling events
+    std::atomic<uint32_t>    _load;           // busy permille in last load window
+    time_point               _loadStart;      // start of current load window
+    clock::duration          _loadBusy;       // busy time in current load window
+    std::atomic<bool>        _eventsQueued;   // outer event queue is non-empty (hint)
+    std::atomic<bool>        _pollBlocking;   // may block in selector; needs wakeup
+    clock::duration          _maxSpinTime;    // busy-poll time limit [static]
+    clock::duration          _spinTime;       // current (adaptive) busy-poll time
+    std::atomic<uint64_t>    _spinHits;       // # of times events were found spinning
+    std::atomic<uint64_t>    _blockingPolls;  // # of blocking selector polls
+    std::atomic<uint64_t>    _wakeups;        // # of selector wakeups
 
     FNET_TransportThread(const FNET_TransportThread &);
     FNET_TransportThread &operator=(const FNET_TransportThread &);
@@ -150,6 +172,28 @@ private:
     void handle_add_cmd(FNET_IOComponent *ioc);
     void handle_close_cmd(FNET_IOComponent *ioc);
 
+    /**
+     * Account for the time spent handling events in the current event
+     * loop iteration, and publish the busy fraction of the load window
+     * when it is complete.
+     *
+     * @param done time when event handling was completed
+     **/
+    void update_load(time_point done);
+
+    /**
+     * Wait for io events or posted events when busy-polling is
+     * enabled. The selector and the event queue are polled without
+     * blocking for a while before falling back to a blocking poll.
+     * Other threads only need to wake up this thread while it may
+     * block. The spin time is halved each time spinning finds nothing
+     * and restored when events show up again, to avoid burning cpu in
+     * idle threads.
+     *
+     * @param msTimeout timeout for the blocking poll
+     **/
+    void busy_poll(int msTimeout);
+
     /**
      * This method is called to initialize the transport thread event
      * loop. It is called from the FRT_Transport::Run method. If you
@@ -227,6 +271,27 @@ public:
     FNET_Connector *Listen(const char *spec, FNET_IPacketStreamer *streamer,
                            FNET_IServerAdapter *serverAdapter);
 
+    /**
+     * Add a network listener using a server socket that is already
+     * listening. This is used to let several transport threads
+     * accept connections on their own socket bound to the same port
+     * (SO_REUSEPORT). Connections accepted by a sharded connector
+     * stay in its transport thread unless another thread is less
+     * loaded. The returned connector takes over the references to the
+     * given shards and shuts them down when it is closed itself.
+     *
+     * @return the connector object, or nullptr if listen failed.
+     * @param spec listen spec for the connector.
+     * @param server_socket the underlying server socket.
+     * @param streamer custom packet streamer.
+     * @param serverAdapter object for custom channel creation.
+     * @param sharded whether the port is shared with other connectors.
+     * @param shards other connectors sharing the port.
+     **/
+    FNET_Connector *Listen(const char *spec, vespalib::ServerSocket server_socket,
+                           FNET_IPacketStreamer *streamer, FNET_IServerAdapter *serverAdapter,
+                           bool sharded, std::vector<FNET_Connector *> shards);
+
 
     /**
      * Connect to a target host in an abstract way. The given 'spec'
@@ -267,7 +332,27 @@ public:
      *
      * @return the current number of IOComponents.
      **/
-    uint32_t GetNumIOComponents() { return _componentCnt; }
+    uint32_t GetNumIOComponents() const { return _componentCnt.load(std::memory_order_relaxed); }
+
+
+    /**
+     * Obtain the recent load of this transport thread; the number of
+     * milliseconds per second spent handling events during the last
+     * load window. Used to select the thread serving new connections.
+     *
+     * @return recent load in the range [0, 1000].
+     **/
+    uint32_t GetLoad() const { return _load.load(std::memory_order_relaxed); }
+
+
+    /**
+     * Obtain a snapshot of the load metrics of this transport thread.
+     * Note that locking is not used, since this information is
+     * volatile anyway.
+     *
+     * @return load metrics
+     **/
+    FNET_TransportThreadStats get_stats() const;
 
 
     /**
@@ -323,6 +408,19 @@ public:
     void SetTCPNoDelay(bool noDelay) { _config._tcpNoDelay = noDelay; }
 
 
+    /**
+     * Set the maximum time the transport thread will spin, polling
+     * for events without blocking, before it blocks waiting for
+     * events. Spinning reduces the latency of handing work to the
+     * transport thread at the cost of cpu usage. 0 (the default)
+     * disables busy-polling. Must be set before the thread is
+     * started.
+     *
+     * @param time maximum time to spin before blocking.
+     **/
+    void SetBusyPollTime(std::chrono::microseconds time) { _config._busyPollTime = time; }
+
+
     /**
      * Add an I/O component to the working set of this transport
      * object. Note that the actual work is performed by the transport
@@ -0,0 +1,29 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+/**
+ * Snapshot of the load of a single transport thread. The event count
+ * and busy time are cumulative since the thread was started. The load
+ * is the fraction of time spent handling events, as opposed to
+ * waiting for them, during the last completed sampling window. Time
+ * spent busy-polling for events is not counted as busy time.
+ **/
+struct FNET_TransportThreadStats
+{
+    uint32_t                  num_components; // current number of IOComponents
+    uint64_t                  io_events;      // socket events handled
+    std::chrono::nanoseconds  busy_time;      // time spent handling events
+    double                    load;           // recent busy fraction [0,1]
+    std::chrono::microseconds busy_poll_time; // max time to spin before blocking (0: disabled)
+    uint64_t                  spin_hits;      // events found while spinning
+    uint64_t                  blocking_polls; // times blocked waiting for events
+    uint64_t                  wakeups;        // times woken up by other threads
+
+    FNET_TransportThreadStats()
+        : num_components(0), io_events(0), busy_time(0), load(0.0),
+          busy_poll_time(0), spin_hits(0), blocking_polls(0), wakeups(0) {}
+};
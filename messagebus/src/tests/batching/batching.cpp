@@ -0,0 +1,122 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include <vespa/messagebus/errorcode.h>
+#include <vespa/messagebus/messagebus.h>
+#include <vespa/messagebus/testlib/receptor.h>
+#include <vespa/messagebus/testlib/simplemessage.h>
+#include <vespa/messagebus/testlib/simpleprotocol.h>
+#include <vespa/messagebus/testlib/simplereply.h>
+#include <vespa/messagebus/testlib/slobrok.h>
+#include <vespa/messagebus/testlib/testserver.h>
+#include <vespa/vespalib/testkit/testapp.h>
+#include <vespa/vespalib/util/stringfmt.h>
+#include <set>
+
+using namespace mbus;
+using vespalib::make_string;
+
+static const duration TIMEOUT = 60s;
+static const uint32_t NUM_MESSAGES = 256;
+
+struct Fixture {
+    Slobrok                slobrok;
+    TestServer             srcServer;
+    TestServer             dstServer;
+    Receptor               srcHandler;
+    Receptor               dstHandler;
+    SourceSession::UP      srcSession;
+    DestinationSession::UP dstSession;
+
+    Fixture(uint32_t maxBatchSize)
+        : slobrok(),
+          srcServer(MessageBusParams().setRetryPolicy(IRetryPolicy::SP()).addProtocol(std::make_shared<SimpleProtocol>()),
+                    RPCNetworkParams(slobrok.config()).setMaxBatchSize(maxBatchSize)),
+          dstServer(MessageBusParams().addProtocol(std::make_shared<SimpleProtocol>()),
+                    RPCNetworkParams(slobrok.config()).setIdentity(Identity("dst"))),
+          srcHandler(),
+          dstHandler(),
+          srcSession(srcServer.mb.createSourceSession(SourceSessionParams()
+                                                      .setThrottlePolicy(IThrottlePolicy::SP())
+                                                      .setReplyHandler(srcHandler))),
+          dstSession(dstServer.mb.createDestinationSession(DestinationSessionParams()
+                                                           .setName("session")
+                                                           .setMessageHandler(dstHandler)))
+    {
+        EXPECT_TRUE(srcServer.waitSlobrok("dst/session", 1u));
+    }
+
+    void sendAll() {
+        for (uint32_t i = 0; i < NUM_MESSAGES; ++i) {
+            auto msg = std::make_unique<SimpleMessage>(make_string("msg %u", i));
+            ASSERT_TRUE(srcSession->send(std::move(msg), Route::parse("dst/session")).isAccepted());
+        }
+    }
+
+    // Replies to every message at the destination, failing every third one.
+    void replyAll() {
+        for (uint32_t i = 0; i < NUM_MESSAGES; ++i) {
+            Message::UP msg = dstHandler.getMessage(TIMEOUT);
+            ASSERT_TRUE(msg);
+            const auto &value = static_cast<SimpleMessage&>(*msg).getValue();
+            auto reply = std::make_unique<SimpleReply>(value);
+            reply->swapState(*msg);
+            if ((i % 3) == 0) {
+                reply->addError(Error(ErrorCode::APP_FATAL_ERROR, value));
+            }
+            dstSession->reply(std::move(reply));
+        }
+    }
+
+    void verifyReplies() {
+        std::set<string> seen;
+        uint32_t numErrors = 0;
+        for (uint32_t i = 0; i < NUM_MESSAGES; ++i) {
+            Reply::UP reply = srcHandler.getReply(TIMEOUT);
+            ASSERT_TRUE(reply);
+            if (reply->hasErrors()) {
+                ASSERT_EQUAL(1u, reply->getNumErrors());
+                EXPECT_EQUAL((uint32_t)ErrorCode::APP_FATAL_ERROR, reply->getError(0).getCode());
+                ++numErrors;
+            } else {
+                ASSERT_EQUAL((uint32_t)SimpleProtocol::REPLY, reply->getType());
+                EXPECT_TRUE(seen.insert(static_cast<SimpleReply&>(*reply).getValue()).second);
+            }
+        }
+        EXPECT_EQUAL((NUM_MESSAGES + 2) / 3, numErrors);
+        EXPECT_EQUAL(NUM_MESSAGES - numErrors, seen.size());
+        EXPECT_FALSE(srcHandler.getReplyNow());
+    }
+};
+
+TEST_F("require that messages are delivered without batching", Fixture(1)) {
+    TEST_DO(f.sendAll());
+    TEST_DO(f.replyAll());
+    TEST_DO(f.verifyReplies());
+    EXPECT_EQUAL(0u, f.dstServer.net.getNumBatchesReceived());
+}
+
+TEST_F("require that batched messages get their own replies", Fixture(16)) {
+    TEST_DO(f.sendAll());
+    TEST_DO(f.replyAll());
+    TEST_DO(f.verifyReplies());
+    // 256 messages sent back to back fill at least one batch of 16
+    EXPECT_GREATER(f.dstServer.net.getNumBatchesReceived(), 0u);
+    EXPECT_LESS(f.dstServer.net.getNumBatchesReceived(), NUM_MESSAGES);
+}
+
+TEST_F("require that single messages are not held back by batching", Fixture(16)) {
+    for (uint32_t i = 0; i < 3; ++i) {
+        auto msg = std::make_unique<SimpleMessage>(make_string("msg %u", i));
+        ASSERT_TRUE(f.srcSession->send(std::move(msg), Route::parse("dst/session")).isAccepted());
+        Message::UP recv = f.dstHandler.getMessage(TIMEOUT);
+        ASSERT_TRUE(recv);
+        auto reply = std::make_unique<SimpleReply>("reply");
+        reply->swapState(*recv);
+        f.dstSession->reply(std::move(reply));
+        Reply::UP ret = f.srcHandler.getReply(TIMEOUT);
+        ASSERT_TRUE(ret);
+        EXPECT_FALSE(ret->hasErrors());
+    }
+}
+
+TEST_MAIN() { TEST_RUN_ALL(); }
@@ -9,6 +9,26 @@
 
 using namespace mbus;
 
+class FakeMirror : public slobrok::api::IMirrorAPI {
+public:
+    SpecList specs;
+    uint32_t gen = 1;
+    mutable uint32_t numLookups = 0;
+
+    SpecList lookup(const std::string &pattern) const override {
+        ++numLookups;
+        SpecList ret;
+        for (const auto &spec : specs) {
+            if (match(spec.first.c_str(), pattern.c_str())) {
+                ret.push_back(spec);
+            }
+        }
+        return ret;
+    }
+    uint32_t updates() const override { return gen; }
+    bool ready() const override { return true; }
+};
+
 TEST("testMaxSize")
 {
     Slobrok slobrok;
@@ -59,4 +79,41 @@ TEST("testMaxSize")
     EXPECT_TRUE(!pool.hasService("me/baz"));
 }
 
+TEST("testMirrorUpdates")
+{
+    FakeMirror mirror;
+    mirror.specs = {{"me/foo", "tcp/foo:1"}, {"me/bar", "tcp/bar:1"}};
+    RPCServicePool pool(mirror, 16);
+
+    RPCServiceAddress::UP addr = pool.resolve("me/foo");
+    ASSERT_TRUE(addr);
+    EXPECT_EQUAL("tcp/foo:1", addr->getConnectionSpec());
+    addr = pool.resolve("me/bar");
+    ASSERT_TRUE(addr);
+    EXPECT_EQUAL(2u, pool.getSize());
+
+    mirror.specs = {{"me/foo", "tcp/foo:2"}};
+    addr = pool.resolve("me/foo");
+    ASSERT_TRUE(addr);
+    EXPECT_EQUAL("tcp/foo:1", addr->getConnectionSpec()); // mirror generation unchanged
+
+    ++mirror.gen;
+    uint32_t numLookups = mirror.numLookups;
+    addr = pool.resolve("me/foo");
+    ASSERT_TRUE(addr);
+    EXPECT_EQUAL("tcp/foo:2", addr->getConnectionSpec());
+    EXPECT_EQUAL(numLookups + 1, mirror.numLookups); // only the used pattern is resolved again
+    EXPECT_EQUAL(2u, pool.getSize());
+    EXPECT_TRUE(pool.hasService("me/foo"));
+    EXPECT_TRUE(pool.hasService("me/bar"));
+
+    addr = pool.resolve("me/foo");
+    EXPECT_EQUAL(numLookups + 1, mirror.numLookups);
+    EXPECT_TRUE(!pool.resolve("me/bar"));
+    EXPECT_EQUAL(numLookups + 2, mirror.numLookups);
+    EXPECT_EQUAL(1u, pool.getSize());
+    EXPECT_TRUE(pool.hasService("me/foo"));
+    EXPECT_TRUE(!pool.hasService("me/bar"));
+}
+
 TEST_MAIN() { TEST_RUN_ALL(); }
\ No newline at end of file
@@ -3,6 +3,8 @@
 #include <vespa/vespalib/testkit/testapp.h>
 #include <vespa/messagebus/destinationsession.h>
 #include <vespa/messagebus/dynamicthrottlepolicy.h>
+#include <vespa/messagebus/errorcode.h>
+#include <vespa/messagebus/gradientthrottlepolicy.h>
 #include <vespa/messagebus/routablequeue.h>
 #include <vespa/messagebus/routing/retrytransienterrorspolicy.h>
 #include <vespa/messagebus/routing/routingspec.h>
@@ -73,7 +75,8 @@ bool waitPending(SourceSession& session, uint32_t size)
 
 class Test : public vespalib::TestApp {
 private:
-    uint32_t getWindowSize(DynamicThrottlePolicy &policy, DynamicTimer &timer, uint32_t maxPending);
+    template <typename PolicyType>
+    uint32_t getWindowSize(PolicyType &policy, DynamicTimer &timer, uint32_t maxPending);
 
 protected:
     void testMaxPendingCount();
@@ -83,6 +86,11 @@ protected:
     void testIdleTimePeriod();
     void testMinWindowSize();
     void testMaxWindowSize();
+    void testGradientWindowSize();
+    void testGradientMinMaxWindowSize();
+    void testGradientBackOff();
+    void testGradientApplicationLimited();
+    void testGradientReplyRtt();
 
 public:
     int Main() override;
@@ -100,6 +108,11 @@ Test::Main()
     testIdleTimePeriod();    TEST_FLUSH();
     testMinWindowSize();     TEST_FLUSH();
     testMaxWindowSize();     TEST_FLUSH();
+    testGradientWindowSize();         TEST_FLUSH();
+    testGradientMinMaxWindowSize();   TEST_FLUSH();
+    testGradientBackOff();            TEST_FLUSH();
+    testGradientApplicationLimited(); TEST_FLUSH();
+    testGradientReplyRtt();           TEST_FLUSH();
 
     TEST_DONE();
 }
@@ -332,8 +345,123 @@ Test::testMaxWindowSize()
 
 }
 
+void
+Test::testGradientWindowSize()
+{
+    auto ptr = std::make_unique<DynamicTimer>();
+    DynamicTimer *timer = ptr.get();
+    GradientThrottlePolicy policy(std::move(ptr));
+
+    double windowSize = getWindowSize(policy, *timer, 100);
+    ASSERT_TRUE(windowSize >= 90 && windowSize <= 110);
+    EXPECT_APPROX(1000.0, policy.getLongRtt(), 50.0);
+
+    windowSize = getWindowSize(policy, *timer, 200);
+    ASSERT_TRUE(windowSize >= 180 && windowSize <= 210);
+
+    windowSize = getWindowSize(policy, *timer, 50);
+    ASSERT_TRUE(windowSize >= 45 && windowSize <= 55);
+
+    windowSize = getWindowSize(policy, *timer, 500);
+    ASSERT_TRUE(windowSize >= 450 && windowSize <= 505);
+
+    windowSize = getWindowSize(policy, *timer, 100);
+    ASSERT_TRUE(windowSize >= 90 && windowSize <= 110);
+    EXPECT_EQUAL(0u, policy.getNumBackOffs());
+}
+
+void
+Test::testGradientMinMaxWindowSize()
+{
+    auto ptr = std::make_unique<DynamicTimer>();
+    DynamicTimer *timer = ptr.get();
+    GradientThrottlePolicy policy(std::move(ptr));
+
+    policy.setMinWindowSize(150);
+    double windowSize = getWindowSize(policy, *timer, 100);
+    ASSERT_TRUE(windowSize >= 150 && windowSize <= 155);
+
+    policy.setMinWindowSize(1);
+    policy.setMaxWindowSize(50);
+    windowSize = getWindowSize(policy, *timer, 100);
+    ASSERT_TRUE(windowSize >= 45 && windowSize <= 50);
+
+    policy.setMaxPendingCount(15);
+    windowSize = getWindowSize(policy, *timer, 100);
+    ASSERT_TRUE(windowSize >= 10 && windowSize <= 15);
+}
+
+void
+Test::testGradientBackOff()
+{
+    auto ptr = std::make_unique<DynamicTimer>();
+    DynamicTimer *timer = ptr.get();
+    GradientThrottlePolicy policy(std::move(ptr));
+
+    SimpleMessage msg("foo");
+    SimpleReply busy("bar");
+    busy.addError(Error(ErrorCode::SESSION_BUSY, "busy"));
+    for (uint32_t i = 0; i < 10; ++i) {
+        uint32_t numPending = 0;
+        while (policy.canSend(msg, numPending)) {
+            policy.processMessage(msg);
+            ++numPending;
+        }
+        timer->_millis += 1000;
+        for ( ; numPending > 0; --numPending) {
+            policy.processReply(busy);
+        }
+    }
+    EXPECT_EQUAL(10u, policy.getNumBackOffs());
+    EXPECT_EQUAL(6u, policy.getMaxPendingCount()); // 20 * 0.9^10
+}
+
+void
+Test::testGradientApplicationLimited()
+{
+    auto ptr = std::make_unique<DynamicTimer>();
+    DynamicTimer *timer = ptr.get();
+    GradientThrottlePolicy policy(std::move(ptr));
+
+    SimpleMessage msg("foo");
+    SimpleReply reply("bar");
+    for (uint32_t i = 0; i < 1000; ++i) {
+        ASSERT_TRUE(policy.canSend(msg, 0));
+        policy.processMessage(msg);
+        timer->_millis += 10;
+        policy.processReply(reply);
+    }
+    EXPECT_EQUAL(20u, policy.getMaxPendingCount());
+    EXPECT_APPROX(10.0, policy.getShortRtt(), 0.01);
+    EXPECT_EQUAL(1.0, policy.getGradient());
+}
+
+void
+Test::testGradientReplyRtt()
+{
+    auto ptr = std::make_unique<DynamicTimer>();
+    DynamicTimer *timer = ptr.get();
+    GradientThrottlePolicy policy(std::move(ptr));
+
+    SimpleMessage msg("foo");
+    SimpleReply reply("bar");
+    for (uint32_t i = 0; i < 100; ++i) {
+        // the round-trip time is measured from when the message was accepted, not from when the
+        // policy saw it, so the time spent before being sent counts
+        auto sent = std::make_unique<SimpleMessage>("foo");
+        sent->setTimeReceived(Message::time_point(std::chrono::milliseconds(timer->_millis)));
+        timer->_millis += 90;
+        policy.processMessage(*sent);
+        timer->_millis += 10;
+        reply.setMessage(std::move(sent));
+        policy.processReply(reply);
+    }
+    EXPECT_APPROX(100.0, policy.getShortRtt(), 0.01);
+}
+
+template <typename PolicyType>
 uint32_t
-Test::getWindowSize(DynamicThrottlePolicy &policy, DynamicTimer &timer, uint32_t maxPending)
+Test::getWindowSize(PolicyType &policy, DynamicTimer &timer, uint32_t maxPending)
 {
     SimpleMessage msg("foo");
     SimpleReply reply("bar");
@@ -344,6 +472,9 @@ Test::getWindowSize(DynamicThrottlePolicy &policy, DynamicTimer &timer, uint32_t
             policy.processMessage(msg);
             ++numPending;
         }
+        auto sent = std::make_unique<SimpleMessage>("foo");
+        sent->setTimeReceived(Message::time_point(std::chrono::milliseconds(timer._millis)));
+        reply.setMessage(std::move(sent));
 
         uint64_t tripTime = (numPending < maxPending) ? 1000 : 1000 + (numPending - maxPending) * 1000;
         timer._millis += tripTime;
@@ -0,0 +1,203 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+#include "gradientthrottlepolicy.h"
+#include "errorcode.h"
+#include "message.h"
+#include "steadytimer.h"
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <vespa/vespalib/util/time.h>
+
+#include <vespa/log/log.h>
+LOG_SETUP(".gradientthrottlepolicy");
+
+namespace mbus {
+
+namespace {
+
+// weight of a sample when the round-trip time drops below the baseline
+constexpr double baselineDropWeight = 0.1;
+
+bool isOverloadError(uint32_t code) {
+    return ((code == ErrorCode::SESSION_BUSY) ||
+            (code == ErrorCode::TIMEOUT) ||
+            (code >= ErrorCode::APP_TRANSIENT_ERROR && code < ErrorCode::FATAL_ERROR));
+}
+
+}
+
+GradientThrottlePolicy::GradientThrottlePolicy() :
+    GradientThrottlePolicy(std::make_unique<SteadyTimer>())
+{ }
+
+GradientThrottlePolicy::GradientThrottlePolicy(ITimer::UP timer) :
+    _timer(std::move(timer)),
+    _pending(0),
+    _maxPendingInSample(0),
+    _numReplies(0),
+    _overloaded(false),
+    _sampleStart(_timer->getMilliTime()),
+    _lastEvent(_sampleStart),
+    _pendingTime(0),
+    _rttSum(0),
+    _numRttReplies(0),
+    _windowSize(20),
+    _maxWindowSize(INT_MAX),
+    _minWindowSize(1),
+    _tolerance(1.5),
+    _smoothing(0.2),
+    _longWindow(600),
+    _backOff(0.9),
+    _shortRtt(0),
+    _longRtt(0),
+    _gradient(1),
+    _numSamples(0),
+    _numBackOffs(0)
+{ }
+
+GradientThrottlePolicy::~GradientThrottlePolicy() = default;
+
+GradientThrottlePolicy &
+GradientThrottlePolicy::setTolerance(double tolerance)
+{
+    _tolerance = std::max(1.0, tolerance);
+    return *this;
+}
+
+GradientThrottlePolicy &
+GradientThrottlePolicy::setSmoothing(double smoothing)
+{
+    _smoothing = smoothing;
+    return *this;
+}
+
+GradientThrottlePolicy &
+GradientThrottlePolicy::setLongWindow(double samples)
+{
+    _longWindow = std::max(1.0, samples);
+    return *this;
+}
+
+GradientThrottlePolicy &
+GradientThrottlePolicy::setBackOff(double backOff)
+{
+    _backOff = std::max(0.0, std::min(1.0, backOff));
+    return *this;
+}
+
+GradientThrottlePolicy &
+GradientThrottlePolicy::setMaxWindowSize(double max)
+{
+    _maxWindowSize = max;
+    return *this;
+}
+
+GradientThrottlePolicy &
+GradientThrottlePolicy::setMinWindowSize(double min)
+{
+    _minWindowSize = min;
+    return *this;
+}
+
+GradientThrottlePolicy &
+GradientThrottlePolicy::setMaxPendingCount(uint32_t maxCount)
+{
+    StaticThrottlePolicy::setMaxPendingCount(maxCount);
+    _maxWindowSize = maxCount;
+    return *this;
+}
+
+void
+GradientThrottlePolicy::updatePendingTime()
+{
+    uint64_t time = _timer->getMilliTime();
+    if (time > _lastEvent) {
+        _pendingTime += (double)_pending * (time - _lastEvent);
+        _lastEvent = time;
+    }
+}
+
+void
+GradientThrottlePolicy::updateWindowSize(uint64_t time)
+{
+    ++_numSamples;
+    if (_overloaded) {
+        _windowSize *= _backOff;
+        ++_numBackOffs;
+        LOG(debug, "WindowSize = %.2f, backing off due to overload", _windowSize);
+    } else if ((_numRttReplies > 0) || (_pendingTime > 0)) {
+        _shortRtt = (_numRttReplies > 0) ? (_rttSum / _numRttReplies) : (_pendingTime / _numReplies);
+        if (_longRtt == 0) {
+            _longRtt = _shortRtt;
+        } else if (_shortRtt < _longRtt) {
+            _longRtt += (_shortRtt - _longRtt) * baselineDropWeight;
+        } else {
+            // a single slow sample should not drag the baseline along
+            _longRtt += (std::min(_shortRtt, 2 * _longRtt) - _longRtt) / _longWindow;
+        }
+        _gradient = (_shortRtt > 0) ? std::max(0.5, std::min(1.0, _tolerance * _longRtt / _shortRtt)) : 1.0;
+        double newSize = _windowSize * _gradient + std::sqrt(_windowSize);
+        if (_maxPendingInSample * 2 < _windowSize) {
+            // the window is not the limiting factor; do not grow it further
+            newSize = std::min(newSize, _windowSize);
+        }
+        _windowSize = _windowSize * (1 - _smoothing) + newSize * _smoothing;
+        LOG(debug, "WindowSize = %.2f, ShortRtt = %.2f, LongRtt = %.2f, Gradient = %.2f",
+            _windowSize, _shortRtt, _longRtt, _gradient);
+    }
+    _windowSize = std::max(_minWindowSize, _windowSize);
+    _windowSize = std::min(_maxWindowSize, _windowSize);
+
+    _numReplies = 0;
+    _overloaded = false;
+    _pendingTime = 0;
+    _rttSum = 0;
+    _numRttReplies = 0;
+    _sampleStart = time;
+    _maxPendingInSample = _pending;
+}
+
+bool
+GradientThrottlePolicy::canSend(const Message &msg, uint32_t pendingCount)
+{
+    if (!StaticThrottlePolicy::canSend(msg, pendingCount)) {
+        return false;
+    }
+    return pendingCount < _windowSize;
+}
+
+void
+GradientThrottlePolicy::processMessage(Message &msg)
+{
+    StaticThrottlePolicy::processMessage(msg);
+    updatePendingTime();
+    ++_pending;
+    _maxPendingInSample = std::max(_maxPendingInSample, _pending);
+}
+
+void
+GradientThrottlePolicy::processReply(Reply &reply)
+{
+    StaticThrottlePolicy::processReply(reply);
+    updatePendingTime();
+    if (_pending > 0) {
+        --_pending;
+    }
+    ++_numReplies;
+    const Message *msg = reply.getAttachedMessage();
+    if (msg != nullptr) {
+        uint64_t sent = vespalib::count_ms(msg->getTimeReceived().time_since_epoch());
+        _rttSum += (_lastEvent > sent) ? (_lastEvent - sent) : 0;
+        ++_numRttReplies;
+    }
+    for (uint32_t i = 0; i < reply.getNumErrors(); ++i) {
+        if (isOverloadError(reply.getError(i).getCode())) {
+            _overloaded = true;
+        }
+    }
+    if ((_numReplies >= _windowSize) && (_lastEvent > _sampleStart)) {
+        updateWindowSize(_lastEvent);
+    }
+}
+
+} // namespace mbus
@@ -0,0 +1,179 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+#pragma once
+
+#include "itimer.h"
+#include "staticthrottlepolicy.h"
+
+namespace mbus {
+
+/**
+ * This is an implementation of the {@link ThrottlePolicy} that limits the number of pending messages of a
+ * {@link SourceSession} based on the observed round-trip time of its messages, in the style of the Vegas
+ * and gradient congestion control algorithms. Instead of probing for the window size with the highest
+ * throughput, it compares the current round-trip time to a long term baseline. As long as the round-trip
+ * time stays close to the baseline, the window grows; when messages start queuing up at the receiver the
+ * round-trip time rises and the window shrinks in proportion. Replies signalling that the receiver is
+ * overloaded make the window back off immediately.
+ *
+ * The round-trip time of a reply is measured from the time its message was accepted by the source session,
+ * using the message attached to the reply. For replies without an attached message, the round-trip time is
+ * estimated as the average number of pending messages over a sample period divided by the number of
+ * replies received in that period (Little's law). A sample is taken roughly once per window of replies.
+ *
+ * <b>NOTE:</b> By context, "pending" is refering to the number of sent messages that have not been replied to
+ * yet.
+ */
+class GradientThrottlePolicy: public StaticThrottlePolicy {
+private:
+    ITimer::UP  _timer;
+    uint32_t    _pending;
+    uint32_t    _maxPendingInSample;
+    uint32_t    _numReplies;
+    bool        _overloaded;
+    uint64_t    _sampleStart;
+    uint64_t    _lastEvent;
+    double      _pendingTime;
+    double      _rttSum;
+    uint32_t    _numRttReplies;
+    double      _windowSize;
+    double      _maxWindowSize;
+    double      _minWindowSize;
+    double      _tolerance;
+    double      _smoothing;
+    double      _longWindow;
+    double      _backOff;
+    double      _shortRtt;
+    double      _longRtt;
+    double      _gradient;
+    uint64_t    _numSamples;
+    uint64_t    _numBackOffs;
+
+    void updatePendingTime();
+    void updateWindowSize(uint64_t time);
+
+public:
+    /**
+     * Convenience typedefs.
+     */
+    typedef std::unique_ptr<GradientThrottlePolicy> UP;
+    typedef std::shared_ptr<GradientThrottlePolicy> SP;
+
+    /**
+     * Constructs a new instance of this policy and sets the appropriate default values of member data.
+     */
+    GradientThrottlePolicy();
+
+    /**
+     * Constructs a new instance of this class using the given clock to measure round-trip times.
+     *
+     * @param timer The timer to use.
+     */
+    GradientThrottlePolicy(ITimer::UP timer);
+
+    ~GradientThrottlePolicy() override;
+
+    /**
+     * Sets how much the round-trip time may exceed the long term baseline before the window starts to
+     * shrink. A value of 1.5 means that the window keeps growing until the round-trip time is 50% above
+     * the baseline.
+     *
+     * @param tolerance The tolerance to set, at least 1.
+     * @return This, to allow chaining.
+     */
+    GradientThrottlePolicy &setTolerance(double tolerance);
+
+    /**
+     * Sets the weight given to each new window size estimate, in the (0, 1] range. The smaller the value,
+     * the slower the window size changes.
+     *
+     * @param smoothing The smoothing to set.
+     * @return This, to allow chaining.
+     */
+    GradientThrottlePolicy &setSmoothing(double smoothing);
+
+    /**
+     * Sets the number of samples over which the round-trip time baseline is allowed to rise. The baseline
+     * follows drops in the round-trip time quickly, but only slowly adapts to a higher round-trip time,
+     * like when the messages sent get larger.
+     *
+     * @param samples The number of samples to set.
+     * @return This, to allow chaining.
+     */
+    GradientThrottlePolicy &setLongWindow(double samples);
+
+    /**
+     * Sets the factor of window size to back off to when the receiver replies that it is overloaded. This
+     * value is capped to the [0, 1] range.
+     *
+     * @param backOff The back off to set.
+     * @return This, to allow chaining.
+     */
+    GradientThrottlePolicy &setBackOff(double backOff);
+
+    /**
+     * Sets the maximium number of pending operations allowed at any time, in
+     * order to avoid using too much resources.
+     *
+     * @param max The max to set.
+     * @return This, to allow chaining.
+     */
+    GradientThrottlePolicy &setMaxWindowSize(double max);
+
+    /**
+     * Sets the minimium number of pending operations allowed at any time, in
+     * order to keep a level of performance.
+     *
+     * @param min The min to set.
+     * @return This, to allow chaining.
+     */
+    GradientThrottlePolicy &setMinWindowSize(double min);
+
+    /**
+     * Sets the maximum number of pending messages allowed.
+     *
+     * @param maxCount The max count.
+     * @return This, to allow chaining.
+     */
+    GradientThrottlePolicy &setMaxPendingCount(uint32_t maxCount);
+
+    double getMaxWindowSize() const { return _maxWindowSize; }
+    double getMinWindowSize() const { return _minWindowSize; }
+
+    /**
+     * Returns the maximum number of pending messages allowed.
+     *
+     * @return The max limit.
+     */
+    uint32_t getMaxPendingCount() const { return (uint32_t)_windowSize; }
+
+    /**
+     * Returns the round-trip time measured in the last sample, in milliseconds.
+     */
+    double getShortRtt() const { return _shortRtt; }
+
+    /**
+     * Returns the long term round-trip time baseline, in milliseconds.
+     */
+    double getLongRtt() const { return _longRtt; }
+
+    /**
+     * Returns the gradient applied to the window size after the last sample, in the [0.5, 1] range.
+     */
+    double getGradient() const { return _gradient; }
+
+    /**
+     * Returns the number of samples taken so far.
+     */
+    uint64_t getNumSamples() const { return _numSamples; }
+
+    /**
+     * Returns the number of times the window has backed off because the receiver was overloaded.
+     */
+    uint64_t getNumBackOffs() const { return _numBackOffs; }
+
+    bool canSend(const Message &msg, uint32_t pendingCount) override;
+    void processMessage(Message &msg) override;
+    void processReply(Reply &reply) override;
+};
+
+} // namespace mbus
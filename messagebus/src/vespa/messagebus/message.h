@@ -39,7 +39,15 @@ public:
     time_point getTimeReceived() const { return _timeReceived; }
 
     /**
-     * This is a convenience method to call {@link #setTimeReceived(uint64_t)}
+     * Sets the timestamp for when this message was last seen by message bus.
+     *
+     * @param timeReceived The timestamp to set.
+     * @return This, to allow chaining.
+     */
+    Message &setTimeReceived(time_point timeReceived) { _timeReceived = timeReceived; return *this; }
+
+    /**
+     * This is a convenience method to call {@link #setTimeReceived(time_point)}
      * passing the current time as argument.
      *
      * @return This, to allow chaining.
@@ -132,7 +132,9 @@ RPCNetwork::RPCNetwork(const RPCNetworkParams &params) :
     _sendAdapters(),
     _compressionConfig(params.getCompressionConfig()),
     _allowDispatchForEncode(params.getDispatchOnEncode()),
-    _allowDispatchForDecode(params.getDispatchOnDecode())
+    _allowDispatchForDecode(params.getDispatchOnDecode()),
+    _maxBatchSize(params.getMaxBatchSize()),
+    _numBatchesReceived(0)
 {
     _transport->SetMaxInputBufferSize(params.getMaxInputBufferSize());
     _transport->SetMaxOutputBufferSize(params.getMaxOutputBufferSize());
@@ -13,6 +13,7 @@
 #include <vespa/vespalib/component/versionspecification.h>
 #include <vespa/vespalib/util/compressionconfig.h>
 #include <vespa/fnet/frt/invokable.h>
+#include <atomic>
 
 class FNET_Transport;
 
@@ -72,6 +73,8 @@ private:
     CompressionConfig                               _compressionConfig;
     bool                                            _allowDispatchForEncode;
     bool                                            _allowDispatchForDecode;
+    uint32_t                                        _maxBatchSize;
+    std::atomic<uint64_t>                           _numBatchesReceived;
 
 
     /**
@@ -227,6 +230,9 @@ public:
     vespalib::Executor & getExecutor() const { return *_executor; }
     bool allowDispatchForEncode() const { return _allowDispatchForEncode; }
     bool allowDispatchForDecode() const { return _allowDispatchForDecode; }
+    uint32_t getMaxBatchSize() const { return _maxBatchSize; }
+    void countBatchReceived() { _numBatchesReceived.fetch_add(1, std::memory_order_relaxed); }
+    uint64_t getNumBatchesReceived() const { return _numBatchesReceived.load(std::memory_order_relaxed); }
 
 };
 
@@ -21,6 +21,7 @@ RPCNetworkParams::RPCNetworkParams(config::ConfigUri configUri) :
     _skip_request_thread(false),
     _skip_reply_thread(false),
     _connectionExpireSecs(600),
+    _maxBatchSize(1),
     _compressionConfig(CompressionConfig::LZ4, 6, 90, 1024)
 { }
 
@@ -26,6 +26,7 @@ private:
     bool              _skip_request_thread;
     bool              _skip_reply_thread;
     double            _connectionExpireSecs;
+    uint32_t          _maxBatchSize;
     CompressionConfig _compressionConfig;
 
 public:
@@ -182,6 +183,30 @@ public:
     }
     CompressionConfig getCompressionConfig() const { return _compressionConfig; }
 
+    /**
+     * Sets the maximum number of requests to the same target that are sent
+     * as a single rpc. Requests are batched until the network thread gets
+     * around to send them, so this only has an effect when sending faster
+     * than one request per network loop. A value of 1 disables batching.
+     * Batching requires the receiver to support it; if it does not, the
+     * requests are sent one by one.
+     *
+     * @param maxBatchSize The maximum number of requests per batch.
+     * @return This, to allow chaining.
+     */
+    RPCNetworkParams &setMaxBatchSize(uint32_t maxBatchSize) {
+        _maxBatchSize = maxBatchSize;
+        return *this;
+    }
+
+    /**
+     * Returns the maximum number of requests to the same target that are
+     * sent as a single rpc.
+     *
+     * @return The maximum batch size.
+     */
+    uint32_t getMaxBatchSize() const { return _maxBatchSize; }
+
 
     RPCNetworkParams &setDispatchOnDecode(bool dispatchOnDecode) {
         _dispatchOnDecode = dispatchOnDecode;
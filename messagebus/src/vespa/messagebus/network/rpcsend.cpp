@@ -3,6 +3,7 @@
 #include "rpcsend.h"
 #include "rpcsend_private.h"
 #include "rpcserviceaddress.h"
+#include "rpctarget.h"
 #include <vespa/messagebus/network/rpcnetwork.h>
 #include <vespa/messagebus/tracelevel.h>
 #include <vespa/messagebus/emptyreply.h>
@@ -11,6 +12,7 @@
 #include <vespa/fnet/frt/reflection.h>
 #include <vespa/vespalib/util/stringfmt.h>
 #include <vespa/vespalib/util/lambdatask.h>
+#include <vespa/vespalib/util/stash.h>
 
 #include <vespa/vespalib/data/slime/cursor.h>
 
@@ -19,6 +21,7 @@ using vespalib::makeLambdaTask;
 
 namespace mbus {
 
+using network::internal::BatchReplyState;
 using network::internal::ReplyContext;
 using network::internal::SendContext;
 
@@ -79,9 +82,15 @@ RPCSend::attach(RPCNetwork &net)
 
 void
 RPCSend::replyError(FRT_RPCRequest *req, const vespalib::Version &version, uint32_t traceLevel, const Error &err)
+{
+    replyError(Context(new ReplyContext(*req, version)), traceLevel, err);
+}
+
+void
+RPCSend::replyError(Context ctx, uint32_t traceLevel, const Error &err)
 {
     Reply::UP reply(new EmptyReply());
-    reply->setContext(Context(new ReplyContext(*req, version)));
+    reply->setContext(ctx);
     reply->getTrace().setLevel(traceLevel);
     reply->addError(err);
     handleReply(std::move(reply));
@@ -92,6 +101,13 @@ RPCSend::handleDiscard(Context ctx)
 {
     ReplyContext::UP tmp(static_cast<ReplyContext*>(ctx.value.PTR));
     FRT_RPCRequest &req = tmp->getRequest();
+    BatchReplyState *batch = tmp->getBatch();
+    if (batch != nullptr) {
+        if ( ! batch->discard()) {
+            return;
+        }
+        delete batch;
+    }
     FNET_Channel *chn = req.GetContext()._value.CHANNEL;
     req.SubRef();
     chn->Free();
@@ -141,10 +157,16 @@ RPCSend::send(RoutingNode &recipient, const vespalib::Version &version,
     } else {
         SendContext *ptr = ctx.release();
         req->SetContext(FNET_Context(ptr));
-        address.getTarget().getFRTTarget().InvokeAsync(req, vespalib::to_s(ptr->getTimeout()), this);
+        sendRequest(address.getTarget(), req, ptr->getTimeout());
     }
 }
 
+void
+RPCSend::sendRequest(RPCTarget &target, FRT_RPCRequest *req, duration timeout)
+{
+    target.getFRTTarget().InvokeAsync(req, vespalib::to_s(timeout), this);
+}
+
 void
 RPCSend::RequestDone(FRT_RPCRequest *req)
 {
@@ -247,9 +269,28 @@ RPCSend::doHandleReply(const IProtocol * protocol, Reply::UP reply) {
             reply->addError(Error(ErrorCode::ENCODE_ERROR, "An error occured while encoding the reply, see log."));
         }
     }
-    FRT_Values &ret = *req.GetReturn();
+    BatchReplyState *batch = ctx->getBatch();
+    if (batch == nullptr) {
+        FRT_Values &ret = *req.GetReturn();
+        createResponse(ret, version, *reply, std::move(payload));
+        req.Return();
+        return;
+    }
+    vespalib::Stash stash;
+    FRT_Values ret(stash);
     createResponse(ret, version, *reply, std::move(payload));
-    req.Return();
+    if ( ! batch->complete(ctx->getBatchIdx(), ret)) {
+        return;
+    }
+    bool discarded = batch->isDiscarded();
+    delete batch;
+    if (discarded) {
+        FNET_Channel *chn = req.GetContext()._value.CHANNEL;
+        req.SubRef();
+        chn->Free();
+    } else {
+        req.Return();
+    }
 }
 
 void
@@ -279,37 +320,138 @@ RPCSend::invoke(FRT_RPCRequest *req)
 void
 RPCSend::doRequest(FRT_RPCRequest *req, const IProtocol * protocol, std::unique_ptr<Params> params)
 {
-    Routable::UP routable = protocol->decode(params->getVersion(), params->getPayload());
+    Error error;
+    Message::UP msg = decodeRequest(*protocol, *params, error);
     req->DiscardBlobs();
-    if ( ! routable ) {
-        replyError(req, params->getVersion(), params->getTraceLevel(),
-                   Error(ErrorCode::DECODE_ERROR,
-                         make_string("Protocol '%s' failed to decode routable.", vespalib::string(params->getProtocol()).c_str())));
+    if ( ! msg ) {
+        replyError(req, params->getVersion(), params->getTraceLevel(), error);
         return;
     }
+    msg->setContext(Context(new ReplyContext(*req, params->getVersion())));
+    msg->pushHandler(*this, *this);
+    _net->getOwner().deliverMessage(std::move(msg), params->getSession());
+}
+
+void
+RPCSend::deliverBatch(FRT_RPCRequest *req, std::vector<std::unique_ptr<Params>> params)
+{
+    _net->countBatchReceived();
+    bool requireSequencing = false;
+    for (const auto &p : params) {
+        const IProtocol * protocol = _net->getOwner().getProtocol(p->getProtocol());
+        if ((protocol != nullptr) && protocol->requireSequencing()) {
+            requireSequencing = true;
+        }
+    }
+    if (requireSequencing || !_net->allowDispatchForDecode()) {
+        doBatchRequest(req, std::move(params));
+    } else {
+        auto rejected = _net->getExecutor().execute(makeLambdaTask([this, req, params = std::move(params)]() mutable {
+            doBatchRequest(req, std::move(params));
+        }));
+        assert (!rejected);
+    }
+}
+
+void
+RPCSend::doBatchRequest(FRT_RPCRequest *req, std::vector<std::unique_ptr<Params>> params)
+{
+    uint32_t numMessages = params.size();
+    std::vector<Message::UP> msgs(numMessages);
+    std::vector<Error> errors(numMessages);
+    for (uint32_t i = 0; i < numMessages; ++i) {
+        const Params &p = *params[i];
+        const IProtocol * protocol = _net->getOwner().getProtocol(p.getProtocol());
+        if (protocol == nullptr) {
+            errors[i] = Error(ErrorCode::UNKNOWN_PROTOCOL, make_string("Protocol '%s' is not known by %s.",
+                                                                       vespalib::string(p.getProtocol()).c_str(), _serverIdent.c_str()));
+        } else {
+            msgs[i] = decodeRequest(*protocol, p, errors[i]);
+        }
+    }
+    req->DiscardBlobs();
+    // The batch may be returned as soon as the last message is delivered, so
+    // the request must not be touched after that.
+    auto *batch = new BatchReplyState(*req, numMessages);
+    for (uint32_t i = 0; i < numMessages; ++i) {
+        const Params &p = *params[i];
+        Context ctx(new ReplyContext(*batch, i, p.getVersion()));
+        if ( ! msgs[i] ) {
+            replyError(ctx, p.getTraceLevel(), errors[i]);
+            continue;
+        }
+        msgs[i]->setContext(ctx);
+        msgs[i]->pushHandler(*this, *this);
+        _net->getOwner().deliverMessage(std::move(msgs[i]), p.getSession());
+    }
+}
+
+Message::UP
+RPCSend::decodeRequest(const IProtocol &protocol, const Params &params, Error &error) const
+{
+    Routable::UP routable = protocol.decode(params.getVersion(), params.getPayload());
+    if ( ! routable ) {
+        error = Error(ErrorCode::DECODE_ERROR,
+                      make_string("Protocol '%s' failed to decode routable.", vespalib::string(params.getProtocol()).c_str()));
+        return Message::UP();
+    }
     if (routable->isReply()) {
-        replyError(req, params->getVersion(), params->getTraceLevel(),
-                   Error(ErrorCode::DECODE_ERROR, "Payload decoded to a reply when expecting a mesage."));
-        return;
+        error = Error(ErrorCode::DECODE_ERROR, "Payload decoded to a reply when expecting a mesage.");
+        return Message::UP();
     }
     Message::UP msg(static_cast<Message*>(routable.release()));
-    vespalib::stringref route = params->getRoute();
+    vespalib::stringref route = params.getRoute();
     if (!route.empty()) {
         msg->setRoute(Route::parse(route));
     }
-    msg->setContext(Context(new ReplyContext(*req, params->getVersion())));
-    msg->pushHandler(*this, *this);
-    msg->setRetryEnabled(params->useRetry());
-    msg->setRetry(params->getRetries());
+    msg->setRetryEnabled(params.useRetry());
+    msg->setRetry(params.getRetries());
     msg->setTimeReceivedNow();
-    msg->setTimeRemaining(params->getRemainingTime());
-    msg->getTrace().setLevel(params->getTraceLevel());
+    msg->setTimeRemaining(params.getRemainingTime());
+    msg->getTrace().setLevel(params.getTraceLevel());
     if (msg->getTrace().shouldTrace(TraceLevel::SEND_RECEIVE)) {
         msg->getTrace().trace(TraceLevel::SEND_RECEIVE,
                               make_string("Message (type %d) received at %s for session '%s'.",
-                                          msg->getType(), _serverIdent.c_str(), string(params->getSession()).c_str()));
+                                          msg->getType(), _serverIdent.c_str(), string(params.getSession()).c_str()));
     }
-    _net->getOwner().deliverMessage(std::move(msg), params->getSession());
+    return msg;
 }
 
 } // namespace mbus
+
+namespace mbus::network::internal {
+
+BatchReplyState::BatchReplyState(FRT_RPCRequest &request, uint32_t numMessages)
+    : _lock(),
+      _request(request),
+      _pending(numMessages),
+      _discarded(false),
+      _encodings(nullptr),
+      _sizes(nullptr),
+      _blobs(nullptr)
+{
+    FRT_Values &ret = *_request.GetReturn();
+    _encodings = ret.AddInt8Array(numMessages);
+    _sizes = ret.AddInt32Array(numMessages);
+    _blobs = ret.AddDataArray(numMessages);
+}
+
+bool
+BatchReplyState::complete(uint32_t idx, const FRT_Values &ret)
+{
+    std::lock_guard<std::mutex> guard(_lock);
+    _encodings[idx] = ret[3]._intval8;
+    _sizes[idx] = ret[4]._intval32;
+    _request.GetReturn()->SetData(&_blobs[idx], ret[5]._data._buf, ret[5]._data._len);
+    return (--_pending == 0);
+}
+
+bool
+BatchReplyState::discard()
+{
+    std::lock_guard<std::mutex> guard(_lock);
+    _discarded = true;
+    return (--_pending == 0);
+}
+
+}
@@ -7,6 +7,7 @@
 #include <vespa/messagebus/common.h>
 #include <vespa/fnet/frt/invokable.h>
 #include <vespa/fnet/frt/invoker.h>
+#include <vector>
 
 class FRT_ReflectionBuilder;
 
@@ -19,6 +20,7 @@ class Error;
 class Route;
 class Message;
 class RPCServiceAddress;
+class RPCTarget;
 class IProtocol;
 
 class PayLoadFiller
@@ -66,6 +68,38 @@ protected:
 
     void send(RoutingNode &recipient, const vespalib::Version &version,
               const PayLoadFiller & filler, duration timeRemaining);
+
+    /**
+     * Sends an encoded request to the given target. The request is completed
+     * through this object. The default implementation invokes the request
+     * right away.
+     *
+     * @param target  The target to send to.
+     * @param req     The request to send.
+     * @param timeout The timeout of the request.
+     */
+    virtual void sendRequest(RPCTarget &target, FRT_RPCRequest *req, duration timeout);
+
+    /**
+     * Decodes the message of an incoming request, and prepares it for delivery
+     * according to the given parameters.
+     *
+     * @param protocol The protocol to decode with.
+     * @param params   The parameters of the request.
+     * @param error    Set if the message could not be decoded.
+     * @return The message, or null on error.
+     */
+    std::unique_ptr<Message> decodeRequest(const IProtocol &protocol, const Params &params, Error &error) const;
+
+    /**
+     * Delivers the messages of an incoming batch request, one per parameter
+     * set. The batch is returned once all messages have been replied to. This
+     * takes over the request, which must already be detached.
+     *
+     * @param req    The batch request.
+     * @param params The parameters of each message in the batch.
+     */
+    void deliverBatch(FRT_RPCRequest *req, std::vector<std::unique_ptr<Params>> params);
     std::unique_ptr<Reply> decode(vespalib::stringref protocol, const vespalib::Version & version,
                                   BlobRef payload, Error & error) const;
     /**
@@ -77,6 +111,7 @@ protected:
      * @param err        The error to reply with.
      */
     void replyError(FRT_RPCRequest *req, const vespalib::Version &version, uint32_t traceLevel, const Error &err);
+    void replyError(Context ctx, uint32_t traceLevel, const Error &err);
 public:
     RPCSend();
     ~RPCSend();
@@ -84,6 +119,7 @@ public:
     void invoke(FRT_RPCRequest *req);
 private:
     void doRequest(FRT_RPCRequest *req, const IProtocol * protocol, std::unique_ptr<Params> params);
+    void doBatchRequest(FRT_RPCRequest *req, std::vector<std::unique_ptr<Params>> params);
     void doRequestDone(FRT_RPCRequest *req);
     void doHandleReply(const IProtocol * protocol, std::unique_ptr<Reply> reply);
     void attach(RPCNetwork &net) final override;
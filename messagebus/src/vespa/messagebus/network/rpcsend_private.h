@@ -3,6 +3,9 @@
 
 #include <vespa/messagebus/trace.h>
 #include <vespa/messagebus/routing/routingnode.h>
+#include <mutex>
+
+class FRT_Values;
 
 namespace mbus::network::internal {
 /**
@@ -28,14 +31,62 @@ private:
     duration           _timeout;
 };
 
+/**
+ * Implements a helper class to collect the replies to the messages of a batch
+ * request. The return value of the batch holds one slot per message, which is
+ * filled in as the replies arrive. The batch is returned once all slots are
+ * filled, or dropped if any of its messages were discarded. The last message to
+ * complete deletes this object.
+ */
+class BatchReplyState {
+private:
+    std::mutex      _lock;
+    FRT_RPCRequest &_request;
+    uint32_t        _pending;
+    bool            _discarded;
+    uint8_t        *_encodings;
+    uint32_t       *_sizes;
+    FRT_DataValue  *_blobs;
+
+public:
+    BatchReplyState(const BatchReplyState &) = delete;
+    BatchReplyState & operator = (const BatchReplyState &) = delete;
+
+    BatchReplyState(FRT_RPCRequest &request, uint32_t numMessages);
+    FRT_RPCRequest &getRequest() { return _request; }
+
+    /**
+     * Stores the body of a 'mbus.slime' return value in the given slot.
+     *
+     * @return True if this was the last message of the batch.
+     */
+    bool complete(uint32_t idx, const FRT_Values &ret);
+
+    /**
+     * Marks the message in the given slot as discarded.
+     *
+     * @return True if this was the last message of the batch.
+     */
+    bool discard();
+
+    /**
+     * Returns whether any message of the batch was discarded.
+     */
+    bool isDiscarded() const { return _discarded; }
+};
+
 /**
  * Implements a helper class to hold the necessary context to send a reply as an
- * rpc return value. This object is held in the callstack of the reply.
+ * rpc return value. This object is held in the callstack of the reply. Replies
+ * to messages that arrived as part of a batch also refer to the state of the
+ * batch and their slot in it.
  */
 class ReplyContext {
 private:
     FRT_RPCRequest   &_request;
     vespalib::Version _version;
+    BatchReplyState  *_batch;
+    uint32_t          _batchIdx;
 
 public:
     typedef std::unique_ptr<ReplyContext> UP;
@@ -43,9 +94,13 @@ public:
     ReplyContext & operator = (const ReplyContext &) = delete;
 
     ReplyContext(FRT_RPCRequest &request, const vespalib::Version &version)
-            : _request(request), _version(version) { }
+            : _request(request), _version(version), _batch(nullptr), _batchIdx(0) { }
+    ReplyContext(BatchReplyState &batch, uint32_t idx, const vespalib::Version &version)
+            : _request(batch.getRequest()), _version(version), _batch(&batch), _batchIdx(idx) { }
     FRT_RPCRequest &getRequest() { return _request; }
     const vespalib::Version &getVersion() { return _version; }
+    BatchReplyState *getBatch() { return _batch; }
+    uint32_t getBatchIdx() const { return _batchIdx; }
 };
 
 
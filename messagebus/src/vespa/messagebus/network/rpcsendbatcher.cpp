@@ -0,0 +1,158 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+#include "rpcsendbatcher.h"
+#include <vespa/fnet/frt/supervisor.h>
+#include <vespa/fnet/frt/target.h>
+#include <vespa/fnet/frt/rpcrequest.h>
+#include <vespa/fnet/frt/error.h>
+#include <vespa/fnet/transport.h>
+#include <algorithm>
+#include <cassert>
+
+namespace mbus {
+
+struct RPCSendBatcher::Batch {
+    std::shared_ptr<RPCSendBatcher> batcher;
+    EntryList                       entries;
+    Batch(std::shared_ptr<RPCSendBatcher> batcher_in, EntryList entries_in)
+        : batcher(std::move(batcher_in)), entries(std::move(entries_in)) {}
+};
+
+RPCSendBatcher::RPCSendBatcher(FRT_Supervisor &orb, FRT_Target &target) :
+    _lock(),
+    _orb(orb),
+    _target(target),
+    _queue(),
+    _flushPending(),
+    _unsupported(false)
+{
+    _target.AddRef();
+}
+
+RPCSendBatcher::~RPCSendBatcher()
+{
+    assert(_queue.empty());
+    _target.SubRef();
+}
+
+void
+RPCSendBatcher::send(FRT_RPCRequest *req, double timeout, FRT_IRequestWait *waiter, uint32_t maxBatchSize)
+{
+    EntryList full;
+    bool postFlush = false;
+    {
+        std::lock_guard<std::mutex> guard(_lock);
+        _queue.push_back(Entry{req, timeout, waiter});
+        if (_queue.size() >= maxBatchSize) {
+            full.swap(_queue);
+        } else if (!_flushPending) {
+            _flushPending = shared_from_this();
+            postFlush = true;
+        }
+    }
+    if (!full.empty()) {
+        flush(std::move(full));
+    }
+    if (postFlush && !_orb.GetTransport()->execute(this)) {
+        execute(); // transport is shutting down
+    }
+}
+
+void
+RPCSendBatcher::flush()
+{
+    EntryList entries;
+    {
+        std::lock_guard<std::mutex> guard(_lock);
+        entries.swap(_queue);
+    }
+    if (!entries.empty()) {
+        flush(std::move(entries));
+    }
+}
+
+void
+RPCSendBatcher::execute()
+{
+    std::shared_ptr<RPCSendBatcher> self;
+    {
+        std::lock_guard<std::mutex> guard(_lock);
+        self = std::move(_flushPending);
+    }
+    flush();
+}
+
+void
+RPCSendBatcher::sendOneByOne(EntryList &entries)
+{
+    for (const Entry &entry: entries) {
+        _target.InvokeAsync(entry.req, entry.timeout, entry.waiter);
+    }
+}
+
+void
+RPCSendBatcher::flush(EntryList entries)
+{
+    if ((entries.size() == 1) || isUnsupported()) {
+        sendOneByOne(entries);
+        return;
+    }
+    uint32_t n = entries.size();
+    FRT_RPCRequest *req = _orb.AllocRPCRequest();
+    req->SetMethodName(METHOD_NAME);
+    FRT_Values &args = *req->GetParams();
+    uint8_t *encodings = args.AddInt8Array(n);
+    uint32_t *sizes = args.AddInt32Array(n);
+    FRT_DataValue *blobs = args.AddDataArray(n);
+    double timeout = 0.0;
+    for (uint32_t i = 0; i < n; ++i) {
+        // the body values of a 'mbus.slime' request; the blob is copied,
+        // since a timed out batch may still be queued for output after the
+        // sub-requests have been completed and freed
+        FRT_Values &params = *entries[i].req->GetParams();
+        encodings[i] = params[3]._intval8;
+        sizes[i] = params[4]._intval32;
+        args.SetData(&blobs[i], params[5]._data._buf, params[5]._data._len);
+        timeout = std::max(timeout, entries[i].timeout);
+    }
+    req->SetContext(FNET_Context(new Batch(shared_from_this(), std::move(entries))));
+    _target.InvokeAsync(req, timeout, this);
+}
+
+void
+RPCSendBatcher::RequestDone(FRT_RPCRequest *req)
+{
+    std::unique_ptr<Batch> batch(static_cast<Batch *>(req->GetContext()._value.VOIDP));
+    EntryList &entries = batch->entries;
+    uint32_t n = entries.size();
+    if (req->GetErrorCode() == FRTE_RPC_NO_SUCH_METHOD) {
+        _unsupported.store(true, std::memory_order_relaxed);
+        req->SubRef();
+        sendOneByOne(entries);
+        return;
+    }
+    if (req->CheckReturnTypes(METHOD_RETURN)) {
+        FRT_Values &ret = *req->GetReturn();
+        if ((ret[0]._int8_array._len != n) || (ret[1]._int32_array._len != n) || (ret[2]._data_array._len != n)) {
+            req->SetError(FRTE_RPC_WRONG_RETURN, "Batch reply does not match the number of requests.");
+        }
+    }
+    for (uint32_t i = 0; i < n; ++i) {
+        FRT_RPCRequest *sub = entries[i].req;
+        if (req->IsError()) {
+            sub->SetError(req->GetErrorCode(), req->GetErrorMessage(), req->GetErrorMessageLen());
+        } else {
+            FRT_Values &ret = *req->GetReturn();
+            FRT_Values &dst = *sub->GetReturn();
+            dst.AddInt8(0);
+            dst.AddInt32(0);
+            dst.AddData("", 0);
+            dst.AddInt8(ret[0]._int8_array._pt[i]);
+            dst.AddInt32(ret[1]._int32_array._pt[i]);
+            dst.AddData(ret[2]._data_array._pt[i]._buf, ret[2]._data_array._pt[i]._len);
+        }
+        entries[i].waiter->RequestDone(sub);
+    }
+    req->SubRef();
+}
+
+} // namespace mbus
@@ -0,0 +1,107 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+#pragma once
+
+#include <vespa/messagebus/common.h>
+#include <vespa/fnet/iexecutable.h>
+#include <vespa/fnet/frt/invoker.h>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+class FRT_Supervisor;
+class FRT_Target;
+
+namespace mbus {
+
+/**
+ * Coalesces requests sent to the same target into a single batch
+ * request. Requests are queued until the transport thread gets
+ * around to flush them, or until the batch is full; whatever was
+ * queued in the meantime is then sent as one rpc. The replies are
+ * demultiplexed back into the original requests, which are completed
+ * as if they had been sent on their own.
+ *
+ * Only requests using the 'mbus.slime' method can be batched; the
+ * batch carries the compression type, uncompressed size and body blob
+ * (params 3-5) of each request, which hold the route, session and trace
+ * level as well as the message payload. The unused auxiliary header
+ * (params 0-2) is left out. If the target does
+ * not know about batching, the requests are sent one by one, and so
+ * is every later request to the same target.
+ *
+ * Instances are shared with the target they send to. Pending flush
+ * events and batches in flight keep the batcher alive, and the
+ * batcher keeps its own reference to the underlying FRT target.
+ */
+class RPCSendBatcher : public FNET_IExecutable,
+                       public FRT_IRequestWait,
+                       public std::enable_shared_from_this<RPCSendBatcher>
+{
+public:
+    static constexpr const char *METHOD_NAME   = "mbus.slime.batch";
+    static constexpr const char *METHOD_PARAMS = "BIX";
+    static constexpr const char *METHOD_RETURN = "BIX";
+
+private:
+    struct Entry {
+        FRT_RPCRequest   *req;
+        double            timeout;
+        FRT_IRequestWait *waiter;
+    };
+    using EntryList = std::vector<Entry>;
+    struct Batch;
+
+    std::mutex                      _lock;
+    FRT_Supervisor                 &_orb;
+    FRT_Target                     &_target;
+    EntryList                       _queue;
+    std::shared_ptr<RPCSendBatcher> _flushPending; // self reference held by the flush event
+    std::atomic<bool>               _unsupported;
+
+    void flush(EntryList entries);
+    void sendOneByOne(EntryList &entries);
+
+public:
+    RPCSendBatcher(const RPCSendBatcher &) = delete;
+    RPCSendBatcher & operator = (const RPCSendBatcher &) = delete;
+
+    /**
+     * Create a batcher sending to the given target.
+     *
+     * @param orb    The supervisor used to allocate batch requests.
+     * @param target The target to send to.
+     */
+    RPCSendBatcher(FRT_Supervisor &orb, FRT_Target &target);
+    ~RPCSendBatcher() override;
+
+    /**
+     * Queue a request to be sent as part of a batch. The request is
+     * completed through the given waiter, exactly like it would be by
+     * FRT_Target::InvokeAsync.
+     *
+     * @param req          The request to send.
+     * @param timeout      The timeout of the request in seconds.
+     * @param waiter       The waiter to complete the request through.
+     * @param maxBatchSize Flush right away when this many requests are queued.
+     */
+    void send(FRT_RPCRequest *req, double timeout, FRT_IRequestWait *waiter, uint32_t maxBatchSize);
+
+    /**
+     * Flush all queued requests right away.
+     */
+    void flush();
+
+    /**
+     * Returns whether the target turned out not to support batching.
+     */
+    bool isUnsupported() const { return _unsupported.load(std::memory_order_relaxed); }
+
+    // Implements FNET_IExecutable; flushes the queue in the transport thread.
+    void execute() override;
+
+    // Implements FRT_IRequestWait; demultiplexes the reply of a batch.
+    void RequestDone(FRT_RPCRequest *req) override;
+};
+
+} // namespace mbus
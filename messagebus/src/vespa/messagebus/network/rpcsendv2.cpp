@@ -2,7 +2,9 @@
 
 #include "rpcsendv2.h"
 #include "rpcnetwork.h"
+#include "rpcsendbatcher.h"
 #include "rpcserviceaddress.h"
+#include "rpctarget.h"
 #include <vespa/messagebus/emptyreply.h>
 #include <vespa/messagebus/tracelevel.h>
 #include <vespa/vespalib/util/stringfmt.h>
@@ -73,6 +75,27 @@ RPCSendV2::build(FRT_ReflectionBuilder & builder)
     builder.ReturnDesc("body_encoding",  "0=raw, 6=lz4");
     builder.ReturnDesc("body_decoded_size", "Uncompressed body blob size");
     builder.ReturnDesc("body_payload", "The reply body blob in slime.");
+
+    builder.DefineMethod(RPCSendBatcher::METHOD_NAME, RPCSendBatcher::METHOD_PARAMS, RPCSendBatcher::METHOD_RETURN,
+                         FRT_METHOD(RPCSendV2::invokeBatch), this);
+    builder.MethodDesc("Send a batch of message bus slime requests and get their replies back.");
+    builder.ParamDesc("body_encoding", "0=raw, 6=lz4, per message");
+    builder.ParamDesc("body_decoded_size", "Uncompressed body blob size, per message");
+    builder.ParamDesc("body_payload", "The message body blob in slime, per message");
+    builder.ReturnDesc("body_encoding",  "0=raw, 6=lz4, per reply");
+    builder.ReturnDesc("body_decoded_size", "Uncompressed body blob size, per reply");
+    builder.ReturnDesc("body_payload", "The reply body blob in slime, per reply");
+}
+
+void
+RPCSendV2::sendRequest(RPCTarget &target, FRT_RPCRequest *req, duration timeout)
+{
+    uint32_t maxBatchSize = _net->getMaxBatchSize();
+    if ((maxBatchSize > 1) && ! target.getBatcher().isUnsupported()) {
+        target.getBatcher().send(req, vespalib::to_s(timeout), this, maxBatchSize);
+    } else {
+        RPCSend::sendRequest(target, req, timeout);
+    }
 }
 
 const char *
@@ -142,12 +165,14 @@ class ParamsV2 : public RPCSend::Params
 {
 public:
     ParamsV2(const FRT_Values &arg)
+        : ParamsV2(arg[3]._intval8, arg[4]._intval32, arg[5]._data)
+    { }
+
+    ParamsV2(uint8_t encoding, uint32_t uncompressedSize, const FRT_DataValue &data)
         : _slime()
     {
-        uint8_t encoding = arg[3]._intval8;
-        uint32_t uncompressedSize = arg[4]._intval32;
-        DataBuffer uncompressed(arg[5]._data._buf, arg[5]._data._len);
-        ConstBufferRef blob(arg[5]._data._buf, arg[5]._data._len);
+        DataBuffer uncompressed(data._buf, data._len);
+        ConstBufferRef blob(data._buf, data._len);
         decompress(CompressionConfig::toType(encoding), uncompressedSize, blob, uncompressed, true);
         assert(uncompressedSize == uncompressed.getDataLen());
         BinaryFormat::decode(Memory(uncompressed.getData(), uncompressed.getDataLen()), _slime);
@@ -186,6 +211,32 @@ RPCSendV2::toParams(const FRT_Values &args) const
     return std::make_unique<ParamsV2>(args);
 }
 
+void
+RPCSendV2::invokeBatch(FRT_RPCRequest *req)
+{
+    const FRT_Values &args = *req->GetParams();
+    uint32_t numMessages = args[0]._int8_array._len;
+    if ((args[1]._int32_array._len != numMessages) || (args[2]._data_array._len != numMessages)) {
+        req->SetError(FRTE_RPC_METHOD_FAILED, "Batch parameter arrays differ in length.");
+        return;
+    }
+    if (numMessages == 0) {
+        FRT_Values &ret = *req->GetReturn();
+        ret.AddInt8Array(0);
+        ret.AddInt32Array(0);
+        ret.AddDataArray(0);
+        return;
+    }
+    req->Detach();
+    std::vector<std::unique_ptr<Params>> params;
+    params.reserve(numMessages);
+    for (uint32_t i = 0; i < numMessages; ++i) {
+        params.push_back(std::make_unique<ParamsV2>(args[0]._int8_array._pt[i], args[1]._int32_array._pt[i],
+                                                    args[2]._data_array._pt[i]));
+    }
+    deliverBatch(req, std::move(params));
+}
+
 std::unique_ptr<Reply>
 RPCSendV2::createReply(const FRT_Values & ret, const string & serviceName,
                        Error & error, vespalib::TraceNode & rootTrace) const
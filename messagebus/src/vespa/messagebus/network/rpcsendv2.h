@@ -8,8 +8,10 @@ namespace mbus {
 class RPCSendV2 : public RPCSend {
 public:
     static bool isCompatible(vespalib::stringref method, vespalib::stringref request, vespalib::stringref response);
+    void invokeBatch(FRT_RPCRequest *req);
 private:
     void build(FRT_ReflectionBuilder & builder) override;
+    void sendRequest(RPCTarget &target, FRT_RPCRequest *req, duration timeout) override;
     const char * getReturnSpec() const override;
     std::unique_ptr<Params> toParams(const FRT_Values &param) const override;
     void encodeRequest(FRT_RPCRequest &req, const vespalib::Version &version, const Route & route,
@@ -2,72 +2,173 @@
 
 #include "rpcservicepool.h"
 #include "rpcnetwork.h"
-#include <vespa/vespalib/stllike/lrucache_map.hpp>
+#include <vespa/vespalib/stllike/hash_map.hpp>
 
 namespace mbus {
 
+namespace {
+
+template <typename T>
+class Held : public vespalib::GenerationHeldBase {
+    std::unique_ptr<const T> _value;
+public:
+    Held(const T *value, size_t size)
+        : vespalib::GenerationHeldBase(size),
+          _value(value)
+    { }
+};
+
+}
+
+RPCServicePool::Resolved::Resolved(std::shared_ptr<RPCService> service, uint32_t updateGen) :
+    _service(std::move(service)),
+    _updateGen(updateGen)
+{ }
+
+RPCServicePool::Resolved::~Resolved() = default;
+
+RPCServicePool::Entry::Entry(std::unique_ptr<const Resolved> resolved, uint64_t lastUse) :
+    _resolved(resolved.release()),
+    _lastUse(lastUse)
+{ }
+
+RPCServicePool::Entry::~Entry()
+{
+    delete _resolved.load(std::memory_order_relaxed);
+}
+
 RPCServicePool::RPCServicePool(const slobrok::api::IMirrorAPI & mirror, uint32_t maxSize) :
     _mirror(mirror),
     _lock(),
-    _lru(std::make_unique<ServiceCache>(maxSize)),
-    _updateGen(0),
+    _generationHandler(),
+    _genHolder(),
+    _services(new ServiceMap()),
+    _useCount(0),
     _maxSize(maxSize)
 {
-    _lru->reserve(maxSize);
     assert(maxSize > 0);
 }
 
-RPCServicePool::~RPCServicePool() = default;
+RPCServicePool::~RPCServicePool()
+{
+    _genHolder.clearHoldLists();
+    delete _services.load(std::memory_order_relaxed);
+}
+
+void
+RPCServicePool::publish(std::unique_ptr<const ServiceMap> services)
+{
+    const ServiceMap *old = _services.exchange(services.release(), std::memory_order_release);
+    holdAndTrim(std::make_unique<Held<ServiceMap>>(old, old->getMemoryConsumption()));
+}
+
+void
+RPCServicePool::publish(Entry &entry, std::unique_ptr<const Resolved> resolved)
+{
+    const Resolved *old = entry._resolved.exchange(resolved.release(), std::memory_order_release);
+    holdAndTrim(std::make_unique<Held<Resolved>>(old, sizeof(Resolved)));
+}
+
+void
+RPCServicePool::holdAndTrim(std::unique_ptr<vespalib::GenerationHeldBase> held)
+{
+    _genHolder.hold(std::move(held));
+    _genHolder.transferHoldLists(_generationHandler.getCurrentGeneration());
+    _generationHandler.incGeneration();
+    _generationHandler.updateFirstUsedGeneration();
+    _genHolder.trimHoldLists(_generationHandler.getFirstUsedGeneration());
+}
+
+void
+RPCServicePool::touch(Entry &entry) const
+{
+    // Added entries are stamped with even counts, and used ones with the odd
+    // count following the most recent addition. Only writers bump the count,
+    // so hits never contend on it.
+    uint64_t lastUse = _useCount.load(std::memory_order_relaxed) + 1;
+    if (entry._lastUse.load(std::memory_order_relaxed) != lastUse) {
+        entry._lastUse.store(lastUse, std::memory_order_relaxed);
+    }
+}
+
+void
+RPCServicePool::evictLeastRecentlyUsed(ServiceMap &services) const
+{
+    auto lru = services.begin();
+    for (auto it = services.begin(); it != services.end(); ++it) {
+        if (it->second->_lastUse.load(std::memory_order_relaxed) <
+            lru->second->_lastUse.load(std::memory_order_relaxed))
+        {
+            lru = it;
+        }
+    }
+    services.erase(lru->first);
+}
 
 RPCServiceAddress::UP
 RPCServicePool::resolve(const string &pattern)
 {
-    std::shared_ptr<RPCService> service;
+    uint32_t updateGen = _mirror.updates();
     {
-        LockGuard guard(_lock);
-        handleMirrorUpdates(guard);
-        std::shared_ptr<RPCService> *found = _lru->findAndRef(pattern);
-        if (found) {
-            service = *found;
+        auto readGuard = _generationHandler.takeGuard();
+        const ServiceMap &services = *_services.load(std::memory_order_acquire);
+        auto found = services.find(pattern);
+        if (found != services.end()) {
+            const Resolved &resolved = *found->second->_resolved.load(std::memory_order_acquire);
+            if (resolved._updateGen == updateGen) {
+                touch(*found->second);
+                return resolved._service->make_address();
+            }
         }
     }
-
-    if (service) {
-        return service->make_address();
-    } else {
-        service = std::make_shared<RPCService>(_mirror, pattern);
-        auto result = service->make_address();
-        if (service->isValid()) {
-            LockGuard guard(_lock);
-            (*_lru)[pattern] = std::move(service);
+    LockGuard guard(_lock);
+    const ServiceMap &current = *_services.load(std::memory_order_relaxed);
+    auto found = current.find(pattern);
+    if (found != current.end()) {
+        const Resolved &resolved = *found->second->_resolved.load(std::memory_order_relaxed);
+        if (resolved._updateGen == updateGen) {
+            touch(*found->second);
+            return resolved._service->make_address(); // resolved by someone else
         }
+    }
+    // Only this pattern is resolved against the current state of the mirror;
+    // other stale entries are resolved when they are used.
+    auto service = std::make_shared<RPCService>(_mirror, pattern);
+    auto result = service->make_address();
+    if (service->isValid() && (found != current.end())) {
+        touch(*found->second);
+        publish(*found->second, std::make_unique<Resolved>(std::move(service), updateGen));
         return result;
     }
-
-}
-
-void
-RPCServicePool::handleMirrorUpdates(const LockGuard &) {
-    uint32_t currentgen = _mirror.updates();
-    if (_updateGen != currentgen) {
-        auto lru = std::make_unique<ServiceCache>(_maxSize);
-        _lru.swap(lru);
-        _updateGen = currentgen;
+    if ( ! service->isValid() && (found == current.end())) {
+        return result;
+    }
+    auto next = std::make_unique<ServiceMap>(current);
+    next->erase(pattern);
+    if (service->isValid()) {
+        if (next->size() >= _maxSize) {
+            evictLeastRecentlyUsed(*next);
+        }
+        uint64_t lastUse = _useCount.fetch_add(2, std::memory_order_relaxed) + 2;
+        (*next)[pattern] = std::make_shared<Entry>(std::make_unique<Resolved>(std::move(service), updateGen), lastUse);
     }
+    publish(std::move(next));
+    return result;
 }
 
 uint32_t
 RPCServicePool::getSize() const
 {
-    LockGuard guard(_lock);
-    return _lru->size();
+    auto readGuard = _generationHandler.takeGuard();
+    return _services.load(std::memory_order_acquire)->size();
 }
 
 bool
 RPCServicePool::hasService(const string &pattern) const
 {
-    LockGuard guard(_lock);
-    return _lru->hasKey(pattern);
+    auto readGuard = _generationHandler.takeGuard();
+    const ServiceMap &services = *_services.load(std::memory_order_acquire);
+    return (services.find(pattern) != services.end());
 }
 
 } // namespace mbus
@@ -2,7 +2,10 @@
 #pragma once
 
 #include "rpcservice.h"
-#include <vespa/vespalib/stllike/lrucache_map.h>
+#include <vespa/vespalib/stllike/hash_map.h>
+#include <vespa/vespalib/util/generationholder.h>
+#include <atomic>
+#include <mutex>
 
 namespace mbus {
 
@@ -11,6 +14,16 @@ class RPCNetwork;
 /**
  * Class used to reuse services for the same pattern when sending messages over
  * the rpc network.
+ *
+ * Each resolved service is stamped with the update generation of the slobrok
+ * mirror it was resolved at. Resolving a pattern with an up to date entry
+ * takes no lock; readers look at the current service map under a generation
+ * guard. Other resolves take the lock and resolve the pattern against the
+ * mirror. When the mirror changes, each cached pattern is resolved again the
+ * next time it is used, and its entry is updated in place. Only adding or
+ * removing patterns publishes a modified copy of the map. Replaced maps and
+ * services are kept on hold until no reader can still be looking at them.
+ * When the pool is full, the least recently used service is evicted.
  */
 class RPCServicePool {
 public:
@@ -56,17 +69,36 @@ public:
      */
     bool hasService(const string &pattern) const;
 private:
-    using ServiceCache = vespalib::lrucache_map< vespalib::LruParam<string, std::shared_ptr<RPCService> >>;
+    struct Resolved {
+        std::shared_ptr<RPCService> _service;
+        uint32_t                    _updateGen;
+        Resolved(std::shared_ptr<RPCService> service, uint32_t updateGen);
+        ~Resolved();
+    };
+    struct Entry {
+        std::atomic<const Resolved *> _resolved;
+        std::atomic<uint64_t>         _lastUse;
+        Entry(std::unique_ptr<const Resolved> resolved, uint64_t lastUse);
+        ~Entry();
+    };
+    using ServiceMap = vespalib::hash_map<string, std::shared_ptr<Entry>>;
     using LockGuard = std::lock_guard<std::mutex>;
 
-    void handleMirrorUpdates(const LockGuard & guard);
+    // Replaces the service map seen by readers. Must be called with the lock held.
+    void publish(std::unique_ptr<const ServiceMap> services);
+    // Replaces the service of an entry seen by readers. Must be called with the lock held.
+    void publish(Entry &entry, std::unique_ptr<const Resolved> resolved);
+    void holdAndTrim(std::unique_ptr<vespalib::GenerationHeldBase> held);
+    void touch(Entry &entry) const;
+    void evictLeastRecentlyUsed(ServiceMap &services) const;
 
     const slobrok::api::IMirrorAPI & _mirror;
-    mutable std::mutex               _lock;
-    std::unique_ptr<ServiceCache>    _lru;
-    uint32_t                         _updateGen;
+    std::mutex                       _lock; // serializes writers
+    vespalib::GenerationHandler      _generationHandler;
+    vespalib::GenerationHolder       _genHolder;
+    std::atomic<const ServiceMap *>  _services;
+    std::atomic<uint64_t>            _useCount;
     uint32_t                         _maxSize;
 };
 
 } // namespace mbus
-
@@ -1,5 +1,6 @@
 // Copyright 2017 Yahoo Holdings. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
 #include "rpctarget.h"
+#include "rpcsendbatcher.h"
 #include <vespa/vespalib/util/exceptions.h>
 #include <vespa/fnet/frt/supervisor.h>
 
@@ -12,7 +13,8 @@ RPCTarget::RPCTarget(const string &spec, FRT_Supervisor &orb) :
     _target(*_orb.GetTarget(spec.c_str())),
     _state(VERSION_NOT_RESOLVED),
     _version(),
-    _versionHandlers()
+    _versionHandlers(),
+    _batcher(std::make_shared<RPCSendBatcher>(_orb, _target))
 {
     // empty
 }
@@ -9,6 +9,8 @@
 
 namespace mbus {
 
+class RPCSendBatcher;
+
 /**
  * Implements a target object that encapsulates the FRT connection
  * target. Instances of this class are returned by {@link RPCService}, and
@@ -57,6 +59,7 @@ private:
     std::atomic<ResolveState>  _state;
     Version_UP                 _version;
     HandlerList                _versionHandlers;
+    std::shared_ptr<RPCSendBatcher> _batcher;
 
 public:
     /**
@@ -103,6 +106,13 @@ public:
      */
     FRT_Target &getFRTTarget() { return _target; }
 
+    /**
+     * Returns the object used to batch requests sent to this target.
+     *
+     * @return The batcher.
+     */
+    RPCSendBatcher &getBatcher() { return *_batcher; }
+
     /**
      * Returns the version to use when communicating with this target.
      * Version must have been successfully resolved before calling this
@@ -4,6 +4,20 @@
 
 namespace mbus {
 
+namespace {
+
+template <typename T>
+class HeldMap : public vespalib::GenerationHeldBase {
+    std::unique_ptr<const T> _map;
+public:
+    HeldMap(const T *map)
+        : vespalib::GenerationHeldBase(sizeof(T) + map->size() * sizeof(typename T::value_type)),
+          _map(map)
+    { }
+};
+
+}
+
 RPCTargetPool::Entry::Entry(RPCTarget::SP target, uint64_t lastUse) :
     _target(target),
     _lastUse(lastUse)
@@ -11,14 +25,18 @@ RPCTargetPool::Entry::Entry(RPCTarget::SP target, uint64_t lastUse) :
 
 RPCTargetPool::RPCTargetPool(double expireSecs) :
     _lock(),
-    _targets(),
+    _generationHandler(),
+    _genHolder(),
+    _targets(new TargetMap()),
     _timer(new SteadyTimer()),
     _expireMillis(static_cast<uint64_t>(expireSecs * 1000))
 { }
 
 RPCTargetPool::RPCTargetPool(ITimer::UP timer, double expireSecs) :
     _lock(),
-    _targets(),
+    _generationHandler(),
+    _genHolder(),
+    _targets(new TargetMap()),
     _timer(std::move(timer)),
     _expireMillis(static_cast<uint64_t>(expireSecs * 1000))
 { }
@@ -26,6 +44,25 @@ RPCTargetPool::RPCTargetPool(ITimer::UP timer, double expireSecs) :
 RPCTargetPool::~RPCTargetPool()
 {
     flushTargets(true);
+    _genHolder.clearHoldLists();
+    delete _targets.load(std::memory_order_relaxed);
+}
+
+void
+RPCTargetPool::publish(std::unique_ptr<const TargetMap> targets)
+{
+    const TargetMap *old = _targets.exchange(targets.release(), std::memory_order_release);
+    _genHolder.hold(std::make_unique<HeldMap<TargetMap>>(old));
+    _genHolder.transferHoldLists(_generationHandler.getCurrentGeneration());
+    _generationHandler.incGeneration();
+    trimHoldLists();
+}
+
+void
+RPCTargetPool::trimHoldLists()
+{
+    _generationHandler.updateFirstUsedGeneration();
+    _genHolder.trimHoldLists(_generationHandler.getFirstUsedGeneration());
 }
 
 void
@@ -33,31 +70,39 @@ RPCTargetPool::flushTargets(bool force)
 {
     uint64_t currentTime = _timer->getMilliTime();
     LockGuard guard(_lock);
-    TargetMap::iterator it = _targets.begin();
-    while (it != _targets.end()) {
-        Entry &entry = it->second;
+    auto targets = std::make_unique<TargetMap>(*_targets.load(std::memory_order_relaxed));
+    bool changed = false;
+    TargetMap::iterator it = targets->begin();
+    while (it != targets->end()) {
+        Entry &entry = *it->second;
         if (entry._target.get() != nullptr) {
             if (entry._target.use_count() > 1) {
-                entry._lastUse = currentTime;
+                entry._lastUse.store(currentTime, std::memory_order_relaxed);
                 ++it;
                 continue; // someone is using this
             }
             if (!force) {
-                if (entry._lastUse + _expireMillis > currentTime) {
+                if (entry._lastUse.load(std::memory_order_relaxed) + _expireMillis > currentTime) {
                     ++it;
                     continue; // not sufficiently idle
                 }
             }
         }
-        _targets.erase(it++); // postfix increment to move the iterator
+        targets->erase(it++); // postfix increment to move the iterator
+        changed = true;
+    }
+    if (changed) {
+        publish(std::move(targets));
+    } else {
+        trimHoldLists(); // free maps replaced while readers were still using them
     }
 }
 
 size_t
 RPCTargetPool::size()
 {
-    LockGuard guard(_lock);
-    return _targets.size();
+    auto readGuard = _generationHandler.takeGuard();
+    return _targets.load(std::memory_order_acquire)->size();
 }
 
 RPCTarget::SP
@@ -65,18 +110,26 @@ RPCTargetPool::getTarget(FRT_Supervisor &orb, const RPCServiceAddress &address)
 {
     const string & spec = address.getConnectionSpec();
     uint64_t currentTime = _timer->getMilliTime();
-    LockGuard guard(_lock);
-    auto it = _targets.find(spec);
-    if (it != _targets.end()) {
-        Entry &entry = it->second;
-        if (entry._target->isValid()) {
-            entry._lastUse = currentTime;
-            return entry._target;
+    {
+        auto readGuard = _generationHandler.takeGuard();
+        const TargetMap &targets = *_targets.load(std::memory_order_acquire);
+        auto it = targets.find(spec);
+        if (it != targets.end() && it->second->_target->isValid()) {
+            it->second->_lastUse.store(currentTime, std::memory_order_relaxed);
+            return it->second->_target;
         }
-        _targets.erase(it);
     }
+    LockGuard guard(_lock);
+    const TargetMap &current = *_targets.load(std::memory_order_relaxed);
+    auto it = current.find(spec);
+    if (it != current.end() && it->second->_target->isValid()) {
+        it->second->_lastUse.store(currentTime, std::memory_order_relaxed);
+        return it->second->_target; // added by someone else
+    }
+    auto targets = std::make_unique<TargetMap>(current);
     auto ret = std::make_shared<RPCTarget>(spec, orb);
-    _targets.insert(TargetMap::value_type(spec, Entry(ret, currentTime)));
+    (*targets)[spec] = std::make_shared<Entry>(ret, currentTime);
+    publish(std::move(targets));
     return ret;
 }
 
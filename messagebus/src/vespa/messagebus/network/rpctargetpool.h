@@ -4,7 +4,9 @@
 #include "rpcserviceaddress.h"
 #include "rpctarget.h"
 #include <vespa/messagebus/itimer.h>
+#include <vespa/vespalib/util/generationholder.h>
 #include <vespa/vespalib/util/sync.h>
+#include <atomic>
 #include <map>
 
 class FRT_Supervisor;
@@ -13,7 +15,10 @@ namespace mbus {
 
 /**
  * Class used to reuse targets for the same address when sending messages over
- * the rpc network.
+ * the rpc network. Lookups of existing targets do not take any locks; they
+ * read the current target map under a generation guard. Writers serialize on
+ * a lock, replace the map with a modified copy, and keep the old map on hold
+ * until no reader can still be looking at it.
  */
 class RPCTargetPool {
 private:
@@ -23,18 +28,28 @@ private:
      * time to time.
      */
     struct Entry {
-        RPCTarget::SP _target;
-        uint64_t      _lastUse;
+        RPCTarget::SP         _target;
+        std::atomic<uint64_t> _lastUse;
 
         Entry(RPCTarget::SP target, uint64_t lastUse);
     };
-    using TargetMap = std::map<string, Entry>;
+    using TargetMap = std::map<string, std::shared_ptr<Entry>>;
     using LockGuard = std::lock_guard<std::mutex>;
 
-    std::mutex     _lock;
-    TargetMap      _targets;
-    ITimer::UP     _timer;
-    uint64_t       _expireMillis;
+    std::mutex                        _lock; // serializes writers
+    vespalib::GenerationHandler       _generationHandler;
+    vespalib::GenerationHolder        _genHolder;
+    std::atomic<const TargetMap *>    _targets;
+    ITimer::UP                        _timer;
+    uint64_t                          _expireMillis;
+
+    /**
+     * Replaces the target map seen by readers, putting the old one on hold
+     * until all readers that might see it are gone. Must be called with the
+     * lock held.
+     */
+    void publish(std::unique_ptr<const TargetMap> targets);
+    void trimHoldLists();
 
 public:
     RPCTargetPool(const RPCTargetPool &) = delete;
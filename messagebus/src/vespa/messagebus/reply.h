@@ -99,6 +99,14 @@ public:
      */
     MessageUP getMessage();
 
+    /**
+     * Returns the Message attached to this Reply without detaching it, or
+     * nullptr if none is attached.
+     *
+     * @return the attached Message
+     */
+    const Message *getAttachedMessage() const { return _msg.get(); }
+
     /**
      * Returns the retry request of this reply. This can be set using {@link
      * #setRetryDelay} and is an instruction to the resender logic of message
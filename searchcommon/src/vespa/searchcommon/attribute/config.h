@@ -34,6 +34,7 @@ public:
     CollectionType collectionType()       const { return _type; }
     bool fastSearch()                     const { return _fastSearch; }
     bool huge()                           const { return _huge; }
+    bool paged()                          const { return _paged; }
     const PredicateParams &predicateParams() const { return _predicateParams; }
     vespalib::eval::ValueType tensorType() const { return _tensorType; }
     DistanceMetric distance_metric() const { return _distance_metric; }
@@ -63,6 +64,12 @@ public:
     const GrowStrategy & getGrowStrategy() const { return _growStrategy; }
     const CompactionStrategy &getCompactionStrategy() const { return _compactionStrategy; }
     Config & setHuge(bool v)                         { _huge = v; return *this;}
+    /**
+     * Keep the attribute data in memory mapped files, letting the
+     * kernel page the data to and from disk (only supported by dense
+     * tensor attributes).
+     */
+    Config & setPaged(bool v)                        { _paged = v; return *this; }
     Config & setFastSearch(bool v)                   { _fastSearch = v; return *this; }
     Config & setPredicateParams(const PredicateParams &v) { _predicateParams = v; return *this; }
     Config & setTensorType(const vespalib::eval::ValueType &tensorType_in) {
@@ -125,6 +132,7 @@ private:
     bool           _isFilter;
     bool           _fastAccess;
     bool           _mutable;
+    bool           _paged;
     GrowStrategy   _growStrategy;
     CompactionStrategy _compactionStrategy;
     PredicateParams    _predicateParams;
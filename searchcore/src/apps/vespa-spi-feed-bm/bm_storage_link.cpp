@@ -0,0 +1,37 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "bm_storage_link.h"
+
+namespace feedbm {
+
+BmStorageLink::BmStorageLink()
+    : storage::StorageLink("vespa-spi-feed-bm"),
+      StorageReplyErrorChecker(),
+      _pending_hash()
+{
+}
+
+BmStorageLink::~BmStorageLink() = default;
+
+bool
+BmStorageLink::onDown(const std::shared_ptr<storage::api::StorageMessage>& msg)
+{
+    (void) msg;
+    return false;
+}
+
+bool
+BmStorageLink::onUp(const std::shared_ptr<storage::api::StorageMessage>& msg)
+{
+    // Replies to commands sent by this link are consumed here, all
+    // other messages continue up to the communication manager.
+    auto entry = _pending_hash.remove(msg->getMsgId());
+    if (!entry.valid()) {
+        return false;
+    }
+    check_error(*msg);
+    entry.release();
+    return true;
+}
+
+}
@@ -0,0 +1,28 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include "pending_tracker_hash.h"
+#include "storage_reply_error_checker.h"
+#include <vespa/storage/common/storagelink.h>
+
+namespace feedbm {
+
+/*
+ * Storage link inserted right below the communication manager in the
+ * storage chain, used to feed commands into the chain and to collect
+ * the replies to them.
+ */
+class BmStorageLink : public storage::StorageLink,
+                      public StorageReplyErrorChecker
+{
+    PendingTrackerHash _pending_hash;
+public:
+    BmStorageLink();
+    ~BmStorageLink() override;
+    bool onDown(const std::shared_ptr<storage::api::StorageMessage>& msg) override;
+    bool onUp(const std::shared_ptr<storage::api::StorageMessage>& msg) override;
+    void retain(uint64_t msg_id, PendingTracker &tracker) { _pending_hash.retain(msg_id, tracker); }
+};
+
+}
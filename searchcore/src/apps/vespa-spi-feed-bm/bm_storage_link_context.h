@@ -0,0 +1,24 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+namespace feedbm {
+
+class BmStorageLink;
+
+/*
+ * Refers to the BmStorageLink in a storage chain. The link is owned
+ * by the storage chain and is only valid while the storage node is
+ * running.
+ */
+struct BmStorageLinkContext
+{
+    BmStorageLink* bm_link;
+    BmStorageLinkContext()
+        : bm_link(nullptr)
+    {
+    }
+    ~BmStorageLinkContext() = default;
+};
+
+}
@@ -0,0 +1,83 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "pending_tracker.h"
+#include <algorithm>
+
+namespace feedbm {
+
+LatencyStats::LatencyStats()
+    : _samples(),
+      _sorted(true)
+{
+}
+
+LatencyStats::~LatencyStats() = default;
+
+void
+LatencyStats::merge(const LatencyStats &rhs)
+{
+    _samples.insert(_samples.end(), rhs._samples.begin(), rhs._samples.end());
+    _sorted = false;
+}
+
+double
+LatencyStats::percentile(double pct)
+{
+    if (_samples.empty()) {
+        return 0.0;
+    }
+    if (!_sorted) {
+        std::sort(_samples.begin(), _samples.end());
+        _sorted = true;
+    }
+    size_t idx = std::min(_samples.size() - 1, static_cast<size_t>(pct / 100.0 * _samples.size()));
+    return _samples[idx];
+}
+
+PendingTracker::PendingTracker(uint32_t limit)
+    : _pending(0u),
+      _limit(limit),
+      _mutex(),
+      _cond(),
+      _latency()
+{
+}
+
+PendingTracker::~PendingTracker()
+{
+    drain();
+}
+
+PendingTracker::time_point
+PendingTracker::retain()
+{
+    std::unique_lock<std::mutex> guard(_mutex);
+    while (_pending >= _limit) {
+        _cond.wait(guard);
+    }
+    ++_pending;
+    return std::chrono::steady_clock::now();
+}
+
+void
+PendingTracker::release(time_point start_time)
+{
+    std::chrono::duration<double> latency = std::chrono::steady_clock::now() - start_time;
+    std::unique_lock<std::mutex> guard(_mutex);
+    _latency.add(latency.count());
+    --_pending;
+    if (_pending < _limit) {
+        _cond.notify_all();
+    }
+}
+
+void
+PendingTracker::drain()
+{
+    std::unique_lock<std::mutex> guard(_mutex);
+    while (_pending > 0) {
+        _cond.wait(guard);
+    }
+}
+
+}
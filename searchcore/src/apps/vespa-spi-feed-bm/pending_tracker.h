@@ -0,0 +1,55 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+
+namespace feedbm {
+
+/*
+ * Latency samples (in seconds) for the operations performed in a pass.
+ */
+class LatencyStats {
+    std::vector<double> _samples;
+    bool                _sorted;
+public:
+    LatencyStats();
+    ~LatencyStats();
+    void add(double latency) {
+        _samples.push_back(latency);
+        _sorted = false;
+    }
+    void merge(const LatencyStats &rhs);
+    double percentile(double pct);
+};
+
+/*
+ * Limits the number of pending operations issued by a client thread
+ * and collects the latency of the completed operations.
+ */
+class PendingTracker {
+public:
+    using time_point = std::chrono::steady_clock::time_point;
+private:
+    uint32_t                _pending;
+    uint32_t                _limit;
+    std::mutex              _mutex;
+    std::condition_variable _cond;
+    LatencyStats            _latency;
+
+public:
+    explicit PendingTracker(uint32_t limit);
+    ~PendingTracker();
+
+    // Wait until below the limit, returns start time of the new operation
+    time_point retain();
+    void release(time_point start_time);
+    void drain();
+    // Only valid after drain()
+    const LatencyStats &get_latency() const { return _latency; }
+};
+
+}
@@ -0,0 +1,42 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "pending_tracker_hash.h"
+#include <vespa/vespalib/stllike/hash_map.hpp>
+#include <cassert>
+
+namespace feedbm {
+
+PendingTrackerHash::PendingTrackerHash()
+    : _mutex(),
+      _pending()
+{
+}
+
+PendingTrackerHash::~PendingTrackerHash()
+{
+    std::lock_guard guard(_mutex);
+    assert(_pending.empty());
+}
+
+void
+PendingTrackerHash::retain(uint64_t msg_id, PendingTracker &tracker)
+{
+    auto start_time = tracker.retain();
+    std::lock_guard guard(_mutex);
+    _pending.insert(std::make_pair(msg_id, Entry(tracker, start_time)));
+}
+
+PendingTrackerHash::Entry
+PendingTrackerHash::remove(uint64_t msg_id)
+{
+    std::lock_guard guard(_mutex);
+    auto itr = _pending.find(msg_id);
+    if (itr == _pending.end()) {
+        return Entry();
+    }
+    auto entry = itr->second;
+    _pending.erase(itr);
+    return entry;
+}
+
+}
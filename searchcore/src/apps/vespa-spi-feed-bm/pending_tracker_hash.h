@@ -0,0 +1,40 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include "pending_tracker.h"
+#include <vespa/vespalib/stllike/hash_map.h>
+
+namespace feedbm {
+
+/*
+ * Maps message ids of storage api commands in flight to the pending
+ * tracker of the client thread that sent them.
+ */
+class PendingTrackerHash {
+public:
+    class Entry {
+        PendingTracker            *_tracker;
+        PendingTracker::time_point _start_time;
+    public:
+        Entry() : _tracker(nullptr), _start_time() { }
+        Entry(PendingTracker &tracker, PendingTracker::time_point start_time)
+            : _tracker(&tracker),
+              _start_time(start_time)
+        {
+        }
+        bool valid() const { return _tracker != nullptr; }
+        void release() { _tracker->release(_start_time); }
+    };
+private:
+    std::mutex                         _mutex;
+    vespalib::hash_map<uint64_t, Entry> _pending;
+public:
+    PendingTrackerHash();
+    ~PendingTrackerHash();
+    void retain(uint64_t msg_id, PendingTracker &tracker);
+    // Returns an invalid entry if the message id is unknown
+    Entry remove(uint64_t msg_id);
+};
+
+}
@@ -0,0 +1,145 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "spi_bm_feed_handler.h"
+#include "pending_tracker.h"
+#include <vespa/document/fieldset/fieldsetrepo.h>
+#include <vespa/document/fieldvalue/document.h>
+#include <vespa/document/update/documentupdate.h>
+#include <vespa/metrics/loadtype.h>
+#include <vespa/persistence/spi/persistenceprovider.h>
+
+using document::Document;
+using document::DocumentId;
+using document::DocumentUpdate;
+using storage::spi::Bucket;
+using storage::spi::PartitionId;
+using storage::spi::PersistenceProvider;
+using storage::spi::Timestamp;
+
+namespace feedbm {
+
+namespace {
+
+storage::spi::LoadType default_load_type(0, "default");
+storage::spi::Context context(default_load_type, storage::spi::Priority(0), storage::spi::Trace::TraceLevel(0));
+
+void
+check_error(const storage::spi::Result &result, std::atomic<uint32_t> &errors)
+{
+    if (result.hasError()) {
+        ++errors;
+    }
+}
+
+class MyOperationComplete : public storage::spi::OperationComplete
+{
+    std::atomic<uint32_t>     &_errors;
+    PendingTracker            &_tracker;
+    PendingTracker::time_point _start_time;
+public:
+    MyOperationComplete(std::atomic<uint32_t> &errors, PendingTracker &tracker);
+    ~MyOperationComplete() override;
+    void onComplete(std::unique_ptr<storage::spi::Result> result) override;
+    void addResultHandler(const storage::spi::ResultHandler* resultHandler) override;
+};
+
+MyOperationComplete::MyOperationComplete(std::atomic<uint32_t> &errors, PendingTracker& tracker)
+    : _errors(errors),
+      _tracker(tracker),
+      _start_time(tracker.retain())
+{
+}
+
+MyOperationComplete::~MyOperationComplete()
+{
+    _tracker.release(_start_time);
+}
+
+void
+MyOperationComplete::onComplete(std::unique_ptr<storage::spi::Result> result)
+{
+    check_error(*result, _errors);
+}
+
+void
+MyOperationComplete::addResultHandler(const storage::spi::ResultHandler * resultHandler)
+{
+    (void) resultHandler;
+}
+
+Bucket
+make_spi_bucket(const document::Bucket &bucket)
+{
+    return Bucket(bucket, PartitionId(0));
+}
+
+}
+
+SpiBmFeedHandler::SpiBmFeedHandler(PersistenceProvider& provider, std::shared_ptr<const document::DocumentTypeRepo> repo)
+    : IBmFeedHandler(),
+      _name("SpiBmFeedHandler"),
+      _provider(provider),
+      _repo(std::move(repo)),
+      _errors(0u)
+{
+}
+
+SpiBmFeedHandler::~SpiBmFeedHandler() = default;
+
+void
+SpiBmFeedHandler::put(const document::Bucket& bucket, std::unique_ptr<Document> document, uint64_t timestamp, PendingTracker& tracker)
+{
+    _provider.putAsync(make_spi_bucket(bucket), Timestamp(timestamp), std::move(document), context, std::make_unique<MyOperationComplete>(_errors, tracker));
+}
+
+void
+SpiBmFeedHandler::update(const document::Bucket& bucket, std::unique_ptr<DocumentUpdate> document_update, uint64_t timestamp, PendingTracker& tracker)
+{
+    _provider.updateAsync(make_spi_bucket(bucket), Timestamp(timestamp), std::move(document_update), context, std::make_unique<MyOperationComplete>(_errors, tracker));
+}
+
+void
+SpiBmFeedHandler::remove(const document::Bucket& bucket, const DocumentId& document_id, uint64_t timestamp, PendingTracker& tracker)
+{
+    _provider.removeAsync(make_spi_bucket(bucket), Timestamp(timestamp), document_id, context, std::make_unique<MyOperationComplete>(_errors, tracker));
+}
+
+void
+SpiBmFeedHandler::get(const document::Bucket& bucket, vespalib::stringref field_set_string, const DocumentId& document_id, PendingTracker& tracker)
+{
+    // The persistence provider has no async get, latency is measured around the blocking call
+    auto field_set = document::FieldSetRepo::parse(*_repo, field_set_string);
+    auto start_time = tracker.retain();
+    auto result = _provider.get(make_spi_bucket(bucket), *field_set, document_id, context);
+    check_error(result, _errors);
+    tracker.release(start_time);
+}
+
+void
+SpiBmFeedHandler::create_bucket(const document::Bucket& bucket, PendingTracker& tracker)
+{
+    auto start_time = tracker.retain();
+    auto result = _provider.createBucket(make_spi_bucket(bucket), context);
+    check_error(result, _errors);
+    tracker.release(start_time);
+}
+
+uint32_t
+SpiBmFeedHandler::get_error_count() const
+{
+    return _errors;
+}
+
+const vespalib::string&
+SpiBmFeedHandler::get_name() const
+{
+    return _name;
+}
+
+bool
+SpiBmFeedHandler::manages_buckets() const
+{
+    return false;
+}
+
+}
@@ -0,0 +1,35 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "storage_api_chain_bm_feed_handler.h"
+#include "bm_storage_link_context.h"
+#include "bm_storage_link.h"
+#include <vespa/storageapi/messageapi/storagecommand.h>
+#include <cassert>
+
+namespace feedbm {
+
+StorageApiChainBmFeedHandler::StorageApiChainBmFeedHandler(std::shared_ptr<BmStorageLinkContext> context, bool distributor)
+    : StorageApiBmFeedHandlerBase("StorageApiChainBmFeedHandler", distributor),
+      _context(std::move(context))
+{
+    assert(_context->bm_link != nullptr);
+}
+
+StorageApiChainBmFeedHandler::~StorageApiChainBmFeedHandler() = default;
+
+void
+StorageApiChainBmFeedHandler::send_cmd(std::shared_ptr<storage::api::StorageCommand> cmd, PendingTracker& pending_tracker)
+{
+    cmd->setSourceIndex(0);
+    auto bm_link = _context->bm_link;
+    bm_link->retain(cmd->getMsgId(), pending_tracker);
+    bm_link->sendDown(std::move(cmd));
+}
+
+uint32_t
+StorageApiChainBmFeedHandler::get_error_count() const
+{
+    return _context->bm_link->get_error_count();
+}
+
+}
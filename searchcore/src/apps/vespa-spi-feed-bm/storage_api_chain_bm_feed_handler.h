@@ -0,0 +1,27 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include "storage_api_bm_feed_handler_base.h"
+
+namespace feedbm {
+
+struct BmStorageLinkContext;
+
+/*
+ * Benchmark feed handler for feed to service layer or distributor
+ * using storage api messages sent directly into the storage chain,
+ * bypassing the network.
+ */
+class StorageApiChainBmFeedHandler : public StorageApiBmFeedHandlerBase
+{
+    std::shared_ptr<BmStorageLinkContext> _context;
+
+    void send_cmd(std::shared_ptr<storage::api::StorageCommand> cmd, PendingTracker& tracker) override;
+public:
+    StorageApiChainBmFeedHandler(std::shared_ptr<BmStorageLinkContext> context, bool distributor);
+    ~StorageApiChainBmFeedHandler() override;
+    uint32_t get_error_count() const override;
+};
+
+}
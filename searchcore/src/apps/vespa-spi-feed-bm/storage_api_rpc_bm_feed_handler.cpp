@@ -0,0 +1,86 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "storage_api_rpc_bm_feed_handler.h"
+#include "pending_tracker_hash.h"
+#include "storage_reply_error_checker.h"
+#include <vespa/documentapi/loadtypes/loadtypeset.h>
+#include <vespa/storage/storageserver/message_dispatcher.h>
+#include <vespa/storage/storageserver/rpc/message_codec_provider.h>
+#include <vespa/storage/storageserver/rpc/shared_rpc_resources.h>
+#include <vespa/storageapi/messageapi/storagecommand.h>
+#include <vespa/vdslib/state/nodetype.h>
+
+using storage::api::StorageMessageAddress;
+using storage::lib::NodeType;
+
+namespace feedbm {
+
+/*
+ * Receives the replies from the rpc client and releases the pending
+ * tracker of the originating client thread.
+ */
+class StorageApiRpcBmFeedHandler::MyMessageDispatcher : public storage::MessageDispatcher,
+                                                        public StorageReplyErrorChecker
+{
+    PendingTrackerHash _pending_hash;
+public:
+    MyMessageDispatcher()
+        : storage::MessageDispatcher(),
+          StorageReplyErrorChecker(),
+          _pending_hash()
+    {
+    }
+    ~MyMessageDispatcher() override;
+    void dispatch_sync(std::shared_ptr<storage::api::StorageMessage> msg) override {
+        release(std::move(msg));
+    }
+    void dispatch_async(std::shared_ptr<storage::api::StorageMessage> msg) override {
+        release(std::move(msg));
+    }
+    void retain(uint64_t msg_id, PendingTracker &tracker) {
+        _pending_hash.retain(msg_id, tracker);
+    }
+    void release(std::shared_ptr<storage::api::StorageMessage> msg) {
+        auto entry = _pending_hash.remove(msg->getMsgId());
+        if (entry.valid()) {
+            check_error(*msg);
+            entry.release();
+        } else {
+            ++_errors;
+        }
+    }
+};
+
+StorageApiRpcBmFeedHandler::MyMessageDispatcher::~MyMessageDispatcher() = default;
+
+StorageApiRpcBmFeedHandler::StorageApiRpcBmFeedHandler(storage::rpc::SharedRpcResources& shared_rpc_resources_in,
+                                                       std::shared_ptr<const document::DocumentTypeRepo> repo,
+                                                       const storage::rpc::StorageApiRpcService::Params& rpc_params,
+                                                       bool distributor)
+    : StorageApiBmFeedHandlerBase("StorageApiRpcBmFeedHandler", distributor),
+      _storage_address(std::make_unique<StorageMessageAddress>("storage", distributor ? NodeType::DISTRIBUTOR : NodeType::STORAGE, 0)),
+      _shared_rpc_resources(shared_rpc_resources_in),
+      _message_dispatcher(std::make_unique<MyMessageDispatcher>()),
+      _message_codec_provider(std::make_unique<storage::rpc::MessageCodecProvider>(std::move(repo), std::make_shared<documentapi::LoadTypeSet>())),
+      _rpc_client(std::make_unique<storage::rpc::StorageApiRpcService>(*_message_dispatcher, _shared_rpc_resources, *_message_codec_provider, rpc_params))
+{
+}
+
+StorageApiRpcBmFeedHandler::~StorageApiRpcBmFeedHandler() = default;
+
+void
+StorageApiRpcBmFeedHandler::send_cmd(std::shared_ptr<storage::api::StorageCommand> cmd, PendingTracker& pending_tracker)
+{
+    cmd->setSourceIndex(0);
+    cmd->setAddress(*_storage_address);
+    _message_dispatcher->retain(cmd->getMsgId(), pending_tracker);
+    _rpc_client->send_rpc_v1_request(std::move(cmd));
+}
+
+uint32_t
+StorageApiRpcBmFeedHandler::get_error_count() const
+{
+    return _message_dispatcher->get_error_count();
+}
+
+}
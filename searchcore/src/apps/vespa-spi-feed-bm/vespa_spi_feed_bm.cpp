@@ -1,5 +1,11 @@
 // Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
 
+#include "bm_storage_chain_builder.h"
+#include "bm_storage_link_context.h"
+#include "pending_tracker.h"
+#include "spi_bm_feed_handler.h"
+#include "storage_api_chain_bm_feed_handler.h"
+#include "storage_api_rpc_bm_feed_handler.h"
 #include <vespa/vespalib/testkit/testapp.h>
 
 #include <tests/proton/common/dummydbowner.h>
@@ -8,10 +14,13 @@
 #include <vespa/config-summarymap.h>
 #include <vespa/fastos/file.h>
 #include <vespa/document/datatype/documenttype.h>
+#include <vespa/document/fieldset/fieldsets.h>
 #include <vespa/document/fieldvalue/intfieldvalue.h>
 #include <vespa/document/repo/configbuilder.h>
 #include <vespa/document/repo/documenttyperepo.h>
 #include <vespa/document/test/make_bucket_space.h>
+#include <vespa/document/update/assignvalueupdate.h>
+#include <vespa/document/update/documentupdate.h>
 #include <vespa/searchcommon/common/schemaconfigurer.h>
 #include <vespa/searchcore/proton/common/hw_info.h>
 #include <vespa/searchcore/proton/matching/querylimiter.h>
@@ -33,7 +42,42 @@
 #include <vespa/config-attributes.h>
 #include <vespa/config-indexschema.h>
 #include <vespa/config-summary.h>
+#include <vespa/config-upgrading.h>
+#include <vespa/config-stor-distribution.h>
+#include <vespa/config-stor-filestor.h>
+#include <vespa/config-persistence.h>
+#include <vespa/config-load-type.h>
+#include <vespa/config-slobroks.h>
+#include <vespa/config/common/configcontext.h>
+#include <vespa/config/subscription/sourcespec.h>
+#include <vespa/messagebus/config-messagebus.h>
+#include <vespa/metrics/config-metricsmanager.h>
+#include <vespa/slobrok/sbmirror.h>
+#include <vespa/slobrok/server/slobrokserver.h>
+#include <vespa/storage/bucketdb/config-stor-bucket-init.h>
+#include <vespa/storage/common/i_storage_chain_builder.h>
+#include <vespa/storage/config/config-stor-bouncer.h>
+#include <vespa/storage/config/config-stor-communicationmanager.h>
+#include <vespa/storage/config/config-stor-distributormanager.h>
+#include <vespa/storage/config/config-stor-opslogger.h>
+#include <vespa/storage/config/config-stor-prioritymapping.h>
+#include <vespa/storage/config/config-stor-server.h>
+#include <vespa/storage/config/config-stor-status.h>
+#include <vespa/storage/config/config-stor-visitordispatcher.h>
+#include <vespa/storage/storageserver/rpc/shared_rpc_resources.h>
+#include <vespa/storage/storageserver/storagenode.h>
+#include <vespa/storage/visiting/config-stor-visitor.h>
+#include <vespa/storageapi/message/state.h>
+#include <vespa/storageserver/app/distributorprocess.h>
+#include <vespa/storageserver/app/servicelayerprocess.h>
+#include <vespa/vdslib/state/clusterstate.h>
 #include <vespa/vespalib/io/fileutil.h>
+#include <vespa/fastos/app.h>
+#include <getopt.h>
+#include <sys/resource.h>
+#include <algorithm>
+#include <iostream>
+#include <thread>
 
 #include <vespa/log/log.h>
 LOG_SETUP("vespa-spi-feed-bm");
@@ -46,36 +90,62 @@ using namespace vespa::config::search::summary;
 using namespace vespa::config::search;
 using namespace std::chrono_literals;
 using vespa::config::content::core::BucketspacesConfig;
+using vespa::config::content::core::BucketspacesConfigBuilder;
+using vespa::config::content::core::StorBouncerConfigBuilder;
+using vespa::config::content::core::StorBucketInitConfigBuilder;
+using vespa::config::content::core::StorCommunicationmanagerConfigBuilder;
+using vespa::config::content::core::StorDistributormanagerConfigBuilder;
+using vespa::config::content::core::StorOpsloggerConfigBuilder;
+using vespa::config::content::core::StorPrioritymappingConfigBuilder;
+using vespa::config::content::core::StorServerConfigBuilder;
+using vespa::config::content::core::StorStatusConfigBuilder;
+using vespa::config::content::core::StorVisitorConfigBuilder;
+using vespa::config::content::core::StorVisitordispatcherConfigBuilder;
+using vespa::config::content::LoadTypeConfigBuilder;
+using vespa::config::content::PersistenceConfigBuilder;
+using vespa::config::content::StorDistributionConfigBuilder;
+using vespa::config::content::StorFilestorConfigBuilder;
+using vespa::config::content::UpgradingConfigBuilder;
+using cloud::config::SlobroksConfigBuilder;
+using messagebus::MessagebusConfigBuilder;
+using metrics::MetricsmanagerConfigBuilder;
 
+using document::AssignValueUpdate;
 using document::BucketId;
 using document::BucketSpace;
 using document::Document;
 using document::DocumentId;
 using document::DocumentType;
 using document::DocumentTypeRepo;
+using document::DocumentUpdate;
 using document::DocumenttypesConfig;
+using document::DocumenttypesConfigBuilder;
 using document::Field;
+using document::FieldUpdate;
 using document::IntFieldValue;
 using document::test::makeBucketSpace;
+using feedbm::BmStorageChainBuilder;
+using feedbm::BmStorageLinkContext;
+using feedbm::IBmFeedHandler;
+using feedbm::LatencyStats;
+using feedbm::PendingTracker;
+using feedbm::SpiBmFeedHandler;
+using feedbm::StorageApiChainBmFeedHandler;
+using feedbm::StorageApiRpcBmFeedHandler;
 using search::TuneFileDocumentDB;
 using search::index::DummyFileHeaderContext;
 using search::index::Schema;
 using search::index::SchemaBuilder;
 using search::transactionlog::TransLogServer;
-using storage::spi::Bucket;
-using storage::spi::PartitionId;
+using storage::rpc::SharedRpcResources;
+using storage::rpc::StorageApiRpcService;
 using storage::spi::PersistenceProvider;
-using storage::spi::Priority;
-using storage::spi::Timestamp;
-using storage::spi::Trace;
 using vespalib::makeLambdaTask;
 
 using DocumentDBMap = std::map<DocTypeName, std::shared_ptr<DocumentDB>>;
 
 namespace {
 
-storage::spi::LoadType default_load_type(0, "default");
-
 vespalib::string base_dir = "testdb";
 
 std::shared_ptr<DocumenttypesConfig> make_document_type() {
@@ -135,86 +205,339 @@ struct MyResourceWriteFilter : public IResourceWriteFilter
     State getAcceptState() const override { return IResourceWriteFilter::State(); }
 };
 
-class MyPendingTracker {
-    uint32_t                _pending;
-    uint32_t                _limit;
-    std::mutex              _mutex;
-    std::condition_variable _cond;
+class MyServiceLayerProcess : public storage::ServiceLayerProcess {
+    PersistenceProvider& _provider;
 
 public:
-    MyPendingTracker(uint32_t limit)
-        : _pending(0u),
-          _limit(limit),
-          _mutex(),
-          _cond()
-    {
+    MyServiceLayerProcess(const config::ConfigUri & configUri,
+                          PersistenceProvider &provider,
+                          std::unique_ptr<storage::IStorageChainBuilder> chain_builder);
+    ~MyServiceLayerProcess() override { shutdown(); }
+
+    void shutdown() override;
+    void setupProvider() override;
+    PersistenceProvider& getProvider() override;
+};
+
+MyServiceLayerProcess::MyServiceLayerProcess(const config::ConfigUri & configUri,
+                                             PersistenceProvider &provider,
+                                             std::unique_ptr<storage::IStorageChainBuilder> chain_builder)
+    : ServiceLayerProcess(configUri),
+      _provider(provider)
+{
+    if (chain_builder) {
+        set_storage_chain_builder(std::move(chain_builder));
     }
+}
+
+void
+MyServiceLayerProcess::shutdown()
+{
+    ServiceLayerProcess::shutdown();
+}
 
-    ~MyPendingTracker()
+void
+MyServiceLayerProcess::setupProvider()
+{
+}
+
+PersistenceProvider&
+MyServiceLayerProcess::getProvider()
+{
+    return _provider;
+}
+
+class BMRange
+{
+    uint32_t _start;
+    uint32_t _end;
+public:
+    BMRange(uint32_t start_in, uint32_t end_in)
+        : _start(start_in),
+          _end(end_in)
     {
-        drain();
     }
+    uint32_t get_start() const { return _start; }
+    uint32_t get_end() const { return _end; }
+};
 
-    void release() {
-        std::unique_lock<std::mutex> guard(_mutex);
-        --_pending;
-        if (_pending < _limit) {
-            _cond.notify_all();
-        }
-        //LOG(info, "release, pending is now %u", _pending);
+class BMParams {
+    uint32_t _documents;
+    uint32_t _client_threads;
+    uint32_t _put_passes;
+    uint32_t _update_passes;
+    uint32_t _get_passes;
+    uint32_t _remove_passes;
+    uint32_t _max_pending;
+    uint32_t _rpc_network_threads;
+    bool     _enable_distributor;
+    bool     _enable_service_layer;
+    bool     _use_storage_chain;
+    uint32_t get_start(uint32_t thread_id) const {
+        return (_documents / _client_threads) * thread_id + std::min(thread_id, _documents % _client_threads);
     }
-    void retain() {
-        std::unique_lock<std::mutex> guard(_mutex);
-        while (_pending >= _limit) {
-            _cond.wait(guard);
-        }
-        ++_pending;
-        //LOG(info, "retain, pending is now %u", _pending);
+public:
+    BMParams()
+        : _documents(160000),
+          _client_threads(32),
+          _put_passes(2),
+          _update_passes(1),
+          _get_passes(1),
+          _remove_passes(2),
+          _max_pending(100),
+          _rpc_network_threads(1),
+          _enable_distributor(false),
+          _enable_service_layer(false),
+          _use_storage_chain(false)
+    {
     }
-
-    void drain() {
-        std::unique_lock<std::mutex> guard(_mutex);
-        while (_pending > 0) {
-            _cond.wait(guard);
-        }
+    BMRange get_range(uint32_t thread_id) const {
+        return BMRange(get_start(thread_id), get_start(thread_id + 1));
     }
+    uint32_t get_documents() const { return _documents; }
+    uint32_t get_client_threads() const { return _client_threads; }
+    uint32_t get_put_passes() const { return _put_passes; }
+    uint32_t get_update_passes() const { return _update_passes; }
+    uint32_t get_get_passes() const { return _get_passes; }
+    uint32_t get_remove_passes() const { return _remove_passes; }
+    uint32_t get_max_pending() const { return _max_pending; }
+    uint32_t get_rpc_network_threads() const { return _rpc_network_threads; }
+    bool get_enable_distributor() const { return _enable_distributor; }
+    bool get_use_storage_chain() const { return _use_storage_chain; }
+    void set_documents(uint32_t documents_in) { _documents = documents_in; }
+    void set_client_threads(uint32_t threads_in) { _client_threads = threads_in; }
+    void set_put_passes(uint32_t put_passes_in) { _put_passes = put_passes_in; }
+    void set_update_passes(uint32_t update_passes_in) { _update_passes = update_passes_in; }
+    void set_get_passes(uint32_t get_passes_in) { _get_passes = get_passes_in; }
+    void set_remove_passes(uint32_t remove_passes_in) { _remove_passes = remove_passes_in; }
+    void set_max_pending(uint32_t max_pending_in) { _max_pending = max_pending_in; }
+    void set_rpc_network_threads(uint32_t threads_in) { _rpc_network_threads = threads_in; }
+    void set_enable_distributor(bool enable_distributor_in) { _enable_distributor = enable_distributor_in; }
+    void set_enable_service_layer(bool enable_service_layer_in) { _enable_service_layer = enable_service_layer_in; }
+    void set_use_storage_chain(bool use_storage_chain_in) { _use_storage_chain = use_storage_chain_in; }
+    bool check() const;
+    bool needs_service_layer() const { return _enable_service_layer || _enable_distributor; }
+    bool needs_distributor() const { return _enable_distributor; }
 };
 
-class MyOperationComplete : public storage::spi::OperationComplete
+bool
+BMParams::check() const
 {
-    MyPendingTracker& _tracker;
-public:
-    MyOperationComplete(MyPendingTracker &tracker);
-    ~MyOperationComplete();
-    void onComplete(std::unique_ptr<storage::spi::Result> result) override;
-    void addResultHandler(const storage::spi::ResultHandler* resultHandler) override;
-};
+    if (_client_threads < 1) {
+        std::cerr << "Too few client threads: " << _client_threads << std::endl;
+        return false;
+    }
+    if (_client_threads > 1024) {
+        std::cerr << "Too many client threads: " << _client_threads << std::endl;
+        return false;
+    }
+    if (_documents < _client_threads) {
+        std::cerr << "Too few documents: " << _documents << std::endl;
+        return false;
+    }
+    if (_max_pending < 1) {
+        std::cerr << "Too few max pending operations: " << _max_pending << std::endl;
+        return false;
+    }
+    if (_rpc_network_threads < 1) {
+        std::cerr << "Too few rpc network threads: " << _rpc_network_threads << std::endl;
+        return false;
+    }
+    if (_use_storage_chain && !needs_service_layer()) {
+        std::cerr << "Storage chain requires service layer" << std::endl;
+        return false;
+    }
+    return true;
+}
 
-MyOperationComplete::MyOperationComplete(MyPendingTracker& tracker)
-    : _tracker(tracker)
+double
+cpu_time_seconds(int who)
 {
-    _tracker.retain();
+    struct rusage usage;
+    getrusage(who, &usage);
+    return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec + (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) * 1e-6;
 }
 
-MyOperationComplete::~MyOperationComplete()
+/*
+ * Config for a service layer or distributor node. All nodes and the
+ * rpc client share the config context, using different config ids.
+ */
+struct MyStorageConfig
 {
-    _tracker.release();
-}
+    vespalib::string                     config_id;
+    DocumenttypesConfigBuilder           documenttypes;
+    StorDistributionConfigBuilder        stor_distribution;
+    StorBouncerConfigBuilder             stor_bouncer;
+    StorCommunicationmanagerConfigBuilder stor_communicationmanager;
+    StorOpsloggerConfigBuilder           stor_opslogger;
+    StorPrioritymappingConfigBuilder     stor_prioritymapping;
+    UpgradingConfigBuilder               upgrading;
+    StorServerConfigBuilder              stor_server;
+    StorStatusConfigBuilder              stor_status;
+    BucketspacesConfigBuilder            bucketspaces;
+    LoadTypeConfigBuilder                load_type;
+    MetricsmanagerConfigBuilder          metricsmanager;
+    SlobroksConfigBuilder                slobroks;
+    MessagebusConfigBuilder              messagebus;
 
-void
-MyOperationComplete::onComplete(std::unique_ptr<storage::spi::Result> result)
+    MyStorageConfig(bool distributor, const vespalib::string& config_id_in, const DocumenttypesConfig& documenttypes_in,
+                    int slobrok_port, int mbus_port, int rpc_port, int status_port, const BMParams& params)
+        : config_id(config_id_in),
+          documenttypes(documenttypes_in),
+          stor_distribution(),
+          stor_bouncer(),
+          stor_communicationmanager(),
+          stor_opslogger(),
+          stor_prioritymapping(),
+          upgrading(),
+          stor_server(),
+          stor_status(),
+          bucketspaces(),
+          load_type(),
+          metricsmanager(),
+          slobroks(),
+          messagebus()
+    {
+        {
+            auto &dc = stor_distribution;
+            {
+                StorDistributionConfigBuilder::Group group;
+                {
+                    StorDistributionConfigBuilder::Group::Nodes node;
+                    node.index = 0;
+                    group.nodes.push_back(std::move(node));
+                }
+                group.index = "invalid";
+                group.name = "invalid";
+                group.capacity = 1.0;
+                group.partitions = "";
+                dc.group.push_back(std::move(group));
+            }
+            dc.redundancy = 1;
+            dc.readyCopies = 1;
+        }
+        stor_server.isDistributor = distributor;
+        stor_server.rootFolder = base_dir + (distributor ? "/distributor" : "/storage");
+        stor_server.persistenceProvider.type = StorServerConfigBuilder::PersistenceProvider::Type::RPC;
+        {
+            SlobroksConfigBuilder::Slobrok slobrok;
+            slobrok.connectionspec = vespalib::make_string("tcp/localhost:%d", slobrok_port);
+            slobroks.slobrok.push_back(std::move(slobrok));
+        }
+        stor_communicationmanager.useDirectStorageapiRpc = true;
+        stor_communicationmanager.rpc.numNetworkThreads = params.get_rpc_network_threads();
+        stor_communicationmanager.mbusport = mbus_port;
+        stor_communicationmanager.rpcport = rpc_port;
+
+        stor_status.httpport = status_port;
+        {
+            BucketspacesConfigBuilder::Documenttype bucket_space_map;
+            bucket_space_map.name = "test";
+            bucket_space_map.bucketspace = "default";
+            bucketspaces.documenttype.emplace_back(std::move(bucket_space_map));
+        }
+    }
+
+    ~MyStorageConfig();
+
+    void add_builders(ConfigSet &set) {
+        set.addBuilder(config_id, &documenttypes);
+        set.addBuilder(config_id, &stor_distribution);
+        set.addBuilder(config_id, &stor_bouncer);
+        set.addBuilder(config_id, &stor_communicationmanager);
+        set.addBuilder(config_id, &stor_opslogger);
+        set.addBuilder(config_id, &stor_prioritymapping);
+        set.addBuilder(config_id, &upgrading);
+        set.addBuilder(config_id, &stor_server);
+        set.addBuilder(config_id, &stor_status);
+        set.addBuilder(config_id, &bucketspaces);
+        set.addBuilder(config_id, &load_type);
+        set.addBuilder(config_id, &metricsmanager);
+        set.addBuilder(config_id, &slobroks);
+        set.addBuilder(config_id, &messagebus);
+    }
+};
+
+MyStorageConfig::~MyStorageConfig() = default;
+
+struct MyServiceLayerConfig : public MyStorageConfig
 {
-    (void) result;
-}
+    PersistenceConfigBuilder             persistence;
+    StorFilestorConfigBuilder            stor_filestor;
+    StorBucketInitConfigBuilder          stor_bucket_init;
+    StorVisitorConfigBuilder             stor_visitor;
 
-void
-MyOperationComplete::addResultHandler(const storage::spi::ResultHandler * resultHandler)
+    MyServiceLayerConfig(const vespalib::string& config_id_in, const DocumenttypesConfig& documenttypes_in,
+                         int slobrok_port, int mbus_port, int rpc_port, int status_port, const BMParams& params)
+        : MyStorageConfig(false, config_id_in, documenttypes_in, slobrok_port, mbus_port, rpc_port, status_port, params),
+          persistence(),
+          stor_filestor(),
+          stor_bucket_init(),
+          stor_visitor()
+    {
+    }
+
+    ~MyServiceLayerConfig();
+
+    void add_builders(ConfigSet &set) {
+        MyStorageConfig::add_builders(set);
+        set.addBuilder(config_id, &persistence);
+        set.addBuilder(config_id, &stor_filestor);
+        set.addBuilder(config_id, &stor_bucket_init);
+        set.addBuilder(config_id, &stor_visitor);
+    }
+};
+
+MyServiceLayerConfig::~MyServiceLayerConfig() = default;
+
+struct MyDistributorConfig : public MyStorageConfig
 {
-    (void) resultHandler;
-}
+    StorDistributormanagerConfigBuilder stor_distributormanager;
+    StorVisitordispatcherConfigBuilder  stor_visitordispatcher;
 
-}
+    MyDistributorConfig(const vespalib::string& config_id_in, const DocumenttypesConfig& documenttypes_in,
+                        int slobrok_port, int mbus_port, int rpc_port, int status_port, const BMParams& params)
+        : MyStorageConfig(true, config_id_in, documenttypes_in, slobrok_port, mbus_port, rpc_port, status_port, params),
+          stor_distributormanager(),
+          stor_visitordispatcher()
+    {
+    }
+
+    ~MyDistributorConfig();
+
+    void add_builders(ConfigSet &set) {
+        MyStorageConfig::add_builders(set);
+        set.addBuilder(config_id, &stor_distributormanager);
+        set.addBuilder(config_id, &stor_visitordispatcher);
+    }
+};
+
+MyDistributorConfig::~MyDistributorConfig() = default;
 
+struct MyRpcClientConfig {
+    vespalib::string      config_id;
+    SlobroksConfigBuilder slobroks;
+
+    MyRpcClientConfig(const vespalib::string &config_id_in, int slobrok_port)
+        : config_id(config_id_in),
+          slobroks()
+    {
+        {
+            SlobroksConfigBuilder::Slobrok slobrok;
+            slobrok.connectionspec = vespalib::make_string("tcp/localhost:%d", slobrok_port);
+            slobroks.slobrok.push_back(std::move(slobrok));
+        }
+    }
+    ~MyRpcClientConfig();
+
+    void add_builders(ConfigSet &set) {
+        set.addBuilder(config_id, &slobroks);
+    }
+};
+
+MyRpcClientConfig::~MyRpcClientConfig() = default;
+
+}
 
 struct PersistenceProviderFixture {
     std::shared_ptr<DocumenttypesConfig>       _document_types;
@@ -226,6 +549,13 @@ struct PersistenceProviderFixture {
     vespalib::string                           _base_dir;
     DummyFileHeaderContext                     _file_header_context;
     int                                        _tls_listen_port;
+    int                                        _slobrok_port;
+    int                                        _service_layer_mbus_port;
+    int                                        _service_layer_rpc_port;
+    int                                        _service_layer_status_port;
+    int                                        _distributor_mbus_port;
+    int                                        _distributor_rpc_port;
+    int                                        _distributor_status_port;
     TransLogServer                             _tls;
     vespalib::string                           _tls_spec;
     matching::QueryLimiter                     _query_limiter;
@@ -239,25 +569,40 @@ struct PersistenceProviderFixture {
     MyPersistenceEngineOwner                   _persistence_owner;
     MyResourceWriteFilter                      _write_filter;
     std::shared_ptr<PersistenceEngine>         _persistence_engine;
-    storage::spi::Context                      _context;
     uint32_t                                   _bucket_bits;
-    
-    PersistenceProviderFixture();
+    MyServiceLayerConfig                       _service_layer_config;
+    MyDistributorConfig                        _distributor_config;
+    MyRpcClientConfig                          _rpc_client_config;
+    ConfigSet                                  _config_set;
+    std::shared_ptr<IConfigContext>            _config_context;
+    std::unique_ptr<IBmFeedHandler>            _feed_handler;
+    std::unique_ptr<slobrok::SlobrokServer>    _slobrok;
+    std::shared_ptr<BmStorageLinkContext>      _service_layer_chain_context;
+    std::unique_ptr<MyServiceLayerProcess>     _service_layer;
+    std::unique_ptr<SharedRpcResources>        _rpc_client_shared_rpc_resources;
+    std::shared_ptr<BmStorageLinkContext>      _distributor_chain_context;
+    std::unique_ptr<storage::DistributorProcess> _distributor;
+
+    explicit PersistenceProviderFixture(const BMParams& params);
     ~PersistenceProviderFixture();
     void create_document_db();
     uint32_t num_buckets() const { return (1u << _bucket_bits); }
-    Bucket make_bucket(uint32_t i) const { return Bucket(document::Bucket(_bucket_space, BucketId(_bucket_bits, i & (num_buckets() - 1))), PartitionId(0)); }
-    BucketId get_bucket_id(const Document &document) const {
-        auto &id = document.getId();
-        auto &gid = id.getGlobalId();
-        return BucketId(_bucket_bits, gid.convertToBucketId().getRawId()).stripUnused();
-    }
+    BucketId make_bucket_id(uint32_t i) const { return BucketId(_bucket_bits, i & (num_buckets() - 1)); }
+    document::Bucket make_bucket(uint32_t i) const { return document::Bucket(_bucket_space, make_bucket_id(i)); }
     DocumentId make_document_id(uint32_t i) const;
     std::unique_ptr<Document> make_document(uint32_t i) const;
+    std::unique_ptr<DocumentUpdate> make_document_update(uint32_t i) const;
     void create_buckets();
+    void wait_slobrok(const vespalib::string &name);
+    void start_service_layer(const BMParams& params);
+    void start_distributor(const BMParams& params);
+    void create_feed_handler(const BMParams& params);
+    void shutdown_feed_handler();
+    void shutdown_distributor();
+    void shutdown_service_layer();
 };
 
-PersistenceProviderFixture::PersistenceProviderFixture()
+PersistenceProviderFixture::PersistenceProviderFixture(const BMParams& params)
     : _document_types(make_document_type()),
       _repo(std::make_shared<DocumentTypeRepo>(*_document_types)),
       _doc_type_name("test"),
@@ -267,6 +612,13 @@ PersistenceProviderFixture::PersistenceProviderFixture()
       _base_dir(base_dir),
       _file_header_context(),
       _tls_listen_port(9017),
+      _slobrok_port(9018),
+      _service_layer_mbus_port(9020),
+      _service_layer_rpc_port(9021),
+      _service_layer_status_port(9022),
+      _distributor_mbus_port(9023),
+      _distributor_rpc_port(9024),
+      _distributor_status_port(9025),
       _tls("tls", _tls_listen_port, _base_dir, _file_header_context),
       _tls_spec(vespalib::make_string("tcp/localhost:%d", _tls_listen_port)),
       _query_limiter(),
@@ -280,17 +632,35 @@ PersistenceProviderFixture::PersistenceProviderFixture()
       _persistence_owner(),
       _write_filter(),
       _persistence_engine(),
-      _context(default_load_type, Priority(0), Trace::TraceLevel(0)),
-      _bucket_bits(16)
+      _bucket_bits(16),
+      _service_layer_config("bm-servicelayer", *_document_types, _slobrok_port, _service_layer_mbus_port, _service_layer_rpc_port, _service_layer_status_port, params),
+      _distributor_config("bm-distributor", *_document_types, _slobrok_port, _distributor_mbus_port, _distributor_rpc_port, _distributor_status_port, params),
+      _rpc_client_config("bm-rpc-client", _slobrok_port),
+      _config_set(),
+      _config_context(std::make_shared<ConfigContext>(_config_set)),
+      _feed_handler(),
+      _slobrok(),
+      _service_layer_chain_context(),
+      _service_layer(),
+      _rpc_client_shared_rpc_resources(),
+      _distributor_chain_context(),
+      _distributor()
 {
     create_document_db();
     _persistence_engine = std::make_unique<PersistenceEngine>(_persistence_owner, _write_filter, -1, false);
     auto proxy = std::make_shared<PersistenceHandlerProxy>(_document_db);
     _persistence_engine->putHandler(_persistence_engine->getWLock(), _bucket_space, _doc_type_name, proxy);
+    _service_layer_config.add_builders(_config_set);
+    _distributor_config.add_builders(_config_set);
+    _rpc_client_config.add_builders(_config_set);
+    _feed_handler = std::make_unique<SpiBmFeedHandler>(*_persistence_engine, _repo);
 }
 
 PersistenceProviderFixture::~PersistenceProviderFixture()
 {
+    shutdown_feed_handler();
+    shutdown_distributor();
+    shutdown_service_layer();
     if (_persistence_engine) {
         _persistence_engine->destroyIterators();
         _persistence_engine->removeHandler(_persistence_engine->getWLock(), _bucket_space, _doc_type_name);
@@ -360,105 +730,458 @@ PersistenceProviderFixture::make_document(uint32_t i) const
     return document;
 }
 
+std::unique_ptr<DocumentUpdate>
+PersistenceProviderFixture::make_document_update(uint32_t i) const
+{
+    auto id = make_document_id(i);
+    auto document_update = std::make_unique<DocumentUpdate>(*_repo, *_document_type, id);
+    document_update->addUpdate(FieldUpdate(_field).addUpdate(AssignValueUpdate(IntFieldValue(15))));
+    return document_update;
+}
+
 void
 PersistenceProviderFixture::create_buckets()
 {
-    auto &provider = *_persistence_engine;
+    if (_feed_handler->manages_buckets()) {
+        return;
+    }
+    PendingTracker tracker(1000);
     for (unsigned int i = 0; i < num_buckets(); ++i) {
-        provider.createBucket(make_bucket(i), _context);
+        _feed_handler->create_bucket(make_bucket(i), tracker);
     }
+    tracker.drain();
 }
 
 void
-put_async_task(PersistenceProviderFixture &f, uint32_t start, uint32_t count, int64_t time_bias)
+PersistenceProviderFixture::wait_slobrok(const vespalib::string &name)
 {
-    MyPendingTracker pending_tracker(100);
-    auto &provider = *f._persistence_engine;
-    auto &context = f._context;
-    uint32_t end = start + count;
-    for (unsigned int i = start; i < end; ++i) {
-        auto bucket = f.make_bucket(i);
-        auto document = f.make_document(i);
-        provider.putAsync(bucket, Timestamp(time_bias + i), std::move(document), context, std::make_unique<MyOperationComplete>(pending_tracker));
+    auto &mirror = _rpc_client_shared_rpc_resources->slobrok_mirror();
+    LOG(info, "Waiting for %s in slobrok", name.c_str());
+    for (;;) {
+        auto specs = mirror.lookup(name);
+        if (!specs.empty()) {
+            LOG(info, "Found %s in slobrok", name.c_str());
+            return;
+        }
+        std::this_thread::sleep_for(100ms);
+    }
+}
+
+namespace {
+
+void
+set_cluster_up(BmStorageLinkContext &context)
+{
+    PendingTracker tracker(1);
+    auto cmd = std::make_shared<storage::api::SetSystemStateCommand>(storage::lib::ClusterState("version:2 distributor:1 storage:1"));
+    context.bm_link->retain(cmd->getMsgId(), tracker);
+    context.bm_link->sendDown(std::move(cmd));
+    tracker.drain();
+}
+
+}
+
+void
+PersistenceProviderFixture::start_service_layer(const BMParams& params)
+{
+    LOG(info, "start slobrok");
+    _slobrok = std::make_unique<slobrok::SlobrokServer>(_slobrok_port);
+    LOG(info, "start service layer");
+    config::ConfigUri config_uri("bm-servicelayer", _config_context);
+    auto chain_builder = std::make_unique<BmStorageChainBuilder>();
+    _service_layer_chain_context = chain_builder->get_context();
+    _service_layer = std::make_unique<MyServiceLayerProcess>(config_uri,
+                                                             *_persistence_engine,
+                                                             std::move(chain_builder));
+    _service_layer->setupConfig(100ms);
+    _service_layer->createNode();
+    _service_layer->getNode().waitUntilInitialized();
+    LOG(info, "start rpc client shared resources");
+    config::ConfigUri client_config_uri("bm-rpc-client", _config_context);
+    _rpc_client_shared_rpc_resources = std::make_unique<SharedRpcResources>(client_config_uri, 0, params.get_rpc_network_threads());
+    _rpc_client_shared_rpc_resources->start_server_and_register_slobrok("bm-rpc-client");
+    wait_slobrok("storage/cluster.storage/storage/0");
+    set_cluster_up(*_service_layer_chain_context);
+}
+
+void
+PersistenceProviderFixture::start_distributor(const BMParams& params)
+{
+    (void) params;
+    config::ConfigUri config_uri("bm-distributor", _config_context);
+    auto chain_builder = std::make_unique<BmStorageChainBuilder>();
+    _distributor_chain_context = chain_builder->get_context();
+    _distributor = std::make_unique<storage::DistributorProcess>(config_uri);
+    _distributor->set_storage_chain_builder(std::move(chain_builder));
+    _distributor->setupConfig(100ms);
+    _distributor->createNode();
+    _distributor->getNode().waitUntilInitialized();
+    wait_slobrok("storage/cluster.storage/distributor/0");
+    set_cluster_up(*_distributor_chain_context);
+}
+
+void
+PersistenceProviderFixture::create_feed_handler(const BMParams& params)
+{
+    StorageApiRpcService::Params rpc_params;
+    // This is the same compression config as the default in stor-communicationmanager.def.
+    rpc_params.compression_config = vespalib::compression::CompressionConfig(vespalib::compression::CompressionConfig::Type::LZ4, 3, 90, 1024);
+    if (params.needs_distributor()) {
+        if (params.get_use_storage_chain()) {
+            _feed_handler = std::make_unique<StorageApiChainBmFeedHandler>(_distributor_chain_context, true);
+        } else {
+            _feed_handler = std::make_unique<StorageApiRpcBmFeedHandler>(*_rpc_client_shared_rpc_resources, _repo, rpc_params, true);
+        }
+        return;
+    }
+    if (params.needs_service_layer()) {
+        if (params.get_use_storage_chain()) {
+            _feed_handler = std::make_unique<StorageApiChainBmFeedHandler>(_service_layer_chain_context, false);
+        } else {
+            _feed_handler = std::make_unique<StorageApiRpcBmFeedHandler>(*_rpc_client_shared_rpc_resources, _repo, rpc_params, false);
+        }
+    }
+}
+
+void
+PersistenceProviderFixture::shutdown_feed_handler()
+{
+    _feed_handler.reset();
+}
+
+void
+PersistenceProviderFixture::shutdown_distributor()
+{
+    if (_distributor) {
+        LOG(info, "stop distributor");
+        _distributor->getNode().requestShutdown("controlled shutdown");
+        _distributor->shutdown();
+        _distributor.reset();
     }
-    pending_tracker.drain();
 }
 
 void
-run_put_async_tasks(PersistenceProviderFixture &f, vespalib::ThreadStackExecutor &executor, int pass, int64_t& time_bias)
+PersistenceProviderFixture::shutdown_service_layer()
 {
-    uint32_t tasks = 32;
-    uint32_t per_task = 5000;
-    LOG(info, "putAsync %u small documents, pass=%u", tasks * per_task, pass);
+    if (_rpc_client_shared_rpc_resources) {
+        LOG(info, "stop rpc client shared resources");
+        _rpc_client_shared_rpc_resources->shutdown();
+        _rpc_client_shared_rpc_resources.reset();
+    }
+    if (_service_layer) {
+        LOG(info, "stop service layer");
+        _service_layer->getNode().requestShutdown("controlled shutdown");
+        _service_layer->shutdown();
+        _service_layer.reset();
+    }
+    if (_slobrok) {
+        LOG(info, "stop slobrok");
+        _slobrok.reset();
+    }
+}
+
+/*
+ * Runs one pass of an operation over all documents, split into one range per
+ * client thread, and reports throughput, latency and cpu usage. Cpu usage is
+ * reported for the whole process and for the client threads alone; the
+ * difference is the cpu used by the layers fed through (network, distributor,
+ * service layer and persistence provider, depending on the options).
+ */
+template <typename Func>
+void
+run_pass(const char *op_name, const char *op_plural, Func func, vespalib::ThreadStackExecutor &executor,
+         const IBmFeedHandler &feed_handler, const BMParams &params, int pass, int64_t &time_bias)
+{
+    uint32_t client_threads = params.get_client_threads();
+    LOG(info, "%s %u small documents, pass=%u", op_name, params.get_documents(), pass);
+    std::vector<LatencyStats> latencies(client_threads);
+    std::vector<double> client_cpu(client_threads);
+    uint32_t old_errors = feed_handler.get_error_count();
+    double start_cpu = cpu_time_seconds(RUSAGE_SELF);
     auto start_time = std::chrono::steady_clock::now();
-    for (uint32_t i = 0; i < tasks; ++i) {
-        executor.execute(makeLambdaTask([&f, i, per_task, time_bias]()
-                                        { put_async_task(f, i * per_task, per_task, time_bias); }));
+    for (uint32_t i = 0; i < client_threads; ++i) {
+        auto range = params.get_range(i);
+        auto &latency = latencies[i];
+        auto &cpu = client_cpu[i];
+        executor.execute(makeLambdaTask([func, range, time_bias, &latency, &cpu]()
+                                        {
+                                            double task_start_cpu = cpu_time_seconds(RUSAGE_THREAD);
+                                            func(range, time_bias, latency);
+                                            cpu = cpu_time_seconds(RUSAGE_THREAD) - task_start_cpu;
+                                        }));
     }
     executor.sync();
     auto end_time = std::chrono::steady_clock::now();
+    double cpu = cpu_time_seconds(RUSAGE_SELF) - start_cpu;
     std::chrono::duration<double> elapsed = end_time - start_time;
-    LOG(info, "%8.2f puts/s for pass=%u", (tasks * per_task) / elapsed.count(), pass);
-    time_bias += tasks * per_task;
+    LatencyStats latency;
+    double cpu_client = 0.0;
+    for (uint32_t i = 0; i < client_threads; ++i) {
+        latency.merge(latencies[i]);
+        cpu_client += client_cpu[i];
+    }
+    double cpu_server = std::max(0.0, cpu - cpu_client);
+    uint32_t new_errors = feed_handler.get_error_count() - old_errors;
+    LOG(info, "%8.2f %s/s for pass=%u using %s", params.get_documents() / elapsed.count(), op_plural, pass, feed_handler.get_name().c_str());
+    if (new_errors != 0) {
+        LOG(warning, "%u failed %s for pass=%u", new_errors, op_plural, pass);
+    }
+    LOG(info, "latency for pass=%u: p50=%.3f ms, p90=%.3f ms, p99=%.3f ms, max=%.3f ms", pass,
+        latency.percentile(50) * 1000.0, latency.percentile(90) * 1000.0, latency.percentile(99) * 1000.0,
+        latency.percentile(100) * 1000.0);
+    LOG(info, "cpu for pass=%u: %.2f cores, %.2f us/%s (client %.2f us/%s, %s %.2f us/%s)", pass, cpu / elapsed.count(),
+        cpu * 1e6 / params.get_documents(), op_name,
+        cpu_client * 1e6 / params.get_documents(), op_name,
+        feed_handler.get_name().c_str(), cpu_server * 1e6 / params.get_documents(), op_name);
+    time_bias += params.get_documents();
+}
+
+void
+put_async_task(PersistenceProviderFixture &f, const BMParams &params, BMRange range, int64_t time_bias, LatencyStats &latency)
+{
+    PendingTracker pending_tracker(params.get_max_pending());
+    auto &feed_handler = *f._feed_handler;
+    for (unsigned int i = range.get_start(); i < range.get_end(); ++i) {
+        auto bucket = f.make_bucket(i);
+        auto document = f.make_document(i);
+        feed_handler.put(bucket, std::move(document), time_bias + i, pending_tracker);
+    }
+    pending_tracker.drain();
+    latency.merge(pending_tracker.get_latency());
+}
+
+void
+update_async_task(PersistenceProviderFixture &f, const BMParams &params, BMRange range, int64_t time_bias, LatencyStats &latency)
+{
+    PendingTracker pending_tracker(params.get_max_pending());
+    auto &feed_handler = *f._feed_handler;
+    for (unsigned int i = range.get_start(); i < range.get_end(); ++i) {
+        auto bucket = f.make_bucket(i);
+        auto document_update = f.make_document_update(i);
+        feed_handler.update(bucket, std::move(document_update), time_bias + i, pending_tracker);
+    }
+    pending_tracker.drain();
+    latency.merge(pending_tracker.get_latency());
 }
 
 void
-remove_async_task(PersistenceProviderFixture &f, uint32_t start, uint32_t count, int64_t time_bias)
+get_async_task(PersistenceProviderFixture &f, const BMParams &params, BMRange range, LatencyStats &latency)
 {
-    MyPendingTracker pending_tracker(100);
-    auto &provider = *f._persistence_engine;
-    auto &context = f._context;
-    uint32_t end = start + count;
-    for (unsigned int i = start; i < end; ++i) {
+    PendingTracker pending_tracker(params.get_max_pending());
+    auto &feed_handler = *f._feed_handler;
+    for (unsigned int i = range.get_start(); i < range.get_end(); ++i) {
         auto bucket = f.make_bucket(i);
         auto document_id = f.make_document_id(i);
-        provider.removeAsync(bucket, Timestamp(time_bias + i), document_id, context, std::make_unique<MyOperationComplete>(pending_tracker));
+        feed_handler.get(bucket, document::AllFields::NAME, document_id, pending_tracker);
     }
     pending_tracker.drain();
+    latency.merge(pending_tracker.get_latency());
 }
 
 void
-run_remove_async_tasks(PersistenceProviderFixture &f, vespalib::ThreadStackExecutor &executor, int pass, int64_t& time_bias)
+remove_async_task(PersistenceProviderFixture &f, const BMParams &params, BMRange range, int64_t time_bias, LatencyStats &latency)
 {
-    uint32_t tasks = 32;
-    uint32_t per_task = 5000;
-    LOG(info, "removeAsync %u small documents, pass=%u", tasks * per_task, pass);
-    auto start_time = std::chrono::steady_clock::now();
-    for (uint32_t i = 0; i < tasks; ++i) {
-        executor.execute(makeLambdaTask([&f, i, per_task, time_bias]()
-                                        { remove_async_task(f, i * per_task, per_task, time_bias); }));
+    PendingTracker pending_tracker(params.get_max_pending());
+    auto &feed_handler = *f._feed_handler;
+    for (unsigned int i = range.get_start(); i < range.get_end(); ++i) {
+        auto bucket = f.make_bucket(i);
+        auto document_id = f.make_document_id(i);
+        feed_handler.remove(bucket, document_id, time_bias + i, pending_tracker);
     }
-    executor.sync();
-    auto end_time = std::chrono::steady_clock::now();
-    std::chrono::duration<double> elapsed = end_time - start_time;
-    LOG(info, "%8.2f removes/s for pass=%u", (tasks * per_task) / elapsed.count(), pass);
-    time_bias += tasks * per_task;
+    pending_tracker.drain();
+    latency.merge(pending_tracker.get_latency());
 }
 
-void benchmark_async_spi()
+void benchmark_async_feed(const BMParams &bm_params)
 {
     vespalib::rmdir(base_dir, true);
-    PersistenceProviderFixture f;
-    auto &provider = *f._persistence_engine;
-    LOG(info, "start initialize");
-    provider.initialize();
+    PersistenceProviderFixture f(bm_params);
+    if (bm_params.needs_service_layer()) {
+        // The service layer initializes the persistence provider
+        f.start_service_layer(bm_params);
+    } else {
+        LOG(info, "start initialize");
+        f._persistence_engine->initialize();
+    }
+    if (bm_params.needs_distributor()) {
+        f.start_distributor(bm_params);
+    }
+    f.create_feed_handler(bm_params);
     LOG(info, "create %u buckets", f.num_buckets());
     f.create_buckets();
-    vespalib::ThreadStackExecutor executor(32, 128 * 1024);
+    vespalib::ThreadStackExecutor executor(bm_params.get_client_threads(), 128 * 1024);
+    auto &feed_handler = *f._feed_handler;
     int64_t time_bias = 1;
-    run_put_async_tasks(f, executor, 0, time_bias);
-    run_put_async_tasks(f, executor, 1, time_bias);
-    run_remove_async_tasks(f, executor, 0, time_bias);
-    run_remove_async_tasks(f, executor, 1, time_bias);
+    for (uint32_t pass = 0; pass < bm_params.get_put_passes(); ++pass) {
+        run_pass("put", "puts", [&f, &bm_params](BMRange range, int64_t bias, LatencyStats &latency)
+                 { put_async_task(f, bm_params, range, bias, latency); },
+                 executor, feed_handler, bm_params, pass, time_bias);
+    }
+    for (uint32_t pass = 0; pass < bm_params.get_update_passes(); ++pass) {
+        run_pass("update", "updates", [&f, &bm_params](BMRange range, int64_t bias, LatencyStats &latency)
+                 { update_async_task(f, bm_params, range, bias, latency); },
+                 executor, feed_handler, bm_params, pass, time_bias);
+    }
+    for (uint32_t pass = 0; pass < bm_params.get_get_passes(); ++pass) {
+        run_pass("get", "gets", [&f, &bm_params](BMRange range, int64_t, LatencyStats &latency)
+                 { get_async_task(f, bm_params, range, latency); },
+                 executor, feed_handler, bm_params, pass, time_bias);
+    }
+    for (uint32_t pass = 0; pass < bm_params.get_remove_passes(); ++pass) {
+        run_pass("remove", "removes", [&f, &bm_params](BMRange range, int64_t bias, LatencyStats &latency)
+                 { remove_async_task(f, bm_params, range, bias, latency); },
+                 executor, feed_handler, bm_params, pass, time_bias);
+    }
+    LOG(info, "%u failed operations using %s", feed_handler.get_error_count(), feed_handler.get_name().c_str());
+}
+
+class App : public FastOS_Application
+{
+    BMParams _bm_params;
+public:
+    App();
+    ~App() override;
+    void usage();
+    bool get_options();
+    int Main() override;
+};
+
+App::App()
+    : _bm_params()
+{
+}
+
+App::~App() = default;
+
+void
+App::usage()
+{
+    std::cerr <<
+        "vespa-spi-feed-bm version 0.0\n"
+        "\n"
+        "USAGE:\n";
+    std::cerr <<
+        "vespa-spi-feed-bm\n"
+        "[--client-threads threads]\n"
+        "[--documents documents]\n"
+        "[--put-passes put-passes]\n"
+        "[--update-passes update-passes]\n"
+        "[--get-passes get-passes]\n"
+        "[--remove-passes remove-passes]\n"
+        "[--max-pending max-pending]\n"
+        "[--rpc-network-threads threads]\n"
+        "[--enable-distributor]\n"
+        "[--enable-service-layer]\n"
+        "[--use-storage-chain]\n"
+        "\n"
+        "Feed goes directly to the persistence provider (spi) by default.\n"
+        "--enable-service-layer feeds through the service layer storage chain,\n"
+        "--enable-distributor feeds through the distributor and the service layer.\n"
+        "Storage api messages are sent using rpc over loopback unless\n"
+        "--use-storage-chain is given, which sends them directly into the\n"
+        "storage chain of the first node fed through." << std::endl;
+}
+
+bool
+App::get_options()
+{
+    int c;
+    const char *opt_argument = nullptr;
+    int long_opt_index = 0;
+    static struct option long_opts[] = {
+        { "client-threads", 1, nullptr, 0 },
+        { "documents", 1, nullptr, 0 },
+        { "enable-distributor", 0, nullptr, 0 },
+        { "enable-service-layer", 0, nullptr, 0 },
+        { "get-passes", 1, nullptr, 0 },
+        { "max-pending", 1, nullptr, 0 },
+        { "put-passes", 1, nullptr, 0 },
+        { "remove-passes", 1, nullptr, 0 },
+        { "rpc-network-threads", 1, nullptr, 0 },
+        { "update-passes", 1, nullptr, 0 },
+        { "use-storage-chain", 0, nullptr, 0 },
+        { nullptr, 0, nullptr, 0 }
+    };
+    enum longopts_enum {
+        LONGOPT_CLIENT_THREADS,
+        LONGOPT_DOCUMENTS,
+        LONGOPT_ENABLE_DISTRIBUTOR,
+        LONGOPT_ENABLE_SERVICE_LAYER,
+        LONGOPT_GET_PASSES,
+        LONGOPT_MAX_PENDING,
+        LONGOPT_PUT_PASSES,
+        LONGOPT_REMOVE_PASSES,
+        LONGOPT_RPC_NETWORK_THREADS,
+        LONGOPT_UPDATE_PASSES,
+        LONGOPT_USE_STORAGE_CHAIN
+    };
+    int opt_index = 1;
+    resetOptIndex(opt_index);
+    while ((c = GetOptLong("", opt_argument, opt_index, long_opts, &long_opt_index)) != -1) {
+        switch (c) {
+        case 0:
+            switch(long_opt_index) {
+            case LONGOPT_CLIENT_THREADS:
+                _bm_params.set_client_threads(atoi(opt_argument));
+                break;
+            case LONGOPT_DOCUMENTS:
+                _bm_params.set_documents(atoi(opt_argument));
+                break;
+            case LONGOPT_ENABLE_DISTRIBUTOR:
+                _bm_params.set_enable_distributor(true);
+                break;
+            case LONGOPT_ENABLE_SERVICE_LAYER:
+                _bm_params.set_enable_service_layer(true);
+                break;
+            case LONGOPT_GET_PASSES:
+                _bm_params.set_get_passes(atoi(opt_argument));
+                break;
+            case LONGOPT_MAX_PENDING:
+                _bm_params.set_max_pending(atoi(opt_argument));
+                break;
+            case LONGOPT_PUT_PASSES:
+                _bm_params.set_put_passes(atoi(opt_argument));
+                break;
+            case LONGOPT_REMOVE_PASSES:
+                _bm_params.set_remove_passes(atoi(opt_argument));
+                break;
+            case LONGOPT_RPC_NETWORK_THREADS:
+                _bm_params.set_rpc_network_threads(atoi(opt_argument));
+                break;
+            case LONGOPT_UPDATE_PASSES:
+                _bm_params.set_update_passes(atoi(opt_argument));
+                break;
+            case LONGOPT_USE_STORAGE_CHAIN:
+                _bm_params.set_use_storage_chain(true);
+                break;
+            default:
+                return false;
+            }
+            break;
+        default:
+            return false;
+        }
+    }
+    return _bm_params.check();
 }
 
 int
-main(int argc, char* argv[])
+App::Main()
 {
-    (void) argc;
-    (void) argv;
+    if (!get_options()) {
+        usage();
+        return 1;
+    }
     DummyFileHeaderContext::setCreator("vespa-spi-feed-bm");
-    benchmark_async_spi();
+    benchmark_async_feed(_bm_params);
     vespalib::rmdir(base_dir, true);
     return 0;
 }
+
+int
+main(int argc, char* argv[])
+{
+    App app;
+    auto exit_value = app.Entry(argc, argv);
+    return exit_value;
+}
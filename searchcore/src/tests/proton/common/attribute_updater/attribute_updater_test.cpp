@@ -22,12 +22,14 @@
 #include <vespa/document/update/tensor_modify_update.h>
 #include <vespa/document/update/tensor_remove_update.h>
 #include <vespa/eval/tensor/default_tensor_engine.h>
+#include <vespa/eval/tensor/dense/mutable_dense_tensor_view.h>
 #include <vespa/eval/tensor/tensor.h>
 #include <vespa/searchcore/proton/common/attribute_updater.h>
 #include <vespa/searchlib/attribute/attributefactory.h>
 #include <vespa/searchlib/attribute/attributevector.hpp>
 #include <vespa/searchlib/attribute/reference_attribute.h>
 #include <vespa/searchlib/tensor/dense_tensor_attribute.h>
+#include <vespa/searchlib/tensor/direct_tensor_attribute.h>
 #include <vespa/searchlib/tensor/serialized_tensor_attribute.h>
 #include <vespa/searchlib/test/weighted_type_test_utils.h>
 #include <vespa/vespalib/stllike/hash_map.hpp>
@@ -48,11 +50,13 @@ using search::attribute::Reference;
 using search::attribute::ReferenceAttribute;
 using search::tensor::ITensorAttribute;
 using search::tensor::DenseTensorAttribute;
+using search::tensor::DirectTensorAttribute;
 using search::tensor::SerializedTensorAttribute;
 using search::tensor::TensorAttribute;
 using vespalib::eval::ValueType;
 using vespalib::eval::TensorSpec;
 using vespalib::tensor::DefaultTensorEngine;
+using vespalib::tensor::MutableDenseTensorView;
 using vespalib::tensor::Tensor;
 
 namespace search {
@@ -79,7 +83,8 @@ makeDocumentTypeRepo()
                              .addField("wsstring", Wset(DataType::T_STRING))
                              .addField("ref", 333)
                              .addField("dense_tensor", DataType::T_TENSOR)
-                             .addField("sparse_tensor", DataType::T_TENSOR),
+                             .addField("sparse_tensor", DataType::T_TENSOR)
+                             .addField("mixed_tensor", DataType::T_TENSOR),
                      Struct("testdoc.body"))
                      .referenceType(333, 222);
     return std::make_unique<DocumentTypeRepo>(builder.config());
@@ -482,6 +487,42 @@ TEST_F("require that tensor remove update is applied",
     f.assertTensor(TensorSpec(f.type).add({{"x", "a"}}, 2));
 }
 
+TEST_F("require that tensor modify update to dense tensor does not change cells seen by readers",
+        TensorFixture<DenseTensorAttribute>("tensor(x[2])", "dense_tensor"))
+{
+    f.setTensor(TensorSpec(f.type).add({{"x", 0}}, 3).add({{"x", 1}}, 5));
+    MutableDenseTensorView old_view(f.attribute->getConfig().tensorType());
+    f.attribute->extract_dense_view(1, old_view);
+    f.applyValueUpdate(*f.attribute, 1,
+                       TensorModifyUpdate(TensorModifyUpdate::Operation::ADD,
+                                          makeTensorFieldValue(TensorSpec("tensor(x{})").add({{"x", 1}}, 2))));
+    f.assertTensor(TensorSpec(f.type).add({{"x", 0}}, 3).add({{"x", 1}}, 7));
+    EXPECT_EQUAL(TensorSpec(f.type).add({{"x", 0}}, 3).add({{"x", 1}}, 5), old_view.toSpec());
+}
+
+TEST_F("require that tensor modify update is applied to direct tensor attribute",
+        TensorFixture<DirectTensorAttribute>("tensor(x{},y[2])", "mixed_tensor"))
+{
+    f.setTensor(TensorSpec(f.type).add({{"x", "a"}, {"y", 0}}, 2).add({{"x", "a"}, {"y", 1}}, 3));
+    f.applyValueUpdate(*f.attribute, 1,
+                       TensorModifyUpdate(TensorModifyUpdate::Operation::MULTIPLY,
+                                          makeTensorFieldValue(TensorSpec("tensor(x{},y{})")
+                                                                       .add({{"x", "a"}, {"y", "1"}}, 5)
+                                                                       .add({{"x", "b"}, {"y", "0"}}, 7))));
+    f.assertTensor(TensorSpec(f.type).add({{"x", "a"}, {"y", 0}}, 2).add({{"x", "a"}, {"y", 1}}, 15));
+}
+
+TEST_F("require that tensor add and remove updates are applied to direct tensor attribute",
+        TensorFixture<DirectTensorAttribute>("tensor(x{})", "sparse_tensor"))
+{
+    f.applyValueUpdate(*f.attribute, 1,
+                       TensorAddUpdate(makeTensorFieldValue(TensorSpec(f.type).add({{"x", "a"}}, 3).add({{"x", "b"}}, 4))));
+    f.assertTensor(TensorSpec(f.type).add({{"x", "a"}}, 3).add({{"x", "b"}}, 4));
+    f.applyValueUpdate(*f.attribute, 1,
+                       TensorRemoveUpdate(makeTensorFieldValue(TensorSpec(f.type).add({{"x", "a"}}, 1))));
+    f.assertTensor(TensorSpec(f.type).add({{"x", "b"}}, 4));
+}
+
 }
 
 TEST_MAIN() { TEST_RUN_ALL(); }
@@ -17,6 +17,8 @@
 #include <vespa/document/update/tensor_add_update.h>
 #include <vespa/document/update/tensor_modify_update.h>
 #include <vespa/document/update/tensor_remove_update.h>
+#include <vespa/eval/tensor/cell_values.h>
+#include <vespa/eval/tensor/sparse/sparse_tensor.h>
 #include <vespa/eval/tensor/tensor.h>
 #include <vespa/searchlib/attribute/attributevector.hpp>
 #include <vespa/searchlib/attribute/changevector.hpp>
@@ -207,11 +209,53 @@ AttributeUpdater::handleUpdate(PredicateAttribute &vec, uint32_t lid, const Valu
 
 namespace {
 
+using vespalib::tensor::CellValues;
+using vespalib::tensor::SparseTensor;
+
+// Apply the update directly to the tensor stored in the attribute.
+// Returns false if the attribute does not support this.
+bool
+applyTensorUpdateInAttribute(TensorAttribute &vec, uint32_t lid, const TensorModifyUpdate &update)
+{
+    auto &cellsTensor = update.getTensor().getAsTensorPtr();
+    if (!cellsTensor) {
+        return true;
+    }
+    // Cells tensor being sparse was validated during deserialize().
+    CellValues cellValues(static_cast<const SparseTensor &>(*cellsTensor));
+    return vec.modify_tensor(lid, TensorModifyUpdate::getJoinFunction(update.getOperation()), cellValues);
+}
+
+bool
+applyTensorUpdateInAttribute(TensorAttribute &vec, uint32_t lid, const TensorAddUpdate &update)
+{
+    auto &addTensor = update.getTensor().getAsTensorPtr();
+    if (!addTensor) {
+        return true;
+    }
+    return vec.add_to_tensor(lid, *addTensor);
+}
+
+bool
+applyTensorUpdateInAttribute(TensorAttribute &vec, uint32_t lid, const TensorRemoveUpdate &update)
+{
+    auto &addressTensor = update.getTensor().getAsTensorPtr();
+    if (!addressTensor) {
+        return true;
+    }
+    // Address tensor being sparse was validated during deserialize().
+    CellValues cellAddresses(static_cast<const SparseTensor &>(*addressTensor));
+    return vec.remove_from_tensor(lid, cellAddresses);
+}
+
 template <typename TensorUpdateType>
 void
 applyTensorUpdate(TensorAttribute &vec, uint32_t lid, const TensorUpdateType &update,
                   bool create_empty_if_non_existing)
 {
+    if (applyTensorUpdateInAttribute(vec, lid, update)) {
+        return;
+    }
     auto oldTensor = vec.getTensor(lid);
     if (!oldTensor && create_empty_if_non_existing) {
         oldTensor = vec.getEmptyTensor();
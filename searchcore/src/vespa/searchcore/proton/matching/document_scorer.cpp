@@ -1,10 +1,12 @@
 // Copyright 2017 Yahoo Holdings. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
 
 #include "document_scorer.h"
+#include <algorithm>
 #include <cassert>
 
 using search::feature_t;
 using search::fef::FeatureResolver;
+using search::fef::MatchData;
 using search::fef::RankProgram;
 using search::fef::LazyValue;
 using search::queryeval::SearchIterator;
@@ -25,15 +27,78 @@ extractScoreFeature(const RankProgram &rankProgram)
 
 DocumentScorer::DocumentScorer(RankProgram &rankProgram,
                                SearchIterator &searchItr)
-    : _searchItr(searchItr),
-      _scoreFeature(extractScoreFeature(rankProgram))
+    : _rankProgram(rankProgram),
+      _searchItr(searchItr),
+      _scoreFeature(extractScoreFeature(rankProgram)),
+      _matchData(nullptr),
+      _batchSize(1),
+      _savedMatchData()
 {
 }
 
+DocumentScorer::DocumentScorer(RankProgram &rankProgram,
+                               SearchIterator &searchItr,
+                               MatchData &matchData,
+                               size_t batchSize)
+    : _rankProgram(rankProgram),
+      _searchItr(searchItr),
+      _scoreFeature(extractScoreFeature(rankProgram)),
+      _matchData(&matchData),
+      _batchSize(rankProgram.has_batch_executors() ? std::max(batchSize, size_t(1)) : 1),
+      _savedMatchData()
+{
+}
+
+DocumentScorer::~DocumentScorer() = default;
+
+void
+DocumentScorer::save_match_data(size_t batchIdx)
+{
+    if (_savedMatchData.size() <= batchIdx) {
+        _savedMatchData.resize(batchIdx + 1);
+    }
+    auto &saved = _savedMatchData[batchIdx];
+    saved.resize(_matchData->getNumTermFields());
+    for (uint32_t i = 0; i < saved.size(); ++i) {
+        saved[i] = *_matchData->resolveTermField(i);
+    }
+}
+
+void
+DocumentScorer::restore_match_data(size_t batchIdx)
+{
+    const auto &saved = _savedMatchData[batchIdx];
+    for (uint32_t i = 0; i < saved.size(); ++i) {
+        *_matchData->resolveTermField(i) = saved[i];
+    }
+}
+
 feature_t
 DocumentScorer::score(uint32_t docId)
 {
     return doScore(docId);
 }
 
+void
+DocumentScorer::score_hits(std::vector<Hit> &hits)
+{
+    if (_batchSize <= 1) {
+        search::queryeval::HitCollector::DocumentScorer::score_hits(hits);
+        return;
+    }
+    for (size_t begin = 0; begin < hits.size(); begin += _batchSize) {
+        size_t end = std::min(hits.size(), begin + _batchSize);
+        for (size_t i = begin; i < end; ++i) {
+            _searchItr.unpack(hits[i].first);
+            save_match_data(i - begin);
+            _rankProgram.batch_add(hits[i].first);
+        }
+        _rankProgram.batch_eval();
+        for (size_t i = begin; i < end; ++i) {
+            restore_match_data(i - begin);
+            hits[i].second = _scoreFeature.as_number(hits[i].first);
+        }
+    }
+}
+
 }
@@ -12,16 +12,38 @@ namespace proton::matching {
  * Class used to calculate the rank score for a set of documents using
  * a rank program for calculation and a search iterator for unpacking match data.
  * The calculateScore() function is always called in increasing docId order.
+ *
+ * If the rank program contains feature executors supporting batch
+ * evaluation and a batch size larger than 1 is given, hits are scored
+ * in batches. The match data unpacked for each document in a batch
+ * is saved while the batch is prepared, and restored again when the
+ * score of that document is calculated, since the search iterator
+ * can only unpack each document once.
  */
 class DocumentScorer : public search::queryeval::HitCollector::DocumentScorer
 {
 private:
+    using Hit = search::queryeval::HitCollector::Hit;
+    using TermFieldMatchData = search::fef::TermFieldMatchData;
+
+    search::fef::RankProgram &_rankProgram;
     search::queryeval::SearchIterator &_searchItr;
     search::fef::LazyValue _scoreFeature;
+    search::fef::MatchData *_matchData;
+    size_t _batchSize;
+    std::vector<std::vector<TermFieldMatchData>> _savedMatchData;
+
+    void save_match_data(size_t batchIdx);
+    void restore_match_data(size_t batchIdx);
 
 public:
     DocumentScorer(search::fef::RankProgram &rankProgram,
                    search::queryeval::SearchIterator &searchItr);
+    DocumentScorer(search::fef::RankProgram &rankProgram,
+                   search::queryeval::SearchIterator &searchItr,
+                   search::fef::MatchData &matchData,
+                   size_t batchSize);
+    ~DocumentScorer() override;
 
     search::feature_t doScore(uint32_t docId) {
         _searchItr.unpack(docId);
@@ -29,6 +51,7 @@ public:
     }
 
     virtual search::feature_t score(uint32_t docId) override;
+    void score_hits(std::vector<Hit> &hits) override;
 };
 
 }
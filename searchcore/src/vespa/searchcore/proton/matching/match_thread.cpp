@@ -305,7 +305,8 @@ MatchThread::findMatches(MatchTools &tools)
             WaitTimer select_best_timer(wait_time_s);
             auto kept_hits = communicator.selectBest(sorted_hit_seq);
             select_best_timer.done();
-            DocumentScorer scorer(tools.rank_program(), tools.search());
+            DocumentScorer scorer(tools.rank_program(), tools.search(),
+                                  tools.match_data(), tools.second_phase_batch_size());
             if (tools.getDoom().hard_doom()) {
                 kept_hits.clear();
             }
@@ -127,6 +127,11 @@ MatchTools::has_second_phase_rank() const {
     return !_rankSetup.getSecondPhaseRank().empty();
 }
 
+uint32_t
+MatchTools::second_phase_batch_size() const {
+    return rank::SecondPhaseBatchSize::lookup(_queryEnv.getProperties());
+}
+
 void
 MatchTools::setup_first_phase()
 {
@@ -59,7 +59,9 @@ public:
     QueryLimiter & getQueryLimiter() { return _queryLimiter; }
     MaybeMatchPhaseLimiter &match_limiter() { return _match_limiter; }
     bool has_second_phase_rank() const;
+    uint32_t second_phase_batch_size() const;
     const search::fef::MatchData &match_data() const { return *_match_data; }
+    search::fef::MatchData &match_data() { return *_match_data; }
     search::fef::RankProgram &rank_program() { return *_rank_program; }
     search::queryeval::SearchIterator &search() { return *_search; }
     search::queryeval::SearchIterator::UP borrow_search() { return std::move(_search); }
@@ -220,6 +220,10 @@ public:
         return _allowVisitCaching;
     }
 
+    bool allowPrefetch() const override {
+        return true;
+    }
+
 private:
     const Matcher                          & _matcher;
     const search::DocumentMetaData::Vector & _metaData;
@@ -215,6 +215,10 @@ public:
         return _visitor.allowVisitCaching();
     }
 
+    bool allowPrefetch() const override {
+        return _visitor.allowPrefetch();
+    }
+
 private:
     const DocumentRetriever  & _retriever;
     search::IDocumentVisitor & _visitor;
@@ -2,11 +2,14 @@
 #include <vespa/vespalib/testkit/test_kit.h>
 
 #include <vespa/searchlib/common/fileheadercontext.h>
+#include <vespa/searchlib/docstore/chunkformat.h>
 #include <vespa/searchlib/docstore/filechunk.h>
 #include <vespa/searchlib/docstore/writeablefilechunk.h>
 #include <vespa/searchlib/test/directory_handler.h>
 #include <vespa/vespalib/test/insertion_operators.h>
 #include <vespa/vespalib/util/threadstackexecutor.h>
+#include <vespa/fastos/file.h>
+#include <algorithm>
 #include <iomanip>
 #include <iostream>
 
@@ -36,6 +39,22 @@ struct SetLidObserver : public ISetLid {
     }
 };
 
+struct LidInfoObserver : public ISetLid {
+    LidInfoWithLidV lids;
+    void setLid(const vespalib::LockGuard &, uint32_t lid, const LidInfo &lidInfo) override {
+        lids.emplace_back(lidInfo, lid);
+    }
+};
+
+struct BufferVisitorObserver : public IBufferVisitor {
+    std::vector<uint32_t> lids;
+    std::vector<vespalib::string> data;
+    void visit(uint32_t lid, vespalib::ConstBufferRef buffer) override {
+        lids.push_back(lid);
+        data.emplace_back(buffer.c_str(), buffer.size());
+    }
+};
+
 struct BucketizerObserver : public IBucketizer {
     mutable std::vector<uint32_t> lids;
     virtual document::BucketId getBucketOf(const vespalib::GenerationHandler::Guard &guard, uint32_t lid) const override {
@@ -237,6 +256,126 @@ TEST("require that entries with lid >= docIdLimit are skipped in updateLidMap()"
     }
 }
 
+namespace {
+
+constexpr uint32_t NUM_CHUNKS = 20;
+constexpr uint32_t LIDS_PER_CHUNK = 3;
+// An empty chunk is flushed after this many chunks with lids
+constexpr uint32_t EMPTY_CHUNK_ID = 10;
+
+/*
+ * Writes NUM_CHUNKS chunks with LIDS_PER_CHUNK lids each, and an empty
+ * chunk in the middle.
+ */
+void
+writeChunksWithEmptyChunkInMiddle(const vespalib::string &baseName)
+{
+    WriteFixture f(baseName, 1000, false);
+    f.updateLidMap(1000);
+    for (uint32_t chunkId = 0; chunkId < NUM_CHUNKS; ++chunkId) {
+        if (chunkId == EMPTY_CHUNK_ID) {
+            f.nextSerialNum();
+            f.flush();
+        }
+        for (uint32_t i = 0; i < LIDS_PER_CHUNK; ++i) {
+            f.append(1 + chunkId * LIDS_PER_CHUNK + i);
+        }
+        f.flush();
+    }
+}
+
+void
+corruptData(const vespalib::string &baseName, uint32_t lid)
+{
+    vespalib::string fileName = FileChunk::NameId(1234).createName(baseName) + ".dat";
+    vespalib::string data = getData(lid);
+    FastOS_File file(fileName.c_str());
+    ASSERT_TRUE(file.OpenReadWrite());
+    std::vector<char> buf(file.GetSize());
+    ASSERT_TRUE(file.Read(&buf[0], buf.size()) == ssize_t(buf.size()));
+    auto pos = std::search(buf.begin(), buf.end(), data.begin(), data.end());
+    ASSERT_TRUE(pos != buf.end());
+    *pos = 'X';
+    file.SetPosition(0);
+    file.WriteBuf(&buf[0], buf.size());
+    ASSERT_TRUE(file.Close());
+}
+
+struct PrefetchFixture : public ReadFixture {
+    LidInfoObserver lidInfos;
+    BufferVisitorObserver visitor;
+    ThreadStackExecutor prefetchExecutor;
+
+    PrefetchFixture(const vespalib::string &baseName)
+        : ReadFixture(baseName, false),
+          lidInfos(),
+          visitor(),
+          prefetchExecutor(4, 0x10000)
+    {
+        chunk.enableRead();
+        vespalib::LockGuard guard(updateLock);
+        chunk.updateLidMap(guard, lidInfos, serialNum, 1000);
+        sortLidInfos();
+    }
+    void sortLidInfos() {
+        std::sort(lidInfos.lids.begin(), lidInfos.lids.end(),
+                  [](const LidInfoWithLid &a, const LidInfoWithLid &b) {
+                      return (a.getChunkId() == b.getChunkId())
+                             ? (a.getLid() < b.getLid())
+                             : (a.getChunkId() < b.getChunkId());
+                  });
+    }
+    void readWithPrefetch() {
+        chunk.readWithPrefetch(lidInfos.lids.begin(), lidInfos.lids.size(), visitor, prefetchExecutor);
+    }
+};
+
+std::vector<uint32_t>
+getLids(uint32_t firstChunk, uint32_t endChunk)
+{
+    std::vector<uint32_t> lids;
+    for (uint32_t lid = 1 + firstChunk * LIDS_PER_CHUNK; lid < 1 + endChunk * LIDS_PER_CHUNK; ++lid) {
+        lids.push_back(lid);
+    }
+    return lids;
+}
+
+}
+
+TEST("require that readWithPrefetch visits lids in order across many chunks and skips empty chunk")
+{
+    writeChunksWithEmptyChunkInMiddle("tmp");
+    {
+        PrefetchFixture f("tmp");
+        EXPECT_EQUAL(NUM_CHUNKS + 1, f.chunk.getNumChunks());
+        EXPECT_EQUAL(NUM_CHUNKS * LIDS_PER_CHUNK, f.lidInfos.lids.size());
+        // A lid in the empty chunk is not found, and is not visited
+        f.lidInfos.lids.emplace_back(LidInfo(0, EMPTY_CHUNK_ID, 10), 1000);
+        f.sortLidInfos();
+        f.readWithPrefetch();
+        auto expLids = getLids(0, NUM_CHUNKS);
+        EXPECT_EQUAL(expLids, f.visitor.lids);
+        for (size_t i = 0; i < f.visitor.lids.size(); ++i) {
+            EXPECT_EQUAL(getData(f.visitor.lids[i]), f.visitor.data[i]);
+        }
+    }
+    test::DirectoryHandler cleanup("tmp");
+}
+
+TEST("require that readWithPrefetch propagates exception from failed chunk read")
+{
+    writeChunksWithEmptyChunkInMiddle("tmp");
+    // Corrupt the chunk with the lids of the 15th written chunk
+    corruptData("tmp", 1 + 14 * LIDS_PER_CHUNK);
+    {
+        PrefetchFixture f("tmp");
+        EXPECT_EXCEPTION(f.readWithPrefetch(), ChunkException, "Crc32 mismatch");
+        // All chunks ahead of the failed one were visited, in order
+        EXPECT_EQUAL(getLids(0, 14), f.visitor.lids);
+    }
+    test::DirectoryHandler cleanup("tmp");
+}
+
 using vespalib::compression::CompressionConfig;
 
 TEST("require that operator == detects inequality") {
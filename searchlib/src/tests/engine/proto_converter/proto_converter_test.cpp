@@ -176,12 +176,32 @@ TEST_F(SearchRequestTest, require_that_query_tree_blob_is_converted) {
     EXPECT_EQ(std::string(&request.stackDump[0], request.stackDump.size()), "query-tree-blob");
 }
 
+TEST_F(SearchRequestTest, require_that_blobs_are_taken_over_from_consumed_proto) {
+    proto.set_offset(123);
+    proto.set_grouping_blob("grouping-blob");
+    proto.set_query_tree_blob("query-tree-blob");
+    Converter::search_request_from_proto(std::move(proto), request);
+    EXPECT_EQ(request.offset, 123);
+    EXPECT_EQ(request.groupSpec, "grouping-blob");
+    EXPECT_EQ(request.stackDump, "query-tree-blob");
+}
+
 //-----------------------------------------------------------------------------
 
 struct SearchReplyTest : ::testing::Test {
     SearchReply reply;
     Converter::ProtoSearchReply proto;
     void convert() { Converter::search_reply_to_proto(reply, proto); }
+    std::string encode_direct() {
+        size_t size = Converter::search_reply_wire_size(reply);
+        std::string wire(size, '\0');
+        Converter::search_reply_to_wire(reply, &wire[0], size);
+        return wire;
+    }
+    void verify_direct_encoding() {
+        convert();
+        EXPECT_EQ(encode_direct(), proto.SerializeAsString());
+    }
 };
 
 TEST_F(SearchReplyTest, require_that_total_hit_count_is_converted) {
@@ -301,6 +321,48 @@ TEST_F(SearchReplyTest, require_that_slime_trace_is_converted) {
     EXPECT_EQ(proto.slime_trace(), "slime-trace");
 }
 
+TEST_F(SearchReplyTest, require_that_empty_reply_is_encoded_directly) {
+    verify_direct_encoding();
+}
+
+TEST_F(SearchReplyTest, require_that_full_reply_is_encoded_directly) {
+    constexpr size_t len = document::GlobalId::LENGTH;
+    char id0[len] = { 1, 2, 3, 4, 5, 6, 7, 8, 9,10,11,12};
+    char id1[len] = {11,12,13,14,15,16,17,18,19,20,21,22};
+    reply.totalHitCount = 9001;
+    reply.coverage.setCovered(150000);
+    reply.coverage.setActive(200000);
+    reply.coverage.setSoonActive(250000);
+    reply.coverage.degradeTimeout();
+    reply.hits.resize(3);
+    reply.hits[0].gid = document::GlobalId(id0);
+    reply.hits[0].metric = 100.0;
+    reply.hits[1].gid = document::GlobalId(id1);
+    reply.hits[1].metric = 0.0;
+    reply.hits[2].metric = -1.5;
+    vespalib::string sort_data("foobar");
+    reply.sortData.assign(sort_data.begin(), sort_data.end());
+    reply.sortIndex.push_back(0);
+    reply.sortIndex.push_back(3); // hit1: 'foo'
+    reply.sortIndex.push_back(3); // hit2: ''
+    reply.sortIndex.push_back(6); // hit3: 'bar'
+    vespalib::string grouping(300, 'g');
+    reply.groupResult.assign(grouping.begin(), grouping.end());
+    reply.propertiesMap.lookupCreate("trace").add("slime", "slime-trace");
+    verify_direct_encoding();
+}
+
+TEST_F(SearchReplyTest, require_that_directly_encoded_reply_can_be_parsed) {
+    reply.totalHitCount = 5;
+    reply.hits.resize(1);
+    reply.hits[0].metric = 42.0;
+    Converter::ProtoSearchReply parsed;
+    ASSERT_TRUE(parsed.ParseFromString(encode_direct()));
+    EXPECT_EQ(parsed.total_hit_count(), 5);
+    ASSERT_EQ(parsed.hits_size(), 1);
+    EXPECT_EQ(parsed.hits(0).relevance(), 42.0);
+}
+
 //-----------------------------------------------------------------------------
 
 struct DocsumRequestTest : ::testing::Test {
@@ -27,6 +27,7 @@ std::string source_dir = get_source_dir();
 std::string vespa_dir = source_dir + "/" + "../../../../..";
 std::string simple_model = vespa_dir + "/" + "eval/src/tests/tensor/onnx_wrapper/simple.onnx";
 std::string dynamic_model = vespa_dir + "/" + "eval/src/tests/tensor/onnx_wrapper/dynamic.onnx";
+std::string guess_batch_model = vespa_dir + "/" + "eval/src/tests/tensor/onnx_wrapper/guess_batch.onnx";
 std::string strange_names_model = source_dir + "/" + "strange_names.onnx";
 
 uint32_t default_docid = 1;
@@ -44,10 +45,11 @@ struct OnnxFeatureTest : ::testing::Test {
     IndexEnvironment indexEnv;
     BlueprintResolver::SP resolver;
     Properties overrides;
+    Properties query_props;
     MatchData::UP match_data;
     RankProgram program;
     OnnxFeatureTest() : factory(), indexEnv(), resolver(new BlueprintResolver(factory, indexEnv)),
-                        overrides(), match_data(), program(resolver)
+                        overrides(), query_props(), match_data(), program(resolver)
     {
         factory.addPrototype(std::make_shared<DocidBlueprint>());
         factory.addPrototype(std::make_shared<RankingExpressionBlueprint>());
@@ -66,6 +68,7 @@ struct OnnxFeatureTest : ::testing::Test {
         ASSERT_TRUE(resolver->compile());
         MatchDataLayout mdl;
         QueryEnvironment queryEnv(&indexEnv);
+        queryEnv.getProperties().import(query_props);
         match_data = mdl.createMatchData();
         program.setup(*match_data, queryEnv, overrides);
     }
@@ -109,6 +112,40 @@ TEST_F(OnnxFeatureTest, dynamic_onnx_model_can_be_calculated) {
     EXPECT_EQ(get(3), TensorSpec("tensor<float>(d0[1],d1[1])").add({{"d0",0},{"d1",0}}, 89.0));
 }
 
+TEST_F(OnnxFeatureTest, onnx_model_with_batch_dimension_can_be_calculated_in_batches) {
+    add_expr("in1", "tensor<float>(x[1]):[docid]");
+    add_expr("in2", "tensor<float>(x[1]):[10]");
+    add_onnx("guess_batch", guess_batch_model);
+    query_props.add(indexproperties::rank::SecondPhaseBatchSize::NAME, "3");
+    compile(onnx_feature("guess_batch"));
+    EXPECT_TRUE(program.has_batch_executors());
+    auto expect = [](double value) {
+        return TensorSpec("tensor<float>(d0[1])").add({{"d0",0}}, value);
+    };
+    program.batch_add(1);
+    program.batch_add(5);
+    program.batch_add(7);
+    program.batch_eval();
+    EXPECT_EQ(get(1), expect(11.0));
+    EXPECT_EQ(get(5), expect(15.0));
+    EXPECT_EQ(get(6), expect(16.0));
+    EXPECT_EQ(get(7), expect(17.0));
+    program.batch_add(8);
+    program.batch_eval();
+    EXPECT_EQ(get(8), expect(18.0));
+    EXPECT_EQ(get(9), expect(19.0));
+}
+
+TEST_F(OnnxFeatureTest, onnx_model_without_batch_dimension_is_not_batched) {
+    add_expr("query_tensor", "tensor<float>(a[1],b[4]):[[docid,2,3,4]]");
+    add_expr("attribute_tensor", "tensor<float>(a[4],b[1]):[[5],[6],[7],[8]]");
+    add_expr("bias_tensor", "tensor<float>(a[1],b[1]):[[9]]");
+    add_onnx("simple", simple_model);
+    query_props.add(indexproperties::rank::SecondPhaseBatchSize::NAME, "3");
+    compile(onnx_feature("simple"));
+    EXPECT_FALSE(program.has_batch_executors());
+}
+
 TEST_F(OnnxFeatureTest, strange_input_and_output_names_are_normalized) {
     add_expr("input_0", "tensor<float>(a[2]):[10,20]");
     add_expr("input_1", "tensor<float>(a[2]):[5,10]");
@@ -2,6 +2,7 @@
 #include <vespa/vespalib/testkit/test_kit.h>
 #include <vespa/vespalib/stllike/string.h>
 #include <vespa/vespalib/util/stringfmt.h>
+#include <vespa/searchlib/features/queryfeature.h>
 #include <vespa/searchlib/features/valuefeature.h>
 #include <vespa/searchlib/features/rankingexpressionfeature.h>
 #include <vespa/searchlib/fef/blueprintfactory.h>
@@ -70,16 +71,18 @@ struct Fixture {
     IndexEnvironment indexEnv;
     BlueprintResolver::SP resolver;
     Properties overrides;
+    Properties query_props;
     MatchData::UP match_data;
     RankProgram program;
     size_t track_cnt;
     Fixture() : factory(), indexEnv(), resolver(new BlueprintResolver(factory, indexEnv)),
-                overrides(), match_data(), program(resolver), track_cnt(0)
+                overrides(), query_props(), match_data(), program(resolver), track_cnt(0)
     {
         factory.addPrototype(Blueprint::SP(new BoxingBlueprint()));
         factory.addPrototype(Blueprint::SP(new DocidBlueprint()));
         factory.addPrototype(Blueprint::SP(new DoubleBlueprint()));
         factory.addPrototype(Blueprint::SP(new ImpureValueBlueprint()));
+        factory.addPrototype(Blueprint::SP(new QueryBlueprint()));
         factory.addPrototype(Blueprint::SP(new RankingExpressionBlueprint()));
         factory.addPrototype(Blueprint::SP(new SumBlueprint()));
         factory.addPrototype(Blueprint::SP(new TrackingBlueprint(track_cnt)));        
@@ -94,6 +97,15 @@ struct Fixture {
         indexEnv.getProperties().add(indexproperties::eval::UseFastForest::NAME, "true");
         return *this;
     }
+    Fixture &batch_expressions(size_t batch_size) {
+        indexEnv.getProperties().add(indexproperties::eval::BatchExpressions::NAME, "true");
+        query_props.add(indexproperties::rank::SecondPhaseBatchSize::NAME, vespalib::make_string("%zu", batch_size));
+        return *this;
+    }
+    Fixture &split_query_level_expressions() {
+        indexEnv.getProperties().add(indexproperties::eval::SplitQueryLevelExpressions::NAME, "true");
+        return *this;
+    }
     Fixture &add_expr(const vespalib::string &name, const vespalib::string &expr) {
         vespalib::string feature_name = expr_feature(name);
         vespalib::string expr_name = feature_name + ".rankingScript";
@@ -113,6 +125,7 @@ struct Fixture {
         ASSERT_TRUE(resolver->compile());
         MatchDataLayout mdl;
         QueryEnvironment queryEnv(&indexEnv);
+        queryEnv.getProperties().import(query_props);
         match_data = mdl.createMatchData();
         program.setup(*match_data, queryEnv, overrides);
         return *this;
@@ -391,4 +404,94 @@ TEST_F("require that fast-forest gbdt evaluation is pure", Fixture()) {
     EXPECT_EQUAL(f1.final_executor_name(), "search::features::FastForestExecutor");
 }
 
+TEST_F("require that ranking expressions can be evaluated in batches", Fixture()) {
+    f1.batch_expressions(3).add_expr("rank", "docid*2+if(docid<5,1,0)").compile();
+    EXPECT_EQUAL(f1.final_executor_name(), "search::features::BatchCompiledRankingExpressionExecutor");
+    EXPECT_TRUE(f1.program.has_batch_executors());
+    f1.program.batch_add(1);
+    f1.program.batch_add(5);
+    f1.program.batch_add(7);
+    f1.program.batch_eval();
+    EXPECT_EQUAL(f1.get(1), 3.0);
+    EXPECT_EQUAL(f1.get(5), 10.0);
+    EXPECT_EQUAL(f1.get(6), 12.0);
+    EXPECT_EQUAL(f1.get(7), 14.0);
+    f1.program.batch_add(2);
+    f1.program.batch_eval();
+    EXPECT_EQUAL(f1.get(2), 5.0);
+    EXPECT_EQUAL(f1.get(8), 16.0);
+}
+
+TEST_F("require that batch compiled ranking expressions work without batching", Fixture()) {
+    f1.batch_expressions(1).add_expr("rank", "docid*2+if(docid<5,1,0)").compile();
+    EXPECT_EQUAL(f1.final_executor_name(), "search::features::BatchCompiledRankingExpressionExecutor");
+    EXPECT_FALSE(f1.program.has_batch_executors());
+    EXPECT_EQUAL(f1.get(1), 3.0);
+    EXPECT_EQUAL(f1.get(6), 12.0);
+}
+
+TEST_F("require that fast-forest gbdt evaluation can be done in batches", Fixture()) {
+    f1.use_fast_forest().batch_expressions(3).add_expr("rank", "if(docid<5,1,2)+if(docid<3,10,20)").compile();
+    EXPECT_EQUAL(f1.final_executor_name(), "search::features::FastForestExecutor");
+    EXPECT_TRUE(f1.program.has_batch_executors());
+    f1.program.batch_add(1);
+    f1.program.batch_add(4);
+    f1.program.batch_add(7);
+    f1.program.batch_eval();
+    EXPECT_EQUAL(f1.get(1), 11.0);
+    EXPECT_EQUAL(f1.get(4), 21.0);
+    EXPECT_EQUAL(f1.get(7), 22.0);
+    EXPECT_EQUAL(f1.get(2), 11.0);
+}
+
+TEST_F("require that executors depending on batch executors are not evaluated in batches", Fixture()) {
+    f1.batch_expressions(3).add_expr("inner", "docid*2").add_expr("outer", "track(rankingExpression(inner))+1").compile();
+    EXPECT_TRUE(f1.program.has_batch_executors());
+    f1.program.batch_add(1);
+    f1.program.batch_add(5);
+    f1.program.batch_eval();
+    EXPECT_EQUAL(f1.track_cnt, 0u);
+    EXPECT_EQUAL(f1.get(expr_feature("outer"), 1), 3.0);
+    EXPECT_EQUAL(f1.get(expr_feature("outer"), 5), 11.0);
+    EXPECT_EQUAL(f1.track_cnt, 2u);
+}
+
+const vespalib::string query_level_expr = "reduce(tensor(x[3])(x+query(a)),sum)*box(docid)";
+
+TEST_F("require that query-level subexpressions can be split out of interpreted ranking expressions", Fixture()) {
+    f1.query_props.add("a", "2");
+    f1.split_query_level_expressions().add_expr("rank", query_level_expr).compile();
+    EXPECT_EQUAL(f1.final_executor_name(), "search::features::SplitInterpretedRankingExpressionExecutor");
+    EXPECT_EQUAL(f1.get(1), 9.0);
+    EXPECT_EQUAL(f1.get(2), 18.0);
+    EXPECT_EQUAL(f1.get(5), 45.0);
+}
+
+TEST_F("require that query-level subexpressions are not split out by default", Fixture()) {
+    f1.query_props.add("a", "2");
+    f1.add_expr("rank", query_level_expr).compile();
+    EXPECT_EQUAL(f1.final_executor_name(), "search::features::InterpretedRankingExpressionExecutor");
+    EXPECT_EQUAL(f1.get(2), 18.0);
+}
+
+TEST_F("require that query-level results can be shared by multiple rank programs", Fixture()) {
+    f1.split_query_level_expressions().add_expr("rank", query_level_expr);
+    ASSERT_TRUE(f1.resolver->compile());
+    QueryEnvironment queryEnv(&f1.indexEnv);
+    queryEnv.getProperties().add("a", "2");
+    for (const auto &spec: f1.resolver->getExecutorSpecs()) {
+        spec.blueprint->prepareSharedState(queryEnv, queryEnv.getObjectStore());
+    }
+    EXPECT_TRUE(queryEnv.getObjectStore().get("rankingExpression.queryLevel.rankingExpression(rank)") != nullptr);
+    MatchDataLayout mdl;
+    auto md = mdl.createMatchData();
+    RankProgram program1(f1.resolver);
+    RankProgram program2(f1.resolver);
+    program1.setup(*md, queryEnv, f1.overrides);
+    program2.setup(*md, queryEnv, f1.overrides);
+    EXPECT_EQUAL(program1.get_seeds().resolve(0).as_number(3), 27.0);
+    EXPECT_EQUAL(program2.get_seeds().resolve(0).as_number(4), 36.0);
+    EXPECT_EQUAL(program1.get_seeds().resolve(0).as_number(5), 45.0);
+}
+
 TEST_MAIN() { TEST_RUN_ALL(); }
@@ -251,6 +251,30 @@ TEST("Access subqueries") {
     EXPECT_EQUAL(0ULL, state.f3->getSubqueries());
 }
 
+TEST("require that copied TermFieldMatchData retains all match information") {
+    TermFieldMatchData tfmd;
+    tfmd.setFieldId(5);
+    tfmd.reset(10);
+    tfmd.appendPosition(TermFieldMatchDataPosition(0, 3, 7, 20));
+    tfmd.appendPosition(TermFieldMatchDataPosition(0, 5, 7, 20));
+    tfmd.setNumOccs(2);
+    tfmd.setFieldLength(20);
+    TermFieldMatchData copy(tfmd);
+    EXPECT_EQUAL(5u, copy.getFieldId());
+    EXPECT_EQUAL(10u, copy.getDocId());
+    ASSERT_EQUAL(2u, copy.size());
+    EXPECT_EQUAL(3u, copy.begin()[0].getPosition());
+    EXPECT_EQUAL(5u, copy.begin()[1].getPosition());
+    EXPECT_EQUAL(2u, copy.getNumOccs());
+    EXPECT_EQUAL(20u, copy.getFieldLength());
+
+    TermFieldMatchData sub;
+    sub.setSubqueries(11, 42);
+    TermFieldMatchData sub_copy(sub);
+    EXPECT_EQUAL(11u, sub_copy.getDocId());
+    EXPECT_EQUAL(42ULL, sub_copy.getSubqueries());
+}
+
 TEST("require that TermFieldMatchData can be tagged as needed or not") {
     TermFieldMatchData tfmd;
     tfmd.setFieldId(123);
@@ -37,6 +37,20 @@ struct PredefinedScorer : public HitCollector::DocumentScorer
     }
 };
 
+struct BatchScorer : public HitCollector::DocumentScorer
+{
+    std::vector<uint32_t> _scored;
+    feature_t score(uint32_t) override {
+        abort();
+    }
+    void score_hits(std::vector<HitCollector::Hit> &hits) override {
+        for (auto &hit : hits) {
+            _scored.push_back(hit.first);
+            hit.second = hit.first + 300;
+        }
+    }
+};
+
 std::vector<HitCollector::Hit> extract(SortedHitSequence seq) {
     std::vector<HitCollector::Hit> ret;
     while (seq.valid()) {
@@ -236,6 +250,16 @@ TEST_F("testReRank - partial", AscendingScoreFixture)
     TEST_DO(checkResult(*rs, f.expBv.get()));
 }
 
+TEST_F("require that all hits are handed to the scorer in doc id order when re-ranking", DescendingScoreFixture)
+{
+    f.addHits();
+    BatchScorer scorer;
+    EXPECT_EQUAL(5u, f.hc.reRank(scorer, extract(f.hc.getSortedHitSequence(5))));
+    EXPECT_TRUE(std::vector<uint32_t>({0, 1, 2, 3, 4}) == scorer._scored);
+    EXPECT_EQUAL(300.0, f.hc.getRanges().second.low);
+    EXPECT_EQUAL(304.0, f.hc.getRanges().second.high);
+}
+
 TEST_F("require that hits for 2nd phase candidates can be retrieved", DescendingScoreFixture)
 {
     f.addHits();
@@ -8,6 +8,7 @@ LOG_SETUP("dense_tensor_store_test");
 #include <vespa/eval/tensor/default_tensor_engine.h>
 #include <vespa/eval/tensor/tensor.h>
 #include <vespa/eval/tensor/dense/mutable_dense_tensor_view.h>
+#include <vespa/vespalib/util/mmap_file_allocator.h>
 
 using search::tensor::DenseTensorStore;
 using vespalib::eval::TensorSpec;
@@ -15,6 +16,8 @@ using vespalib::eval::ValueType;
 using vespalib::tensor::MutableDenseTensorView;
 using vespalib::tensor::Tensor;
 using vespalib::tensor::DefaultTensorEngine;
+using vespalib::alloc::MemoryAllocator;
+using vespalib::alloc::MmapFileAllocator;
 
 using EntryRef = DenseTensorStore::EntryRef;
 
@@ -28,8 +31,8 @@ makeTensor(const TensorSpec &spec)
 struct Fixture
 {
     DenseTensorStore store;
-    Fixture(const vespalib::string &tensorType)
-        : store(ValueType::from_spec(tensorType))
+    Fixture(const vespalib::string &tensorType, std::unique_ptr<MemoryAllocator> allocator = {})
+        : store(ValueType::from_spec(tensorType), std::move(allocator))
     {}
     void assertSetAndGetTensor(const TensorSpec &tensorSpec) {
         Tensor::UP expTensor = makeTensor(tensorSpec);
@@ -68,6 +71,21 @@ TEST_F("require that correct empty tensor is returned for 1d bound tensor", Fixt
                                    add({{"x", 2}}, 0));
 }
 
+TEST_F("require that we can store tensors in memory mapped file",
+       Fixture("tensor(x[3])", std::make_unique<MmapFileAllocator>("mmap_file_allocator_dir", MmapFileAllocator::Advice::RANDOM)))
+{
+    auto &allocator = dynamic_cast<const MmapFileAllocator &>(*f.store.get_allocator());
+    EXPECT_EQUAL(1u, allocator.get_num_allocations());
+    f.assertSetAndGetTensor(TensorSpec("tensor(x[3])").
+                                       add({{"x", 0}}, 2).
+                                       add({{"x", 1}}, 3).
+                                       add({{"x", 2}}, 5));
+    auto mapped = allocator.get_mapped_memory();
+    EXPECT_LESS(0u, mapped.mapped);
+    EXPECT_LESS(0u, mapped.resident);
+    EXPECT_GREATER_EQUAL(mapped.mapped, mapped.resident);
+}
+
 void
 assertArraySize(const vespalib::string &tensorType, uint32_t expArraySize) {
     Fixture f(tensorType);
@@ -182,6 +182,27 @@ TEST(DistanceFunctionsTest, hamming_gives_expected_score)
     EXPECT_DOUBLE_EQ(hamming->to_rawscore(d25), 1.0/(1.0 + 1.0));
 }
 
+TEST(DistanceFunctionsTest, int8_and_bfloat16_cells_give_same_distance_as_double_cells)
+{
+    using CellType = vespalib::eval::ValueType::CellType;
+    std::vector<double> d1{1.0, -2.0, 3.0, 4.0};
+    std::vector<double> d2{-5.0, 6.0, 7.0, 0.0};
+    std::vector<int8_t> i1(d1.begin(), d1.end());
+    std::vector<int8_t> i2(d2.begin(), d2.end());
+    std::vector<vespalib::BFloat16> b1(d1.begin(), d1.end());
+    std::vector<vespalib::BFloat16> b2(d2.begin(), d2.end());
+    for (auto metric: {DistanceMetric::Euclidean, DistanceMetric::Angular,
+                       DistanceMetric::InnerProduct, DistanceMetric::Hamming})
+    {
+        auto expect = make_distance_function(metric, CellType::DOUBLE)->calc(t(d1), t(d2));
+        auto int8_dist = make_distance_function(metric, CellType::INT8);
+        auto bf16_dist = make_distance_function(metric, CellType::BFLOAT16);
+        EXPECT_DOUBLE_EQ(int8_dist->calc(TypedCells(i1), TypedCells(i2)), expect);
+        EXPECT_DOUBLE_EQ(bf16_dist->calc(TypedCells(b1), TypedCells(b2)), expect);
+        EXPECT_DOUBLE_EQ(int8_dist->calc_with_limit(TypedCells(i1), TypedCells(i2), 1000.0), expect);
+    }
+}
+
 TEST(GeoDegreesTest, gives_expected_score)
 {
     auto ct = vespalib::eval::ValueType::CellType::DOUBLE;
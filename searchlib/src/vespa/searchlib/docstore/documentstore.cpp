@@ -29,6 +29,7 @@ public:
         _visitor(visitor)
     { }
     void visit(uint32_t lid, vespalib::ConstBufferRef buf) override;
+    bool allowPrefetch() const override { return _visitor.allowPrefetch(); }
 private:
     const DocumentTypeRepo & _repo;
     IDocumentVisitor & _visitor;
@@ -14,6 +14,7 @@
 #include <vespa/vespalib/util/array.hpp>
 #include <vespa/vespalib/stllike/hash_map.hpp>
 #include <vespa/fastos/file.h>
+#include <deque>
 #include <future>
 
 #include <vespa/log/log.h>
@@ -313,6 +314,20 @@ struct FixedParams {
     IFileChunkVisitorProgress *visitorProgress;
 };
 
+/**
+ * Chunks being read ahead by executor tasks. The tasks refer to the
+ * file chunk, so they must all be done before it can be left, also when
+ * the visitor throws.
+ */
+class InFlightChunks : public std::deque<FutureChunk> {
+public:
+    ~InFlightChunks() {
+        for (FutureChunk & chunk : *this) {
+            chunk.wait();
+        }
+    }
+};
+
 void
 appendChunks(FixedParams * args, Chunk::UP chunk)
 {
@@ -396,6 +411,58 @@ FileChunk::read(LidInfoWithLidV::const_iterator begin, size_t count, ChunkInfo c
     }
 }
 
+void
+FileChunk::readWithPrefetch(LidInfoWithLidV::const_iterator begin, size_t count, IBufferVisitor & visitor,
+                            vespalib::ThreadExecutor & executor) const
+{
+    assert(frozen());
+    if (count == 0) { return; }
+    std::vector<std::pair<size_t, size_t>> ranges;
+    for (size_t start(0), i(1); i <= count; i++) {
+        if ((i == count) || ((begin + i)->getChunkId() != (begin + start)->getChunkId())) {
+            ranges.emplace_back(start, i);
+            start = i;
+        }
+    }
+    if (ranges.size() == 1) {
+        return read(begin, count, _chunkInfo[begin->getChunkId()], visitor);
+    }
+    const size_t maxInFlight = std::max(2ul, executor.getNumThreads() * 2);
+    InFlightChunks inFlight;
+    size_t next(0);
+    for (const auto & range : ranges) {
+        for (; (next < ranges.size()) && (inFlight.size() < maxInFlight); next++) {
+            std::promise<Chunk::UP> promisedChunk;
+            inFlight.push_back(promisedChunk.get_future());
+            uint32_t chunkId = (begin + ranges[next].first)->getChunkId();
+            auto task = vespalib::makeLambdaTask([promise = std::move(promisedChunk), chunkId, this]() mutable {
+                try {
+                    const ChunkInfo & cInfo(_chunkInfo[chunkId]);
+                    vespalib::DataBuffer whole(0ul, ALIGNMENT);
+                    FileRandRead::FSP keepAlive(_file->read(cInfo.getOffset(), whole, cInfo.getSize()));
+                    promise.set_value(std::make_unique<Chunk>(chunkId, whole.getData(), whole.getDataLen(), _skipCrcOnRead));
+                } catch (...) {
+                    promise.set_exception(std::current_exception());
+                }
+            });
+            vespalib::Executor::Task::UP rejected = executor.execute(std::move(task));
+            if (rejected) {
+                rejected->run();
+            }
+        }
+        FutureChunk futureChunk = std::move(inFlight.front());
+        inFlight.pop_front();
+        Chunk::UP chunk = futureChunk.get();
+        for (size_t i(range.first); i < range.second; i++) {
+            const LidInfoWithLid & li = *(begin + i);
+            vespalib::ConstBufferRef buf = chunk->getLid(li.getLid());
+            if (buf.size() != 0) {
+                visitor.visit(li.getLid(), buf);
+            }
+        }
+    }
+}
+
 ssize_t
 FileChunk::read(uint32_t lid, SubChunkId chunkId,
                 vespalib::DataBuffer & buffer) const
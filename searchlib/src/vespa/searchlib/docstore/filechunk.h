@@ -113,6 +113,16 @@ public:
     virtual size_t updateLidMap(const LockGuard &guard, ISetLid &lidMap, uint64_t serialNum, uint32_t docIdLimit);
     virtual ssize_t read(uint32_t lid, SubChunkId chunk, vespalib::DataBuffer & buffer) const;
     virtual void read(LidInfoWithLidV::const_iterator begin, size_t count, IBufferVisitor & visitor) const;
+    /**
+     * Same as read above, but the chunks are read and decompressed ahead of the visitor
+     * by tasks on the given executor. At most 2 chunks per executor thread are in flight.
+     * Tasks rejected by the executor are run in the calling thread.
+     * The lids are visited in the same order, in the calling thread. If reading a chunk
+     * fails, the exception is rethrown when the visitor gets to that chunk.
+     * Only to be used on frozen file chunks.
+     */
+    void readWithPrefetch(LidInfoWithLidV::const_iterator begin, size_t count, IBufferVisitor & visitor,
+                          vespalib::ThreadExecutor & executor) const;
     void remove(uint32_t lid, uint32_t size);
     virtual size_t getDiskFootprint() const { return _diskFootprint; }
     virtual size_t getMemoryFootprint() const;
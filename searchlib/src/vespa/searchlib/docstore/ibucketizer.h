@@ -21,6 +21,8 @@ class IBufferVisitor {
 public:
     virtual ~IBufferVisitor() { }
     virtual void visit(uint32_t lid, vespalib::ConstBufferRef buffer) = 0;
+    // Bulk visitors may let the store read ahead of the visitor, using more threads.
+    virtual bool allowPrefetch() const { return false; }
 };
 
 }
@@ -50,6 +50,7 @@ public:
     virtual ~IDocumentVisitor() { }
     virtual void visit(uint32_t lid, DocumentUP doc) = 0;
     virtual bool allowVisitCaching() const = 0;
+    virtual bool allowPrefetch() const { return false; }
 private:
 };
 
@@ -19,6 +19,9 @@ namespace search {
 namespace {
     constexpr size_t DEFAULT_MAX_FILESIZE = 1000000000ul;
     constexpr uint32_t DEFAULT_MAX_LIDS_PER_FILE = 32 * 1024 * 1024;
+    // Prefetch tasks beyond the limit are rejected and read by the visiting thread itself.
+    constexpr uint32_t PREFETCH_THREADS = 2;
+    constexpr uint32_t PREFETCH_TASK_LIMIT = 2 * PREFETCH_THREADS;
 }
 
 using vespalib::LockGuard;
@@ -74,6 +77,7 @@ LogDataStore::LogDataStore(vespalib::ThreadExecutor &executor, const vespalib::s
       _prevActive(FileId::active()),
       _readOnly(readOnly),
       _executor(executor),
+      _prefetchExecutor(PREFETCH_THREADS, 128 * 1024, PREFETCH_TASK_LIMIT),
       _initFlushSyncToken(0),
       _tlSyncer(tlSyncer),
       _bucketizer(std::move(bucketizer)),
@@ -148,14 +152,23 @@ LogDataStore::read(const LidVector & lids, IBufferVisitor & visitor) const
     for (size_t curr(1); curr < orderedLids.size(); curr++) {
         const LidInfoWithLid & li = orderedLids[curr];
         if (prevFile != li.getFileId()) {
-            const FileChunk & fc(*_fileChunks[prevFile]);
-            fc.read(orderedLids.begin() + start, curr - start, visitor);
+            readFromFile(*_fileChunks[prevFile], orderedLids.begin() + start, curr - start, visitor);
             start = curr;
             prevFile = li.getFileId();
         }
     }
-    const FileChunk & fc(*_fileChunks[prevFile]);
-    fc.read(orderedLids.begin() + start, orderedLids.size() - start, visitor);
+    readFromFile(*_fileChunks[prevFile], orderedLids.begin() + start, orderedLids.size() - start, visitor);
+}
+
+void
+LogDataStore::readFromFile(const FileChunk & fc, LidInfoWithLidV::const_iterator begin, size_t count,
+                           IBufferVisitor & visitor) const
+{
+    if (fc.frozen() && visitor.allowPrefetch()) {
+        fc.readWithPrefetch(begin, count, visitor, _prefetchExecutor);
+    } else {
+        fc.read(begin, count, visitor);
+    }
 }
 
 ssize_t
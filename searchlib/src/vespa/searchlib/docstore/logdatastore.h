@@ -10,7 +10,7 @@
 #include <vespa/searchlib/common/tunefileinfo.h>
 #include <vespa/searchlib/transactionlog/syncproxy.h>
 #include <vespa/vespalib/util/rcuvector.h>
-#include <vespa/vespalib/util/threadexecutor.h>
+#include <vespa/vespalib/util/threadstackexecutor.h>
 
 #include <set>
 
@@ -189,6 +189,8 @@ private:
 
     void compactWorst(double bloatLimit, double spreadLimit, bool prioritizeDiskBloat);
     void compactFile(FileId chunkId);
+    void readFromFile(const FileChunk & fc, LidInfoWithLidV::const_iterator begin, size_t count,
+                      IBufferVisitor & visitor) const;
 
     typedef vespalib::RcuVector<uint64_t> LidInfoVector;
     typedef std::vector<FileChunk::UP> FileChunkVector;
@@ -285,6 +287,9 @@ private:
     vespalib::Lock                           _updateLock;
     bool                                     _readOnly;
     vespalib::ThreadExecutor                &_executor;
+    // Reads chunks ahead of visitors allowing it. Kept apart from _executor,
+    // which writes and compacts files.
+    mutable vespalib::ThreadStackExecutor    _prefetchExecutor;
     SerialNum                                _initFlushSyncToken;
     transactionlog::SyncProxy               &_tlSyncer;
     IBucketizer::SP                          _bucketizer;
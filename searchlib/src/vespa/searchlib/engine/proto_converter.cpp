@@ -5,11 +5,17 @@
 #include <vespa/vespalib/data/slime/slime.h>
 #include <vespa/vespalib/data/slime/binary_format.h>
 #include <vespa/vespalib/data/smart_buffer.h>
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/wire_format_lite.h>
+#include <cstring>
 
 namespace search::engine {
 
 namespace {
 
+using google::protobuf::internal::WireFormatLite;
+using google::protobuf::io::CodedOutputStream;
+
 template <typename T>
 vespalib::string make_sort_spec(const T &sorting) {
     vespalib::string spec;
@@ -43,13 +49,73 @@ void add_multi_props(fef::Properties &dst, const T &src) {
     }
 }
 
+// Sizes and writers for the protobuf wire format, used to encode
+// search replies without an intermediate message. Like the generated
+// serializer, fields holding default values are left out. All field
+// numbers are below 16, so each tag is a single byte.
+
+size_t int64_field_size(uint64_t value) {
+    return (value != 0) ? (1 + CodedOutputStream::VarintSize64(value)) : 0;
 }
 
-//-----------------------------------------------------------------------------
+size_t bool_field_size(bool value) {
+    return value ? 2 : 0;
+}
 
-void
-ProtoConverter::search_request_from_proto(const ProtoSearchRequest &proto, SearchRequest &request)
-{
+bool is_default(double value) {
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return (bits == 0);
+}
+
+size_t double_field_size(double value) {
+    return is_default(value) ? 0 : 9;
+}
+
+size_t message_field_size(size_t size) {
+    return 1 + CodedOutputStream::VarintSize32(size) + size;
+}
+
+size_t bytes_field_size(size_t size) {
+    return (size != 0) ? message_field_size(size) : 0;
+}
+
+uint8_t *write_int64_field(int field, uint64_t value, uint8_t *pos) {
+    return (value != 0) ? WireFormatLite::WriteInt64ToArray(field, value, pos) : pos;
+}
+
+uint8_t *write_bool_field(int field, bool value, uint8_t *pos) {
+    return value ? WireFormatLite::WriteBoolToArray(field, value, pos) : pos;
+}
+
+uint8_t *write_double_field(int field, double value, uint8_t *pos) {
+    return is_default(value) ? pos : WireFormatLite::WriteDoubleToArray(field, value, pos);
+}
+
+uint8_t *write_bytes_field(int field, const void *data, size_t size, uint8_t *pos) {
+    if (size == 0) {
+        return pos;
+    }
+    pos = WireFormatLite::WriteTagToArray(field, WireFormatLite::WIRETYPE_LENGTH_DELIMITED, pos);
+    pos = CodedOutputStream::WriteVarint32ToArray(size, pos);
+    return CodedOutputStream::WriteRawToArray(data, size, pos);
+}
+
+vespalib::stringref slime_trace(const SearchReply &reply) {
+    return reply.propertiesMap.trace().lookup("slime").get();
+}
+
+size_t hit_size(const SearchReply &reply, size_t i) {
+    size_t size = bytes_field_size(document::GlobalId::LENGTH);
+    size += double_field_size(reply.hits[i].metric);
+    if (reply.sortIndex.size() > 0) {
+        size += bytes_field_size(reply.sortIndex[i + 1] - reply.sortIndex[i]);
+    }
+    return size;
+}
+
+// everything except the query tree and grouping blobs
+void convert_search_request(const ProtoConverter::ProtoSearchRequest &proto, SearchRequest &request) {
     request.offset = proto.offset();
     request.maxhits = proto.hits();
     request.setTimeout(1ms * proto.timeout());
@@ -74,11 +140,29 @@ ProtoConverter::search_request_from_proto(const ProtoSearchRequest &proto, Searc
         add_multi_props(rank_props, proto.rank_properties());
         add_single_props(rank_props, proto.tensor_rank_properties());
     }
-    request.groupSpec.assign(proto.grouping_blob().begin(), proto.grouping_blob().end());
     request.location = proto.geo_location();
+}
+
+}
+
+//-----------------------------------------------------------------------------
+
+void
+ProtoConverter::search_request_from_proto(const ProtoSearchRequest &proto, SearchRequest &request)
+{
+    convert_search_request(proto, request);
+    request.groupSpec.assign(proto.grouping_blob().begin(), proto.grouping_blob().end());
     request.stackDump.assign(proto.query_tree_blob().begin(), proto.query_tree_blob().end());
 }
 
+void
+ProtoConverter::search_request_from_proto(ProtoSearchRequest &&proto, SearchRequest &request)
+{
+    convert_search_request(proto, request);
+    request.groupSpec = std::move(*proto.mutable_grouping_blob());
+    request.stackDump = std::move(*proto.mutable_query_tree_blob());
+}
+
 void
 ProtoConverter::search_reply_to_proto(const SearchReply &reply, ProtoSearchReply &proto)
 {
@@ -106,6 +190,55 @@ ProtoConverter::search_reply_to_proto(const SearchReply &reply, ProtoSearchReply
     proto.set_slime_trace(slime_trace.get().data(), slime_trace.get().size());
 }
 
+size_t
+ProtoConverter::search_reply_wire_size(const SearchReply &reply)
+{
+    size_t size = 0;
+    size += int64_field_size(reply.totalHitCount);
+    size += int64_field_size(reply.coverage.getCovered());
+    size += int64_field_size(reply.coverage.getActive());
+    size += int64_field_size(reply.coverage.getSoonActive());
+    size += bool_field_size(reply.coverage.wasDegradedByMatchPhase());
+    size += bool_field_size(reply.coverage.wasDegradedByTimeout());
+    for (size_t i = 0; i < reply.hits.size(); ++i) {
+        size += message_field_size(hit_size(reply, i));
+    }
+    size += bytes_field_size(reply.groupResult.size());
+    size += bytes_field_size(slime_trace(reply).size());
+    return size;
+}
+
+void
+ProtoConverter::search_reply_to_wire(const SearchReply &reply, char *dst, size_t size)
+{
+    bool has_sort_data = (reply.sortIndex.size() > 0);
+    assert(!has_sort_data || (reply.sortIndex.size() == (reply.hits.size() + 1)));
+    uint8_t *pos = reinterpret_cast<uint8_t *>(dst);
+    pos = write_int64_field(1, reply.totalHitCount, pos);
+    pos = write_int64_field(2, reply.coverage.getCovered(), pos);
+    pos = write_int64_field(3, reply.coverage.getActive(), pos);
+    pos = write_int64_field(4, reply.coverage.getSoonActive(), pos);
+    pos = write_bool_field(5, reply.coverage.wasDegradedByMatchPhase(), pos);
+    pos = write_bool_field(6, reply.coverage.wasDegradedByTimeout(), pos);
+    for (size_t i = 0; i < reply.hits.size(); ++i) {
+        pos = WireFormatLite::WriteTagToArray(7, WireFormatLite::WIRETYPE_LENGTH_DELIMITED, pos);
+        pos = CodedOutputStream::WriteVarint32ToArray(hit_size(reply, i), pos);
+        pos = write_bytes_field(1, reply.hits[i].gid.get(), document::GlobalId::LENGTH, pos);
+        pos = write_double_field(2, reply.hits[i].metric, pos);
+        if (has_sort_data) {
+            size_t sort_data_offset = reply.sortIndex[i];
+            size_t sort_data_size = (reply.sortIndex[i + 1] - reply.sortIndex[i]);
+            assert((sort_data_offset + sort_data_size) <= reply.sortData.size());
+            pos = write_bytes_field(3, &reply.sortData[sort_data_offset], sort_data_size, pos);
+        }
+    }
+    pos = write_bytes_field(8, reply.groupResult.begin(), reply.groupResult.size(), pos);
+    vespalib::stringref trace = slime_trace(reply);
+    pos = write_bytes_field(9, trace.data(), trace.size(), pos);
+    assert(pos == reinterpret_cast<uint8_t *>(dst + size));
+    (void) size;
+}
+
 //-----------------------------------------------------------------------------
 
 void
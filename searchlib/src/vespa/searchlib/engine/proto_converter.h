@@ -23,8 +23,16 @@ struct ProtoConverter {
     using ProtoMonitorReply = ::searchlib::searchprotocol::protobuf::MonitorReply;
 
     static void search_request_from_proto(const ProtoSearchRequest &proto, SearchRequest &request);
+    // takes over the query tree and grouping blobs instead of copying them
+    static void search_request_from_proto(ProtoSearchRequest &&proto, SearchRequest &request);
     static void search_reply_to_proto(const SearchReply &reply, ProtoSearchReply &proto);
 
+    // encode a search reply directly into the wire format of
+    // ProtoSearchReply, without building an intermediate message;
+    // the bytes are the same as the serialized search_reply_to_proto
+    static size_t search_reply_wire_size(const SearchReply &reply);
+    static void search_reply_to_wire(const SearchReply &reply, char *dst, size_t size);
+
     static void docsum_request_from_proto(const ProtoDocsumRequest &proto, DocsumRequest &request);
     static void docsum_reply_to_proto(const DocsumReply &reply, ProtoDocsumReply &proto);
 
@@ -48,16 +48,19 @@ void encode_message(const MSG &src, FRT_Values &dst) {
     dst.AddData(compressed.getData(), compressed.getDataLen());
 }
 
-void encode_search_reply(const ProtoSearchReply &src, FRT_Values &dst) {
+void encode_search_reply(const SearchReply &src, FRT_Values &dst) {
     using vespalib::compression::compress;
-    auto output = src.SerializeAsString();
-    if (src.grouping_blob().empty()) {
+    size_t size = ProtoConverter::search_reply_wire_size(src);
+    if (src.groupResult.empty()) {
         dst.AddInt8(CompressionConfig::Type::NONE);
-        dst.AddInt32(output.size());
-        dst.AddData(output.data(), output.size());
+        dst.AddInt32(size);
+        ProtoConverter::search_reply_to_wire(src, dst.AddData(size), size);
     } else {
-        ConstBufferRef buf(output.data(), output.size());
-        DataBuffer compressed(output.data(), output.size());
+        DataBuffer output(size);
+        ProtoConverter::search_reply_to_wire(src, output.getFree(), size);
+        output.moveFreeToData(size);
+        ConstBufferRef buf(output.getData(), output.getDataLen());
+        DataBuffer compressed(output.getData(), output.getDataLen());
         CompressionConfig::Type type = compress(get_compression_config(), buf, compressed, true);
         dst.AddInt8(type);
         dst.AddInt32(buf.size());
@@ -93,7 +96,7 @@ struct SearchRequestDecoder : SearchRequest::Source::Decoder {
             return std::unique_ptr<SearchRequest>(nullptr);
         }
         auto req = std::make_unique<SearchRequest>(std::move(relative_time));
-        ProtoConverter::search_request_from_proto(msg, *req);
+        ProtoConverter::search_request_from_proto(std::move(msg), *req);
         return req;
     }
 };
@@ -110,9 +113,7 @@ struct SearchCompletionHandler : SearchClient {
     SearchCompletionHandler(FRT_RPCRequest &req_in, SearchProtocolMetrics &metrics_in)
         : req(req_in), metrics(metrics_in), stats() {}
     void searchDone(SearchReply::UP reply) override {
-        ProtoSearchReply msg;
-        ProtoConverter::search_reply_to_proto(*reply, msg);
-        encode_search_reply(msg, *req.GetReturn());
+        encode_search_reply(*reply, *req.GetReturn());
         stats.reply_size = (*req.GetReturn())[2]._data._len;
         if (reply->request) {
             stats.latency = vespalib::to_s(reply->request->getTimeUsed());
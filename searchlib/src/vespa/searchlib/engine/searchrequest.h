@@ -18,7 +18,7 @@ public:
     uint32_t          offset;
     uint32_t          maxhits;
     vespalib::string  sortSpec;
-    std::vector<char> groupSpec;
+    std::string       groupSpec;
     std::vector<char> sessionId;
 
     SearchRequest();
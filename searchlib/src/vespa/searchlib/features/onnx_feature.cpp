@@ -2,11 +2,13 @@
 
 #include "onnx_feature.h"
 #include <vespa/searchlib/fef/properties.h>
+#include <vespa/searchlib/fef/indexproperties.h>
 #include <vespa/searchlib/fef/featureexecutor.h>
 #include <vespa/eval/tensor/dense/dense_tensor_view.h>
 #include <vespa/eval/tensor/dense/mutable_dense_tensor_view.h>
 #include <vespa/vespalib/util/stringfmt.h>
 #include <vespa/vespalib/util/stash.h>
+#include <algorithm>
 
 #include <vespa/log/log.h>
 LOG_SETUP(".features.onnx_feature");
@@ -46,26 +48,94 @@ vespalib::string normalize_name(const vespalib::string &name, const char *contex
 }
 
 /**
- * Feature executor that evaluates an onnx model
+ * Feature executor that evaluates an onnx model. If the model has a
+ * batch dimension, documents may also be evaluated in batches (one
+ * model invocation per batch) during second phase ranking.
  */
 class OnnxFeatureExecutor : public FeatureExecutor
 {
 private:
+    const Onnx &_model;
+    const Onnx::WireInfo &_wire_info;
     Onnx::EvalContext _eval_context;
+    std::unique_ptr<Onnx::BatchEvalContext> _batch_context;
+    vespalib::ConstArrayRef<fef::LazyValue> _params;
+    size_t _max_batch_size;
+    std::vector<uint32_t> _batch_docs;
+    bool _batch_ready;
+
+    void bind_results(const Onnx::EvalContext &ctx) {
+        for (size_t i = 0; i < ctx.num_results(); ++i) {
+            outputs().set_object(i, ctx.get_result(i));
+        }
+    }
+    void bind_results(const Onnx::BatchEvalContext &ctx, size_t batch_idx) {
+        for (size_t i = 0; i < ctx.num_results(); ++i) {
+            outputs().set_object(i, ctx.get_result(batch_idx, i));
+        }
+    }
+    // index of docid in the current batch; max size_t if not found
+    size_t batch_index(uint32_t docid) const {
+        if (_batch_ready) {
+            auto pos = std::lower_bound(_batch_docs.begin(), _batch_docs.end(), docid);
+            if ((pos != _batch_docs.end()) && (*pos == docid)) {
+                return (pos - _batch_docs.begin());
+            }
+        }
+        return size_t(-1);
+    }
+
 public:
-    OnnxFeatureExecutor(const Onnx &model, const Onnx::WireInfo &wire_info)
-        : _eval_context(model, wire_info) {}
+    OnnxFeatureExecutor(const Onnx &model, const Onnx::WireInfo &wire_info, size_t max_batch_size)
+        : _model(model),
+          _wire_info(wire_info),
+          _eval_context(model, wire_info),
+          _batch_context(),
+          _params(),
+          _max_batch_size(Onnx::BatchEvalContext::can_batch(model, wire_info) ? max_batch_size : 1),
+          _batch_docs(),
+          _batch_ready(false) {}
     bool isPure() override { return true; }
+    bool supports_batch() const override { return (_max_batch_size > 1); }
+    void handle_bind_inputs(vespalib::ConstArrayRef<fef::LazyValue> inputs) override {
+        _params = inputs;
+    }
     void handle_bind_outputs(vespalib::ArrayRef<fef::NumberOrObject>) override {
-        for (size_t i = 0; i < _eval_context.num_results(); ++i) {
-            outputs().set_object(i, _eval_context.get_result(i));
+        bind_results(_eval_context);
+    }
+    void batch_add(uint32_t docid) override {
+        if (_batch_ready) {
+            _batch_docs.clear();
+            _batch_ready = false;
+        }
+        if (!_batch_context) {
+            _batch_context = std::make_unique<Onnx::BatchEvalContext>(_model, _wire_info, _max_batch_size);
+        }
+        assert(_batch_docs.size() < _max_batch_size);
+        assert(_batch_docs.empty() || (docid > _batch_docs.back()));
+        size_t batch_idx = _batch_docs.size();
+        for (size_t i = 0; i < _batch_context->num_params(); ++i) {
+            _batch_context->bind_param(batch_idx, i, _params[i].as_object(docid).get());
+        }
+        _batch_docs.push_back(docid);
+    }
+    void batch_eval() override {
+        if (!_batch_docs.empty() && !_batch_ready) {
+            _batch_context->eval(_batch_docs.size());
+            _batch_ready = true;
         }
     }
-    void execute(uint32_t) override {
+    void execute(uint32_t docid) override {
+        size_t batch_idx = batch_index(docid);
+        if (batch_idx < _batch_docs.size()) {
+            bind_results(*_batch_context, batch_idx);
+            return;
+        }
         for (size_t i = 0; i < _eval_context.num_params(); ++i) {
             _eval_context.bind_param(i, inputs().get_object(i).get());
         }
         _eval_context.eval();
+        bind_results(_eval_context);
     }
 };
 
@@ -122,10 +192,11 @@ OnnxBlueprint::setup(const IIndexEnvironment &env,
 }
 
 FeatureExecutor &
-OnnxBlueprint::createExecutor(const IQueryEnvironment &, Stash &stash) const
+OnnxBlueprint::createExecutor(const IQueryEnvironment &env, Stash &stash) const
 {
     assert(_model);
-    return stash.create<OnnxFeatureExecutor>(*_model, _wire_info);
+    size_t max_batch_size = fef::indexproperties::rank::SecondPhaseBatchSize::lookup(env.getProperties());
+    return stash.create<OnnxFeatureExecutor>(*_model, _wire_info, std::max(max_batch_size, size_t(1)));
 }
 
 }
@@ -7,6 +7,8 @@
 #include <vespa/searchlib/features/rankingexpression/feature_name_extractor.h>
 #include <vespa/eval/tensor/default_tensor_engine.h>
 #include <vespa/eval/eval/param_usage.h>
+#include <vespa/eval/eval/gbdt.h>
+#include <algorithm>
 
 #include <vespa/log/log.h>
 LOG_SETUP(".features.rankingexpression");
@@ -22,6 +24,7 @@ using vespalib::eval::InterpretedFunction;
 using vespalib::eval::LazyParams;
 using vespalib::eval::NodeTypes;
 using vespalib::eval::PassParams;
+using vespalib::eval::SplitInterpretedFunction;
 using vespalib::eval::Value;
 using vespalib::eval::ValueType;
 using vespalib::eval::gbdt::FastForest;
@@ -39,12 +42,25 @@ vespalib::string list_issues(const std::vector<vespalib::string> &issues) {
     return result;
 }
 
+// features with the same value for all documents evaluated for a query
+bool is_query_level_feature(vespalib::stringref name) {
+    return (vespalib::starts_with(name, "query(") || vespalib::starts_with(name, "constant("));
+}
+
+// query-level results shared by all match threads for a query
+struct SharedQueryLevelResults : fef::Anything {
+    mutable SplitInterpretedFunction::Results results;
+    SharedQueryLevelResults(const SplitInterpretedFunction &function) : results(function) {}
+};
+
 } // namespace search::features::<unnamed>
 
 //-----------------------------------------------------------------------------
 
 /**
- * Implements the executor for fast forest gbdt evaluation
+ * Implements the executor for fast forest gbdt evaluation. When
+ * batching is enabled, all documents in a batch are scored with a
+ * single call to FastForest::eval_batch.
  **/
 class FastForestExecutor : public fef::FeatureExecutor
 {
@@ -52,10 +68,18 @@ private:
     const FastForest &_forest;
     FastForest::Context::UP _ctx;
     ArrayRef<float> _params;
+    size_t _max_batch_size;
+    std::vector<float> _batch_params;  // [param * _max_batch_size + batch_idx]
+    std::vector<double> _batch_results;
+    std::vector<uint32_t> _batch_docs;
+    bool _batch_ready;
 
 public:
-    FastForestExecutor(ArrayRef<float> param_space, const FastForest &forest);
+    FastForestExecutor(ArrayRef<float> param_space, const FastForest &forest, size_t max_batch_size);
     bool isPure() override { return true; }
+    bool supports_batch() const override { return (_max_batch_size > 1); }
+    void batch_add(uint32_t docid) override;
+    void batch_eval() override;
     void execute(uint32_t docId) override;
 };
 
@@ -79,6 +103,39 @@ public:
 
 //-----------------------------------------------------------------------------
 
+/**
+ * Implements the executor for ranking expressions compiled for batch
+ * evaluation. Input values are gathered into one column per input
+ * for each document in the batch, and the whole batch is scored with
+ * a single call to the compiled function. Documents outside a batch
+ * are evaluated as a batch of size 1.
+ **/
+class BatchCompiledRankingExpressionExecutor : public fef::FeatureExecutor
+{
+private:
+    using function_type = CompiledFunction::batch_function;
+    function_type _ranking_function;
+    size_t _num_params;
+    size_t _max_batch_size;
+    std::vector<double> _cells;               // [param * _max_batch_size + batch_idx]
+    std::vector<const double *> _columns;
+    std::vector<double> _single_params;
+    std::vector<const double *> _single_columns;
+    std::vector<double> _results;
+    std::vector<uint32_t> _batch_docs;
+    bool _batch_ready;
+
+public:
+    BatchCompiledRankingExpressionExecutor(const CompiledFunction &compiled_function, size_t max_batch_size);
+    bool isPure() override { return true; }
+    bool supports_batch() const override { return (_max_batch_size > 1); }
+    void batch_add(uint32_t docid) override;
+    void batch_eval() override;
+    void execute(uint32_t docId) override;
+};
+
+//-----------------------------------------------------------------------------
+
 /**
  * Implements the executor for lazy compiled ranking expressions
  **/
@@ -127,18 +184,91 @@ public:
     void execute(uint32_t docId) override;
 };
 
+/**
+ * Implements the executor for interpreted ranking expressions with
+ * query-level subexpressions split out. The query-level results are
+ * calculated once and shared by all match threads when available in
+ * the object store. If any of the query-level inputs turn out not to
+ * be constant, the plain interpreted function is used instead.
+ **/
+class SplitInterpretedRankingExpressionExecutor : public fef::FeatureExecutor
+{
+private:
+    const SplitInterpretedFunction      &_split_function;
+    SplitInterpretedFunction::Results   &_results;
+    const InterpretedFunction           &_plain_function;
+    InterpretedFunction::Context         _split_context;
+    InterpretedFunction::Context         _plain_context;
+    MyLazyParams                         _params;
+    bool                                 _use_split;
+
+protected:
+    void handle_bind_inputs(ConstArrayRef<fef::LazyValue> inputs) override;
+
+public:
+    SplitInterpretedRankingExpressionExecutor(const SplitInterpretedFunction &split_function,
+                                              SplitInterpretedFunction::Results &results,
+                                              const InterpretedFunction &plain_function,
+                                              ConstArrayRef<char> input_is_object);
+    bool isPure() override { return true; }
+    void execute(uint32_t docId) override;
+};
+
 //-----------------------------------------------------------------------------
 
-FastForestExecutor::FastForestExecutor(ArrayRef<float> param_space, const FastForest &forest)
+FastForestExecutor::FastForestExecutor(ArrayRef<float> param_space, const FastForest &forest, size_t max_batch_size)
     : _forest(forest),
       _ctx(_forest.create_context()),
-      _params(param_space)
+      _params(param_space),
+      _max_batch_size(std::max(max_batch_size, size_t(1))),
+      _batch_params(),
+      _batch_results(),
+      _batch_docs(),
+      _batch_ready(false)
+{
+    if (_max_batch_size > 1) {
+        _batch_params.resize(_params.size() * _max_batch_size, 0.0);
+        _batch_results.resize(_max_batch_size, 0.0);
+    }
+}
+
+void
+FastForestExecutor::batch_add(uint32_t docid)
 {
+    if (_batch_ready) {
+        _batch_docs.clear();
+        _batch_ready = false;
+    }
+    assert(_batch_docs.size() < _max_batch_size);
+    assert(_batch_docs.empty() || (docid > _batch_docs.back()));
+    size_t batch_idx = _batch_docs.size();
+    fef::FeatureExecutor::Inputs batch_inputs(inputs());
+    batch_inputs.set_docid(docid);
+    for (size_t i = 0; i < _params.size(); ++i) {
+        _batch_params[i * _max_batch_size + batch_idx] = batch_inputs.get_number(i);
+    }
+    _batch_docs.push_back(docid);
 }
 
 void
-FastForestExecutor::execute(uint32_t)
+FastForestExecutor::batch_eval()
 {
+    if (!_batch_docs.empty() && !_batch_ready) {
+        _forest.eval_batch(*_ctx, _batch_params.data(), _max_batch_size, _batch_docs.size(), _batch_results.data());
+        _batch_ready = true;
+    }
+}
+
+void
+FastForestExecutor::execute(uint32_t docid)
+{
+    if (_batch_ready) {
+        auto pos = std::lower_bound(_batch_docs.begin(), _batch_docs.end(), docid);
+        if ((pos != _batch_docs.end()) && (*pos == docid)) {
+            outputs().set_number(0, _batch_results[pos - _batch_docs.begin()]);
+            return;
+        }
+    }
     size_t i = 0;
     for (; (i + 3) < _params.size(); i += 4) {
         _params[i+0] = inputs().get_number(i+0);
@@ -178,6 +308,72 @@ CompiledRankingExpressionExecutor::execute(uint32_t)
 
 //-----------------------------------------------------------------------------
 
+BatchCompiledRankingExpressionExecutor::BatchCompiledRankingExpressionExecutor(const CompiledFunction &compiled_function,
+                                                                               size_t max_batch_size)
+    : _ranking_function(compiled_function.get_batch_function()),
+      _num_params(compiled_function.num_params()),
+      _max_batch_size(std::max(max_batch_size, size_t(1))),
+      _cells(_num_params * _max_batch_size, 0.0),
+      _columns(),
+      _single_params(_num_params, 0.0),
+      _single_columns(),
+      _results(_max_batch_size, 0.0),
+      _batch_docs(),
+      _batch_ready(false)
+{
+    for (size_t i = 0; i < _num_params; ++i) {
+        _columns.push_back(&_cells[i * _max_batch_size]);
+        _single_columns.push_back(&_single_params[i]);
+    }
+}
+
+void
+BatchCompiledRankingExpressionExecutor::batch_add(uint32_t docid)
+{
+    if (_batch_ready) {
+        _batch_docs.clear();
+        _batch_ready = false;
+    }
+    assert(_batch_docs.size() < _max_batch_size);
+    assert(_batch_docs.empty() || (docid > _batch_docs.back()));
+    size_t batch_idx = _batch_docs.size();
+    fef::FeatureExecutor::Inputs batch_inputs(inputs());
+    batch_inputs.set_docid(docid);
+    for (size_t i = 0; i < _num_params; ++i) {
+        _cells[i * _max_batch_size + batch_idx] = batch_inputs.get_number(i);
+    }
+    _batch_docs.push_back(docid);
+}
+
+void
+BatchCompiledRankingExpressionExecutor::batch_eval()
+{
+    if (!_batch_docs.empty() && !_batch_ready) {
+        _ranking_function(_columns.data(), _results.data(), _batch_docs.size());
+        _batch_ready = true;
+    }
+}
+
+void
+BatchCompiledRankingExpressionExecutor::execute(uint32_t docid)
+{
+    if (_batch_ready) {
+        auto pos = std::lower_bound(_batch_docs.begin(), _batch_docs.end(), docid);
+        if ((pos != _batch_docs.end()) && (*pos == docid)) {
+            outputs().set_number(0, _results[pos - _batch_docs.begin()]);
+            return;
+        }
+    }
+    for (size_t i = 0; i < _num_params; ++i) {
+        _single_params[i] = inputs().get_number(i);
+    }
+    double result = 0.0;
+    _ranking_function(_single_columns.data(), &result, 1);
+    outputs().set_number(0, result);
+}
+
+//-----------------------------------------------------------------------------
+
 namespace {
 
 using Context = fef::FeatureExecutor::Inputs;
@@ -215,6 +411,45 @@ InterpretedRankingExpressionExecutor::execute(uint32_t)
 
 //-----------------------------------------------------------------------------
 
+SplitInterpretedRankingExpressionExecutor::SplitInterpretedRankingExpressionExecutor(const SplitInterpretedFunction &split_function,
+                                                                                     SplitInterpretedFunction::Results &results,
+                                                                                     const InterpretedFunction &plain_function,
+                                                                                     ConstArrayRef<char> input_is_object)
+    : _split_function(split_function),
+      _results(results),
+      _plain_function(plain_function),
+      _split_context(split_function.main()),
+      _plain_context(plain_function),
+      _params(inputs(), input_is_object),
+      _use_split(true)
+{
+}
+
+void
+SplitInterpretedRankingExpressionExecutor::handle_bind_inputs(ConstArrayRef<fef::LazyValue> inputs)
+{
+    for (size_t param: _split_function.query_level_params()) {
+        if (!inputs[param].is_const()) {
+            _use_split = false;
+        }
+    }
+}
+
+void
+SplitInterpretedRankingExpressionExecutor::execute(uint32_t)
+{
+    if (_use_split) {
+        if (!_results.ready()) {
+            _results.resolve(_params);
+        }
+        outputs().set_object(0, _split_function.eval(_split_context, _params, _results));
+    } else {
+        outputs().set_object(0, _plain_function.eval(_plain_context, _params));
+    }
+}
+
+//-----------------------------------------------------------------------------
+
 RankingExpressionBlueprint::RankingExpressionBlueprint()
     : RankingExpressionBlueprint(std::make_shared<rankingexpression::NullExpressionReplacer>()) {}
 
@@ -224,6 +459,8 @@ RankingExpressionBlueprint::RankingExpressionBlueprint(rankingexpression::Expres
       _intrinsic_expression(),
       _fast_forest(),
       _interpreted_function(),
+      _split_function(),
+      _query_level_key(),
       _compile_token(),
       _input_is_object()
 {
@@ -320,12 +557,30 @@ RankingExpressionBlueprint::setup(const fef::IIndexEnvironment &env,
                 bool suggest_lazy = CompiledFunction::should_use_lazy_params(*rank_function);
                 if (fef::indexproperties::eval::LazyExpressions::check(env.getProperties(), suggest_lazy)) {
                     _compile_token = CompileCache::compile(*rank_function, PassParams::LAZY);
+                } else if (fef::indexproperties::eval::BatchExpressions::check(env.getProperties()) &&
+                           !vespalib::eval::gbdt::contains_gbdt(rank_function->root(), 16))
+                {
+                    // large gbdt models are better off with the (non-batch) forest optimizations
+                    _compile_token = CompileCache::compile(*rank_function, PassParams::BATCH);
                 } else {
                     _compile_token = CompileCache::compile(*rank_function, PassParams::ARRAY);
                 }
             }
         } else {
             _interpreted_function.reset(new InterpretedFunction(DefaultTensorEngine::ref(), *rank_function, node_types));
+            if (fef::indexproperties::eval::SplitQueryLevelExpressions::check(env.getProperties())) {
+                std::vector<bool> is_query_level;
+                for (size_t i = 0; i < rank_function->num_params(); ++i) {
+                    is_query_level.push_back(is_query_level_feature(rank_function->param_name(i)));
+                }
+                _split_function = std::make_unique<SplitInterpretedFunction>(DefaultTensorEngine::ref(), *rank_function,
+                                                                             node_types, is_query_level);
+                if (_split_function->num_subexprs() == 0) {
+                    _split_function.reset();
+                } else {
+                    _query_level_key = "rankingExpression.queryLevel." + getName();
+                }
+            }
         }
     }
     FeatureType output_type = do_compile
@@ -347,6 +602,9 @@ RankingExpressionBlueprint::prepareSharedState(const fef::IQueryEnvironment & en
     if (_intrinsic_expression) {
         return _intrinsic_expression->prepare_shared_state(env, store);
     }
+    if (_split_function && (store.get(_query_level_key) == nullptr)) {
+        store.add(_query_level_key, std::make_unique<SharedQueryLevelResults>(*_split_function));
+    }
 }
 
 fef::FeatureExecutor &
@@ -355,17 +613,29 @@ RankingExpressionBlueprint::createExecutor(const fef::IQueryEnvironment &env, ve
     if (_intrinsic_expression) {
         return _intrinsic_expression->create_executor(env, stash);
     }
+    if (_split_function) {
+        ConstArrayRef<char> input_is_object = stash.copy_array<char>(_input_is_object);
+        const auto *shared = dynamic_cast<const SharedQueryLevelResults *>(env.getObjectStore().get(_query_level_key));
+        auto &results = ((shared != nullptr) && (&shared->results.function() == _split_function.get()))
+                        ? shared->results
+                        : stash.create<SplitInterpretedFunction::Results>(*_split_function);
+        return stash.create<SplitInterpretedRankingExpressionExecutor>(*_split_function, results, *_interpreted_function, input_is_object);
+    }
     if (_interpreted_function) {
         ConstArrayRef<char> input_is_object = stash.copy_array<char>(_input_is_object);
         return stash.create<InterpretedRankingExpressionExecutor>(*_interpreted_function, input_is_object);
     }
     if (_fast_forest) {
         ArrayRef<float> param_space = stash.create_array<float>(_input_is_object.size(), 0.0);
-        return stash.create<FastForestExecutor>(param_space, *_fast_forest);
+        size_t max_batch_size = fef::indexproperties::rank::SecondPhaseBatchSize::lookup(env.getProperties());
+        return stash.create<FastForestExecutor>(param_space, *_fast_forest, max_batch_size);
     }
     assert(_compile_token.get() != nullptr); // will be nullptr for VERIFY_SETUP feature motivation
     if (_compile_token->get().pass_params() == PassParams::ARRAY) {
         return stash.create<CompiledRankingExpressionExecutor>(_compile_token->get());
+    } else if (_compile_token->get().pass_params() == PassParams::BATCH) {
+        size_t max_batch_size = fef::indexproperties::rank::SecondPhaseBatchSize::lookup(env.getProperties());
+        return stash.create<BatchCompiledRankingExpressionExecutor>(_compile_token->get(), max_batch_size);
     } else {
         assert(_compile_token->get().pass_params() == PassParams::LAZY);
         return stash.create<LazyCompiledRankingExpressionExecutor>(_compile_token->get());
@@ -4,6 +4,7 @@
 #include <vespa/searchlib/fef/blueprint.h>
 #include <vespa/eval/eval/fast_forest.h>
 #include <vespa/eval/eval/interpreted_function.h>
+#include <vespa/eval/eval/split_interpreted_function.h>
 #include <vespa/eval/eval/llvm/compile_cache.h>
 #include <vespa/searchlib/features/rankingexpression/expression_replacer.h>
 #include <vespa/searchlib/features/rankingexpression/intrinsic_expression.h>
@@ -18,12 +19,14 @@ namespace search::features {
 class RankingExpressionBlueprint : public fef::Blueprint
 {
 private:
-    rankingexpression::ExpressionReplacer::SP  _expression_replacer;
-    rankingexpression::IntrinsicExpression::UP _intrinsic_expression;
-    vespalib::eval::gbdt::FastForest::UP       _fast_forest;
-    vespalib::eval::InterpretedFunction::UP    _interpreted_function;
-    vespalib::eval::CompileCache::Token::UP    _compile_token;
-    std::vector<char>                          _input_is_object;
+    rankingexpression::ExpressionReplacer::SP    _expression_replacer;
+    rankingexpression::IntrinsicExpression::UP   _intrinsic_expression;
+    vespalib::eval::gbdt::FastForest::UP         _fast_forest;
+    vespalib::eval::InterpretedFunction::UP      _interpreted_function;
+    vespalib::eval::SplitInterpretedFunction::UP _split_function;
+    vespalib::string                             _query_level_key;
+    vespalib::eval::CompileCache::Token::UP      _compile_token;
+    std::vector<char>                            _input_is_object;
 
 public:
     RankingExpressionBlueprint();
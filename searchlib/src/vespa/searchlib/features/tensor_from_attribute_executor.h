@@ -42,7 +42,7 @@ TensorFromAttributeExecutor<WeightedBufferType>::execute(uint32_t docId)
 {
     _attrBuffer.fill(*_attribute, docId);
     vespalib::tensor::DirectSparseTensorBuilder builder(_type);
-    vespalib::tensor::SparseTensorAddressBuilder address;
+    vespalib::tensor::SparseTensorAddressBuilder address(builder.labels());
     for (size_t i = 0; i < _attrBuffer.size(); ++i) {
         address.clear();
         address.add(vespalib::string(_attrBuffer[i].value()));
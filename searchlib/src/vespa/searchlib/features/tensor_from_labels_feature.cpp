@@ -92,7 +92,7 @@ createQueryExecutor(const search::fef::IQueryEnvironment &env,
         std::vector<vespalib::string> vector;
         ArrayParser::parse(prop.get(), vector);
         DirectSparseTensorBuilder tensorBuilder(type);
-        SparseTensorAddressBuilder address;
+        SparseTensorAddressBuilder address(tensorBuilder.labels());
         for (const auto &elem : vector) {
             address.clear();
             address.add(elem);
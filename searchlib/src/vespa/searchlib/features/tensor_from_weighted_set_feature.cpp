@@ -107,7 +107,7 @@ createQueryExecutor(const search::fef::IQueryEnvironment &env,
         WeightedStringVector vector;
         WeightedSetParser::parse(prop.get(), vector);
         DirectSparseTensorBuilder tensorBuilder(type);
-        SparseTensorAddressBuilder address;
+        SparseTensorAddressBuilder address(tensorBuilder.labels());
         for (const auto &elem : vector._data) {
             address.clear();
             address.add(elem.value());
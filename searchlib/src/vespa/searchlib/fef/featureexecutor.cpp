@@ -20,6 +20,16 @@ FeatureExecutor::isPure()
     return false;
 }
 
+void
+FeatureExecutor::batch_add(uint32_t)
+{
+}
+
+void
+FeatureExecutor::batch_eval()
+{
+}
+
 void
 FeatureExecutor::handle_bind_inputs(vespalib::ConstArrayRef<LazyValue>)
 {
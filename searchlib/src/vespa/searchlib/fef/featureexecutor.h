@@ -150,6 +150,22 @@ public:
      **/
     virtual bool isPure();
 
+    /**
+     * Check if this feature executor is able to calculate its outputs
+     * for a batch of documents in one go. Batch evaluation is driven
+     * by the RankProgram: batch_add is called for each document in
+     * the batch (in increasing docid order, with match data unpacked
+     * for that document) followed by a single call to batch_eval.
+     * After that, execute should use the pre-calculated outputs for
+     * documents in the batch. The default implementation does not
+     * support batching.
+     *
+     * @return true if this feature executor supports batching
+     **/
+    virtual bool supports_batch() const { return false; }
+    virtual void batch_add(uint32_t docid);
+    virtual void batch_eval();
+
     /**
      * Make sure this executor has been executed for the given
      * document.
@@ -88,6 +88,14 @@ const vespalib::string UseFastForest::NAME("vespa.eval.use_fast_forest");
 const bool UseFastForest::DEFAULT_VALUE(false);
 bool UseFastForest::check(const Properties &props) { return lookupBool(props, NAME, DEFAULT_VALUE); }
 
+const vespalib::string BatchExpressions::NAME("vespa.eval.batch_expressions");
+const bool BatchExpressions::DEFAULT_VALUE(false);
+bool BatchExpressions::check(const Properties &props) { return lookupBool(props, NAME, DEFAULT_VALUE); }
+
+const vespalib::string SplitQueryLevelExpressions::NAME("vespa.eval.split_query_level_expressions");
+const bool SplitQueryLevelExpressions::DEFAULT_VALUE(false);
+bool SplitQueryLevelExpressions::check(const Properties &props) { return lookupBool(props, NAME, DEFAULT_VALUE); }
+
 } // namespace eval
 
 namespace rank {
@@ -110,6 +118,15 @@ SecondPhase::lookup(const Properties &props)
     return lookupString(props, NAME, DEFAULT_VALUE);
 }
 
+const vespalib::string SecondPhaseBatchSize::NAME("vespa.rank.secondphase.batchsize");
+const uint32_t SecondPhaseBatchSize::DEFAULT_VALUE(1);
+
+uint32_t
+SecondPhaseBatchSize::lookup(const Properties &props)
+{
+    return lookupUint32(props, NAME, DEFAULT_VALUE);
+}
+
 } // namespace rank
 
 namespace execute::onmatch {
@@ -33,6 +33,23 @@ struct UseFastForest {
     static bool check(const Properties &props);
 };
 
+// compile expressions to evaluate several documents in one call when
+// batching second phase rank (see rank::SecondPhaseBatchSize). affects rank/summary/dump
+struct BatchExpressions {
+    static const vespalib::string NAME;
+    static const bool DEFAULT_VALUE;
+    static bool check(const Properties &props);
+};
+
+// evaluate query-level subexpressions of interpreted expressions
+// (only depending on query and constant features) once per query,
+// sharing the results between match threads. affects rank/summary/dump
+struct SplitQueryLevelExpressions {
+    static const vespalib::string NAME;
+    static const bool DEFAULT_VALUE;
+    static bool check(const Properties &props);
+};
+
 } // namespace eval
 
 namespace rank {
@@ -55,6 +72,18 @@ namespace rank {
         static vespalib::string lookup(const Properties &props);
     };
 
+    /**
+     * Property for the max number of documents evaluated together
+     * during second phase rank by feature executors supporting batch
+     * evaluation (like onnx models with a batch dimension). A value
+     * of 1 disables batch evaluation.
+     **/
+    struct SecondPhaseBatchSize {
+        static const vespalib::string NAME;
+        static const uint32_t DEFAULT_VALUE;
+        static uint32_t lookup(const Properties &props);
+    };
+
 } // namespace rank
 
 namespace summary {
@@ -160,6 +160,7 @@ RankProgram::RankProgram(BlueprintResolver::SP resolver)
       _hot_stash(32768),
       _cold_stash(),
       _executors(),
+      _batch_executors(),
       _unboxed_seeds(),
       _is_const()
 {
@@ -180,6 +181,7 @@ RankProgram::setup(const MatchData &md,
     const auto &specs = _resolver->getExecutorSpecs();
     _executors.reserve(specs.size());
     _is_const.resize(specs.size()*2); // Reserve space in hashmap for executors to be const
+    std::vector<char> after_batch(specs.size(), 0); // depends (directly or indirectly) on a batch executor
     for (uint32_t i = 0; i < specs.size(); ++i) {
         vespalib::ArrayRef<NumberOrObject> outputs = _hot_stash.create_array<NumberOrObject>(specs[i].output_types.size());
         StashSelector stash(_hot_stash, _cold_stash);
@@ -194,6 +196,7 @@ RankProgram::setup(const MatchData &md,
         vespalib::ArrayRef<LazyValue> inputs = stash.get().create_array<LazyValue>(num_inputs, nullptr);
         for (size_t input_idx = 0; input_idx < num_inputs; ++input_idx) {
             auto ref = specs[i].inputs[input_idx];
+            after_batch[i] |= after_batch[ref.executor];
             FeatureExecutor *input_executor = _executors[ref.executor];
             const NumberOrObject *input_value = input_executor->outputs().get_raw(ref.output);
             if (check_const(input_value)) {
@@ -212,6 +215,12 @@ RankProgram::setup(const MatchData &md,
         _executors.push_back(executor);
         if (is_const) {
             run_const(executor);
+        } else if (executor->supports_batch() && !after_batch[i]) {
+            // batch_add for an executor depending on another batch
+            // executor would force per-document evaluation of its
+            // inputs before they have been evaluated as a batch
+            _batch_executors.push_back(executor);
+            after_batch[i] = 1;
         }
     }
     for (const auto &seed_entry: _resolver->getSeedMap()) {
@@ -239,6 +248,22 @@ RankProgram::setup(const MatchData &md,
     }
 }
 
+void
+RankProgram::batch_add(uint32_t docid)
+{
+    for (FeatureExecutor *executor: _batch_executors) {
+        executor->batch_add(docid);
+    }
+}
+
+void
+RankProgram::batch_eval()
+{
+    for (FeatureExecutor *executor: _batch_executors) {
+        executor->batch_eval();
+    }
+}
+
 FeatureResolver
 RankProgram::get_seeds(bool unbox_seeds) const
 {
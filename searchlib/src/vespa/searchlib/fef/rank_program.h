@@ -38,6 +38,7 @@ private:
     vespalib::Stash                  _hot_stash;
     vespalib::Stash                  _cold_stash;
     std::vector<FeatureExecutor *>   _executors;
+    std::vector<FeatureExecutor *>   _batch_executors;
     MappedValues                     _unboxed_seeds;
     ValueSet                         _is_const;
 
@@ -70,6 +71,18 @@ public:
                const IQueryEnvironment &queryEnv,
                const Properties &featureOverrides = Properties());
 
+    /**
+     * Batch evaluation of the executors able to calculate outputs for
+     * several documents in one go (see FeatureExecutor::supports_batch).
+     * Call batch_add for each document in the batch in increasing
+     * docid order with match data unpacked for that document, then
+     * call batch_eval before resolving lazy values for the documents
+     * in the batch.
+     **/
+    bool has_batch_executors() const { return !_batch_executors.empty(); }
+    void batch_add(uint32_t docid);
+    void batch_eval();
+
     /**
      * Obtain the names and storage locations of all seed features for
      * this rank program. Programs for ranking phases will only have a
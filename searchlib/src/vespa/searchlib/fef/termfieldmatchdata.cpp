@@ -22,12 +22,14 @@ TermFieldMatchData::TermFieldMatchData(const TermFieldMatchData & rhs) :
     _fieldId(rhs._fieldId),
     _flags(rhs._flags),
     _sz(0),
-    _numOccs(0),
-    _fieldLength(0)
+    _numOccs(rhs._numOccs),
+    _fieldLength(rhs._fieldLength)
 {
     memset(&_data, 0, sizeof(_data));
     if (isRawScore()) {
         _data._rawScore = rhs._data._rawScore;
+    } else if (rhs.empty() && !rhs.allocated()) {
+        _data._subqueries = rhs._data._subqueries;
     } else {
         for (auto it(rhs.begin()), mt(rhs.end()); it != mt; it++) {
             appendPosition(*it);
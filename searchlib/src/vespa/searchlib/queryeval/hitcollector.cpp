@@ -33,6 +33,14 @@ HitCollector::sortHitsByDocId()
     }
 }
 
+void
+HitCollector::DocumentScorer::score_hits(std::vector<Hit> &hits)
+{
+    for (auto &hit : hits) {
+        hit.second = score(hit.first);
+    }
+}
+
 HitCollector::HitCollector(uint32_t numDocs,
                            uint32_t maxHitsSize)
     : _numDocs(numDocs),
@@ -186,8 +194,8 @@ HitCollector::reRank(DocumentScorer &scorer, std::vector<Hit> hits) {
                          -std::numeric_limits<feature_t>::max());
 
     std::sort(hits.begin(), hits.end()); // sort on docId
-    for (auto &hit : hits) {
-        hit.second = scorer.score(hit.first);
+    scorer.score_hits(hits);
+    for (const auto &hit : hits) {
         finalScores.low = std::min(finalScores.low, hit.second);
         finalScores.high = std::max(finalScores.high, hit.second);
     }
@@ -26,6 +26,13 @@ public:
     struct DocumentScorer {
         virtual ~DocumentScorer() {}
         virtual feature_t score(uint32_t docId) = 0;
+        /**
+         * Calculate the score of all the given hits (sorted on doc
+         * id) and store it in each hit. The default implementation
+         * invokes score() for each hit. Scorers able to calculate the
+         * score for several documents together may override this.
+         **/
+        virtual void score_hits(std::vector<Hit> &hits);
     };
 
 private:
@@ -180,9 +187,9 @@ public:
     const std::vector<Hit> & getReRankedHits() const { return _reRankedHits; }
 
     /**
-     * Re-ranks the given hits by invoking the score() method on the
-     * given document scorer. The hits are sorted on doc id so that
-     * score() is called in doc id order.
+     * Re-ranks the given hits by invoking the score_hits() method on
+     * the given document scorer. The hits are sorted on doc id so
+     * that documents are scored in doc id order.
      **/
     size_t reRank(DocumentScorer &scorer, std::vector<Hit> hits);
 
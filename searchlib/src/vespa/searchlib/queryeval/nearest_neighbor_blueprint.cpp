@@ -42,6 +42,14 @@ template<>
 void
 convert_cells<double,double>(std::unique_ptr<DenseTensorView> &, vespalib::eval::ValueType) {}
 
+template<>
+void
+convert_cells<vespalib::BFloat16,vespalib::BFloat16>(std::unique_ptr<DenseTensorView> &, vespalib::eval::ValueType) {}
+
+template<>
+void
+convert_cells<int8_t,int8_t>(std::unique_ptr<DenseTensorView> &, vespalib::eval::ValueType) {}
+
 struct ConvertCellsSelector
 {
     template <typename LCT, typename RCT>
@@ -11,12 +11,17 @@
 #include <vespa/fastlib/io/bufferedfile.h>
 #include <vespa/searchlib/attribute/load_utils.h>
 #include <vespa/searchlib/attribute/readerbase.h>
+#include <vespa/vespalib/data/slime/cursor.h>
 #include <vespa/vespalib/data/slime/inserter.h>
+#include <vespa/vespalib/util/mmap_file_allocator_factory.h>
 
 #include <vespa/log/log.h>
 LOG_SETUP(".searchlib.tensor.dense_tensor_attribute");
 
 using search::attribute::LoadUtils;
+using vespalib::alloc::MemoryAllocator;
+using vespalib::alloc::MmapFileAllocator;
+using vespalib::alloc::MmapFileAllocatorFactory;
 using vespalib::eval::ValueType;
 using vespalib::slime::ObjectInserter;
 using vespalib::tensor::DenseTensorView;
@@ -76,6 +81,19 @@ can_use_index_save_file(const search::attribute::Config &config, const search::a
     return true;
 }
 
+std::unique_ptr<MemoryAllocator>
+make_memory_allocator(const vespalib::string& name, const search::attribute::Config &config)
+{
+    if (!config.paged()) {
+        return {};
+    }
+    // Nearest neighbor search using the index touches vectors at random,
+    // while brute force search scans through all vectors.
+    auto advice = config.hnsw_index_params().has_value() ? MmapFileAllocator::Advice::RANDOM
+                                                         : MmapFileAllocator::Advice::SEQUENTIAL;
+    return MmapFileAllocatorFactory::instance().make_memory_allocator(name, advice);
+}
+
 }
 
 void
@@ -108,7 +126,7 @@ DenseTensorAttribute::memory_usage() const
 DenseTensorAttribute::DenseTensorAttribute(vespalib::stringref baseFileName, const Config& cfg,
                                            const NearestNeighborIndexFactory& index_factory)
     : TensorAttribute(baseFileName, cfg, _denseTensorStore),
-      _denseTensorStore(cfg.tensorType()),
+      _denseTensorStore(cfg.tensorType(), make_memory_allocator(getName(), cfg)),
       _index()
 {
     if (cfg.hnsw_index_params().has_value()) {
@@ -164,6 +182,21 @@ DenseTensorAttribute::complete_set_tensor(DocId docid, const Tensor& tensor,
     }
 }
 
+bool
+DenseTensorAttribute::modify_tensor(DocId docid, join_fun_t op, const CellValues &cells)
+{
+    if (_index) {
+        // the nearest neighbor index must see both the old and the new vector
+        return false;
+    }
+    EntryRef ref = _refVector[docid];
+    if (ref.valid()) {
+        // readers and the attribute saver may still use the old cells
+        setTensorRef(docid, _denseTensorStore.modify_tensor(ref, op, cells));
+    }
+    return true;
+}
+
 std::unique_ptr<Tensor>
 DenseTensorAttribute::getTensor(DocId docId) const
 {
@@ -281,6 +314,12 @@ DenseTensorAttribute::get_state(const vespalib::slime::Inserter& inserter) const
 {
     auto& object = inserter.insertObject();
     populate_state(object);
+    if (auto allocator = dynamic_cast<const MmapFileAllocator *>(_denseTensorStore.get_allocator())) {
+        auto mapped_memory = allocator->get_mapped_memory();
+        auto& paged = object["tensor_store"].setObject("paged_memory");
+        paged.setLong("mapped", mapped_memory.mapped);
+        paged.setLong("resident", mapped_memory.resident);
+    }
     if (_index) {
         ObjectInserter index_inserter(object, "nearest_neighbor_index");
         _index->get_state(index_inserter);
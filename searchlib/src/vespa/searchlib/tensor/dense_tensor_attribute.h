@@ -36,6 +36,7 @@ public:
     void setTensor(DocId docId, const Tensor &tensor) override;
     std::unique_ptr<PrepareResult> prepare_set_tensor(DocId docid, const Tensor& tensor) const override;
     void complete_set_tensor(DocId docid, const Tensor& tensor, std::unique_ptr<PrepareResult> prepare_result) override;
+    bool modify_tensor(DocId docid, join_fun_t op, const CellValues &cells) override;
     std::unique_ptr<Tensor> getTensor(DocId docId) const override;
     void extract_dense_view(DocId docId, vespalib::tensor::MutableDenseTensorView &tensor) const override;
     bool supports_extract_dense_view() const override { return true; }
@@ -5,8 +5,10 @@
 #include <vespa/eval/tensor/dense/dense_tensor_view.h>
 #include <vespa/eval/tensor/dense/mutable_dense_tensor_view.h>
 #include <vespa/eval/tensor/dense/dense_tensor.h>
+#include <vespa/eval/tensor/dense/dense_tensor_modify.h>
 #include <vespa/eval/tensor/serialization/typed_binary_format.h>
 #include <vespa/vespalib/datastore/datastore.hpp>
+#include <vespa/vespalib/util/alloc.h>
 
 using vespalib::datastore::Handle;
 using vespalib::tensor::Tensor;
@@ -26,6 +28,8 @@ size_t size_of(CellType type) {
     switch (type) {
     case CellType::DOUBLE: return sizeof(double);
     case CellType::FLOAT: return sizeof(float);
+    case CellType::BFLOAT16: return sizeof(vespalib::BFloat16);
+    case CellType::INT8: return sizeof(int8_t);
     }
     abort();
 }
@@ -52,8 +56,10 @@ DenseTensorStore::TensorSizeCalc::alignedSize() const
     return my_align(bufSize(), DENSE_TENSOR_ALIGNMENT);
 }
 
-DenseTensorStore::BufferType::BufferType(const TensorSizeCalc &tensorSizeCalc)
-    : vespalib::datastore::BufferType<char>(tensorSizeCalc.alignedSize(), MIN_BUFFER_ARRAYS, RefType::offsetSize())
+DenseTensorStore::BufferType::BufferType(const TensorSizeCalc &tensorSizeCalc,
+                                         const vespalib::alloc::MemoryAllocator* allocator)
+    : vespalib::datastore::BufferType<char>(tensorSizeCalc.alignedSize(), MIN_BUFFER_ARRAYS, RefType::offsetSize()),
+      _allocator(allocator)
 {}
 
 DenseTensorStore::BufferType::~BufferType() = default;
@@ -65,11 +71,12 @@ DenseTensorStore::BufferType::cleanHold(void *buffer, size_t offset,
     memset(static_cast<char *>(buffer) + offset, 0, numElems);
 }
 
-DenseTensorStore::DenseTensorStore(const ValueType &type)
+DenseTensorStore::DenseTensorStore(const ValueType &type, std::unique_ptr<vespalib::alloc::MemoryAllocator> allocator)
     : TensorStore(_concreteStore),
+      _allocator(std::move(allocator)),
       _concreteStore(),
       _tensorSizeCalc(type),
-      _bufferType(_tensorSizeCalc),
+      _bufferType(_tensorSizeCalc, _allocator.get()),
       _type(type),
       _emptySpace()
 {
@@ -181,4 +188,15 @@ DenseTensorStore::setTensor(const Tensor &tensor)
     return setDenseTensor(view);
 }
 
+TensorStore::EntryRef
+DenseTensorStore::modify_tensor(EntryRef ref, join_fun_t op, const vespalib::tensor::CellValues &cells)
+{
+    assert(ref.valid());
+    auto oldraw = getRawBuffer(ref);
+    auto newraw = allocRawBuffer();
+    memcpy(newraw.data, static_cast<const char *>(oldraw), getBufSize());
+    vespalib::tensor::modify_dense_cells_in_place(op, _type, newraw.data, cells);
+    return newraw.ref;
+}
+
 }
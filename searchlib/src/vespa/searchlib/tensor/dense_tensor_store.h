@@ -6,13 +6,16 @@
 #include <vespa/eval/eval/value_type.h>
 #include <vespa/eval/tensor/dense/typed_cells.h>
 
-namespace vespalib { namespace tensor { class MutableDenseTensorView; }}
+namespace vespalib { namespace tensor { class CellValues; class MutableDenseTensorView; }}
+namespace vespalib::alloc { class MemoryAllocator; }
 
 namespace search::tensor {
 
 /**
  * Class for storing dense tensors with known bounds in memory, used
- * by DenseTensorAttribute.
+ * by DenseTensorAttribute. An optional memory allocator is used for
+ * the data store buffers, e.g. to keep the tensors in memory mapped
+ * files.
  */
 class DenseTensorStore : public TensorStore
 {
@@ -20,6 +23,7 @@ public:
     using RefType = vespalib::datastore::EntryRefT<22>;
     using DataStoreType = vespalib::datastore::DataStoreT<RefType>;
     using ValueType = vespalib::eval::ValueType;
+    using join_fun_t = double (*)(double, double);
 
     struct TensorSizeCalc
     {
@@ -34,12 +38,15 @@ public:
     class BufferType : public vespalib::datastore::BufferType<char>
     {
         using CleanContext = vespalib::datastore::BufferType<char>::CleanContext;
+        const vespalib::alloc::MemoryAllocator* _allocator;
     public:
-        BufferType(const TensorSizeCalc &tensorSizeCalc);
+        BufferType(const TensorSizeCalc &tensorSizeCalc, const vespalib::alloc::MemoryAllocator* allocator);
         ~BufferType() override;
         void cleanHold(void *buffer, size_t offset, size_t numElems, CleanContext cleanCtx) override;
+        const vespalib::alloc::MemoryAllocator* get_memory_allocator() const override { return _allocator; }
     };
 private:
+    std::unique_ptr<vespalib::alloc::MemoryAllocator> _allocator;
     DataStoreType _concreteStore;
     TensorSizeCalc _tensorSizeCalc;
     BufferType _bufferType;
@@ -53,10 +60,11 @@ private:
     setDenseTensor(const TensorType &tensor);
 
 public:
-    DenseTensorStore(const ValueType &type);
+    DenseTensorStore(const ValueType &type, std::unique_ptr<vespalib::alloc::MemoryAllocator> allocator);
     ~DenseTensorStore() override;
 
     const ValueType &type() const { return _type; }
+    const vespalib::alloc::MemoryAllocator* get_allocator() const { return _allocator.get(); }
     size_t getNumCells() const { return _tensorSizeCalc._numCells; }
     uint32_t getCellSize() const { return _tensorSizeCalc._cellSize; }
     size_t getBufSize() const { return _tensorSizeCalc.bufSize(); }
@@ -68,6 +76,9 @@ public:
     void getTensor(EntryRef ref, vespalib::tensor::MutableDenseTensorView &tensor) const;
     vespalib::tensor::TypedCells get_typed_cells(EntryRef ref) const;
     EntryRef setTensor(const Tensor &tensor);
+    // Store a copy of a stored tensor with modified cells, see TensorModifyUpdate.
+    // The old tensor is left untouched; the caller must hold it.
+    EntryRef modify_tensor(EntryRef ref, join_fun_t op, const vespalib::tensor::CellValues &cells);
     // The following method is meant to be used only for unit tests.
     uint32_t getArraySize() const { return _bufferType.getArraySize(); }
 };
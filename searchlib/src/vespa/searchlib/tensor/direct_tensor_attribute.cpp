@@ -75,6 +75,47 @@ DirectTensorAttribute::setTensor(DocId lid, const Tensor &tensor)
     set_tensor(lid, tensor.clone());
 }
 
+// The updates below are applied to the stored tensor directly,
+// avoiding copies of the old and new tensors. The old tensor is put
+// on hold until no readers can observe it anymore.
+
+bool
+DirectTensorAttribute::modify_tensor(DocId docid, join_fun_t op, const CellValues &cells)
+{
+    EntryRef ref = _refVector[docid];
+    const Tensor *old_tensor = ref.valid() ? _direct_store.get_tensor(ref) : nullptr;
+    if (old_tensor != nullptr) {
+        if (auto new_tensor = old_tensor->modify(op, cells)) {
+            set_tensor(docid, std::move(new_tensor));
+        }
+    }
+    return true;
+}
+
+bool
+DirectTensorAttribute::add_to_tensor(DocId docid, const Tensor &cells)
+{
+    EntryRef ref = _refVector[docid];
+    const Tensor *old_tensor = ref.valid() ? _direct_store.get_tensor(ref) : nullptr;
+    if (auto new_tensor = ((old_tensor != nullptr) ? *old_tensor : *_emptyTensor).add(cells)) {
+        set_tensor(docid, std::move(new_tensor));
+    }
+    return true;
+}
+
+bool
+DirectTensorAttribute::remove_from_tensor(DocId docid, const CellValues &addresses)
+{
+    EntryRef ref = _refVector[docid];
+    const Tensor *old_tensor = ref.valid() ? _direct_store.get_tensor(ref) : nullptr;
+    if (old_tensor != nullptr) {
+        if (auto new_tensor = old_tensor->remove(addresses)) {
+            set_tensor(docid, std::move(new_tensor));
+        }
+    }
+    return true;
+}
+
 std::unique_ptr<Tensor>
 DirectTensorAttribute::getTensor(DocId docId) const
 {
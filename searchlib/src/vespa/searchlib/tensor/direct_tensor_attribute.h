@@ -19,6 +19,10 @@ public:
     virtual std::unique_ptr<AttributeSaver> onInitSave(vespalib::stringref fileName) override;
     virtual void compactWorst() override;
 
+    bool modify_tensor(DocId docid, join_fun_t op, const CellValues &cells) override;
+    bool add_to_tensor(DocId docid, const Tensor &cells) override;
+    bool remove_from_tensor(DocId docid, const CellValues &addresses) override;
+
     void set_tensor(DocId docId, std::unique_ptr<Tensor> tensor);
     const Tensor &get_tensor_ref(DocId docId) const override;
     virtual bool supports_get_tensor_ref() const override { return true; }
@@ -13,38 +13,43 @@ make_distance_function(DistanceMetric variant, ValueType::CellType cell_type)
 {
     switch (variant) {
         case DistanceMetric::Euclidean:
-            if (cell_type == ValueType::CellType::FLOAT) {
-                return std::make_unique<SquaredEuclideanDistance<float>>();
-            } else {
-                return std::make_unique<SquaredEuclideanDistance<double>>();
+            switch (cell_type) {
+            case ValueType::CellType::FLOAT: return std::make_unique<SquaredEuclideanDistance<float>>();
+            case ValueType::CellType::DOUBLE: return std::make_unique<SquaredEuclideanDistance<double>>();
+            case ValueType::CellType::BFLOAT16: return std::make_unique<SquaredEuclideanDistance<vespalib::BFloat16>>();
+            case ValueType::CellType::INT8: return std::make_unique<SquaredEuclideanDistance<int8_t>>();
             }
             break;
         case DistanceMetric::Angular:
-            if (cell_type == ValueType::CellType::FLOAT) {
-                return std::make_unique<AngularDistance<float>>();
-            } else {
-                return std::make_unique<AngularDistance<double>>();
+            switch (cell_type) {
+            case ValueType::CellType::FLOAT: return std::make_unique<AngularDistance<float>>();
+            case ValueType::CellType::DOUBLE: return std::make_unique<AngularDistance<double>>();
+            case ValueType::CellType::BFLOAT16: return std::make_unique<AngularDistance<vespalib::BFloat16>>();
+            case ValueType::CellType::INT8: return std::make_unique<AngularDistance<int8_t>>();
             }
             break;
         case DistanceMetric::GeoDegrees:
-            if (cell_type == ValueType::CellType::FLOAT) {
-                return std::make_unique<GeoDegreesDistance<float>>();
-            } else {
-                return std::make_unique<GeoDegreesDistance<double>>();
+            switch (cell_type) {
+            case ValueType::CellType::FLOAT: return std::make_unique<GeoDegreesDistance<float>>();
+            case ValueType::CellType::DOUBLE: return std::make_unique<GeoDegreesDistance<double>>();
+            case ValueType::CellType::BFLOAT16: return std::make_unique<GeoDegreesDistance<vespalib::BFloat16>>();
+            case ValueType::CellType::INT8: return std::make_unique<GeoDegreesDistance<int8_t>>();
             }
             break;
         case DistanceMetric::InnerProduct:
-            if (cell_type == ValueType::CellType::FLOAT) {
-                return std::make_unique<InnerProductDistance<float>>();
-            } else {
-                return std::make_unique<InnerProductDistance<double>>();
+            switch (cell_type) {
+            case ValueType::CellType::FLOAT: return std::make_unique<InnerProductDistance<float>>();
+            case ValueType::CellType::DOUBLE: return std::make_unique<InnerProductDistance<double>>();
+            case ValueType::CellType::BFLOAT16: return std::make_unique<InnerProductDistance<vespalib::BFloat16>>();
+            case ValueType::CellType::INT8: return std::make_unique<InnerProductDistance<int8_t>>();
             }
             break;
         case DistanceMetric::Hamming:
-            if (cell_type == ValueType::CellType::FLOAT) {
-                return std::make_unique<HammingDistance<float>>();
-            } else {
-                return std::make_unique<HammingDistance<double>>();
+            switch (cell_type) {
+            case ValueType::CellType::FLOAT: return std::make_unique<HammingDistance<float>>();
+            case ValueType::CellType::DOUBLE: return std::make_unique<HammingDistance<double>>();
+            case ValueType::CellType::BFLOAT16: return std::make_unique<HammingDistance<vespalib::BFloat16>>();
+            case ValueType::CellType::INT8: return std::make_unique<HammingDistance<int8_t>>();
             }
             break;
     }
@@ -3,10 +3,9 @@
 #include "tensor_attribute.h"
 #include <vespa/document/base/exceptions.h>
 #include <vespa/document/datatype/tensor_data_type.h>
-#include <vespa/eval/eval/simple_tensor.h>
 #include <vespa/eval/tensor/dense/typed_dense_tensor_builder.h>
+#include <vespa/eval/tensor/mixed/mixed_tensor_builder.h>
 #include <vespa/eval/tensor/sparse/sparse_tensor.h>
-#include <vespa/eval/tensor/wrapped_simple_tensor.h>
 #include <vespa/searchlib/util/state_explorer_utils.h>
 #include <vespa/vespalib/data/slime/cursor.h>
 #include <vespa/vespalib/data/slime/inserter.h>
@@ -14,12 +13,11 @@
 
 using document::TensorDataType;
 using document::WrongTensorTypeException;
-using vespalib::eval::SimpleTensor;
 using vespalib::eval::ValueType;
+using vespalib::tensor::MixedTensorBuilder;
 using vespalib::tensor::SparseTensor;
 using vespalib::tensor::Tensor;
 using vespalib::tensor::TypedDenseTensorBuilder;
-using vespalib::tensor::WrappedSimpleTensor;
 using search::StateExplorerUtils;
 
 namespace search::tensor {
@@ -48,7 +46,7 @@ createEmptyTensor(const ValueType &type)
         using MyTypify = vespalib::eval::TypifyCellType;
         return vespalib::typify_invoke<1,MyTypify,CallMakeEmptyTensor>(type.cell_type(), type);
     } else {
-        return std::make_unique<WrappedSimpleTensor>(std::make_unique<SimpleTensor>(type, SimpleTensor::Cells()));
+        return MixedTensorBuilder(type).build_mixed();
     }
 }
 
@@ -286,6 +284,24 @@ TensorAttribute::complete_set_tensor(DocId docid, const Tensor& tensor,
     (void) prepare_result;
 }
 
+bool
+TensorAttribute::modify_tensor(DocId, join_fun_t, const CellValues &)
+{
+    return false;
+}
+
+bool
+TensorAttribute::add_to_tensor(DocId, const Tensor &)
+{
+    return false;
+}
+
+bool
+TensorAttribute::remove_from_tensor(DocId, const CellValues &)
+{
+    return false;
+}
+
 IMPLEMENT_IDENTIFIABLE_ABSTRACT(TensorAttribute, AttributeVector);
 
 }
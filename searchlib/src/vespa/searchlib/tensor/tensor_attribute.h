@@ -8,6 +8,8 @@
 #include <vespa/searchlib/attribute/not_implemented_attribute.h>
 #include <vespa/vespalib/util/rcuvector.h>
 
+namespace vespalib::tensor { class CellValues; }
+
 namespace search::tensor {
 
 /**
@@ -34,6 +36,8 @@ protected:
 public:
     DECLARE_IDENTIFIABLE_ABSTRACT(TensorAttribute);
     using RefCopyVector = vespalib::Array<EntryRef>;
+    using CellValues = vespalib::tensor::CellValues;
+    using join_fun_t = double (*)(double, double);
     TensorAttribute(vespalib::stringref name, const Config &cfg, TensorStore &tensorStore);
     ~TensorAttribute() override;
     const ITensorAttribute *asTensorAttribute() const override;
@@ -73,6 +77,23 @@ public:
      */
     virtual void complete_set_tensor(DocId docid, const Tensor& tensor, std::unique_ptr<PrepareResult> prepare_result);
 
+    /**
+     * Apply partial updates directly to the tensor stored for a
+     * document (see TensorModifyUpdate, TensorAddUpdate and
+     * TensorRemoveUpdate). Adding cells to a document without a
+     * tensor starts out with an empty tensor; modifying or removing
+     * cells of a document without a tensor does nothing.
+     *
+     * These functions are only called by the attribute writer thread.
+     * They return false if this attribute is unable to apply the
+     * update directly, in which case the caller must fall back to
+     * reading the old tensor, applying the update and setting the
+     * resulting tensor.
+     */
+    virtual bool modify_tensor(DocId docid, join_fun_t op, const CellValues &cells);
+    virtual bool add_to_tensor(DocId docid, const Tensor &cells);
+    virtual bool remove_from_tensor(DocId docid, const CellValues &addresses);
+
     virtual void compactWorst() = 0;
 };
 
@@ -26,7 +26,7 @@ GetDocsumArgs::initFromDocsumRequest(const search::engine::DocsumRequest &req)
     _dumpFeatures      = req.dumpFeatures;
     _resultClassName   = req.resultClassName;
     _stackItems        = req.stackItems;
-    _stackDump         = req.stackDump;
+    _stackDump.assign(req.stackDump.begin(), req.stackDump.end());
     _location          = req.location;
     _locations_possible = true;
     _timeout           = req.getTimeLeft();
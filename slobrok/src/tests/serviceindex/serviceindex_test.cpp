@@ -0,0 +1,119 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+#include <vespa/vespalib/testkit/test_kit.h>
+#include <vespa/slobrok/serviceindex.h>
+
+using slobrok::api::IMirrorAPI;
+using slobrok::api::ServiceIndex;
+using SpecList = IMirrorAPI::SpecList;
+
+// Looks up patterns both through the index and by matching every service.
+class IndexTester : public IMirrorAPI
+{
+    SpecList     _specs;
+    ServiceIndex _index;
+
+public:
+    IndexTester(const SpecList &specs) : _specs(specs), _index(specs) {}
+
+    SpecList lookup(const std::string &pattern) const override {
+        SpecList ret;
+        for (uint32_t idx : _index.candidates(pattern)) {
+            if (match(_index.specs()[idx].first.c_str(), pattern.c_str())) {
+                ret.push_back(_index.specs()[idx]);
+            }
+        }
+        return ret;
+    }
+    uint32_t updates() const override { return 0; }
+    bool ready() const override { return true; }
+
+    SpecList lookupAll(const std::string &pattern) const {
+        SpecList ret;
+        for (const auto &spec : _specs) {
+            if (match(spec.first.c_str(), pattern.c_str())) {
+                ret.push_back(spec);
+            }
+        }
+        return ret;
+    }
+
+    void verify(const std::string &pattern, size_t expectedHits) {
+        TEST_STATE(pattern.c_str());
+        SpecList actual = lookup(pattern);
+        EXPECT_EQUAL(expectedHits, actual.size());
+        EXPECT_TRUE(lookupAll(pattern) == actual);
+    }
+};
+
+SpecList makeSpecs() {
+    SpecList specs;
+    specs.emplace_back("foo/bar/0/default", "tcp/host0:1");
+    specs.emplace_back("foo/bar/1/default", "tcp/host1:1");
+    specs.emplace_back("foo/bar/10/default", "tcp/host10:1");
+    specs.emplace_back("foo/baz/0/default", "tcp/host0:2");
+    specs.emplace_back("foo/baz/0/chain.x", "tcp/host0:3");
+    specs.emplace_back("foo/bar.foo/qux.bar/bar123/nop000", "tcp/host2:1");
+    specs.emplace_back("foo/bar*zot/qux?foo**bar*/*nop*", "tcp/host3:1");
+    specs.emplace_back("foo", "tcp/host4:1");
+    specs.emplace_back("A", "tcp/host5:1");
+    specs.emplace_back("A/x/w", "tcp/host5:2");
+    specs.emplace_back("B/x", "tcp/host6:1");
+    specs.emplace_back("foo1/bar", "tcp/host7:1");
+    specs.emplace_back("a//b", "tcp/host8:1");
+    return specs;
+}
+
+TEST("require that empty index has no candidates") {
+    ServiceIndex index;
+    EXPECT_EQUAL(0u, index.candidates("**").size());
+    EXPECT_EQUAL(0u, index.candidates("foo").size());
+}
+
+TEST("require that candidates are given in service order") {
+    ServiceIndex index(makeSpecs());
+    std::vector<uint32_t> expect({0, 1, 2});
+    EXPECT_TRUE(expect == index.candidates("foo/bar/*/default"));
+}
+
+TEST("require that literal names are found") {
+    IndexTester tester(makeSpecs());
+    tester.verify("foo/bar/1/default", 1);
+    tester.verify("foo/bar/2/default", 0);
+    tester.verify("foo", 1);
+    tester.verify("fo", 0);
+    tester.verify("foo/bar", 0);
+    tester.verify("a//b", 1);
+    tester.verify("", 0);
+}
+
+TEST("require that single stars match within one level") {
+    IndexTester tester(makeSpecs());
+    tester.verify("foo/bar/*/default", 3);
+    tester.verify("foo/bar/1*/default", 2);
+    tester.verify("foo/*/0/*", 3);
+    tester.verify("*/x", 1);
+    tester.verify("*", 2);
+    tester.verify("*/*", 2);
+    tester.verify("foo/*", 0);
+    tester.verify("foo/b*z/0/*", 0);
+    tester.verify("a/*/b", 1);
+    tester.verify("a/*", 0);
+}
+
+TEST("require that double stars match the rest of the name") {
+    IndexTester tester(makeSpecs());
+    tester.verify("**", 13);
+    tester.verify("f**", 9);
+    tester.verify("foo**", 9);
+    tester.verify("foo/**", 7);
+    tester.verify("foo*/**", 8);
+    tester.verify("A**", 2);
+    tester.verify("foo/**/default", 0);
+}
+
+TEST("require that stars in names match literally") {
+    IndexTester tester(makeSpecs());
+    tester.verify("foo/bar*zot/qux?foo**bar*/*nop*", 1);
+}
+
+TEST_MAIN() { TEST_RUN_ALL(); }
@@ -3,6 +3,7 @@
 #include "sbmirror.h"
 #include <vespa/fnet/frt/supervisor.h>
 #include <vespa/fnet/frt/target.h>
+#include <unordered_set>
 
 #include <vespa/log/log.h>
 LOG_SETUP(".slobrok.mirror");
@@ -56,10 +57,10 @@ MirrorAPI::lookup(const std::string & pattern) const
 {
     SpecList ret;
     LockGuard guard(_lock);
-    SpecList::const_iterator end = _specs.end();
-    for (SpecList::const_iterator it = _specs.begin(); it != end; ++it) {
-        if (match(it->first.c_str(), pattern.c_str())) {
-            ret.push_back(*it);
+    const SpecList &specs = _specs.specs();
+    for (uint32_t idx : _specs.candidates(pattern)) {
+        if (match(specs[idx].first.c_str(), pattern.c_str())) {
+            ret.push_back(specs[idx]);
         }
     }
     return ret;
@@ -103,9 +104,10 @@ IMirrorAPI::match(const char *name, const char *pattern)
 void
 MirrorAPI::updateTo(SpecList& newSpecs, uint32_t newGen)
 {
+    ServiceIndex index(std::move(newSpecs));
     {
         LockGuard guard(_lock);
-        std::swap(newSpecs, _specs);
+        std::swap(index, _specs);
         _updates.add();
     }
     _specsGen.setFromInt(newGen);
@@ -175,20 +177,20 @@ MirrorAPI::handleIncrementalFetch()
         updateTo(specs, diff_to);
     } else if (_specsGen == diff_from) {
         // incremental update
+        std::unordered_set<std::string> drop;
+        for (uint32_t idx = 0; idx < numRemove; idx++) {
+            drop.insert(r[idx]._str);
+        }
+        for (uint32_t idx = 0; idx < numNames; idx++) {
+            drop.insert(n[idx]._str);
+        }
         SpecList specs;
-        SpecList::const_iterator end = _specs.end();
-        for (SpecList::const_iterator it = _specs.begin();
+        SpecList::const_iterator end = _specs.specs().end();
+        for (SpecList::const_iterator it = _specs.specs().begin();
              it != end;
              ++it)
         {
-            bool keep = true;
-            for (uint32_t idx = 0; idx < numRemove; idx++) {
-                if (it->first == r[idx]._str) keep = false;
-            }
-            for (uint32_t idx = 0; idx < numNames; idx++) {
-                if (it->first == n[idx]._str) keep = false;
-            }
-            if (keep) specs.push_back(*it);
+            if (drop.find(it->first) == drop.end()) specs.push_back(*it);
         }
         for (uint32_t idx = 0; idx < numNames; idx++) {
             specs.push_back(
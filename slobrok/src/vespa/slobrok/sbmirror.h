@@ -4,6 +4,7 @@
 #include "imirrorapi.h"
 #include "backoff.h"
 #include "sblist.h"
+#include "serviceindex.h"
 #include <vespa/vespalib/util/gencnt.h>
 #include <vespa/fnet/frt/invoker.h>
 
@@ -17,7 +18,8 @@ namespace slobrok::api {
  *
  * Updates to the service repository are
  * fetched in the background. Lookups against this object is done
- * using an internal mirror of the service repository.
+ * using an internal mirror of the service repository, which is
+ * indexed by the components of the service names.
  **/
 class MirrorAPI : public FNET_Task,
                   public FRT_IRequestWait,
@@ -92,7 +94,7 @@ private:
     bool                     _reqPending;
     bool                     _scheduled;
     bool                     _reqDone;
-    SpecList                 _specs;
+    ServiceIndex             _specs;
     vespalib::GenCnt         _specsGen;
     vespalib::GenCnt         _updates;
     SlobrokList              _slobrokSpecs;
@@ -0,0 +1,101 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "serviceindex.h"
+#include <algorithm>
+
+namespace slobrok::api {
+
+ServiceIndex::ServiceIndex()
+    : _specs(),
+      _root(std::make_unique<Node>())
+{
+}
+
+ServiceIndex::ServiceIndex(SpecList specs)
+    : _specs(std::move(specs)),
+      _root(std::make_unique<Node>())
+{
+    for (uint32_t i = 0; i < _specs.size(); ++i) {
+        const std::string &name = _specs[i].first;
+        Node *node = _root.get();
+        size_t pos = 0;
+        for (;;) {
+            size_t end = std::min(name.find('/', pos), name.size());
+            std::unique_ptr<Node> &child = node->children[name.substr(pos, end - pos)];
+            if (!child) {
+                child = std::make_unique<Node>();
+            }
+            node = child.get();
+            if (end == name.size()) {
+                break;
+            }
+            pos = end + 1;
+        }
+        node->specs.push_back(i);
+    }
+}
+
+ServiceIndex::ServiceIndex(ServiceIndex &&) noexcept = default;
+ServiceIndex &ServiceIndex::operator=(ServiceIndex &&) noexcept = default;
+ServiceIndex::~ServiceIndex() = default;
+
+void
+ServiceIndex::collectAll(const Node &node, std::vector<uint32_t> &out)
+{
+    out.insert(out.end(), node.specs.begin(), node.specs.end());
+    for (const auto &child : node.children) {
+        collectAll(*child.second, out);
+    }
+}
+
+/*
+ * Up to the first '*' of a pattern component, the component must
+ * match literally. A single '*' never matches beyond the end of the
+ * component, while a component with more stars may match the rest
+ * of the name.
+ */
+void
+ServiceIndex::collect(const Node &node, const std::string &pattern, size_t pos, std::vector<uint32_t> &out)
+{
+    size_t end = std::min(pattern.find('/', pos), pattern.size());
+    bool last = (end == pattern.size());
+    size_t star = pattern.find('*', pos);
+    if (star >= end) {
+        auto it = node.children.find(pattern.substr(pos, end - pos));
+        if (it != node.children.end()) {
+            if (last) {
+                const auto &specs = it->second->specs;
+                out.insert(out.end(), specs.begin(), specs.end());
+            } else {
+                collect(*it->second, pattern, end + 1, out);
+            }
+        }
+        return;
+    }
+    std::string prefix = pattern.substr(pos, star - pos);
+    bool deep = (pattern.find('*', star + 1) < end);
+    for (auto it = node.children.lower_bound(prefix);
+         (it != node.children.end()) && (it->first.compare(0, prefix.size(), prefix) == 0);
+         ++it)
+    {
+        if (deep) {
+            collectAll(*it->second, out);
+        } else if (last) {
+            const auto &specs = it->second->specs;
+            out.insert(out.end(), specs.begin(), specs.end());
+        } else {
+            collect(*it->second, pattern, end + 1, out);
+        }
+    }
+}
+
+std::vector<uint32_t>
+ServiceIndex::candidates(const std::string &pattern) const
+{
+    std::vector<uint32_t> ret;
+    collect(*_root, pattern, 0, ret);
+    std::sort(ret.begin(), ret.end());
+    return ret;
+}
+
+} // namespace slobrok::api
@@ -0,0 +1,73 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+#pragma once
+
+#include "imirrorapi.h"
+#include <map>
+#include <memory>
+
+namespace slobrok::api {
+
+/**
+ * @brief An index over a list of services, used to speed up lookups.
+ *
+ * Service names are split into their '/' separated components, and
+ * stored in a trie keyed by those components. A lookup walks the
+ * trie along the components of the pattern, so that only services
+ * that may match the pattern are considered, instead of all of
+ * them. The candidates found must still be checked against the
+ * pattern, since the index does not implement the full matching
+ * rules of IMirrorAPI.
+ **/
+class ServiceIndex
+{
+public:
+    using Spec = IMirrorAPI::Spec;
+    using SpecList = IMirrorAPI::SpecList;
+
+    /**
+     * @brief Create an empty index.
+     **/
+    ServiceIndex();
+
+    /**
+     * @brief Create an index over the given services.
+     *
+     * @param specs the services to index
+     **/
+    explicit ServiceIndex(SpecList specs);
+
+    ServiceIndex(ServiceIndex &&) noexcept;
+    ServiceIndex &operator=(ServiceIndex &&) noexcept;
+    ~ServiceIndex();
+
+    /**
+     * @brief Obtain all the indexed services, in the order given.
+     **/
+    const SpecList &specs() const { return _specs; }
+
+    /**
+     * @brief Obtain the services that may match the given pattern.
+     *
+     * The returned positions refer to the list of indexed services,
+     * and are given in increasing order. All services matching the
+     * pattern are included, but not all services included will match.
+     *
+     * @param pattern the pattern to look up
+     * @return positions of candidate services
+     **/
+    std::vector<uint32_t> candidates(const std::string &pattern) const;
+
+private:
+    struct Node {
+        std::map<std::string, std::unique_ptr<Node>> children;
+        std::vector<uint32_t>                        specs;
+    };
+
+    static void collectAll(const Node &node, std::vector<uint32_t> &out);
+    static void collect(const Node &node, const std::string &pattern, size_t pos, std::vector<uint32_t> &out);
+
+    SpecList              _specs;
+    std::unique_ptr<Node> _root;
+};
+
+} // namespace slobrok::api
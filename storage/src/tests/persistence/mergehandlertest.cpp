@@ -644,6 +644,30 @@ TEST_F(MergeHandlerTest, spi_flush_guard) {
     }
 }
 
+TEST_F(MergeHandlerTest, apply_bucket_diff_stops_issuing_operations_after_failure) {
+    PersistenceProviderWrapper providerWrapper(getPersistenceProvider());
+    MergeHandler handler(providerWrapper, getEnv());
+
+    providerWrapper.setResult(
+            spi::Result(spi::Result::ErrorType::PERMANENT_ERROR, "who you gonna call?"));
+
+    setUpChain(MIDDLE);
+    // The put is the first entry of the diff; the two removes follow it
+    providerWrapper.setFailureMask(PersistenceProviderWrapper::FAIL_PUT);
+    providerWrapper.clearOperationLog();
+
+    try {
+        auto cmd = createDummyApplyDiff(6000);
+        handler.handleApplyBucketDiff(*cmd, createTracker(cmd, _bucket));
+        FAIL() << "No exception thrown on failing put";
+    } catch (const std::runtime_error& e) {
+        EXPECT_TRUE(std::string(e.what()).find("Failed put") != std::string::npos);
+    }
+    std::string log = providerWrapper.toString();
+    EXPECT_TRUE(log.find("put(") != std::string::npos) << log;
+    EXPECT_TRUE(log.find("remove(") == std::string::npos) << log;
+}
+
 TEST_F(MergeHandlerTest, bucket_not_found_in_db) {
     MergeHandler handler(getPersistenceProvider(), getEnv());
     // Send merge for unknown bucket
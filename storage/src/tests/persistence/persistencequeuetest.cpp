@@ -5,12 +5,15 @@
 #include <tests/persistence/filestorage/forwardingmessagesender.h>
 #include <vespa/document/test/make_document_bucket.h>
 #include <vespa/document/fieldset/fieldsets.h>
+#include <thread>
+
 #include <vespa/log/log.h>
 
 LOG_SETUP(".persistencequeuetest");
 
 using document::test::makeDocumentBucket;
 using namespace ::testing;
+using namespace std::chrono_literals;
 
 namespace storage {
 
@@ -167,4 +170,28 @@ TEST_F(PersistenceQueueTest, exclusive_locked_operation_not_started_if_exclusive
     ASSERT_FALSE(lock1.first.get());
 }
 
+TEST_F(PersistenceQueueTest, waiting_thread_is_woken_when_blocking_bucket_lock_is_released) {
+    Fixture f(*this);
+    // Make sure the thread would be stuck for a long time if it were left to the timeout.
+    f.filestorHandler->setGetNextMessageTimeout(60000);
+
+    f.filestorHandler->schedule(createPut(1234, 0), _disk);
+    f.filestorHandler->schedule(createPut(1234, 1), _disk);
+
+    auto lock0 = f.filestorHandler->getNextMessage(_disk, f.stripeId);
+    ASSERT_TRUE(lock0.first.get());
+
+    FileStorHandler::LockedMessage lock1;
+    std::thread fetcher([&]() {
+        lock1 = f.filestorHandler->getNextMessage(_disk, f.stripeId);
+    });
+    std::this_thread::sleep_for(10ms);
+    auto start = std::chrono::steady_clock::now();
+    lock0.first.reset();
+    fetcher.join();
+    ASSERT_TRUE(lock1.first.get());
+    EXPECT_EQ(document::BucketId(16, 1234), lock1.first->getBucket().getBucketId());
+    EXPECT_LT(std::chrono::steady_clock::now() - start, 30s);
+}
+
 } // namespace storage
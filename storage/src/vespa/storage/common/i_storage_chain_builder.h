@@ -0,0 +1,25 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include <memory>
+
+namespace storage {
+
+class StorageLink;
+
+/*
+ * Interface for building a storage chain, one link at a time, from
+ * the top (communication manager) to the bottom. A node uses the
+ * default implementation unless another one is set before the node
+ * is initialized, which lets tests and benchmarks insert extra links.
+ */
+class IStorageChainBuilder
+{
+public:
+    virtual ~IStorageChainBuilder() = default;
+    virtual void add(std::unique_ptr<StorageLink> link) = 0;
+    virtual std::unique_ptr<StorageLink> build() && = 0;
+};
+
+}
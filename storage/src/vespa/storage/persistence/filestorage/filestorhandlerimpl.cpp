@@ -370,13 +370,12 @@ FileStorHandlerImpl::Stripe::lock(const document::Bucket &bucket, api::LockingRe
     while (isLocked(guard, bucket, lockReq)) {
         LOG(spam, "Contending for filestor lock for %s with %s access",
             bucket.getBucketId().toString().c_str(), api::to_string(lockReq));
+        ReleaseWaiter waiter(*this);
         guard.wait(100);
     }
 
-    auto locker = std::make_shared<BucketLock>(guard, *this, bucket, 255, api::MessageType::INTERNAL_ID, 0, lockReq);
-
-    guard.broadcast();
-    return locker;
+    // Taking a lock never makes a queued operation runnable, so nobody needs to be woken here.
+    return std::make_shared<BucketLock>(guard, *this, bucket, 255, api::MessageType::INTERNAL_ID, 0, lockReq);
 }
 
 namespace {
@@ -921,9 +920,23 @@ FileStorHandlerImpl::Disk::schedule(const std::shared_ptr<api::StorageMessage>&
 FileStorHandlerImpl::Stripe::Stripe(const FileStorHandlerImpl & owner, MessageSender & messageSender)
     : _owner(owner),
       _messageSender(messageSender),
-      _active_merges(0)
+      _metrics(nullptr),
+      _active_merges(0),
+      _release_waiters(0)
 {}
 
+void
+FileStorHandlerImpl::Stripe::wakeup(vespalib::MonitorGuard & guard)
+{
+    // Threads waiting for locks to be released share the monitor with the persistence
+    // threads. A single signal could end up with one of those, so wake everyone then.
+    if (_release_waiters > 0) {
+        guard.broadcast();
+    } else {
+        guard.signal();
+    }
+}
+
 FileStorHandler::LockedMessage
 FileStorHandlerImpl::Stripe::getNextMessage(uint32_t timeout, Disk & disk)
 {
@@ -963,11 +976,18 @@ FileStorHandlerImpl::Stripe::getMessage(vespalib::MonitorGuard & guard, Priority
         auto locker = std::make_unique<BucketLock>(guard, *this, bucket, msg->getPriority(),
                                                    msg->getType().getId(), msg->getMsgId(),
                                                    msg->lockingRequirements());
+        if (!_queue.empty()) {
+            // Only one thread is woken per scheduled message or released lock. Pass the
+            // wakeup on in case there is more runnable work, so it is not left to a timeout.
+            wakeup(guard);
+        }
         guard.unlock();
         return FileStorHandler::LockedMessage(std::move(locker), std::move(msg));
     } else {
         std::shared_ptr<api::StorageReply> msgReply(makeQueueTimeoutReply(*msg));
-        guard.broadcast(); // XXX: needed here?
+        if (!_queue.empty()) {
+            wakeup(guard);
+        }
         guard.unlock();
         _messageSender.sendReply(msgReply);
         return {};
@@ -987,6 +1007,7 @@ FileStorHandlerImpl::Stripe::waitUntilNoLocks() const
 {
     vespalib::MonitorGuard lockGuard(_lock);
     while (!_lockedBuckets.empty()) {
+        ReleaseWaiter waiter(*this);
         lockGuard.wait();
     }
 }
@@ -1002,6 +1023,7 @@ void
 FileStorHandlerImpl::Stripe::waitInactive(const AbortBucketOperationsCommand& cmd) const {
     vespalib::MonitorGuard lockGuard(_lock);
     while (hasActive(lockGuard, cmd)) {
+        ReleaseWaiter waiter(*this);
         lockGuard.wait();
     }
 }
@@ -1046,8 +1068,12 @@ void FileStorHandlerImpl::Stripe::abort(std::vector<std::shared_ptr<api::Storage
 bool FileStorHandlerImpl::Stripe::schedule(MessageEntry messageEntry)
 {
     vespalib::MonitorGuard lockGuard(_lock);
-    _queue.emplace_back(std::move(messageEntry));
-    lockGuard.broadcast();
+    auto iter = _queue.emplace_back(std::move(messageEntry)).first;
+    // No point in waking anyone if the operation cannot be started until a lock is released,
+    // release() takes care of that.
+    if (!operationIsInhibited(lockGuard, iter->_bucket, *iter->_command)) {
+        wakeup(lockGuard);
+    }
     return true;
 }
 
@@ -1057,6 +1083,7 @@ FileStorHandlerImpl::Stripe::flush()
     vespalib::MonitorGuard lockGuard(_lock);
     while (!(_queue.empty() && _lockedBuckets.empty())) {
         LOG(debug, "Still %ld in queue and %ld locked buckets", _queue.size(), _lockedBuckets.size());
+        ReleaseWaiter waiter(*this);
         lockGuard.wait(100);
     }
 }
@@ -1085,6 +1112,7 @@ void FileStorHandlerImpl::Stripe::release(const document::Bucket & bucket,
     auto iter = _lockedBuckets.find(bucket);
     assert(iter != _lockedBuckets.end());
     auto& entry = iter->second;
+    bool freed_merge_slot = false;
 
     if (reqOfReleasedLock == api::LockingRequirements::Exclusive) {
         assert(entry._exclusiveLock);
@@ -1092,6 +1120,7 @@ void FileStorHandlerImpl::Stripe::release(const document::Bucket & bucket,
         if (message_type_is_merge_related(entry._exclusiveLock->msgType)) {
             assert(_active_merges > 0);
             --_active_merges;
+            freed_merge_slot = true;
         }
         entry._exclusiveLock.reset();
     } else {
@@ -1104,7 +1133,13 @@ void FileStorHandlerImpl::Stripe::release(const document::Bucket & bucket,
     if (!entry._exclusiveLock && entry._sharedLocks.empty()) {
         _lockedBuckets.erase(iter); // No more locks held
     }
-    guard.broadcast();
+    if (_release_waiters > 0) {
+        guard.broadcast();
+    } else if (freed_merge_slot ? !_queue.empty() : hasQueued(guard, bucket)) {
+        // Only operations on the released bucket (or merges held back by the merge
+        // limit) can have become runnable.
+        guard.signal();
+    }
 }
 
 void FileStorHandlerImpl::Stripe::lock(const vespalib::MonitorGuard &, const document::Bucket & bucket,
@@ -1125,6 +1160,13 @@ void FileStorHandlerImpl::Stripe::lock(const vespalib::MonitorGuard &, const doc
     }
 }
 
+bool
+FileStorHandlerImpl::Stripe::hasQueued(const vespalib::MonitorGuard &, const document::Bucket& bucket) const noexcept
+{
+    const BucketIdx& idx(bmi::get<2>(_queue));
+    return (idx.find(bucket) != idx.end());
+}
+
 bool
 FileStorHandlerImpl::Stripe::isLocked(const vespalib::MonitorGuard &, const document::Bucket& bucket,
                                       api::LockingRequirements lockReq) const noexcept
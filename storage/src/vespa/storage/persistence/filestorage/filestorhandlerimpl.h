@@ -121,6 +121,7 @@ public:
                                   const api::StorageMessage&) const noexcept;
         bool isLocked(const vespalib::MonitorGuard &, const document::Bucket&,
                       api::LockingRequirements lockReq) const noexcept;
+        bool hasQueued(const vespalib::MonitorGuard &, const document::Bucket&) const noexcept;
 
         void lock(const vespalib::MonitorGuard &, const document::Bucket & bucket,
                   api::LockingRequirements lockReq, const LockEntry & lockEntry);
@@ -137,6 +138,21 @@ public:
         BucketIdx & exposeBucketIdx() { return bmi::get<2>(_queue); }
         void setMetrics(FileStorStripeMetrics * metrics) { _metrics = metrics; }
     private:
+        /**
+         * Registers a thread that waits on the stripe monitor for locks to be released
+         * (as opposed to waiting for work), forcing wakeups to be broadcast while it waits.
+         */
+        class ReleaseWaiter {
+        public:
+            explicit ReleaseWaiter(const Stripe & stripe) : _stripe(stripe) { ++_stripe._release_waiters; }
+            ~ReleaseWaiter() { --_stripe._release_waiters; }
+        private:
+            const Stripe & _stripe;
+        };
+        // Wakes a single persistence thread, unless someone is waiting for locks to be released.
+        // This only avoids waking idle threads; scheduling, dequeuing and releasing buckets
+        // are still serialized on the stripe monitor.
+        void wakeup(vespalib::MonitorGuard & guard);
         bool hasActive(vespalib::MonitorGuard & monitor, const AbortBucketOperationsCommand& cmd) const;
         // Precondition: the bucket used by `iter`s operation is not locked in a way that conflicts
         // with its locking requirements.
@@ -150,6 +166,7 @@ public:
         PriorityQueue             _queue;
         LockedBuckets             _lockedBuckets;
         uint32_t                  _active_merges;
+        mutable uint32_t          _release_waiters;
     };
     struct Disk {
         FileStorDiskMetrics * metrics;
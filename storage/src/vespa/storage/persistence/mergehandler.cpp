@@ -6,7 +6,10 @@
 #include <vespa/document/fieldset/fieldsets.h>
 #include <vespa/vespalib/objects/nbostream.h>
 #include <vespa/vespalib/util/exceptions.h>
+#include <vespa/vespalib/util/stringfmt.h>
 #include <algorithm>
+#include <condition_variable>
+#include <mutex>
 
 #include <vespa/log/log.h>
 LOG_SETUP(".persistence.mergehandler");
@@ -34,23 +37,18 @@ constexpr int getDeleteFlag() {
     return 2;
 }
 
-/**
- * Throws std::runtime_error if result has an error.
- */
-void
-checkResult(const spi::Result& result,
-            const spi::Bucket& bucket,
-            const document::DocumentId& docId,
-            const char* op)
+vespalib::string
+failureMessage(const spi::Result& result,
+               const spi::Bucket& bucket,
+               const document::DocumentId& docId,
+               const char* op)
 {
-    if (result.hasError()) {
-        vespalib::asciistream ss;
-        ss << "Failed " << op
-           << " for " << docId.toString()
-           << " in " << bucket
-           << ": " << result.toString();
-        throw std::runtime_error(ss.str());
-    }
+    vespalib::asciistream ss;
+    ss << "Failed " << op
+       << " for " << docId.toString()
+       << " in " << bucket
+       << ": " << result.toString();
+    return ss.str();
 }
 
 void
@@ -488,6 +486,137 @@ MergeHandler::fetchLocalData(
         entries.size(), bucket.toString().c_str(), countUnfilledEntries(diff));
 }
 
+/**
+ * Keeps track of the puts and removes issued asynchronously while applying a
+ * diff locally, so that all of them can be in flight in the provider at the
+ * same time instead of waiting for each one in turn.
+ */
+class MergeHandler::AsyncApplyState {
+public:
+    AsyncApplyState()
+        : _lock(),
+          _cond(),
+          _pending(0),
+          _issued(0),
+          _failedSeqNo(0),
+          _failure()
+    { }
+
+    ~AsyncApplyState() {
+        // Operations may still be in flight if applying the diff was aborted by an exception.
+        std::unique_lock<std::mutex> guard(_lock);
+        waitForPending(guard);
+    }
+
+    uint32_t issue() {
+        std::lock_guard<std::mutex> guard(_lock);
+        ++_pending;
+        return _issued++;
+    }
+
+    void complete(uint32_t seqNo, vespalib::string failure) {
+        std::lock_guard<std::mutex> guard(_lock);
+        // Report the failure of the first issued operation, as it was when the
+        // operations were applied one at a time.
+        if (!failure.empty() && (_failure.empty() || (seqNo < _failedSeqNo))) {
+            _failedSeqNo = seqNo;
+            _failure = std::move(failure);
+        }
+        if (--_pending == 0) {
+            _cond.notify_all();
+        }
+    }
+
+    /**
+     * Waits for all issued operations to complete and throws
+     * std::runtime_error if an operation has already failed. Used to stop
+     * issuing more operations once the diff can no longer be applied.
+     */
+    void throwIfFailed() {
+        std::unique_lock<std::mutex> guard(_lock);
+        if (!_failure.empty()) {
+            waitForPending(guard);
+            throw std::runtime_error(_failure);
+        }
+    }
+
+    /**
+     * Waits for all issued operations to complete.
+     * Throws std::runtime_error if any of them failed.
+     */
+    void waitAndCheck() {
+        std::unique_lock<std::mutex> guard(_lock);
+        waitForPending(guard);
+        if (!_failure.empty()) {
+            throw std::runtime_error(_failure);
+        }
+    }
+
+private:
+    void waitForPending(std::unique_lock<std::mutex>& guard) {
+        _cond.wait(guard, [this]() { return _pending == 0; });
+    }
+
+    std::mutex              _lock;
+    std::condition_variable _cond;
+    uint32_t                _pending;
+    uint32_t                _issued;
+    uint32_t                _failedSeqNo;
+    vespalib::string        _failure;
+};
+
+namespace {
+
+class ApplyDiffEntryDone : public spi::OperationComplete {
+public:
+    ApplyDiffEntryDone(MergeHandler::AsyncApplyState& state, const spi::Bucket& bucket, const document::DocumentId& docId,
+                       const char* op, metrics::DoubleAverageMetric& latencyMetric, const framework::Clock& clock)
+        : _state(state),
+          _seqNo(state.issue()),
+          _bucket(bucket),
+          _docId(docId),
+          _op(op),
+          _latencyMetric(latencyMetric),
+          _startTime(clock),
+          _resultHandler(nullptr),
+          _completed(false)
+    { }
+
+    ~ApplyDiffEntryDone() override {
+        if (!_completed) {
+            _state.complete(_seqNo, vespalib::make_string("Failed %s for %s in %s: operation was dropped by the provider",
+                                                          _op, _docId.toString().c_str(), _bucket.toString().c_str()));
+        }
+    }
+
+    void onComplete(std::unique_ptr<spi::Result> result) override {
+        if (_resultHandler != nullptr) {
+            _resultHandler->handle(*result);
+        }
+        _latencyMetric.addValue(_startTime.getElapsedTimeAsDouble());
+        _completed = true;
+        _state.complete(_seqNo, result->hasError() ? failureMessage(*result, _bucket, _docId, _op) : vespalib::string());
+    }
+
+    void addResultHandler(const spi::ResultHandler* resultHandler) override {
+        assert(_resultHandler == nullptr);
+        _resultHandler = resultHandler;
+    }
+
+private:
+    MergeHandler::AsyncApplyState& _state;
+    const uint32_t                 _seqNo;
+    spi::Bucket                    _bucket;
+    document::DocumentId           _docId;
+    const char*                    _op;
+    metrics::DoubleAverageMetric&  _latencyMetric;
+    framework::MilliSecTimer       _startTime;
+    const spi::ResultHandler*      _resultHandler;
+    bool                           _completed;
+};
+
+}
+
 document::Document::UP
 MergeHandler::deserializeDiffDocument(
         const api::ApplyBucketDiffCommand::Entry& e,
@@ -509,21 +638,24 @@ void
 MergeHandler::applyDiffEntry(const spi::Bucket& bucket,
                              const api::ApplyBucketDiffCommand::Entry& e,
                              spi::Context& context,
-                             const document::DocumentTypeRepo& repo)
+                             const document::DocumentTypeRepo& repo,
+                             AsyncApplyState& state)
 {
+    state.throwIfFailed();
     spi::Timestamp timestamp(e._entry._timestamp);
+    auto& metrics = _env._metrics.merge_handler_metrics;
     if (!(e._entry._flags & (DELETED | DELETED_IN_PLACE))) {
         // Regular put entry
         Document::SP doc(deserializeDiffDocument(e, repo));
         DocumentId docId = doc->getId();
-        framework::MilliSecTimer start_time(_env._component.getClock());
-        checkResult(_spi.put(bucket, timestamp, std::move(doc), context), bucket, docId, "put");
-        _env._metrics.merge_handler_metrics.put_latency.addValue(start_time.getElapsedTimeAsDouble());
+        auto onComplete = std::make_unique<ApplyDiffEntryDone>(state, bucket, docId, "put",
+                                                               metrics.put_latency, _env._component.getClock());
+        _spi.putAsync(bucket, timestamp, std::move(doc), context, std::move(onComplete));
     } else {
         DocumentId docId(e._docName);
-        framework::MilliSecTimer start_time(_env._component.getClock());
-        checkResult(_spi.remove(bucket, timestamp, docId, context), bucket, docId, "remove");
-        _env._metrics.merge_handler_metrics.remove_latency.addValue(start_time.getElapsedTimeAsDouble());
+        auto onComplete = std::make_unique<ApplyDiffEntryDone>(state, bucket, docId, "remove",
+                                                               metrics.remove_latency, _env._component.getClock());
+        _spi.removeAsync(bucket, timestamp, docId, context, std::move(onComplete));
     }
 }
 
@@ -553,6 +685,7 @@ MergeHandler::applyDiffLocally(
     std::shared_ptr<const document::DocumentTypeRepo> repo(_env._component.getTypeRepo()->documentTypeRepo);
     assert(repo);
 
+    AsyncApplyState state;
     uint32_t existingCount = entries.size();
     uint32_t i = 0, j = 0;
     while (i < diff.size() && j < existingCount) {
@@ -585,7 +718,7 @@ MergeHandler::applyDiffLocally(
             ++i;
             LOG(spam, "ApplyBucketDiff(%s): Adding slot %s",
                 bucket.toString().c_str(), e.toString().c_str());
-            applyDiffEntry(bucket, e, context, *repo);
+            applyDiffEntry(bucket, e, context, *repo, state);
         } else {
             assert(spi::Timestamp(e._entry._timestamp)
                    == existing.getTimestamp());
@@ -599,7 +732,7 @@ MergeHandler::applyDiffLocally(
                     "timestamp in %s. Diff slot: %s. Existing slot: %s",
                     bucket.toString().c_str(), e.toString().c_str(),
                     existing.toString().c_str());
-                applyDiffEntry(bucket, e, context, *repo);
+                applyDiffEntry(bucket, e, context, *repo, state);
             } else {
                 // Duplicate put, just ignore it.
                 LOG(debug, "During diff apply, attempting to add slot "
@@ -631,10 +764,13 @@ MergeHandler::applyDiffLocally(
         LOG(spam, "ApplyBucketDiff(%s): Adding slot %s",
             bucket.toString().c_str(), e.toString().c_str());
 
-        applyDiffEntry(bucket, e, context, *repo);
+        applyDiffEntry(bucket, e, context, *repo, state);
         byteCount += e._headerBlob.size() + e._bodyBlob.size();
     }
 
+    // All puts and removes must have been applied before the bucket info can be fetched.
+    state.waitAndCheck();
+
     if (byteCount + notNeededByteCount != 0) {
         _env._metrics.merge_handler_metrics.mergeAverageDataReceivedNeeded.addValue(
                 static_cast<double>(byteCount) / (byteCount + notNeededByteCount));
@@ -30,6 +30,8 @@ public:
         DELETED_IN_PLACE           = 0x04
     };
 
+    class AsyncApplyState;
+
     MergeHandler(spi::PersistenceProvider& spi, PersistenceUtil&);
     /** Used for unit testing */
     MergeHandler(spi::PersistenceProvider& spi,
@@ -73,13 +75,15 @@ private:
                                              spi::Context& context);
 
     /**
-     * Invoke either put, remove or unrevertable remove on the SPI
-     * depending on the flags in the diff entry.
+     * Asynchronously invoke either put, remove or unrevertable remove on the
+     * SPI depending on the flags in the diff entry. Completion (and failure)
+     * is tracked by the given state.
      */
     void applyDiffEntry(const spi::Bucket&,
                         const api::ApplyBucketDiffCommand::Entry&,
                         spi::Context& context,
-                        const document::DocumentTypeRepo& repo);
+                        const document::DocumentTypeRepo& repo,
+                        AsyncApplyState& state);
 
     /**
      * Fill entries-vector with metadata for bucket up to maxTimestamp,
@@ -38,7 +38,8 @@ public:
                     DistributorNodeContext&,
                     ApplicationGenerationFetcher& generationFetcher,
                     NeedActiveState,
-                    std::unique_ptr<StorageLink> communicationManager);
+                    std::unique_ptr<StorageLink> communicationManager,
+                    std::unique_ptr<IStorageChainBuilder> storage_chain_builder);
     ~DistributorNode() override;
 
     const lib::NodeType& getNodeType() const override { return lib::NodeType::DISTRIBUTOR; }
@@ -49,7 +50,7 @@ public:
 
 private:
     void initializeNodeSpecific() override;
-    std::unique_ptr<StorageLink> createChain() override;
+    void createChain(IStorageChainBuilder &builder) override;
     api::Timestamp getUniqueTimestamp() override;
 
     /**
@@ -12,6 +12,7 @@
 #include <vespa/storage/frameworkimpl/status/statuswebserver.h>
 #include <vespa/storage/frameworkimpl/thread/deadlockdetector.h>
 #include <vespa/storage/common/statusmetricconsumer.h>
+#include <vespa/storage/common/storage_chain_builder.h>
 #include <vespa/vespalib/io/fileutil.h>
 #include <vespa/vespalib/util/exceptions.h>
 #include <vespa/vespalib/util/time.h>
@@ -95,6 +96,7 @@ StorageNode::StorageNode(
       _stateReporter(),
       _stateManager(),
       _chain(),
+      _chain_builder(std::make_unique<StorageChainBuilder>()),
       _configLock(),
       _initial_config_mutex(),
       _serverConfig(),
@@ -203,7 +205,9 @@ StorageNode::initialize()
     _deadLockDetector->setWaitSlack(framework::MilliSecTime(
             static_cast<uint32_t>(_serverConfig->deadLockDetectorTimeoutSlack * 1000)));
 
-    _chain.reset(createChain().release());
+    createChain(*_chain_builder);
+    _chain = std::move(*_chain_builder).build();
+    _chain_builder.reset();
 
     assert(_communicationManager != nullptr);
     _communicationManager->updateBucketSpacesConfig(*_bucketSpacesConfig);
@@ -622,4 +626,10 @@ StorageNode::releaseStateManager() {
     return std::move(_stateManager);
 }
 
+void
+StorageNode::set_storage_chain_builder(std::unique_ptr<IStorageChainBuilder> builder)
+{
+    _chain_builder = std::move(builder);
+}
+
 } // storage
@@ -36,6 +36,7 @@ class StateReporter;
 class CommunicationManager;
 class FileStorManager;
 class HostInfo;
+class IStorageChainBuilder;
 class StateManager;
 class MemoryStatusViewer;
 class StatusWebServer;
@@ -95,6 +96,8 @@ public:
 
     // For testing
     StorageLink* getChain() { return _chain.get(); }
+    // Must be called before the node is initialized to have any effect
+    void set_storage_chain_builder(std::unique_ptr<IStorageChainBuilder> builder);
     virtual void initializeStatusWebServer();
 protected:
     using StorServerConfig = vespa::config::content::core::StorServerConfig;
@@ -130,6 +133,7 @@ private:
 
     // The storage chain can depend on anything.
     std::unique_ptr<StorageLink>               _chain;
+    std::unique_ptr<IStorageChainBuilder>      _chain_builder;
 
     /** Implementation of config callbacks. */
     void configure(std::unique_ptr<StorServerConfig> config) override;
@@ -177,7 +181,7 @@ protected:
     void initialize();
     virtual void subscribeToConfigs();
     virtual void initializeNodeSpecific() = 0;
-    virtual std::unique_ptr<StorageLink> createChain() = 0;
+    virtual void createChain(IStorageChainBuilder &builder) = 0;
     virtual void handleLiveConfigUpdate(const InitialGuard & initGuard);
     void shutdown();
     virtual void removeConfigSubscriptions();
@@ -0,0 +1,59 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include <vespa/vespalib/util/bfloat16.h>
+#include <vespa/vespalib/gtest/gtest.h>
+#include <cmath>
+#include <vector>
+
+using namespace vespalib;
+
+TEST(BFloat16Test, normal_usage) {
+    EXPECT_EQ(sizeof(BFloat16), 2u);
+    BFloat16 answer = 42;
+    double fortytwo = answer;
+    EXPECT_EQ(fortytwo, 42);
+    std::vector<BFloat16> vec;
+    for (uint32_t i = 0; i < 10; ++i) {
+        vec.emplace_back(i);
+    }
+    float sum = 0;
+    for (float value : vec) {
+        sum += value;
+    }
+    EXPECT_EQ(sum, 45);
+}
+
+TEST(BFloat16Test, small_integers_are_exact) {
+    for (int i = -256; i <= 256; ++i) {
+        BFloat16 value(i);
+        EXPECT_EQ(float(value), float(i));
+    }
+}
+
+TEST(BFloat16Test, conversion_rounds_to_nearest_even) {
+    // 1.0 has bits 0x3f800000; one bfloat16 ulp is 0x10000
+    auto from_bits = [](uint32_t bits) { float f; memcpy(&f, &bits, sizeof(f)); return f; };
+    EXPECT_EQ(BFloat16(from_bits(0x3f807fff)).get_bits(), 0x3f80);
+    EXPECT_EQ(BFloat16(from_bits(0x3f808000)).get_bits(), 0x3f80);
+    EXPECT_EQ(BFloat16(from_bits(0x3f808001)).get_bits(), 0x3f81);
+    EXPECT_EQ(BFloat16(from_bits(0x3f818000)).get_bits(), 0x3f82);
+}
+
+TEST(BFloat16Test, special_values_are_kept) {
+    EXPECT_TRUE(std::isnan(float(BFloat16(std::numeric_limits<float>::quiet_NaN()))));
+    EXPECT_TRUE(std::isinf(float(BFloat16(std::numeric_limits<float>::infinity()))));
+    EXPECT_EQ(float(BFloat16(-0.0f)), 0.0f);
+    EXPECT_TRUE(std::signbit(float(BFloat16(-0.0f))));
+    EXPECT_TRUE(std::isinf(float(std::numeric_limits<BFloat16>::infinity())));
+    EXPECT_TRUE(std::isnan(float(std::numeric_limits<BFloat16>::quiet_NaN())));
+    EXPECT_EQ(float(std::numeric_limits<BFloat16>::max()), 0x1.fep127f);
+}
+
+TEST(BFloat16Test, precision_is_about_three_decimal_digits) {
+    float third = 1.0f / 3.0f;
+    float value = BFloat16(third);
+    EXPECT_NE(value, third);
+    EXPECT_NEAR(value, third, 0.001);
+}
+
+GTEST_MAIN_RUN_ALL_TESTS()
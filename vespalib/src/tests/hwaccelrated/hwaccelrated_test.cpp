@@ -31,10 +31,54 @@ void verifyEuclideanDistance(const hwaccelrated::IAccelrated & accel) {
     }
 }
 
+template<typename T>
+void verifySmallCellTypes(const hwaccelrated::IAccelrated & accel) {
+    const size_t testLength(1000);
+    srand(1);
+    std::vector<T> a(testLength);
+    std::vector<T> b(testLength);
+    for (size_t i(0); i < testLength; i++) {
+        // small enough for all sums to be exact in float
+        a[i] = int(rand()%128) - 64;
+        b[i] = int(rand()%128) - 64;
+    }
+    for (size_t j(0); j < 0x20; j++) {
+        double dotProduct(0);
+        double distance(0);
+        for (size_t i(j); i < testLength; i++) {
+            double x = a[i];
+            double y = b[i];
+            dotProduct += x * y;
+            distance += (x - y) * (x - y);
+        }
+        EXPECT_EQUAL(distance, double(accel.squaredEuclideanDistance(&a[j], &b[j], testLength - j)));
+        EXPECT_EQUAL(dotProduct, double(accel.dotProduct(&a[j], &b[j], testLength - j)));
+    }
+}
+
 TEST("test euclidean distance") {
     hwaccelrated::GenericAccelrator genericAccelrator;
     verifyEuclideanDistance<float>(genericAccelrator);
     verifyEuclideanDistance<double >(genericAccelrator);
 }
 
+TEST("test int8 and bfloat16 dot product and euclidean distance") {
+    hwaccelrated::GenericAccelrator genericAccelrator;
+    verifySmallCellTypes<int8_t>(genericAccelrator);
+    verifySmallCellTypes<BFloat16>(genericAccelrator);
+    const auto & thisCpu = hwaccelrated::IAccelrated::getAccelerator();
+    verifySmallCellTypes<int8_t>(thisCpu);
+    verifySmallCellTypes<BFloat16>(thisCpu);
+}
+
+TEST("test int8 euclidean distance does not overflow on long vectors") {
+    const size_t testLength(300000);
+    std::vector<int8_t> a(testLength, -128);
+    std::vector<int8_t> b(testLength, 127);
+    hwaccelrated::GenericAccelrator genericAccelrator;
+    EXPECT_EQUAL(testLength * 255.0 * 255.0, genericAccelrator.squaredEuclideanDistance(&a[0], &b[0], testLength));
+    const auto & thisCpu = hwaccelrated::IAccelrated::getAccelerator();
+    EXPECT_EQUAL(testLength * 255.0 * 255.0, thisCpu.squaredEuclideanDistance(&a[0], &b[0], testLength));
+}
+
 TEST_MAIN() { TEST_RUN_ALL(); }
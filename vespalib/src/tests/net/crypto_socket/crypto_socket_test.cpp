@@ -4,6 +4,7 @@
 #include <vespa/vespalib/net/crypto_engine.h>
 #include <vespa/vespalib/net/tls/tls_crypto_engine.h>
 #include <vespa/vespalib/net/tls/maybe_tls_crypto_engine.h>
+#include <vespa/vespalib/net/tls/statistics.h>
 #include <vespa/vespalib/net/crypto_socket.h>
 #include <vespa/vespalib/net/selector.h>
 #include <vespa/vespalib/net/server_socket.h>
@@ -14,6 +15,7 @@
 #include <vespa/vespalib/test/make_tls_options_for_testing.h>
 #include <sys/types.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <fcntl.h>
 
 using namespace vespalib;
@@ -28,8 +30,31 @@ struct SocketPair {
         client.reset(sockets[0]);
         server.reset(sockets[1]);
     }
+    SocketPair(SocketHandle client_in, SocketHandle server_in)
+        : client(std::move(client_in)), server(std::move(server_in)) {}
 };
 
+// kernel TLS is only available for TCP sockets
+struct TcpSocketPair : SocketPair {
+    static SocketPair connect() {
+        ServerSocket listener("tcp/0");
+        auto client = SocketSpec(listener.address().spec()).client_address().connect();
+        auto server = listener.accept();
+        return SocketPair(std::move(client), std::move(server));
+    }
+    TcpSocketPair() : SocketPair(connect()) {}
+};
+
+net::tls::TransportSecurityOptions make_kernel_tls_options_for_testing() {
+    auto opts = make_tls_options_for_testing();
+    return net::tls::TransportSecurityOptions(net::tls::TransportSecurityOptions::Params()
+            .ca_certs_pem(opts.ca_certs_pem())
+            .cert_chain_pem(opts.cert_chain_pem())
+            .private_key_pem(opts.private_key_pem())
+            .authorized_peers(opts.authorized_peers())
+            .enable_kernel_tls(true));
+}
+
 //-----------------------------------------------------------------------------
 
 bool is_blocked(int res) {
@@ -129,6 +154,33 @@ void write_bytes(CryptoSocket &socket, const vespalib::string &message) {
     }
 }
 
+void writev_bytes(CryptoSocket &socket, const std::vector<vespalib::string> &parts) {
+    std::vector<struct iovec> iov;
+    for (const auto &part: parts) {
+        iov.push_back({const_cast<char *>(part.data()), part.size()});
+    }
+    SingleFdSelector selector(socket.get_fd());
+    size_t idx = 0;
+    while (idx < iov.size()) {
+        ASSERT_TRUE(selector.wait_writable());
+        auto res = socket.writev(&iov[idx], iov.size() - idx);
+        if (res > 0) {
+            while (res > 0) {
+                size_t n = std::min(size_t(res), iov[idx].iov_len);
+                iov[idx].iov_base = static_cast<char *>(iov[idx].iov_base) + n;
+                iov[idx].iov_len -= n;
+                res -= n;
+                if (iov[idx].iov_len == 0) {
+                    ++idx;
+                }
+            }
+        } else {
+            ASSERT_TRUE(is_blocked(res));
+        }
+        flush(socket);
+    }
+}
+
 //-----------------------------------------------------------------------------
 
 void write_EOF(CryptoSocket &socket) {
@@ -172,6 +224,17 @@ void verify_socket_io(CryptoSocket &socket, SmartBuffer &read_buffer, bool is_se
         vespalib::string read = read_bytes(socket, read_buffer, server_message.size());
         EXPECT_EQUAL(server_message, read);
     }
+    std::vector<vespalib::string> parts = {"small ", vespalib::string(100000, 'x'), " and ", "more"};
+    vespalib::string gathered;
+    for (const auto &part: parts) {
+        gathered.append(part);
+    }
+    if (is_server) {
+        vespalib::string read = read_bytes(socket, read_buffer, gathered.size());
+        EXPECT_EQUAL(gathered, read);
+    } else {
+        writev_bytes(socket, parts);
+    }
 }
 
 //-----------------------------------------------------------------------------
@@ -234,6 +297,16 @@ TEST_MT_FFF("require that encrypted async socket io works with TlsCryptoEngine",
     TEST_DO(verify_crypto_socket(f1, f2, (thread_id == 0)));
 }
 
+TEST_MT_FFF("require that encrypted async socket io works with TlsCryptoEngine with kernel TLS enabled",
+            2, TcpSocketPair(), TlsCryptoEngine(make_kernel_tls_options_for_testing()), TimeBomb(60))
+{
+    auto before = net::tls::ConnectionStatistics::get(thread_id == 0).snapshot();
+    TEST_DO(verify_crypto_socket(f1, f2, (thread_id == 0)));
+    auto delta = net::tls::ConnectionStatistics::get(thread_id == 0).snapshot().subtract(before);
+    // falls back to user space TLS if the kernel does not support it
+    EXPECT_EQUAL(1u, delta.kernel_tls_connections + delta.kernel_tls_fallbacks);
+}
+
 TEST_MT_FFF("require that encrypted async socket io works with MaybeTlsCryptoEngine(true)",
             2, SocketPair(), MaybeTlsCryptoEngine(std::make_shared<TlsCryptoEngine>(make_tls_options_for_testing()), true), TimeBomb(60))
 {
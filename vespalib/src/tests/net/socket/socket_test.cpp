@@ -355,6 +355,29 @@ TEST("require that reuse addr can be set and cleared") {
     TEST_DO(verifier.verify_reuse_addr(false));
 }
 
+#ifdef SO_REUSEPORT
+TEST("require that reuse port can be set and cleared") {
+    SocketHandle handle(socket(my_inet(), SOCK_STREAM, 0));
+    test::SocketOptionsVerifier verifier(handle.get());
+    EXPECT_TRUE(!SocketOptions::set_reuse_port(-1, true));
+    EXPECT_TRUE(handle.set_reuse_port(true));
+    TEST_DO(verifier.verify_reuse_port(true));
+    EXPECT_TRUE(handle.set_reuse_port(false));
+    TEST_DO(verifier.verify_reuse_port(false));
+}
+
+TEST("require that server sockets can share a port with reuse port") {
+    ServerSocket first(SocketSpec("tcp/0"), true);
+    ASSERT_TRUE(first.valid());
+    SocketSpec spec = SocketSpec("tcp/0").replace_port(first.address().port());
+    ServerSocket second(spec, true);
+    ServerSocket third(spec, false);
+    EXPECT_TRUE(second.valid());
+    EXPECT_FALSE(third.valid());
+    EXPECT_EQUAL(second.address().port(), first.address().port());
+}
+#endif
+
 TEST("require that ipv6_only can be set and cleared") {
     if (ipv6_enabled) {
         SocketHandle handle(socket(my_inet(), SOCK_STREAM, 0));
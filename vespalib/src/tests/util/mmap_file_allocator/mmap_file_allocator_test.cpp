@@ -0,0 +1,128 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include <vespa/vespalib/util/mmap_file_allocator.h>
+#include <vespa/vespalib/util/mmap_file_allocator_factory.h>
+#include <vespa/vespalib/io/fileutil.h>
+#include <vespa/vespalib/gtest/gtest.h>
+#include <cstring>
+
+using vespalib::alloc::Alloc;
+using vespalib::alloc::MemoryAllocator;
+using vespalib::alloc::MmapFileAllocator;
+using vespalib::alloc::MmapFileAllocatorFactory;
+
+namespace {
+
+vespalib::string basedir("mmap-file-allocator-dir");
+vespalib::string hello("hello");
+
+struct MyAlloc
+{
+    const MemoryAllocator& allocator;
+    void* data;
+    size_t size;
+
+    MyAlloc(MemoryAllocator& allocator_in, MemoryAllocator::PtrAndSize buf)
+        : allocator(allocator_in),
+          data(buf.first),
+          size(buf.second)
+    {
+    }
+
+    ~MyAlloc()
+    {
+        allocator.free(data, size);
+    }
+
+    MemoryAllocator::PtrAndSize asPair() const noexcept { return std::make_pair(data, size); }
+};
+
+}
+
+class MmapFileAllocatorTest : public ::testing::Test
+{
+protected:
+    MmapFileAllocator _allocator;
+
+public:
+    MmapFileAllocatorTest();
+    ~MmapFileAllocatorTest();
+};
+
+MmapFileAllocatorTest::MmapFileAllocatorTest()
+    : _allocator(basedir)
+{
+}
+
+MmapFileAllocatorTest::~MmapFileAllocatorTest() = default;
+
+TEST_F(MmapFileAllocatorTest, zero_sized_allocation_is_handled)
+{
+    MyAlloc buf(_allocator, _allocator.alloc(0));
+    EXPECT_EQ(nullptr, buf.data);
+    EXPECT_EQ(0u, buf.size);
+}
+
+TEST_F(MmapFileAllocatorTest, mmap_file_allocator_works)
+{
+    MyAlloc buf(_allocator, _allocator.alloc(4));
+    EXPECT_LE(4u, buf.size);
+    EXPECT_TRUE(buf.data != nullptr);
+    memcpy(buf.data, "1234", 4);
+    EXPECT_EQ(0, memcmp(buf.data, "1234", 4));
+    MyAlloc buf2(_allocator, _allocator.alloc(5));
+    EXPECT_LE(5u, buf2.size);
+    EXPECT_TRUE(buf2.data != nullptr);
+    EXPECT_TRUE(buf.data != buf2.data);
+    memcpy(buf2.data, "67890", 5);
+    EXPECT_EQ(0, memcmp(buf2.data, "67890", 5));
+    EXPECT_EQ(0, memcmp(buf.data, "1234", 4));
+    EXPECT_EQ(2u, _allocator.get_num_allocations());
+    EXPECT_EQ(buf.size + buf2.size, _allocator.get_end_offset());
+    auto mapped = _allocator.get_mapped_memory();
+    EXPECT_EQ(buf.size + buf2.size, mapped.mapped);
+    EXPECT_EQ(buf.size + buf2.size, mapped.resident);
+}
+
+TEST_F(MmapFileAllocatorTest, freed_allocation_is_unmapped)
+{
+    {
+        MyAlloc buf(_allocator, _allocator.alloc(4));
+        EXPECT_EQ(1u, _allocator.get_num_allocations());
+    }
+    EXPECT_EQ(0u, _allocator.get_num_allocations());
+    EXPECT_EQ(0u, _allocator.get_mapped_memory().mapped);
+}
+
+TEST_F(MmapFileAllocatorTest, free_with_requested_size_is_handled)
+{
+    const MemoryAllocator &allocator = _allocator;
+    auto buf = allocator.alloc(4);
+    allocator.free(buf.first, 4);
+    EXPECT_EQ(0u, _allocator.get_num_allocations());
+}
+
+TEST_F(MmapFileAllocatorTest, alloc_can_use_mmap_file_allocator)
+{
+    auto alloc = Alloc::alloc_with_allocator(&_allocator).create(hello.size() + 1);
+    memcpy(alloc.get(), hello.c_str(), hello.size() + 1);
+    EXPECT_EQ(hello, vespalib::string(static_cast<const char *>(alloc.get())));
+    EXPECT_EQ(1u, _allocator.get_num_allocations());
+}
+
+TEST(MmapFileAllocatorFactoryTest, allocator_is_only_made_when_setup)
+{
+    auto& factory = MmapFileAllocatorFactory::instance();
+    EXPECT_FALSE(factory.make_memory_allocator("foo", MmapFileAllocator::Advice::NORMAL));
+    factory.setup(basedir + "-factory");
+    {
+        auto allocator = factory.make_memory_allocator("foo", MmapFileAllocator::Advice::SEQUENTIAL);
+        ASSERT_TRUE(allocator);
+        EXPECT_TRUE(vespalib::isDirectory(basedir + "-factory/0.foo"));
+    }
+    EXPECT_FALSE(vespalib::fileExists(basedir + "-factory/0.foo"));
+    factory.setup("");
+    vespalib::rmdir(basedir + "-factory", true);
+}
+
+GTEST_MAIN_RUN_ALL_TESTS()
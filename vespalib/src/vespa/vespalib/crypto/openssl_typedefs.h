@@ -43,6 +43,13 @@ struct EvpPkeyDeleter {
 };
 using EvpPkeyPtr = std::unique_ptr<::EVP_PKEY, EvpPkeyDeleter>;
 
+struct EvpPkeyCtxDeleter {
+    void operator()(::EVP_PKEY_CTX* ctx) const noexcept {
+        ::EVP_PKEY_CTX_free(ctx);
+    }
+};
+using EvpPkeyCtxPtr = std::unique_ptr<::EVP_PKEY_CTX, EvpPkeyCtxDeleter>;
+
 struct EcKeyDeleter {
     void operator()(::EC_KEY* ec_key) const noexcept {
         ::EC_KEY_free(ec_key);
@@ -138,5 +138,11 @@ BufferTypeBase::calcArraysToAlloc(uint32_t bufferId, size_t elemsNeeded, bool re
     return result;
 }
 
+const alloc::MemoryAllocator*
+BufferTypeBase::get_memory_allocator() const
+{
+    return nullptr;
+}
+
 }
 
@@ -5,6 +5,8 @@
 #include <cstdint>
 #include <cstddef>
 
+namespace vespalib::alloc { class MemoryAllocator; }
+
 namespace vespalib::datastore {
 
 /**
@@ -66,6 +68,12 @@ public:
      */
     virtual size_t calcArraysToAlloc(uint32_t bufferId, size_t elementsNeeded, bool resizing) const;
 
+    /**
+     * Return the memory allocator used for buffers of this type, or
+     * nullptr if the default allocator should be used.
+     */
+    virtual const alloc::MemoryAllocator* get_memory_allocator() const;
+
     void clampMaxArrays(uint32_t maxArrays);
 
     uint32_t getActiveBuffers() const { return _activeBuffers; }
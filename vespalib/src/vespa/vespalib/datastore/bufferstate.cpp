@@ -116,6 +116,10 @@ BufferState::onActive(uint32_t bufferId, uint32_t typeId,
     (void) reservedElements;
     AllocResult alloc = calcAllocation(bufferId, *typeHandler, elementsNeeded, false);
     assert(alloc.elements >= reservedElements + elementsNeeded);
+    auto allocator = typeHandler->get_memory_allocator();
+    if ((allocator != nullptr) && (_buffer.get_allocator() != allocator)) {
+        _buffer = Alloc::alloc_with_allocator(allocator);
+    }
     _buffer.create(alloc.bytes).swap(_buffer);
     buffer = _buffer.get();
     assert(buffer != NULL || alloc.elements == 0u);
@@ -2,9 +2,100 @@
 
 #include "avx2.h"
 #include "avxprivate.hpp"
+#include <immintrin.h>
 
 namespace vespalib::hwaccelrated {
 
+namespace {
+
+// 16 int8 values are widened to int16 before the differences are
+// squared and pairwise added into 8 int32 lanes. Each lane grows by at
+// most 2*255*255 per step, so the lanes are flushed to 64 bits well
+// before they can overflow.
+double
+squaredEuclideanDistanceInt8(const int8_t * a, const int8_t * b, size_t sz)
+{
+    constexpr size_t STEP = 16;
+    constexpr size_t STEPS_PER_BLOCK = 8192;
+    const size_t limit = sz - (sz % STEP);
+    int64_t sum(0);
+    size_t i(0);
+    while (i < limit) {
+        const size_t end = std::min(limit, i + STEP * STEPS_PER_BLOCK);
+        __m256i partial = _mm256_setzero_si256();
+        for (; i < end; i += STEP) {
+            __m256i x = _mm256_cvtepi8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(a + i)));
+            __m256i y = _mm256_cvtepi8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(b + i)));
+            __m256i diff = _mm256_sub_epi16(x, y);
+            partial = _mm256_add_epi32(partial, _mm256_madd_epi16(diff, diff));
+        }
+        alignas(32) int32_t lanes[8];
+        _mm256_store_si256(reinterpret_cast<__m256i *>(lanes), partial);
+        for (int32_t lane : lanes) {
+            sum += lane;
+        }
+    }
+    return sum + helper::squaredEuclideanDistance(a + i, b + i, sz - i);
+}
+
+// bfloat16 is the upper half of a float, so 8 values are converted by
+// zero extending them to 32 bits and shifting them into place.
+inline __m256
+loadBFloat16(const BFloat16 * p)
+{
+    __m256i bits = _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p)));
+    return _mm256_castsi256_ps(_mm256_slli_epi32(bits, 16));
+}
+
+inline float
+sumLanes(__m256 v)
+{
+    alignas(32) float lanes[8];
+    _mm256_store_ps(lanes, v);
+    return avx::sumR<float, 8>(lanes);
+}
+
+float
+dotProductBFloat16(const BFloat16 * a, const BFloat16 * b, size_t sz)
+{
+    constexpr size_t STEP = 8;
+    __m256 partial = _mm256_setzero_ps();
+    size_t i(0);
+    for (; i + STEP <= sz; i += STEP) {
+        partial = _mm256_fmadd_ps(loadBFloat16(a + i), loadBFloat16(b + i), partial);
+    }
+    float sum(0);
+    for (; i < sz; i++) {
+        sum += a[i] * b[i];
+    }
+    return sum + sumLanes(partial);
+}
+
+double
+squaredEuclideanDistanceBFloat16(const BFloat16 * a, const BFloat16 * b, size_t sz)
+{
+    constexpr size_t STEP = 8;
+    __m256 partial = _mm256_setzero_ps();
+    size_t i(0);
+    for (; i + STEP <= sz; i += STEP) {
+        __m256 diff = _mm256_sub_ps(loadBFloat16(a + i), loadBFloat16(b + i));
+        partial = _mm256_fmadd_ps(diff, diff, partial);
+    }
+    double sum(0);
+    for (; i < sz; i++) {
+        float diff = a[i] - b[i];
+        sum += diff * diff;
+    }
+    return sum + sumLanes(partial);
+}
+
+}
+
+float
+Avx2Accelrator::dotProduct(const BFloat16 * a, const BFloat16 * b, size_t sz) const {
+    return dotProductBFloat16(a, b, sz);
+}
+
 size_t
 Avx2Accelrator::populationCount(const uint64_t *a, size_t sz) const {
     return helper::populationCount(a, sz);
@@ -20,6 +111,16 @@ Avx2Accelrator::squaredEuclideanDistance(const double * a, const double * b, siz
     return avx::euclideanDistanceSelectAlignment<double, 32>(a, b, sz);
 }
 
+double
+Avx2Accelrator::squaredEuclideanDistance(const int8_t * a, const int8_t * b, size_t sz) const {
+    return squaredEuclideanDistanceInt8(a, b, sz);
+}
+
+double
+Avx2Accelrator::squaredEuclideanDistance(const BFloat16 * a, const BFloat16 * b, size_t sz) const {
+    return squaredEuclideanDistanceBFloat16(a, b, sz);
+}
+
 void
 Avx2Accelrator::and64(size_t offset, const std::vector<std::pair<const void *, bool>> &src, void *dest) const {
     helper::andChunks<32u, 2u>(offset, src, dest);
@@ -56,6 +56,29 @@ euclideanDistanceT(const T * a, const T * b, size_t sz)
     return sum;
 }
 
+/**
+ * Converts bfloat16 vectors to float in blocks small enough to stay
+ * in L1 cache, and accumulates the result of the given float kernel.
+ */
+template <typename FloatKernel>
+double
+convertAndAccumulate(const BFloat16 * a, const BFloat16 * b, size_t sz, FloatKernel kernel)
+{
+    constexpr size_t BLOCK_SIZE = 256;
+    float af[BLOCK_SIZE];
+    float bf[BLOCK_SIZE];
+    double sum(0);
+    for (size_t i(0); i < sz; i += BLOCK_SIZE) {
+        const size_t n = std::min(BLOCK_SIZE, sz - i);
+        for (size_t j(0); j < n; j++) {
+            af[j] = a[i + j];
+            bf[j] = b[i + j];
+        }
+        sum += kernel(af, bf, n);
+    }
+    return sum;
+}
+
 template<size_t UNROLL, typename Operation>
 void
 bitOperation(Operation operation, void * aOrg, const void * bOrg, size_t bytes) {
@@ -119,6 +142,14 @@ GenericAccelrator::dotProduct(const int64_t * a, const int64_t * b, size_t sz) c
     return multiplyAdd<long long, int64_t, 8>(a, b, sz);
 }
 
+float
+GenericAccelrator::dotProduct(const BFloat16 * a, const BFloat16 * b, size_t sz) const
+{
+    return convertAndAccumulate(a, b, sz, [this](const float * af, const float * bf, size_t n) {
+        return dotProduct(af, bf, n);
+    });
+}
+
 void
 GenericAccelrator::orBit(void * aOrg, const void * bOrg, size_t bytes) const
 {
@@ -165,6 +196,18 @@ GenericAccelrator::squaredEuclideanDistance(const double * a, const double * b,
     return euclideanDistanceT<double, 4>(a, b, sz);
 }
 
+double
+GenericAccelrator::squaredEuclideanDistance(const int8_t * a, const int8_t * b, size_t sz) const {
+    return helper::squaredEuclideanDistance(a, b, sz);
+}
+
+double
+GenericAccelrator::squaredEuclideanDistance(const BFloat16 * a, const BFloat16 * b, size_t sz) const {
+    return convertAndAccumulate(a, b, sz, [this](const float * af, const float * bf, size_t n) {
+        return squaredEuclideanDistance(af, bf, n);
+    });
+}
+
 void
 GenericAccelrator::and64(size_t offset, const std::vector<std::pair<const void *, bool>> &src, void *dest) const {
     helper::andChunks<16, 4>(offset, src, dest);
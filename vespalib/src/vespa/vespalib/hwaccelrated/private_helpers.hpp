@@ -3,6 +3,7 @@
 #pragma once
 
 #include <vespa/vespalib/util/optimized.h>
+#include <algorithm>
 #include <cstring>
 
 namespace vespalib::hwaccelrated::helper {
@@ -24,6 +25,23 @@ populationCount(const uint64_t *a, size_t sz) {
     return count;
 }
 
+inline double
+squaredEuclideanDistance(const int8_t * a, const int8_t * b, size_t sz) {
+    // Differences are at most 255, so 32-bit partial sums cannot overflow within a block.
+    constexpr size_t BLOCK_SIZE = 256;
+    int64_t sum(0);
+    for (size_t i(0); i < sz; i += BLOCK_SIZE) {
+        const size_t n = std::min(BLOCK_SIZE, sz - i);
+        int32_t partial(0);
+        for (size_t j(0); j < n; j++) {
+            int32_t diff = int32_t(a[i + j]) - int32_t(b[i + j]);
+            partial += diff * diff;
+        }
+        sum += partial;
+    }
+    return sum;
+}
+
 template<typename T>
 T get(const void * base, bool invert) {
     T v;
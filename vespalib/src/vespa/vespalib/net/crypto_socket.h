@@ -5,6 +5,8 @@
 #include <memory>
 #include <cstdlib>
 
+struct iovec;
+
 namespace vespalib {
 
 /**
@@ -85,6 +87,17 @@ struct CryptoSocket {
      **/
     virtual ssize_t write(const char *buf, size_t len) = 0;
 
+    /**
+     * Called when the application has data spread across multiple
+     * buffers it wants to write. The semantics are the same as with
+     * a normal socket writev (errno, etc.); a partial write may stop
+     * in the middle of any buffer. The default implementation calls
+     * write for each buffer in turn. Implementations should override
+     * this to hand all the buffers to the underlying socket (or
+     * encoder) at once.
+     **/
+    virtual ssize_t writev(const struct iovec *iov, int iovcnt);
+
     /**
      * Try to flush data in the write pipeline that is not dependent
      * on data not yet written by the application into the underlying
@@ -43,8 +43,8 @@ ServerSocket::cleanup()
     }
 }
 
-ServerSocket::ServerSocket(const SocketSpec &spec)
-    : _handle(adjust_blocking(spec.server_address().listen(), false)),
+ServerSocket::ServerSocket(const SocketSpec &spec, bool reuse_port)
+    : _handle(adjust_blocking(spec.server_address().listen(500, reuse_port), false)),
       _path(spec.path()),
       _blocking(true),
       _shutdown(false)
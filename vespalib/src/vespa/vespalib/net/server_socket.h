@@ -21,7 +21,7 @@ private:
     void cleanup();
 public:
     ServerSocket() : _handle(), _path() {}
-    explicit ServerSocket(const SocketSpec &spec);
+    explicit ServerSocket(const SocketSpec &spec, bool reuse_port = false);
     explicit ServerSocket(const vespalib::string &spec);
     explicit ServerSocket(int port);
     ServerSocket(ServerSocket &&rhs);
@@ -165,7 +165,7 @@ SocketAddress::connect(const std::function<bool(SocketHandle&)> &tweak) const
 }
 
 SocketHandle
-SocketAddress::listen(int backlog) const
+SocketAddress::listen(int backlog, bool reuse_port) const
 {
     if (valid()) {
         SocketHandle handle(socket(_addr.ss_family, SOCK_STREAM, 0));
@@ -176,6 +176,9 @@ SocketAddress::listen(int backlog) const
             if (port() > 0) {
                 handle.set_reuse_addr(true);
             }
+            if (reuse_port && !handle.set_reuse_port(true)) {
+                return SocketHandle();
+            }
             if ((bind(handle.get(), addr(), _size) == 0) &&
                 (::listen(handle.get(), backlog) == 0))
             {
@@ -2,6 +2,7 @@
 
 #include "socket_options.h"
 
+#include <cerrno>
 #include <fcntl.h>
 #include <netinet/in.h>
 #include <netinet/tcp.h>
@@ -48,6 +49,19 @@ SocketOptions::set_reuse_addr(int fd, bool value)
     return set_bool_opt(fd, SOL_SOCKET, SO_REUSEADDR, value);
 }
 
+bool
+SocketOptions::set_reuse_port(int fd, bool value)
+{
+#ifdef SO_REUSEPORT
+    return set_bool_opt(fd, SOL_SOCKET, SO_REUSEPORT, value);
+#else
+    (void) fd;
+    (void) value;
+    errno = ENOTSUP;
+    return false;
+#endif
+}
+
 bool
 SocketOptions::set_ipv6_only(int fd, bool value)
 {
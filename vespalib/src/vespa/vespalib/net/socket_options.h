@@ -12,6 +12,7 @@ struct SocketOptions {
     static bool set_blocking(int fd, bool value);
     static bool set_nodelay(int fd, bool value);
     static bool set_reuse_addr(int fd, bool value);
+    static bool set_reuse_port(int fd, bool value);
     static bool set_ipv6_only(int fd, bool value);
     static bool set_keepalive(int fd, bool value);
     static bool set_linger(int fd, bool enable, int value);
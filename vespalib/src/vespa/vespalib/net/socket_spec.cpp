@@ -110,4 +110,16 @@ SocketSpec::replace_host(const vespalib::string &new_host) const
     return SocketSpec();
 }
 
+SocketSpec
+SocketSpec::replace_port(int new_port) const
+{
+    if (_type == Type::HOST_PORT) {
+        return from_host_port(_node, new_port);
+    }
+    if (_type == Type::PORT) {
+        return from_port(new_port);
+    }
+    return SocketSpec();
+}
+
 } // namespace vespalib
@@ -28,6 +28,7 @@ public:
     explicit SocketSpec(const vespalib::string &spec);
     vespalib::string spec() const;
     SocketSpec replace_host(const vespalib::string &new_host) const;
+    SocketSpec replace_port(int new_port) const;
     static SocketSpec from_path(const vespalib::string &path) {
         return SocketSpec(Type::PATH, path, -1);
     }
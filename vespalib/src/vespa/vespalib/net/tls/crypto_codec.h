@@ -53,6 +53,7 @@ struct DecodeResult {
 };
 
 struct TlsContext;
+struct KernelTlsParams;
 
 // TODO move to different namespace, not dependent on TLS?
 
@@ -69,6 +70,11 @@ public:
 
     virtual ~CryptoCodec() = default;
 
+    /*
+     * Whether the codec is used by the client or the server side of a session.
+     */
+    virtual Mode mode() const noexcept = 0;
+
     /*
      * Minimum buffer size required to represent one wire format frame
      * of encrypted (ciphertext) data, including frame overhead.
@@ -175,6 +181,27 @@ public:
      */
     virtual EncodeResult half_close(char* ciphertext, size_t ciphertext_size) noexcept = 0;
 
+    /*
+     * Returns true if the codec has been configured to let the kernel take over
+     * encoding and decoding (kTLS) once the handshake has completed.
+     */
+    virtual bool kernel_tls_requested() const noexcept { return false; }
+
+    /*
+     * Exports the negotiated session state needed to continue the session using
+     * kernel TLS. Returns false if this is not possible, e.g. due to an unsupported
+     * protocol version or cipher suite.
+     *
+     * Precondition:  handshake must be completed, all ciphertext produced by the
+     *                handshake must have been sent to the peer and no ciphertext
+     *                received from the peer may be pending outside the codec.
+     *                encode() and decode() must not have been called.
+     * Postcondition: if true is returned, decode() must not be called again on this
+     *                codec instance. encode() and half_close() may still be used
+     *                if the kernel only accepts the receive direction.
+     */
+    virtual bool export_kernel_tls_params(KernelTlsParams&) noexcept { return false; }
+
     /*
      * Creates an implementation defined CryptoCodec that provides at least TLSv1.2
      * compliant handshaking and full duplex data transfer.
@@ -1,7 +1,10 @@
 // Copyright 2018 Yahoo Holdings. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
 
 #include "crypto_codec_adapter.h"
+#include "kernel_tls.h"
+#include "statistics.h"
 #include <assert.h>
+#include <sys/uio.h>
 
 namespace vespalib::net::tls {
 
@@ -77,7 +80,13 @@ CryptoCodecAdapter::handshake()
         _output.commit(hs_res.bytes_produced);
         switch (hs_res.state) {
         case ::vespalib::net::tls::HandshakeResult::State::Failed: return HandshakeResult::FAIL;
-        case ::vespalib::net::tls::HandshakeResult::State::Done: return hs_try_flush();
+        case ::vespalib::net::tls::HandshakeResult::State::Done: {
+            auto flush_res = hs_try_flush();
+            if ((flush_res == HandshakeResult::DONE) && !_kernel_tls_checked) {
+                try_enable_kernel_tls();
+            }
+            return flush_res;
+        }
         case ::vespalib::net::tls::HandshakeResult::State::NeedsWork: return HandshakeResult::NEED_WORK;
         case ::vespalib::net::tls::HandshakeResult::State::NeedsMorePeerData:
             auto flush_res = hs_try_flush();
@@ -93,6 +102,73 @@ CryptoCodecAdapter::handshake()
     return HandshakeResult::DONE;
 }
 
+void
+CryptoCodecAdapter::try_enable_kernel_tls()
+{
+    _kernel_tls_checked = true;
+    if (!_codec->kernel_tls_requested()) {
+        return;
+    }
+    auto &stats = ConnectionStatistics::get(_codec->mode() == CryptoCodec::Mode::Server);
+    // data already received from the peer would have to be decoded in user space
+    if (_input.obtain().size == 0) {
+        KernelTlsParams params;
+        if (_codec->export_kernel_tls_params(params)) {
+            _kernel_rx = kernel_tls::enable_rx(_socket.get(), params);
+            _kernel_tx = _kernel_rx && kernel_tls::enable_tx(_socket.get(), params);
+        }
+    }
+    if (_kernel_rx) {
+        stats.inc_kernel_tls_connections();
+    } else {
+        stats.inc_kernel_tls_fallbacks();
+    }
+}
+
+ssize_t
+CryptoCodecAdapter::kernel_read(char *buf, size_t len)
+{
+    for (;;) {
+        if (_got_tls_close) {
+            return 0;
+        }
+        uint8_t record_type;
+        ssize_t res = kernel_tls::recv(_socket.get(), buf, len, record_type);
+        if (res == 0) { // eof without close_notify
+            errno = EIO;
+            return -1;
+        }
+        if ((res < 0) || (record_type == kernel_tls::record_type_application_data)) {
+            return res;
+        }
+        if ((record_type == kernel_tls::record_type_alert) && (res == 2) && (buf[1] == 0)) {
+            _got_tls_close = true; // close_notify
+            continue;
+        }
+        // TLSv1.3 session tickets (handshake type 4) are ignored since we never
+        // resume sessions. Anything else (e.g. key updates) cannot be handled.
+        if ((record_type == kernel_tls::record_type_handshake) && (buf[0] == 4)) {
+            continue;
+        }
+        ConnectionStatistics::get(_codec->mode() == CryptoCodec::Mode::Server).inc_broken_tls_connections();
+        errno = EIO;
+        return -1;
+    }
+}
+
+ssize_t
+CryptoCodecAdapter::kernel_half_close()
+{
+    if (!_encoded_tls_close) {
+        auto res = kernel_tls::send_close_notify(_socket.get());
+        if (res < 0) {
+            return res;
+        }
+        _encoded_tls_close = true;
+    }
+    return _socket.half_close();
+}
+
 void
 CryptoCodecAdapter::do_handshake_work()
 {
@@ -102,6 +178,9 @@ CryptoCodecAdapter::do_handshake_work()
 ssize_t
 CryptoCodecAdapter::read(char *buf, size_t len)
 {
+    if (_kernel_rx) {
+        return kernel_read(buf, len);
+    }
     auto drain_res = drain(buf, len);
     if ((drain_res != 0) || _got_tls_close) {
         return drain_res;
@@ -125,6 +204,9 @@ CryptoCodecAdapter::read(char *buf, size_t len)
 ssize_t
 CryptoCodecAdapter::drain(char *buf, size_t len)
 {
+    if (_kernel_rx) {
+        return 0;
+    }
     auto src = _input.obtain();
     auto res = _codec->decode(src.data, src.size, buf, len);
     if (res.failed()) {
@@ -141,6 +223,9 @@ CryptoCodecAdapter::drain(char *buf, size_t len)
 ssize_t
 CryptoCodecAdapter::write(const char *buf, size_t len)
 {
+    if (_kernel_tx) {
+        return _socket.write(buf, len);
+    }
     if (_output.obtain().size >= _codec->min_encode_buffer_size()) {
         if (flush() < 0) {
             return -1;
@@ -160,6 +245,92 @@ CryptoCodecAdapter::write(const char *buf, size_t len)
     return res.bytes_consumed;
 }
 
+namespace {
+
+// small buffers are gathered into plaintext chunks of this size
+// before encoding to avoid a separate tls frame for each of them
+constexpr size_t gather_size = 16 * 1024;
+
+// writev stops encoding when this much encoded data is pending
+constexpr size_t max_batch_size = 256 * 1024;
+
+}
+
+ssize_t
+CryptoCodecAdapter::encode_frame(const char *buf, size_t len)
+{
+    auto dst = _output.reserve(_codec->min_encode_buffer_size());
+    auto res = _codec->encode(buf, len, dst.data, dst.size);
+    if (res.failed) {
+        errno = EIO;
+        return -1;
+    }
+    _output.commit(res.bytes_produced);
+    return res.bytes_consumed;
+}
+
+ssize_t
+CryptoCodecAdapter::encode_gathered()
+{
+    size_t pos = 0;
+    while (pos < _gather.size()) {
+        ssize_t res = encode_frame(_gather.data() + pos, _gather.size() - pos);
+        if (res < 0) {
+            return res;
+        }
+        pos += res;
+    }
+    _gather.clear();
+    return pos;
+}
+
+ssize_t
+CryptoCodecAdapter::writev(const struct iovec *iov, int iovcnt)
+{
+    if (_kernel_tx) {
+        return _socket.writev(iov, iovcnt);
+    }
+    if (_output.obtain().size >= _codec->min_encode_buffer_size()) {
+        if (flush() < 0) {
+            return -1;
+        }
+        if (_output.obtain().size > 0) {
+            errno = EWOULDBLOCK;
+            return -1;
+        }
+    }
+    ssize_t total = 0;
+    _gather.clear();
+    for (int i = 0; i < iovcnt; ++i) {
+        const char *buf = static_cast<const char *>(iov[i].iov_base);
+        size_t len = iov[i].iov_len;
+        if ((_gather.size() + len) <= gather_size) {
+            _gather.insert(_gather.end(), buf, buf + len);
+            total += len;
+            continue;
+        }
+        if (encode_gathered() < 0) {
+            return -1;
+        }
+        while ((len > 0) && (_output.obtain().size < max_batch_size)) {
+            ssize_t res = encode_frame(buf, len);
+            if (res < 0) {
+                return -1;
+            }
+            buf += res;
+            len -= res;
+            total += res;
+        }
+        if (len > 0) {
+            break;
+        }
+    }
+    if (encode_gathered() < 0) {
+        return -1;
+    }
+    return total;
+}
+
 ssize_t
 CryptoCodecAdapter::flush()
 {
@@ -180,6 +351,9 @@ CryptoCodecAdapter::flush()
 ssize_t
 CryptoCodecAdapter::half_close()
 {
+    if (_kernel_tx) {
+        return kernel_half_close();
+    }
     auto flush_res = flush_all();
     if (flush_res < 0) {
         return flush_res;
@@ -6,6 +6,7 @@
 #include <vespa/vespalib/net/socket_handle.h>
 #include <vespa/vespalib/data/smart_buffer.h>
 #include "crypto_codec.h"
+#include <vector>
 
 namespace vespalib::net::tls {
 
@@ -18,10 +19,14 @@ class CryptoCodecAdapter : public TlsCryptoSocket
 private:
     SmartBuffer                  _input;
     SmartBuffer                  _output;
+    std::vector<char>            _gather;
     SocketHandle                 _socket;
     std::unique_ptr<CryptoCodec> _codec;
     bool                         _got_tls_close;
     bool                         _encoded_tls_close;
+    bool                         _kernel_tls_checked;
+    bool                         _kernel_rx; // peer data decrypted by the kernel
+    bool                         _kernel_tx; // our data encrypted by the kernel
 
     bool is_blocked(ssize_t res, int error) const {
         return ((res < 0) && ((error == EWOULDBLOCK) || (error == EAGAIN)));
@@ -30,10 +35,16 @@ private:
     HandshakeResult hs_try_fill();
     ssize_t fill_input(); // -1/0/1 -> error/eof/ok
     ssize_t flush_all();  // -1/0 -> error/ok
+    ssize_t encode_frame(const char *buf, size_t len); // -1 on error
+    ssize_t encode_gathered();                         // -1 on error
+    void try_enable_kernel_tls();
+    ssize_t kernel_read(char *buf, size_t len);
+    ssize_t kernel_half_close();
 public:
     CryptoCodecAdapter(SocketHandle socket, std::unique_ptr<CryptoCodec> codec)
-        : _input(64 * 1024), _output(64 * 1024), _socket(std::move(socket)), _codec(std::move(codec)),
-          _got_tls_close(false), _encoded_tls_close(false) {}
+        : _input(64 * 1024), _output(64 * 1024), _gather(), _socket(std::move(socket)), _codec(std::move(codec)),
+          _got_tls_close(false), _encoded_tls_close(false), _kernel_tls_checked(false),
+          _kernel_rx(false), _kernel_tx(false) {}
     void inject_read_data(const char *buf, size_t len) override;
     int get_fd() const override { return _socket.get(); }
     HandshakeResult handshake() override;
@@ -42,8 +53,10 @@ public:
     ssize_t read(char *buf, size_t len) override;
     ssize_t drain(char *, size_t) override;
     ssize_t write(const char *buf, size_t len) override;
+    ssize_t writev(const struct iovec *iov, int iovcnt) override;
     ssize_t flush() override;
     ssize_t half_close() override;
+    bool uses_kernel_tls() const noexcept { return _kernel_rx; }
 };
 
 } // namespace vespalib::net::tls
@@ -5,7 +5,9 @@
 
 #include <vespa/vespalib/crypto/crypto_exception.h>
 #include <vespa/vespalib/net/tls/crypto_codec.h>
+#include <vespa/vespalib/net/tls/kernel_tls.h>
 #include <vespa/vespalib/net/tls/statistics.h>
+#include <vespa/vespalib/stllike/string.h>
 
 #include <mutex>
 #include <vector>
@@ -15,6 +17,8 @@
 #include <openssl/ssl.h>
 #include <openssl/crypto.h>
 #include <openssl/err.h>
+#include <openssl/evp.h>
+#include <openssl/kdf.h>
 #include <openssl/pem.h>
 
 #include <vespa/log/bufferedlogger.h>
@@ -171,6 +175,105 @@ void log_ssl_error(const char* source, const SocketAddress& peer_address, int ss
           ssl_error_to_str(ssl_error), ssl_error_from_stack().c_str());
 }
 
+void wipe(std::vector<unsigned char>& secret) noexcept {
+    if (!secret.empty()) {
+        secure_memzero(secret.data(), secret.size());
+        secret.clear();
+    }
+}
+
+#if (OPENSSL_VERSION_NUMBER >= 0x10101000L)
+
+bool decode_hex(stringref hex, std::vector<unsigned char>& out) {
+    if ((hex.size() % 2) != 0) {
+        return false;
+    }
+    auto nibble = [](char c) noexcept -> int {
+        if ((c >= '0') && (c <= '9')) return (c - '0');
+        if ((c >= 'a') && (c <= 'f')) return (c - 'a' + 10);
+        if ((c >= 'A') && (c <= 'F')) return (c - 'A' + 10);
+        return -1;
+    };
+    out.resize(hex.size() / 2);
+    for (size_t i = 0; i < out.size(); ++i) {
+        int hi = nibble(hex[2 * i]);
+        int lo = nibble(hex[2 * i + 1]);
+        if ((hi < 0) || (lo < 0)) {
+            wipe(out);
+            return false;
+        }
+        out[i] = static_cast<unsigned char>((hi << 4) | lo);
+    }
+    return true;
+}
+
+// TLSv1.2 PRF (RFC 5246, section 5) using the handshake digest of the cipher suite
+bool tls12_prf(const ::EVP_MD* md, const unsigned char* secret, size_t secret_len, const char* label,
+               const unsigned char* seed, size_t seed_len, unsigned char* out, size_t out_len) noexcept
+{
+    EvpPkeyCtxPtr ctx(::EVP_PKEY_CTX_new_id(EVP_PKEY_TLS1_PRF, nullptr));
+    size_t len = out_len;
+    return (ctx &&
+            (::EVP_PKEY_derive_init(ctx.get()) == 1) &&
+            (::EVP_PKEY_CTX_set_tls1_prf_md(ctx.get(), md) == 1) &&
+            (::EVP_PKEY_CTX_set1_tls1_prf_secret(ctx.get(), secret, secret_len) == 1) &&
+            (::EVP_PKEY_CTX_add1_tls1_prf_seed(ctx.get(), reinterpret_cast<const unsigned char*>(label), strlen(label)) == 1) &&
+            (::EVP_PKEY_CTX_add1_tls1_prf_seed(ctx.get(), seed, seed_len) == 1) &&
+            (::EVP_PKEY_derive(ctx.get(), out, &len) == 1) &&
+            (len == out_len));
+}
+
+// HKDF-Expand-Label (RFC 8446, section 7.1) with an empty context
+bool tls13_hkdf_expand_label(const ::EVP_MD* md, const std::vector<unsigned char>& secret,
+                             const char* label, unsigned char* out, size_t out_len) noexcept
+{
+    const char* prefix = "tls13 ";
+    const size_t label_len = strlen(prefix) + strlen(label);
+    unsigned char info[2 + 1 + 255 + 1];
+    size_t info_len = 0;
+    info[info_len++] = static_cast<unsigned char>(out_len >> 8);
+    info[info_len++] = static_cast<unsigned char>(out_len & 0xff);
+    info[info_len++] = static_cast<unsigned char>(label_len);
+    memcpy(info + info_len, prefix, strlen(prefix));
+    info_len += strlen(prefix);
+    memcpy(info + info_len, label, strlen(label));
+    info_len += strlen(label);
+    info[info_len++] = 0; // empty context
+    EvpPkeyCtxPtr ctx(::EVP_PKEY_CTX_new_id(EVP_PKEY_HKDF, nullptr));
+    size_t len = out_len;
+    return (ctx &&
+            (::EVP_PKEY_derive_init(ctx.get()) == 1) &&
+            (::EVP_PKEY_CTX_hkdf_mode(ctx.get(), EVP_PKEY_HKDEF_MODE_EXPAND_ONLY) == 1) &&
+            (::EVP_PKEY_CTX_set_hkdf_md(ctx.get(), md) == 1) &&
+            (::EVP_PKEY_CTX_set1_hkdf_key(ctx.get(), secret.data(), secret.size()) == 1) &&
+            (::EVP_PKEY_CTX_add1_hkdf_info(ctx.get(), info, info_len) == 1) &&
+            (::EVP_PKEY_derive(ctx.get(), out, &len) == 1) &&
+            (len == out_len));
+}
+
+bool tls13_traffic_keys(const ::EVP_MD* md, const std::vector<unsigned char>& secret,
+                        size_t key_size, KernelTlsParams::Direction& dir) noexcept
+{
+    unsigned char iv[sizeof(dir.salt) + sizeof(dir.iv)];
+    bool ok = (!secret.empty() &&
+               tls13_hkdf_expand_label(md, secret, "key", dir.key, key_size) &&
+               tls13_hkdf_expand_label(md, secret, "iv", iv, sizeof(iv)));
+    memcpy(dir.salt, iv, sizeof(dir.salt));
+    memcpy(dir.iv, iv + sizeof(dir.salt), sizeof(dir.iv));
+    secure_memzero(iv, sizeof(iv));
+    dir.rec_seq = 0; // fresh application traffic keys
+    return ok;
+}
+
+void store_big_endian(unsigned char* dst, uint64_t value) noexcept {
+    for (int i = 7; i >= 0; --i) {
+        dst[i] = value & 0xff;
+        value >>= 8;
+    }
+}
+
+#endif
+
 } // anon ns
 
 OpenSslCryptoCodecImpl::OpenSslCryptoCodecImpl(std::shared_ptr<OpenSslTlsContextImpl> ctx,
@@ -183,7 +286,9 @@ OpenSslCryptoCodecImpl::OpenSslCryptoCodecImpl(std::shared_ptr<OpenSslTlsContext
       _ssl(::SSL_new(_ctx->native_context())),
       _mode(mode),
       _deferred_handshake_params(),
-      _deferred_handshake_result()
+      _deferred_handshake_result(),
+      _client_traffic_secret(),
+      _server_traffic_secret()
 {
     if (!_ssl) {
         throw CryptoException("Failed to create new SSL from SSL_CTX");
@@ -234,7 +339,10 @@ OpenSslCryptoCodecImpl::OpenSslCryptoCodecImpl(std::shared_ptr<OpenSslTlsContext
     }
 }
 
-OpenSslCryptoCodecImpl::~OpenSslCryptoCodecImpl() = default;
+OpenSslCryptoCodecImpl::~OpenSslCryptoCodecImpl() {
+    wipe(_client_traffic_secret);
+    wipe(_server_traffic_secret);
+}
 
 std::unique_ptr<OpenSslCryptoCodecImpl>
 OpenSslCryptoCodecImpl::make_client_codec(std::shared_ptr<OpenSslTlsContextImpl> ctx,
@@ -482,6 +590,104 @@ EncodeResult OpenSslCryptoCodecImpl::half_close(char* ciphertext, size_t ciphert
     return encoded_bytes(0, static_cast<size_t>(pending_after - pending_before));
 }
 
+bool OpenSslCryptoCodecImpl::kernel_tls_requested() const noexcept {
+    return _ctx->transport_security_options().enable_kernel_tls();
+}
+
+void OpenSslCryptoCodecImpl::capture_traffic_secret(const ::SSL* ssl, const char* line) noexcept {
+    auto* self = static_cast<OpenSslCryptoCodecImpl*>(SSL_get_app_data(ssl));
+    if (self == nullptr) {
+        return;
+    }
+    // Key log format: "<label> <client random> <secret>", all but label hex encoded
+    stringref entry(line);
+    std::vector<unsigned char>* dst = nullptr;
+    if (entry.find("CLIENT_TRAFFIC_SECRET_0 ") == 0) {
+        dst = &self->_client_traffic_secret;
+    } else if (entry.find("SERVER_TRAFFIC_SECRET_0 ") == 0) {
+        dst = &self->_server_traffic_secret;
+    } else {
+        return;
+    }
+    auto pos = entry.rfind(' ');
+#if (OPENSSL_VERSION_NUMBER >= 0x10101000L)
+    if (!decode_hex(entry.substr(pos + 1), *dst)) {
+        LOG(warning, "Unable to parse TLS traffic secret for kernel TLS");
+    }
+#else
+    (void) pos;
+    (void) dst;
+#endif
+}
+
+bool OpenSslCryptoCodecImpl::export_kernel_tls_params(KernelTlsParams& params) noexcept {
+    bool ok = false;
+#if (OPENSSL_VERSION_NUMBER >= 0x10101000L)
+    const ::SSL_CIPHER* cipher = ::SSL_get_current_cipher(_ssl.get());
+    if (!SSL_is_init_finished(_ssl.get()) || ::SSL_has_pending(_ssl.get()) || (cipher == nullptr)) {
+        wipe(_client_traffic_secret);
+        wipe(_server_traffic_secret);
+        return false;
+    }
+    const int cipher_nid = ::SSL_CIPHER_get_cipher_nid(cipher);
+    bool supported_cipher = true;
+    if (cipher_nid == NID_aes_128_gcm) {
+        params.cipher = KernelTlsParams::Cipher::AES_GCM_128;
+    } else if (cipher_nid == NID_aes_256_gcm) {
+        params.cipher = KernelTlsParams::Cipher::AES_GCM_256;
+    } else {
+        supported_cipher = false;
+    }
+    const ::EVP_MD* md = ::SSL_CIPHER_get_handshake_digest(cipher);
+    const size_t key_size = params.key_size();
+    auto& client_dir = (_mode == Mode::Client) ? params.tx : params.rx;
+    auto& server_dir = (_mode == Mode::Client) ? params.rx : params.tx;
+    const int version = ::SSL_version(_ssl.get());
+    if (!supported_cipher || (md == nullptr)) {
+        LOG(debug, "Cipher suite %s not supported by kernel TLS", ::SSL_CIPHER_get_name(cipher));
+    } else if (version == TLS1_2_VERSION) {
+        // Key block layout for AEAD ciphers (RFC 5246, section 6.3 and RFC 5288, section 3)
+        unsigned char master_key[SSL_MAX_MASTER_KEY_LENGTH];
+        unsigned char seed[2 * SSL3_RANDOM_SIZE];
+        unsigned char key_block[2 * sizeof(params.tx.key) + 2 * sizeof(params.tx.salt)];
+        const size_t salt_size = sizeof(params.tx.salt);
+        const size_t key_block_size = 2 * key_size + 2 * salt_size;
+        const size_t master_key_size = ::SSL_SESSION_get_master_key(::SSL_get_session(_ssl.get()),
+                                                                    master_key, sizeof(master_key));
+        ::SSL_get_server_random(_ssl.get(), seed, SSL3_RANDOM_SIZE);
+        ::SSL_get_client_random(_ssl.get(), seed + SSL3_RANDOM_SIZE, SSL3_RANDOM_SIZE);
+        ok = ((master_key_size > 0) &&
+              tls12_prf(md, master_key, master_key_size, "key expansion",
+                        seed, sizeof(seed), key_block, key_block_size));
+        if (ok) {
+            memcpy(client_dir.key, key_block, key_size);
+            memcpy(server_dir.key, key_block + key_size, key_size);
+            memcpy(client_dir.salt, key_block + 2 * key_size, salt_size);
+            memcpy(server_dir.salt, key_block + 2 * key_size + salt_size, salt_size);
+            // The Finished messages are the only records protected by these keys so far.
+            // The explicit nonce of records sent by the kernel continues from the
+            // sequence number, which keeps it unique for the lifetime of the keys.
+            for (auto* dir : {&params.tx, &params.rx}) {
+                dir->rec_seq = 1;
+                store_big_endian(dir->iv, dir->rec_seq);
+            }
+            params.version = 0x0303;
+        }
+        secure_memzero(master_key, sizeof(master_key));
+        secure_memzero(key_block, sizeof(key_block));
+    } else if (version == TLS1_3_VERSION) {
+        ok = (tls13_traffic_keys(md, _client_traffic_secret, key_size, client_dir) &&
+              tls13_traffic_keys(md, _server_traffic_secret, key_size, server_dir));
+        params.version = 0x0304;
+    }
+    wipe(_client_traffic_secret);
+    wipe(_server_traffic_secret);
+#else
+    (void) params;
+#endif
+    return ok;
+}
+
 }
 
 // External references:
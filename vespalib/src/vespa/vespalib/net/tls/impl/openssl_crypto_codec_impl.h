@@ -8,6 +8,7 @@
 #include <vespa/vespalib/net/tls/crypto_codec.h>
 #include <memory>
 #include <optional>
+#include <vector>
 
 namespace vespalib::net::tls { struct TlsContext; }
 
@@ -55,6 +56,9 @@ class OpenSslCryptoCodecImpl : public CryptoCodec {
     Mode           _mode;
     std::optional<DeferredHandshakeParams> _deferred_handshake_params;
     std::optional<HandshakeResult>         _deferred_handshake_result;
+    // TLSv1.3 application traffic secrets, only captured if kernel TLS is requested
+    std::vector<unsigned char> _client_traffic_secret;
+    std::vector<unsigned char> _server_traffic_secret;
 public:
     ~OpenSslCryptoCodecImpl() override;
 
@@ -77,6 +81,8 @@ public:
     static constexpr size_t MaximumTlsFrameSize = 16384 + 2048;
     static constexpr size_t MaximumFramePlaintextSize = 16384;
 
+    Mode mode() const noexcept override { return _mode; }
+
     size_t min_encode_buffer_size() const noexcept override {
         return MaximumTlsFrameSize;
     }
@@ -95,6 +101,15 @@ public:
                         char* plaintext, size_t plaintext_size) noexcept override;
     EncodeResult half_close(char* ciphertext, size_t ciphertext_size) noexcept override;
 
+    bool kernel_tls_requested() const noexcept override;
+    bool export_kernel_tls_params(KernelTlsParams& params) noexcept override;
+    /*
+     * Key log callback installed on contexts with kernel TLS enabled. Captures the
+     * TLSv1.3 application traffic secrets of the codec owning the SSL object, since
+     * OpenSSL offers no other way of getting at these.
+     */
+    static void capture_traffic_secret(const ::SSL* ssl, const char* line) noexcept;
+
     const SocketAddress& peer_address() const noexcept { return _peer_address; }
     /*
      * If a client has sent a SNI extension field as part of the handshake,
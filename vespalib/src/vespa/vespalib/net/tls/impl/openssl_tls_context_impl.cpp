@@ -215,6 +215,9 @@ OpenSslTlsContextImpl::OpenSslTlsContextImpl(
     disable_session_resumption();
     enforce_peer_certificate_verification();
     set_ssl_ctx_self_reference();
+    if (ts_opts.enable_kernel_tls()) {
+        prepare_for_kernel_tls();
+    }
     if (!ts_opts.accepted_ciphers().empty()) {
         // Due to how we resolve provided ciphers, this implicitly provides an
         // _intersection_ between our default cipher suite and the configured one.
@@ -330,6 +333,18 @@ void OpenSslTlsContextImpl::disable_session_resumption() {
     SSL_CTX_set_options(_ctx.get(), SSL_OP_NO_TICKET);
 }
 
+void OpenSslTlsContextImpl::prepare_for_kernel_tls() {
+#if (OPENSSL_VERSION_NUMBER >= 0x10101000L)
+    // TLSv1.3 session tickets are sent as encrypted records after the handshake
+    // has completed. This would leave the record sequence numbers unknown when
+    // handing the session over to the kernel. We never resume sessions anyway.
+    if (SSL_CTX_set_num_tickets(_ctx.get(), 0) != 1) {
+        throw CryptoException("SSL_CTX_set_num_tickets");
+    }
+    ::SSL_CTX_set_keylog_callback(_ctx.get(), OpenSslCryptoCodecImpl::capture_traffic_secret);
+#endif
+}
+
 namespace {
 
 // There's no good reason for entries to contain embedded nulls, aside from
@@ -43,6 +43,9 @@ private:
     // explicitly to the peer that it's not a supported action.
     void disable_renegotiation();
     void disable_session_resumption();
+    // Capture the session state needed to hand established sessions over to the
+    // kernel, and avoid sending anything after the handshake that would prevent it.
+    void prepare_for_kernel_tls();
     void enforce_peer_certificate_verification();
     void set_ssl_ctx_self_reference();
     void set_accepted_cipher_suites(const std::vector<vespalib::string>& ciphers);
@@ -0,0 +1,173 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "kernel_tls.h"
+#include "transport_security_options.h"
+#include <cerrno>
+#include <cstring>
+#include <sys/socket.h>
+
+#if defined(__linux__) && __has_include(<linux/tls.h>)
+#include <linux/tls.h>
+#include <netinet/tcp.h>
+#define VESPALIB_HAVE_KERNEL_TLS 1
+#ifndef SOL_TLS
+#define SOL_TLS 282
+#endif
+#ifndef TCP_ULP
+#define TCP_ULP 31
+#endif
+#endif
+
+namespace vespalib::net::tls {
+
+KernelTlsParams::KernelTlsParams() noexcept
+    : version(0),
+      cipher(Cipher::AES_GCM_128),
+      tx(),
+      rx()
+{
+    memset(&tx, 0, sizeof(tx));
+    memset(&rx, 0, sizeof(rx));
+}
+
+KernelTlsParams::~KernelTlsParams() {
+    secure_memzero(&tx, sizeof(tx));
+    secure_memzero(&rx, sizeof(rx));
+}
+
+namespace kernel_tls {
+
+#ifdef VESPALIB_HAVE_KERNEL_TLS
+
+namespace {
+
+void store_rec_seq(unsigned char* dst, uint64_t seq) noexcept {
+    for (int i = 7; i >= 0; --i) {
+        dst[i] = seq & 0xff;
+        seq >>= 8;
+    }
+}
+
+template <typename CryptoInfo>
+bool install(int fd, int direction, uint16_t version, uint16_t cipher_type,
+             const KernelTlsParams::Direction& dir, size_t key_size) noexcept
+{
+    CryptoInfo info;
+    memset(&info, 0, sizeof(info));
+    info.info.version = version;
+    info.info.cipher_type = cipher_type;
+    static_assert(sizeof(info.salt) == sizeof(dir.salt));
+    static_assert(sizeof(info.iv) == sizeof(dir.iv));
+    memcpy(info.key, dir.key, key_size);
+    memcpy(info.salt, dir.salt, sizeof(info.salt));
+    memcpy(info.iv, dir.iv, sizeof(info.iv));
+    store_rec_seq(info.rec_seq, dir.rec_seq);
+    int res = setsockopt(fd, SOL_TLS, direction, &info, sizeof(info));
+    int saved_errno = errno;
+    secure_memzero(&info, sizeof(info));
+    errno = saved_errno;
+    return (res == 0);
+}
+
+bool install(int fd, int direction, const KernelTlsParams& params, const KernelTlsParams::Direction& dir) noexcept {
+    if ((params.version != TLS_1_2_VERSION) && (params.version != TLS_1_3_VERSION)) {
+        errno = ENOTSUP;
+        return false;
+    }
+    switch (params.cipher) {
+    case KernelTlsParams::Cipher::AES_GCM_128:
+        return install<tls12_crypto_info_aes_gcm_128>(fd, direction, params.version, TLS_CIPHER_AES_GCM_128,
+                                                      dir, params.key_size());
+    case KernelTlsParams::Cipher::AES_GCM_256:
+        return install<tls12_crypto_info_aes_gcm_256>(fd, direction, params.version, TLS_CIPHER_AES_GCM_256,
+                                                      dir, params.key_size());
+    }
+    errno = ENOTSUP;
+    return false;
+}
+
+}
+
+bool enable_rx(int fd, const KernelTlsParams& params) noexcept {
+    if (setsockopt(fd, SOL_TCP, TCP_ULP, "tls", sizeof("tls")) != 0) {
+        return false;
+    }
+    return install(fd, TLS_RX, params, params.rx);
+}
+
+bool enable_tx(int fd, const KernelTlsParams& params) noexcept {
+    return install(fd, TLS_TX, params, params.tx);
+}
+
+ssize_t recv(int fd, char* buf, size_t len, uint8_t& record_type) noexcept {
+    char cmsg_buf[CMSG_SPACE(sizeof(uint8_t))];
+    struct iovec iov = {buf, len};
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = cmsg_buf;
+    msg.msg_controllen = sizeof(cmsg_buf);
+    ssize_t res = ::recvmsg(fd, &msg, 0);
+    while ((res < 0) && (errno == EINTR)) {
+        res = ::recvmsg(fd, &msg, 0);
+    }
+    record_type = record_type_application_data;
+    if (res > 0) {
+        struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+        if ((cmsg != nullptr) && (cmsg->cmsg_level == SOL_TLS) && (cmsg->cmsg_type == TLS_GET_RECORD_TYPE)) {
+            record_type = *reinterpret_cast<const uint8_t*>(CMSG_DATA(cmsg));
+        }
+    }
+    return res;
+}
+
+ssize_t send_close_notify(int fd) noexcept {
+    char alert[2] = {1, 0}; // level: warning, description: close_notify
+    char cmsg_buf[CMSG_SPACE(sizeof(uint8_t))];
+    struct iovec iov = {alert, sizeof(alert)};
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = cmsg_buf;
+    msg.msg_controllen = sizeof(cmsg_buf);
+    struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = SOL_TLS;
+    cmsg->cmsg_type = TLS_SET_RECORD_TYPE;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(uint8_t));
+    *reinterpret_cast<uint8_t*>(CMSG_DATA(cmsg)) = record_type_alert;
+    ssize_t res = ::sendmsg(fd, &msg, MSG_NOSIGNAL);
+    while ((res < 0) && (errno == EINTR)) {
+        res = ::sendmsg(fd, &msg, MSG_NOSIGNAL);
+    }
+    return res;
+}
+
+#else // no kernel TLS support
+
+bool enable_rx(int, const KernelTlsParams&) noexcept {
+    errno = ENOTSUP;
+    return false;
+}
+
+bool enable_tx(int, const KernelTlsParams&) noexcept {
+    errno = ENOTSUP;
+    return false;
+}
+
+ssize_t recv(int, char*, size_t, uint8_t&) noexcept {
+    errno = ENOTSUP;
+    return -1;
+}
+
+ssize_t send_close_notify(int) noexcept {
+    errno = ENOTSUP;
+    return -1;
+}
+
+#endif
+
+}
+
+}
@@ -0,0 +1,82 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <sys/types.h>
+
+namespace vespalib::net::tls {
+
+/*
+ * Negotiated session state needed to let the kernel (kTLS) encrypt and
+ * decrypt the records of an established TLS session. Key material is
+ * wiped on destruction.
+ */
+struct KernelTlsParams {
+    enum class Cipher {
+        AES_GCM_128,
+        AES_GCM_256
+    };
+    struct Direction {
+        unsigned char key[32]; // only the first key_size() bytes are used
+        unsigned char salt[4]; // implicit part of the record nonce
+        unsigned char iv[8];   // explicit part of the record nonce
+        uint64_t      rec_seq; // sequence number of the next record
+    };
+    // TLS protocol version, on the wire format (0x0303 for TLSv1.2, 0x0304 for TLSv1.3)
+    uint16_t  version;
+    Cipher    cipher;
+    Direction tx;
+    Direction rx;
+
+    KernelTlsParams() noexcept;
+    ~KernelTlsParams();
+    KernelTlsParams(const KernelTlsParams&) = delete;
+    KernelTlsParams& operator=(const KernelTlsParams&) = delete;
+
+    size_t key_size() const noexcept { return (cipher == Cipher::AES_GCM_128) ? 16 : 32; }
+};
+
+/*
+ * Socket operations for TLS sessions handed over to the kernel. All
+ * functions set errno on failure, like the underlying system calls.
+ * On platforms without kernel TLS, enabling always fails with ENOTSUP.
+ */
+namespace kernel_tls {
+
+// TLS record content types (RFC 8446, section 5.1)
+constexpr uint8_t record_type_alert            = 21;
+constexpr uint8_t record_type_handshake        = 22;
+constexpr uint8_t record_type_application_data = 23;
+
+/*
+ * Attach the kernel TLS layer to the socket and install the keys used
+ * to decrypt records from the peer. Returns false if the kernel does
+ * not support it; the socket is then unchanged for all practical
+ * purposes and user space TLS may still be used in both directions.
+ */
+bool enable_rx(int fd, const KernelTlsParams& params) noexcept;
+
+/*
+ * Install the keys used to encrypt records sent to the peer. Must be
+ * called after a successful enable_rx(). Returns false if the kernel
+ * does not support it, in which case records must still be encrypted
+ * in user space.
+ */
+bool enable_tx(int fd, const KernelTlsParams& params) noexcept;
+
+/*
+ * Read decrypted data from a socket with kernel TLS receive enabled.
+ * The content type of the record the data belongs to is stored in
+ * record_type; data from different records is never mixed.
+ */
+ssize_t recv(int fd, char* buf, size_t len, uint8_t& record_type) noexcept;
+
+/*
+ * Send a close_notify alert on a socket with kernel TLS transmit enabled.
+ */
+ssize_t send_close_notify(int fd) noexcept;
+
+}
+
+}
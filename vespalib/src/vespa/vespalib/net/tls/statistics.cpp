@@ -16,6 +16,8 @@ ConnectionStatistics::Snapshot ConnectionStatistics::snapshot() const noexcept {
     s.failed_tls_handshakes      = failed_tls_handshakes.load(std::memory_order_relaxed);
     s.invalid_peer_credentials   = invalid_peer_credentials.load(std::memory_order_relaxed);
     s.broken_tls_connections     = broken_tls_connections.load(std::memory_order_relaxed);
+    s.kernel_tls_connections     = kernel_tls_connections.load(std::memory_order_relaxed);
+    s.kernel_tls_fallbacks       = kernel_tls_fallbacks.load(std::memory_order_relaxed);
     return s;
 }
 
@@ -26,6 +28,8 @@ ConnectionStatistics::Snapshot ConnectionStatistics::Snapshot::subtract(const Sn
     s.failed_tls_handshakes    = failed_tls_handshakes    - rhs.failed_tls_handshakes;
     s.invalid_peer_credentials = invalid_peer_credentials - rhs.invalid_peer_credentials;
     s.broken_tls_connections   = broken_tls_connections   - rhs.broken_tls_connections;
+    s.kernel_tls_connections   = kernel_tls_connections   - rhs.kernel_tls_connections;
+    s.kernel_tls_fallbacks     = kernel_tls_fallbacks     - rhs.kernel_tls_fallbacks;
     return s;
 }
 
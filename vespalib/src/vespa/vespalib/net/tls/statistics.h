@@ -31,6 +31,13 @@ struct ConnectionStatistics {
     std::atomic<uint64_t> invalid_peer_credentials = 0;
     // Number of connections broken due to errors during TLS encoding or decoding
     std::atomic<uint64_t> broken_tls_connections   = 0;
+    // Number of TLS connections handed over to kernel TLS (kTLS) after the
+    // handshake. Only counted when kernel TLS is enabled in the TLS config.
+    std::atomic<uint64_t> kernel_tls_connections   = 0;
+    // Number of TLS connections that stayed in user space TLS even though
+    // kernel TLS was enabled; unsupported kernel, protocol or cipher suite,
+    // or data already received from the peer at handshake completion.
+    std::atomic<uint64_t> kernel_tls_fallbacks     = 0;
 
     void inc_insecure_connections() noexcept {
         insecure_connections.fetch_add(1, std::memory_order_relaxed);
@@ -47,6 +54,12 @@ struct ConnectionStatistics {
     void inc_broken_tls_connections() noexcept {
         broken_tls_connections.fetch_add(1, std::memory_order_relaxed);
     }
+    void inc_kernel_tls_connections() noexcept {
+        kernel_tls_connections.fetch_add(1, std::memory_order_relaxed);
+    }
+    void inc_kernel_tls_fallbacks() noexcept {
+        kernel_tls_fallbacks.fetch_add(1, std::memory_order_relaxed);
+    }
 
     struct Snapshot {
         uint64_t insecure_connections     = 0;
@@ -54,6 +67,8 @@ struct ConnectionStatistics {
         uint64_t failed_tls_handshakes    = 0;
         uint64_t invalid_peer_credentials = 0;
         uint64_t broken_tls_connections   = 0;
+        uint64_t kernel_tls_connections   = 0;
+        uint64_t kernel_tls_fallbacks     = 0;
 
         Snapshot subtract(const Snapshot& rhs) const noexcept;
     };
@@ -12,7 +12,8 @@ TransportSecurityOptions::TransportSecurityOptions(Params params)
       _private_key_pem(std::move(params._private_key_pem)),
       _authorized_peers(std::move(params._authorized_peers)),
       _accepted_ciphers(std::move(params._accepted_ciphers)),
-      _disable_hostname_validation(params._disable_hostname_validation)
+      _disable_hostname_validation(params._disable_hostname_validation),
+      _enable_kernel_tls(params._enable_kernel_tls)
 {
 }
 
@@ -20,18 +21,21 @@ TransportSecurityOptions::TransportSecurityOptions(vespalib::string ca_certs_pem
                                                    vespalib::string cert_chain_pem,
                                                    vespalib::string private_key_pem,
                                                    AuthorizedPeers authorized_peers,
-                                                   bool disable_hostname_validation)
+                                                   bool disable_hostname_validation,
+                                                   bool enable_kernel_tls)
     : _ca_certs_pem(std::move(ca_certs_pem)),
       _cert_chain_pem(std::move(cert_chain_pem)),
       _private_key_pem(std::move(private_key_pem)),
       _authorized_peers(std::move(authorized_peers)),
-      _disable_hostname_validation(disable_hostname_validation)
+      _disable_hostname_validation(disable_hostname_validation),
+      _enable_kernel_tls(enable_kernel_tls)
 {
 }
 
 TransportSecurityOptions TransportSecurityOptions::copy_without_private_key() const {
     return TransportSecurityOptions(_ca_certs_pem, _cert_chain_pem, "",
-                                    _authorized_peers, _disable_hostname_validation);
+                                    _authorized_peers, _disable_hostname_validation,
+                                    _enable_kernel_tls);
 }
 
 void secure_memzero(void* buf, size_t size) noexcept {
@@ -44,7 +48,8 @@ TransportSecurityOptions::Params::Params()
       _private_key_pem(),
       _authorized_peers(),
       _accepted_ciphers(),
-      _disable_hostname_validation(false)
+      _disable_hostname_validation(false),
+      _enable_kernel_tls(false)
 {
 }
 
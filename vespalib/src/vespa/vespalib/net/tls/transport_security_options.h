@@ -15,6 +15,7 @@ class TransportSecurityOptions {
     AuthorizedPeers  _authorized_peers;
     std::vector<vespalib::string> _accepted_ciphers;
     bool _disable_hostname_validation;
+    bool _enable_kernel_tls;
 public:
     struct Params {
         vespalib::string _ca_certs_pem;
@@ -23,6 +24,7 @@ public:
         AuthorizedPeers  _authorized_peers;
         std::vector<vespalib::string> _accepted_ciphers;
         bool _disable_hostname_validation;
+        bool _enable_kernel_tls;
 
         Params();
         ~Params();
@@ -43,6 +45,10 @@ public:
             _disable_hostname_validation = disable;
             return *this;
         }
+        Params& enable_kernel_tls(bool enable) {
+            _enable_kernel_tls = enable;
+            return *this;
+        }
     };
 
     explicit TransportSecurityOptions(Params params);
@@ -57,13 +63,17 @@ public:
     TransportSecurityOptions copy_without_private_key() const;
     const std::vector<vespalib::string>& accepted_ciphers() const noexcept { return _accepted_ciphers; }
     bool disable_hostname_validation() const noexcept { return _disable_hostname_validation; }
+    // If set, established connections try to hand encryption and decryption
+    // over to the kernel (kTLS), falling back to user space TLS if not possible.
+    bool enable_kernel_tls() const noexcept { return _enable_kernel_tls; }
 
 private:
     TransportSecurityOptions(vespalib::string ca_certs_pem,
                              vespalib::string cert_chain_pem,
                              vespalib::string private_key_pem,
                              AuthorizedPeers authorized_peers,
-                             bool disable_hostname_validation);
+                             bool disable_hostname_validation,
+                             bool enable_kernel_tls);
 };
 
 // Zeroes out `size` bytes in `buf` in a way that shall never be optimized
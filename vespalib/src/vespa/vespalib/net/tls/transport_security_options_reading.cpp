@@ -129,6 +129,7 @@ std::unique_ptr<TransportSecurityOptions> load_from_input(Input& input) {
     if (root["disable-hostname-validation"].valid()) {
         disable_hostname_validation = root["disable-hostname-validation"].asBool();
     }
+    bool enable_kernel_tls = root["enable-kernel-tls"].asBool();
 
     auto options = std::make_unique<TransportSecurityOptions>(
             TransportSecurityOptions::Params()
@@ -137,7 +138,8 @@ std::unique_ptr<TransportSecurityOptions> load_from_input(Input& input) {
                 .private_key_pem(priv_key)
                 .authorized_peers(std::move(authorized_peers))
                 .accepted_ciphers(std::move(accepted_ciphers))
-                .disable_hostname_validation(disable_hostname_validation));
+                .disable_hostname_validation(disable_hostname_validation)
+                .enable_kernel_tls(enable_kernel_tls));
     secure_memzero(&priv_key[0], priv_key.size());
     return options;
 }
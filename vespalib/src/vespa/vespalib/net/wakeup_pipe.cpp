@@ -2,27 +2,46 @@
 
 #include "wakeup_pipe.h"
 #include "socket_utils.h"
+#include <cstdint>
 #include <unistd.h>
+#ifdef __linux__
+#include <sys/eventfd.h>
+#endif
 
 namespace vespalib {
 
 WakeupPipe::WakeupPipe()
     : _pipe()
 {
+#ifdef __linux__
+    _pipe[0] = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (_pipe[0] != -1) {
+        _pipe[1] = _pipe[0];
+        return;
+    }
+    // fall back to a plain pipe (e.g. if out of eventfd resources)
+#endif
     socketutils::nonblocking_pipe(_pipe);
 }
 
 WakeupPipe::~WakeupPipe()
 {
     close(_pipe[0]);
-    close(_pipe[1]);
+    if (_pipe[1] != _pipe[0]) {
+        close(_pipe[1]);
+    }
 }
 
 void
 WakeupPipe::write_token()
 {
-    char token = 'T';
-    [[maybe_unused]] ssize_t res = write(_pipe[1], &token, 1);
+    if (is_eventfd()) {
+        uint64_t token = 1;
+        [[maybe_unused]] ssize_t res = write(_pipe[1], &token, sizeof(token));
+    } else {
+        char token = 'T';
+        [[maybe_unused]] ssize_t res = write(_pipe[1], &token, sizeof(token));
+    }
 }
 
 void
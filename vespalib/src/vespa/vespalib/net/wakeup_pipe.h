@@ -11,11 +11,15 @@ namespace vespalib {
  * blocking call to epoll_wait. The pipe readability is part of the
  * selection set and a wakeup is triggered by writing to the
  * pipe. When a wakeup is detected, pending tokens will be read and
- * discarded to avoid spurious wakeups in the future.
+ * discarded to avoid spurious wakeups in the future. On Linux, an
+ * eventfd is used instead of a pipe when available; it needs a single
+ * file descriptor and tokens are collapsed into a counter by the
+ * kernel.
  **/
 class WakeupPipe {
 private:
     int _pipe[2];
+    bool is_eventfd() const { return (_pipe[0] == _pipe[1]); }
 public:
     WakeupPipe();
     ~WakeupPipe();
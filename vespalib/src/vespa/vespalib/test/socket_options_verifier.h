@@ -40,6 +40,11 @@ struct SocketOptionsVerifier {
     void verify_reuse_addr(bool value) {
         TEST_DO(verify_bool_opt(fd, SOL_SOCKET, SO_REUSEADDR, value));
     }
+#ifdef SO_REUSEPORT
+    void verify_reuse_port(bool value) {
+        TEST_DO(verify_bool_opt(fd, SOL_SOCKET, SO_REUSEPORT, value));
+    }
+#endif
     void verify_ipv6_only(bool value) {
         TEST_DO(verify_bool_opt(fd, IPPROTO_IPV6, IPV6_V6ONLY, value));
     }
@@ -95,6 +95,7 @@ public:
     Alloc create(size_t sz) const {
         return (sz == 0) ? Alloc(_allocator) : Alloc(_allocator, sz);
     }
+    const MemoryAllocator *get_allocator() const { return _allocator; }
 
     static Alloc allocAlignedHeap(size_t sz, size_t alignment);
     static Alloc allocHeap(size_t sz=0);
@@ -105,6 +106,8 @@ public:
      */
     static Alloc alloc(size_t sz, size_t mmapLimit = MemoryAllocator::HUGEPAGE_SIZE, size_t alignment=0);
     static Alloc alloc();
+    // Create an empty allocation using the given allocator for future allocations.
+    static Alloc alloc_with_allocator(const MemoryAllocator* allocator);
 private:
     Alloc(const MemoryAllocator * allocator, size_t sz) : _alloc(allocator->alloc(sz)), _allocator(allocator) { }
     Alloc(const MemoryAllocator * allocator) : _alloc(nullptr, 0), _allocator(allocator) { }
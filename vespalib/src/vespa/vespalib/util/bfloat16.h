@@ -0,0 +1,84 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+namespace vespalib {
+
+/**
+ * Class holding 16-bit floating-point numbers.
+ * Truncated version of normal 32-bit float; the sign and
+ * exponent are kept as-is but the mantissa has only 8-bit
+ * precision.  Well suited for ML / AI, halving memory
+ * requirements for large vectors and similar data.
+ * Conversion from float rounds to nearest (ties to even).
+ * Arithmetic is done by converting to float.
+ **/
+class BFloat16 {
+private:
+    uint16_t _bits;
+public:
+    constexpr static uint16_t nan_bits = 0x7fc0;
+
+    BFloat16(float value) noexcept : _bits(float_to_bits(value)) {}
+    BFloat16() noexcept : _bits(0) {}
+    ~BFloat16() = default;
+    BFloat16(const BFloat16 &other) noexcept = default;
+    BFloat16 & operator=(const BFloat16 &other) noexcept = default;
+    BFloat16 & operator=(float value) noexcept {
+        _bits = float_to_bits(value);
+        return *this;
+    }
+
+    operator float() const noexcept { return bits_to_float(_bits); }
+
+    float to_float() const noexcept { return bits_to_float(_bits); }
+    void assign(float value) noexcept { _bits = float_to_bits(value); }
+
+    uint16_t get_bits() const { return _bits; }
+    void assign_bits(uint16_t value) { _bits = value; }
+
+    static uint16_t float_to_bits(float value) noexcept {
+        uint32_t bits;
+        memcpy(&bits, &value, sizeof(bits));
+        if ((bits & 0x7fffffffu) > 0x7f800000u) {
+            return nan_bits | (bits >> 16);
+        }
+        uint32_t rounding = 0x7fffu + ((bits >> 16) & 1u);
+        return (bits + rounding) >> 16;
+    }
+
+    static float bits_to_float(uint16_t bits) noexcept {
+        uint32_t expanded = uint32_t(bits) << 16;
+        float value;
+        memcpy(&value, &expanded, sizeof(value));
+        return value;
+    }
+};
+
+}
+
+namespace std {
+template<> class numeric_limits<vespalib::BFloat16> {
+public:
+    static constexpr bool is_specialized = true;
+    static constexpr bool is_signed = true;
+    static constexpr bool is_integer = false;
+    static constexpr bool is_exact = false;
+    static constexpr bool has_infinity = true;
+    static constexpr bool has_quiet_NaN = true;
+    static constexpr int digits = 8;
+    static constexpr int max_exponent = std::numeric_limits<float>::max_exponent;
+    static constexpr int min_exponent = std::numeric_limits<float>::min_exponent;
+
+    static vespalib::BFloat16 lowest() noexcept { return vespalib::BFloat16::bits_to_float(0xff7f); }
+    static vespalib::BFloat16 max() noexcept { return vespalib::BFloat16::bits_to_float(0x7f7f); }
+    static vespalib::BFloat16 min() noexcept { return vespalib::BFloat16::bits_to_float(0x0080); }
+    static vespalib::BFloat16 epsilon() noexcept { return vespalib::BFloat16::bits_to_float(0x3c00); }
+    static vespalib::BFloat16 infinity() noexcept { return vespalib::BFloat16::bits_to_float(0x7f80); }
+    static vespalib::BFloat16 quiet_NaN() noexcept { return vespalib::BFloat16::bits_to_float(vespalib::BFloat16::nan_bits); }
+};
+}
@@ -0,0 +1,178 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "mmap_file_allocator.h"
+#include <vespa/vespalib/stllike/hash_map.hpp>
+#include <vespa/vespalib/util/error.h>
+#include <vespa/vespalib/util/exceptions.h>
+#include <vespa/vespalib/util/stringfmt.h>
+#include <algorithm>
+#include <cassert>
+#include <cinttypes>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <vector>
+
+namespace vespalib::alloc {
+
+namespace {
+
+int
+advice_to_madvise(MmapFileAllocator::Advice advice)
+{
+    switch (advice) {
+    case MmapFileAllocator::Advice::RANDOM:     return MADV_RANDOM;
+    case MmapFileAllocator::Advice::SEQUENTIAL: return MADV_SEQUENTIAL;
+    case MmapFileAllocator::Advice::NORMAL:     return MADV_NORMAL;
+    }
+    abort();
+}
+
+size_t
+page_size()
+{
+    static size_t size = sysconf(_SC_PAGESIZE);
+    return size;
+}
+
+size_t
+count_resident(void *ptr, size_t sz)
+{
+    size_t pages = (sz + page_size() - 1) / page_size();
+    std::vector<unsigned char> vec(pages);
+    if (mincore(ptr, sz, vec.data()) != 0) {
+        return 0;
+    }
+    size_t resident = 0;
+    for (unsigned char flags : vec) {
+        if ((flags & 1) != 0) {
+            ++resident;
+        }
+    }
+    return std::min(sz, resident * page_size());
+}
+
+}
+
+MmapFileAllocator::MmapFileAllocator(const vespalib::string& dir_name, Advice advice)
+    : _dir_name(dir_name),
+      _advice(advice),
+      _lock(),
+      _file(_dir_name + "/swapfile"),
+      _end_offset(0),
+      _allocations()
+{
+    mkdir(_dir_name, true);
+    _file.open(File::CREATE | File::TRUNC, false);
+}
+
+MmapFileAllocator::~MmapFileAllocator()
+{
+    assert(_allocations.empty());
+    _file.close();
+    _file.unlink();
+    rmdir(_dir_name, true);
+}
+
+uint64_t
+MmapFileAllocator::get_end_offset() const
+{
+    std::lock_guard guard(_lock);
+    return _end_offset;
+}
+
+size_t
+MmapFileAllocator::get_num_allocations() const
+{
+    std::lock_guard guard(_lock);
+    return _allocations.size();
+}
+
+MemoryAllocator::PtrAndSize
+MmapFileAllocator::alloc(size_t sz) const
+{
+    if (sz == 0) {
+        return PtrAndSize(nullptr, 0); // empty allocation
+    }
+    sz = (sz + page_size() - 1) & ~(page_size() - 1); // round up to page size
+    std::lock_guard guard(_lock);
+    uint64_t offset = _end_offset;
+    _end_offset += sz;
+    _file.resize(_end_offset);
+    void *buf = mmap(nullptr, sz,
+                     PROT_READ | PROT_WRITE,
+                     MAP_SHARED,
+                     _file.getFileDescriptor(),
+                     offset);
+    if (buf == MAP_FAILED) {
+        throw IoException(make_string("Failed mmap(nullptr, %zu, PROT_READ | PROT_WRITE, MAP_SHARED, %s(fd=%d), %" PRIu64 "). Reason given by OS = '%s'",
+                                      sz, _file.getFilename().c_str(), _file.getFileDescriptor(), offset, getLastErrorString().c_str()),
+                          IoException::getErrorType(errno), VESPA_STRLOC);
+    }
+    assert(buf != nullptr);
+    // Register allocation
+    auto ins_res = _allocations.insert(std::make_pair(buf, SizeAndOffset(sz, offset)));
+    assert(ins_res.second);
+    int retval = madvise(buf, sz, advice_to_madvise(_advice));
+    assert(retval == 0);
+#ifdef __linux__
+    retval = madvise(buf, sz, MADV_DONTDUMP);
+    assert(retval == 0);
+#endif
+    return PtrAndSize(buf, sz);
+}
+
+void
+MmapFileAllocator::free(PtrAndSize alloc) const
+{
+    if (alloc.second == 0) {
+        assert(alloc.first == nullptr);
+        return; // empty allocation
+    }
+    assert(alloc.first != nullptr);
+    std::lock_guard guard(_lock);
+    // Check that matching allocation is registered
+    auto itr = _allocations.find(alloc.first);
+    assert(itr != _allocations.end());
+    // Size might be the requested size and not the allocated size
+    assert(itr->second.size >= alloc.second);
+    auto size_and_offset = itr->second;
+    _allocations.erase(itr);
+    int retval = munmap(alloc.first, size_and_offset.size);
+    assert(retval == 0);
+#ifdef __linux__
+    // Release the disk space used by the freed area
+    retval = fallocate(_file.getFileDescriptor(), FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE,
+                       size_and_offset.offset, size_and_offset.size);
+    (void) retval;
+#endif
+}
+
+size_t
+MmapFileAllocator::resize_inplace(PtrAndSize, size_t) const
+{
+    return 0;
+}
+
+MmapFileAllocator::MappedMemory
+MmapFileAllocator::get_mapped_memory() const
+{
+    std::vector<std::pair<void *, size_t>> allocations;
+    {
+        std::lock_guard guard(_lock);
+        allocations.reserve(_allocations.size());
+        for (const auto &allocation : _allocations) {
+            allocations.emplace_back(allocation.first, allocation.second.size);
+        }
+    }
+    // Scan outside the lock; an allocation freed meanwhile makes
+    // mincore() fail and is then counted as non-resident.
+    MappedMemory result;
+    for (const auto &allocation : allocations) {
+        result.mapped += allocation.second;
+        result.resident += count_resident(allocation.first, allocation.second);
+    }
+    return result;
+}
+
+}
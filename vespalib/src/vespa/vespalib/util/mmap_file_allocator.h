@@ -0,0 +1,69 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include "alloc.h"
+#include <vespa/vespalib/io/fileutil.h>
+#include <vespa/vespalib/stllike/hash_map.h>
+#include <vespa/vespalib/stllike/string.h>
+#include <mutex>
+
+namespace vespalib::alloc {
+
+/*
+ * Class handling memory allocations backed by a file. Each allocation
+ * is a shared memory mapping of a separate area of the file, letting
+ * the kernel page the data in and out of memory as needed. This
+ * enables data structures larger than the available memory, at the
+ * cost of page faults when touching data not resident in memory.
+ *
+ * File space is never reused; the backing file grows with each
+ * allocation and the disk space of freed areas is released by
+ * punching holes in the file. The backing file and its directory are
+ * removed when the allocator is destroyed.
+ */
+class MmapFileAllocator : public MemoryAllocator {
+public:
+    // Expected access pattern for the allocated memory, see madvise(2)
+    enum class Advice { NORMAL, RANDOM, SEQUENTIAL };
+
+    struct MappedMemory {
+        size_t mapped;   // number of bytes mapped
+        size_t resident; // number of mapped bytes resident in memory
+        MappedMemory() : mapped(0), resident(0) {}
+    };
+
+private:
+    struct SizeAndOffset {
+        size_t   size;
+        uint64_t offset;
+        SizeAndOffset() : SizeAndOffset(0u, 0u) { }
+        SizeAndOffset(size_t size_in, uint64_t offset_in)
+            : size(size_in),
+              offset(offset_in)
+        {
+        }
+    };
+    using Allocations = hash_map<void *, SizeAndOffset>;
+    const vespalib::string _dir_name;
+    const Advice           _advice;
+    mutable std::mutex     _lock;
+    mutable File           _file;
+    mutable uint64_t       _end_offset;
+    mutable Allocations    _allocations;
+
+public:
+    MmapFileAllocator(const vespalib::string &dir_name, Advice advice = Advice::NORMAL);
+    ~MmapFileAllocator() override;
+    PtrAndSize alloc(size_t sz) const override;
+    void free(PtrAndSize alloc) const override;
+    size_t resize_inplace(PtrAndSize, size_t) const override;
+
+    // For unit test
+    uint64_t get_end_offset() const;
+    size_t get_num_allocations() const;
+
+    MappedMemory get_mapped_memory() const;
+};
+
+}
@@ -0,0 +1,34 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include "mmap_file_allocator.h"
+#include <atomic>
+
+namespace vespalib::alloc {
+
+/*
+ * Class for creating an mmap file allocator on demand, used by data
+ * structures configured to be paged to disk. Each allocator gets a
+ * separate directory below the base directory given by setup().
+ *
+ * Memory allocations are not backed by files until setup() has been
+ * called with a non-empty base directory.
+ */
+class MmapFileAllocatorFactory {
+    vespalib::string _dir_name;
+    std::atomic<uint64_t> _generation;
+
+    MmapFileAllocatorFactory();
+    ~MmapFileAllocatorFactory();
+    MmapFileAllocatorFactory(const MmapFileAllocatorFactory &) = delete;
+    MmapFileAllocatorFactory& operator=(const MmapFileAllocatorFactory &) = delete;
+public:
+    void setup(const vespalib::string &dir_name);
+    std::unique_ptr<MmapFileAllocator> make_memory_allocator(const vespalib::string& name,
+                                                             MmapFileAllocator::Advice advice);
+
+    static MmapFileAllocatorFactory& instance();
+};
+
+}